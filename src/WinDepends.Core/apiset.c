@@ -3,7 +3,7 @@
 *
 *  Created on: Dec 06, 2024
 *
-*  Modified on: Mar 21, 2025
+*  Modified on: Oct 18, 2026
 *
 *      Project: WinDepends.Core
 *
@@ -153,6 +153,46 @@ ApiSetpSearchForApiSetHostV6(
     return FoundEntry;
 }
 
+NTSTATUS
+NTAPI
+ApiSetpResolveEntryToHostV6(
+    _In_ PAPI_SET_NAMESPACE ApiSetNamespace,
+    _In_ PAPI_SET_NAMESPACE_ENTRY_V6 ResolvedNamespaceEntry,
+    _In_opt_ PCUNICODE_STRING ParentName,
+    _Out_ PUNICODE_STRING Output
+)
+{
+    PAPI_SET_VALUE_ENTRY_V6 HostLibraryEntry;
+
+    if (ResolvedNamespaceEntry->Count > 1 && ParentName) {
+
+        HostLibraryEntry = ApiSetpSearchForApiSetHostV6(ResolvedNamespaceEntry,
+            ParentName->Buffer,
+            ParentName->Length / sizeof(WCHAR),
+            (PAPI_SET_NAMESPACE_V6)ApiSetNamespace);
+
+    }
+    else if (ResolvedNamespaceEntry->Count > 0) {
+
+        HostLibraryEntry = API_SET_VALUE_ENTRY_V6(ApiSetNamespace,
+            ResolvedNamespaceEntry,
+            0);
+    }
+    else {
+        return STATUS_APISET_NOT_PRESENT;
+    }
+
+    if (IS_API_SET_EMPTY_VALUE_ENTRY_V6(HostLibraryEntry)) {
+        return STATUS_APISET_NOT_HOSTED;
+    }
+
+    Output->Length = (USHORT)HostLibraryEntry->ValueLength;
+    Output->MaximumLength = Output->Length;
+    Output->Buffer = API_SET_VALUE_ENTRY_VALUE_V6(ApiSetNamespace, HostLibraryEntry);
+
+    return STATUS_SUCCESS;
+}
+
 NTSTATUS
 NTAPI
 ApiSetResolveToHostV6(
@@ -162,13 +202,11 @@ ApiSetResolveToHostV6(
     _Out_ PUNICODE_STRING Output
 )
 {
-    BOOLEAN Resolved = FALSE;
     USHORT ApiSetEffectiveLength;
     WCHAR* ApiSetNameBuffer, * pwch;
     ULONG ApiSetNameBufferLength;
 
     PAPI_SET_NAMESPACE_ENTRY_V6 ResolvedNamespaceEntry;
-    PAPI_SET_VALUE_ENTRY_V6 HostLibraryEntry;
 
     do {
 
@@ -198,37 +236,14 @@ ApiSetResolveToHostV6(
             break;
         }
 
-        if (ResolvedNamespaceEntry->Count > 1 && ParentName) {
-
-            HostLibraryEntry = ApiSetpSearchForApiSetHostV6(ResolvedNamespaceEntry,
-                ParentName->Buffer,
-                ParentName->Length / sizeof(WCHAR),
-                (PAPI_SET_NAMESPACE_V6)ApiSetNamespace);
-
-        }
-        else if (ResolvedNamespaceEntry->Count > 0) {
-
-            HostLibraryEntry = API_SET_VALUE_ENTRY_V6(ApiSetNamespace,
-                ResolvedNamespaceEntry,
-                0);
-        }
-        else {
-            break;
-        }
-
-        if (IS_API_SET_EMPTY_VALUE_ENTRY_V6(HostLibraryEntry)) {
-            return STATUS_APISET_NOT_HOSTED;
-        }
-
-        Output->Length = (USHORT)HostLibraryEntry->ValueLength;
-        Output->MaximumLength = Output->Length;
-        Output->Buffer = API_SET_VALUE_ENTRY_VALUE_V6(ApiSetNamespace, HostLibraryEntry);
-
-        Resolved = TRUE;
+        return ApiSetpResolveEntryToHostV6(ApiSetNamespace,
+            ResolvedNamespaceEntry,
+            ParentName,
+            Output);
 
     } while (FALSE);
 
-    return Resolved ? STATUS_SUCCESS : STATUS_APISET_NOT_PRESENT;
+    return STATUS_APISET_NOT_PRESENT;
 }
 
 PAPI_SET_NAMESPACE_ENTRY_V4
@@ -310,6 +325,48 @@ ApiSetpSearchForApiSetHostV4(
     return NULL;
 }
 
+NTSTATUS
+NTAPI
+ApiSetpResolveEntryToHostV4(
+    _In_ PAPI_SET_NAMESPACE ApiSetNamespace,
+    _In_ PAPI_SET_NAMESPACE_ENTRY_V4 ResolvedNamespaceEntry,
+    _In_opt_ PCUNICODE_STRING ParentName,
+    _Out_ PUNICODE_STRING Output
+)
+{
+    PAPI_SET_VALUE_ARRAY_V4 ResolvedValueArray;
+    PAPI_SET_VALUE_ENTRY_V4 HostLibraryEntry;
+
+    ResolvedValueArray = API_SET_NAMESPACE_ENTRY_DATA_V4(ApiSetNamespace,
+        ResolvedNamespaceEntry);
+
+    if (ResolvedValueArray->Count > 1 && ParentName) {
+
+        HostLibraryEntry = ApiSetpSearchForApiSetHostV4(ResolvedValueArray,
+            ParentName,
+            (PAPI_SET_NAMESPACE_ARRAY_V4)ApiSetNamespace);
+
+    }
+    else if (ResolvedValueArray->Count > 0) {
+
+        HostLibraryEntry = API_SET_VALUE_ENTRY_V4(ApiSetNamespace, ResolvedValueArray, 0);
+
+    }
+    else {
+        return STATUS_APISET_NOT_PRESENT;
+    }
+
+    if (HostLibraryEntry == NULL || IS_API_SET_EMPTY_VALUE_ENTRY_V4(HostLibraryEntry)) {
+        return STATUS_APISET_NOT_HOSTED;
+    }
+
+    Output->Length = (USHORT)HostLibraryEntry->ValueLength;
+    Output->MaximumLength = Output->Length;
+    Output->Buffer = API_SET_VALUE_ENTRY_VALUE_V4(ApiSetNamespace, HostLibraryEntry);
+
+    return STATUS_SUCCESS;
+}
+
 NTSTATUS
 NTAPI
 ApiSetResolveToHostV4(
@@ -319,10 +376,7 @@ ApiSetResolveToHostV4(
     _Out_ PUNICODE_STRING Output
 )
 {
-    BOOLEAN Resolved = FALSE;
     PAPI_SET_NAMESPACE_ENTRY_V4 ResolvedNamespaceEntry;
-    PAPI_SET_VALUE_ARRAY_V4 ResolvedValueArray;
-    PAPI_SET_VALUE_ENTRY_V4 HostLibraryEntry;
     UNICODE_STRING ApiSetNameNoExtString;
     USHORT PrefixLength = sizeof(ULONGLONG);
 
@@ -349,38 +403,14 @@ ApiSetResolveToHostV4(
             break;
         }
 
-        ResolvedValueArray = API_SET_NAMESPACE_ENTRY_DATA_V4(ApiSetNamespace,
-            ResolvedNamespaceEntry);
-
-        if (ResolvedValueArray->Count > 1 && ParentName) {
-
-            HostLibraryEntry = ApiSetpSearchForApiSetHostV4(ResolvedValueArray,
-                ParentName,
-                (PAPI_SET_NAMESPACE_ARRAY_V4)ApiSetNamespace);
-
-        }
-        else if (ResolvedValueArray->Count > 0) {
-
-            HostLibraryEntry = API_SET_VALUE_ENTRY_V4(ApiSetNamespace, ResolvedValueArray, 0);
-
-        }
-        else {
-            break;
-        }
-
-        if (HostLibraryEntry == NULL || IS_API_SET_EMPTY_VALUE_ENTRY_V4(HostLibraryEntry)) {
-            return STATUS_APISET_NOT_HOSTED;
-        }
-
-        Output->Length = (USHORT)HostLibraryEntry->ValueLength;
-        Output->MaximumLength = Output->Length;
-        Output->Buffer = API_SET_VALUE_ENTRY_VALUE_V4(ApiSetNamespace, HostLibraryEntry);
-
-        Resolved = TRUE;
+        return ApiSetpResolveEntryToHostV4(ApiSetNamespace,
+            ResolvedNamespaceEntry,
+            ParentName,
+            Output);
 
     } while (FALSE);
 
-    return Resolved ? STATUS_SUCCESS : STATUS_APISET_NOT_PRESENT;
+    return STATUS_APISET_NOT_PRESENT;
 }
 
 PAPI_SET_VALUE_ENTRY_V2
@@ -422,6 +452,42 @@ ApiSetpSearchForApiSetHostV2(
     return NULL;
 }
 
+NTSTATUS
+NTAPI
+ApiSetpResolveEntryToHostV2(
+    _In_ PAPI_SET_NAMESPACE ApiSetNamespace,
+    _In_ PAPI_SET_NAMESPACE_ENTRY_V2 ApiSetNamespaceEntry,
+    _In_opt_ PCUNICODE_STRING ParentName,
+    _Out_ PUNICODE_STRING Output
+)
+{
+    PAPI_SET_VALUE_ARRAY_V2 ApiSetValueArray;
+    PAPI_SET_VALUE_ENTRY_V2 HostLibraryEntry;
+
+    ApiSetValueArray = (PAPI_SET_VALUE_ARRAY_V2)((ULONG_PTR)ApiSetNamespace +
+        ApiSetNamespaceEntry->DataOffset);
+
+    if (ApiSetValueArray->Count > 1 && ParentName) {
+
+        HostLibraryEntry = ApiSetpSearchForApiSetHostV2(ApiSetValueArray,
+            ParentName,
+            ApiSetNamespace);
+    }
+    else {
+        HostLibraryEntry = NULL;
+    }
+
+    if (HostLibraryEntry == NULL) {
+        HostLibraryEntry = ApiSetValueArray->Array;
+    }
+
+    Output->Length = (USHORT)HostLibraryEntry->ValueLength;
+    Output->MaximumLength = Output->Length;
+    Output->Buffer = (WCHAR*)((ULONG_PTR)ApiSetNamespace + HostLibraryEntry->ValueOffset);
+
+    return STATUS_SUCCESS;
+}
+
 NTSTATUS
 NTAPI
 ApiSetResolveToHostV2(
@@ -431,12 +497,9 @@ ApiSetResolveToHostV2(
     _Out_ PUNICODE_STRING Output
 )
 {
-    BOOLEAN Resolved = FALSE;
     LONG result, low, middle, high;
     PAPI_SET_NAMESPACE_ARRAY_V2 ApiSetNamespaceArray;
     PAPI_SET_NAMESPACE_ENTRY_V2 ApiSetNamespaceEntry;
-    PAPI_SET_VALUE_ARRAY_V2 ApiSetValueArray;
-    PAPI_SET_VALUE_ENTRY_V2 HostLibraryEntry;
     UNICODE_STRING ApiSetNamespaceString;
     UNICODE_STRING ApiSetNameNoExtString;
     USHORT PrefixLength = sizeof(ULONGLONG);
@@ -488,30 +551,634 @@ ApiSetResolveToHostV2(
             break;
         }
 
-        ApiSetValueArray = (PAPI_SET_VALUE_ARRAY_V2)((ULONG_PTR)ApiSetNamespace +
-            ApiSetNamespaceEntry->DataOffset);
+        return ApiSetpResolveEntryToHostV2(ApiSetNamespace,
+            ApiSetNamespaceEntry,
+            ParentName,
+            Output);
 
-        if (ApiSetValueArray->Count > 1 && ParentName) {
+    } while (FALSE);
 
-            HostLibraryEntry = ApiSetpSearchForApiSetHostV2(ApiSetValueArray,
-                ParentName,
-                ApiSetNamespace);
+    return STATUS_APISET_NOT_PRESENT;
+}
+
+/*
+* ApiSetpEnumerateValue
+*
+* Purpose:
+*
+* Pass single namespace value entry to the enumeration callback.
+* Value at index 0 is the default host, others are parent specific exceptions.
+*
+*/
+BOOL
+NTAPI
+ApiSetpEnumerateValue(
+    _In_ PCUNICODE_STRING ContractName,
+    _In_ ULONG ValueIndex,
+    _In_ PWCHAR ParentBuffer,
+    _In_ ULONG ParentLength,
+    _In_ PWCHAR HostBuffer,
+    _In_ ULONG HostLength,
+    _In_ PAPI_SET_ENUMERATE_CALLBACK Callback,
+    _In_opt_ PVOID Context
+)
+{
+    UNICODE_STRING ParentName, HostName;
+
+    ParentName.Length = ParentName.MaximumLength = (USHORT)ParentLength;
+    ParentName.Buffer = ParentBuffer;
+
+    HostName.Length = HostName.MaximumLength = (USHORT)HostLength;
+    HostName.Buffer = HostBuffer;
+
+    return Callback(ContractName,
+        (ValueIndex > 0) ? &ParentName : NULL,
+        &HostName,
+        Context);
+}
+
+/*
+* ApiSetEnumerateNamespace
+*
+* Purpose:
+*
+* Walk all namespace entries and their values.
+*
+* Contract names are reported in the form used for lookup by ApiSetResolveToHost*:
+* V6 names are cut to the hashed part (up to the last hyphen), V2/V4 names are
+* reported as stored (without prefix and extension).
+* Not hosted values are reported with empty host name.
+*
+*/
+BOOL
+NTAPI
+ApiSetEnumerateNamespace(
+    _In_ PAPI_SET_NAMESPACE ApiSetNamespace,
+    _In_ PAPI_SET_ENUMERATE_CALLBACK Callback,
+    _In_opt_ PVOID Context
+)
+{
+    ULONG i, j;
+    UNICODE_STRING ContractName;
+
+    union {
+        PAPI_SET_NAMESPACE_V6 v6;
+        PAPI_SET_NAMESPACE_ARRAY_V4 v4;
+        PAPI_SET_NAMESPACE_ARRAY_V2 v2;
+        PVOID Data;
+    } ApiSet;
+
+    ApiSet.Data = ApiSetNamespace;
+
+    switch (ApiSetNamespace->Version) {
+
+    case API_SET_SCHEMA_VERSION_V2:
+    {
+        PAPI_SET_NAMESPACE_ENTRY_V2 NamespaceEntry;
+        PAPI_SET_VALUE_ARRAY_V2 ValueArray;
+        PAPI_SET_VALUE_ENTRY_V2 ValueEntry;
+
+        for (i = 0; i < ApiSet.v2->Count; i++) {
+
+            NamespaceEntry = API_SET_NAMESPACE_ENTRY_V2(ApiSetNamespace, i);
+            ContractName.Length = ContractName.MaximumLength = (USHORT)NamespaceEntry->NameLength;
+            ContractName.Buffer = (WCHAR*)((ULONG_PTR)ApiSetNamespace + NamespaceEntry->NameOffset);
+
+            ValueArray = (PAPI_SET_VALUE_ARRAY_V2)((ULONG_PTR)ApiSetNamespace + NamespaceEntry->DataOffset);
+
+            for (j = 0; j < ValueArray->Count; j++) {
+
+                ValueEntry = &ValueArray->Array[j];
+
+                if (!ApiSetpEnumerateValue(&ContractName, j,
+                    (WCHAR*)((ULONG_PTR)ApiSetNamespace + ValueEntry->NameOffset),
+                    ValueEntry->NameLength,
+                    (WCHAR*)((ULONG_PTR)ApiSetNamespace + ValueEntry->ValueOffset),
+                    ValueEntry->ValueLength,
+                    Callback,
+                    Context))
+                {
+                    return FALSE;
+                }
+            }
         }
-        else {
-            HostLibraryEntry = NULL;
+        break;
+    }
+
+    case API_SET_SCHEMA_VERSION_V4:
+    {
+        PAPI_SET_NAMESPACE_ENTRY_V4 NamespaceEntry;
+        PAPI_SET_VALUE_ARRAY_V4 ValueArray;
+        PAPI_SET_VALUE_ENTRY_V4 ValueEntry;
+
+        for (i = 0; i < ApiSet.v4->Count; i++) {
+
+            NamespaceEntry = API_SET_NAMESPACE_ENTRY_V4(ApiSetNamespace, i);
+            ContractName.Length = ContractName.MaximumLength = (USHORT)NamespaceEntry->NameLength;
+            ContractName.Buffer = API_SET_NAMESPACE_ENTRY_NAME_V4(ApiSetNamespace, NamespaceEntry);
+
+            ValueArray = API_SET_NAMESPACE_ENTRY_DATA_V4(ApiSetNamespace, NamespaceEntry);
+
+            for (j = 0; j < ValueArray->Count; j++) {
+
+                ValueEntry = API_SET_VALUE_ENTRY_V4(ApiSetNamespace, ValueArray, j);
+
+                if (!ApiSetpEnumerateValue(&ContractName, j,
+                    API_SET_VALUE_ENTRY_NAME_V4(ApiSetNamespace, ValueEntry),
+                    ValueEntry->NameLength,
+                    API_SET_VALUE_ENTRY_VALUE_V4(ApiSetNamespace, ValueEntry),
+                    IS_API_SET_EMPTY_VALUE_ENTRY_V4(ValueEntry) ? 0 : ValueEntry->ValueLength,
+                    Callback,
+                    Context))
+                {
+                    return FALSE;
+                }
+            }
         }
+        break;
+    }
+
+    case API_SET_SCHEMA_VERSION_V6:
+    {
+        PAPI_SET_NAMESPACE_ENTRY_V6 NamespaceEntry;
+        PAPI_SET_VALUE_ENTRY_V6 ValueEntry;
+
+        for (i = 0; i < ApiSet.v6->Count; i++) {
+
+            NamespaceEntry = (PAPI_SET_NAMESPACE_ENTRY_V6)RtlOffsetToPointer(ApiSetNamespace,
+                ApiSet.v6->NamespaceEntryOffset + i * sizeof(API_SET_NAMESPACE_ENTRY_V6));
 
-        if (HostLibraryEntry == NULL) {
-            HostLibraryEntry = ApiSetValueArray->Array;
+            ContractName.Length = ContractName.MaximumLength = (USHORT)NamespaceEntry->HashNameLength;
+            ContractName.Buffer = API_SET_NAMESPACE_ENTRY_NAME_V6(ApiSet.v6, NamespaceEntry);
+
+            for (j = 0; j < NamespaceEntry->Count; j++) {
+
+                ValueEntry = API_SET_VALUE_ENTRY_V6(ApiSetNamespace, NamespaceEntry, j);
+
+                if (!ApiSetpEnumerateValue(&ContractName, j,
+                    API_SET_VALUE_NAME_V6(ApiSetNamespace, ValueEntry),
+                    ValueEntry->NameLength,
+                    API_SET_VALUE_ENTRY_VALUE_V6(ApiSetNamespace, ValueEntry),
+                    IS_API_SET_EMPTY_VALUE_ENTRY_V6(ValueEntry) ? 0 : ValueEntry->ValueLength,
+                    Callback,
+                    Context))
+                {
+                    return FALSE;
+                }
+            }
         }
+        break;
+    }
 
-        Output->Length = (USHORT)HostLibraryEntry->ValueLength;
-        Output->MaximumLength = Output->Length;
-        Output->Buffer = (WCHAR*)((ULONG_PTR)ApiSetNamespace + HostLibraryEntry->ValueOffset);
+    default:
+        return FALSE;
+    }
 
-        Resolved = TRUE;
+    return TRUE;
+}
 
-    } while (FALSE);
+/*
+* ApiSetpHashKey
+*
+* Purpose:
+*
+* FNV-1a hash over lowercased key characters.
+*
+*/
+__forceinline ULONG ApiSetpHashKey(
+    _In_reads_(KeyLength) CONST WCHAR* Key,
+    _In_ ULONG KeyLength
+)
+{
+    ULONG i, hash = 2166136261UL;
+
+    for (i = 0; i < KeyLength; i++) {
+        hash ^= locase_w(Key[i]);
+        hash *= 16777619UL;
+    }
+
+    return hash;
+}
 
-    return Resolved ? STATUS_SUCCESS : STATUS_APISET_NOT_PRESENT;
+/*
+* ApiSetpGetLookupKey
+*
+* Purpose:
+*
+* Extract part of the contract name used for namespace lookup.
+* V6 uses name up to the last hyphen, V2/V4 use name without prefix and extension.
+*
+*/
+BOOL
+NTAPI
+ApiSetpGetLookupKey(
+    _In_ ULONG Version,
+    _In_ PCUNICODE_STRING ApiSetNameToResolve,
+    _Out_ WCHAR** Key,
+    _Out_ PULONG KeyLength
+)
+{
+    WCHAR* pwch;
+    ULONG NameLength;
+
+    *Key = NULL;
+    *KeyLength = 0;
+
+    if (!ApiSetpValidateNameToResolve(ApiSetNameToResolve))
+        return FALSE;
+
+    NameLength = ApiSetNameToResolve->Length / sizeof(WCHAR);
+
+    if (Version == API_SET_SCHEMA_VERSION_V6) {
+
+        pwch = ApiSetNameToResolve->Buffer + NameLength;
+        do {
+            if (NameLength <= 1)
+                break;
+            --NameLength;
+            --pwch;
+        } while (*pwch != L'-');
+
+        if (NameLength == 0)
+            return FALSE;
+
+        *Key = ApiSetNameToResolve->Buffer;
+    }
+    else {
+
+        if (NameLength < API_SET_PREFIX_NAME_U_LENGTH)
+            return FALSE;
+
+        NameLength -= API_SET_PREFIX_NAME_U_LENGTH;
+
+        *Key = ApiSetNameToResolve->Buffer + API_SET_PREFIX_NAME_U_LENGTH;
+        if (NameLength >= API_SET_DLL_EXT_U_NAME_LENGTH &&
+            (*Key)[NameLength - API_SET_DLL_EXT_U_NAME_LENGTH] == L'.')
+        {
+            NameLength -= API_SET_DLL_EXT_U_NAME_LENGTH;
+        }
+    }
+
+    *KeyLength = NameLength;
+    return TRUE;
+}
+
+/*
+* ApiSetpIndexInsert
+*
+* Purpose:
+*
+* Add namespace entry to the index under lowercased key.
+*
+*/
+BOOL
+NTAPI
+ApiSetpIndexInsert(
+    _In_ PAPI_SET_INDEX Index,
+    _In_ PVOID NamespaceEntry,
+    _In_reads_(KeyLength) CONST WCHAR* Key,
+    _In_ ULONG KeyLength
+)
+{
+    ULONG i, bucket;
+    PAPI_SET_INDEX_ENTRY IndexEntry;
+
+    if (Index->Count >= Index->Capacity ||
+        Index->KeyBufferUsed + KeyLength > Index->KeyBufferLength)
+    {
+        return FALSE;
+    }
+
+    IndexEntry = &Index->Entries[Index->Count];
+    IndexEntry->NamespaceEntry = NamespaceEntry;
+    IndexEntry->KeyLength = KeyLength;
+    IndexEntry->Key = Index->KeyBuffer + Index->KeyBufferUsed;
+
+    for (i = 0; i < KeyLength; i++) {
+        IndexEntry->Key[i] = locase_w(Key[i]);
+    }
+    Index->KeyBufferUsed += KeyLength;
+
+    IndexEntry->Hash = ApiSetpHashKey(IndexEntry->Key, KeyLength);
+
+    bucket = IndexEntry->Hash & (Index->BucketCount - 1);
+    IndexEntry->Next = Index->Buckets[bucket];
+    Index->Buckets[bucket] = ++Index->Count;
+
+    return TRUE;
+}
+
+/*
+* ApiSetCreateIndex
+*
+* Purpose:
+*
+* Build lowercase hash index over namespace contract names.
+* Index keeps pointers into the namespace and must be destroyed before namespace is unloaded.
+*
+*/
+PAPI_SET_INDEX
+NTAPI
+ApiSetCreateIndex(
+    _In_ PAPI_SET_NAMESPACE ApiSetNamespace
+)
+{
+    BOOL bResult = FALSE;
+    ULONG i, count = 0, keyLength = 0, bucketCount;
+    PAPI_SET_INDEX Index = NULL;
+
+    union {
+        PAPI_SET_NAMESPACE_V6 v6;
+        PAPI_SET_NAMESPACE_ARRAY_V4 v4;
+        PAPI_SET_NAMESPACE_ARRAY_V2 v2;
+        PVOID Data;
+    } ApiSet;
+
+    PAPI_SET_NAMESPACE_ENTRY_V6 EntryV6;
+    PAPI_SET_NAMESPACE_ENTRY_V4 EntryV4;
+    PAPI_SET_NAMESPACE_ENTRY_V2 EntryV2;
+
+    ApiSet.Data = ApiSetNamespace;
+
+    __try {
+
+        //
+        // Calculate index size.
+        //
+        switch (ApiSetNamespace->Version) {
+
+        case API_SET_SCHEMA_VERSION_V2:
+            count = ApiSet.v2->Count;
+            for (i = 0; i < count; i++) {
+                keyLength += API_SET_NAMESPACE_ENTRY_V2(ApiSetNamespace, i)->NameLength / sizeof(WCHAR);
+            }
+            break;
+
+        case API_SET_SCHEMA_VERSION_V4:
+            count = ApiSet.v4->Count;
+            for (i = 0; i < count; i++) {
+                keyLength += API_SET_NAMESPACE_ENTRY_V4(ApiSetNamespace, i)->NameLength / sizeof(WCHAR);
+            }
+            break;
+
+        case API_SET_SCHEMA_VERSION_V6:
+            count = ApiSet.v6->Count;
+            for (i = 0; i < count; i++) {
+                EntryV6 = (PAPI_SET_NAMESPACE_ENTRY_V6)RtlOffsetToPointer(ApiSetNamespace,
+                    ApiSet.v6->NamespaceEntryOffset + i * sizeof(API_SET_NAMESPACE_ENTRY_V6));
+                keyLength += EntryV6->HashNameLength / sizeof(WCHAR);
+            }
+            break;
+
+        default:
+            __leave;
+        }
+
+        if (count == 0 || count > API_SET_INDEX_MAX_ENTRIES)
+            __leave;
+
+        bucketCount = 16;
+        while (bucketCount < count * 2) {
+            bucketCount <<= 1;
+        }
+
+        Index = (PAPI_SET_INDEX)heap_calloc(NULL, sizeof(API_SET_INDEX));
+        if (Index == NULL)
+            __leave;
+
+        Index->Namespace = ApiSetNamespace;
+        Index->Version = ApiSetNamespace->Version;
+        Index->Capacity = count;
+        Index->BucketCount = bucketCount;
+        Index->KeyBufferLength = keyLength;
+
+        Index->Entries = (PAPI_SET_INDEX_ENTRY)heap_calloc(NULL, count * sizeof(API_SET_INDEX_ENTRY));
+        Index->Buckets = (PULONG)heap_calloc(NULL, bucketCount * sizeof(ULONG));
+        Index->KeyBuffer = (PWCHAR)heap_calloc(NULL, (keyLength + 1) * sizeof(WCHAR));
+
+        if (Index->Entries == NULL || Index->Buckets == NULL || Index->KeyBuffer == NULL)
+            __leave;
+
+        //
+        // Fill index.
+        //
+        for (i = 0; i < count; i++) {
+
+            switch (Index->Version) {
+
+            case API_SET_SCHEMA_VERSION_V2:
+                EntryV2 = API_SET_NAMESPACE_ENTRY_V2(ApiSetNamespace, i);
+                if (!ApiSetpIndexInsert(Index, EntryV2,
+                    (WCHAR*)((ULONG_PTR)ApiSetNamespace + EntryV2->NameOffset),
+                    EntryV2->NameLength / sizeof(WCHAR)))
+                {
+                    __leave;
+                }
+                break;
+
+            case API_SET_SCHEMA_VERSION_V4:
+                EntryV4 = API_SET_NAMESPACE_ENTRY_V4(ApiSetNamespace, i);
+                if (!ApiSetpIndexInsert(Index, EntryV4,
+                    API_SET_NAMESPACE_ENTRY_NAME_V4(ApiSetNamespace, EntryV4),
+                    EntryV4->NameLength / sizeof(WCHAR)))
+                {
+                    __leave;
+                }
+                break;
+
+            case API_SET_SCHEMA_VERSION_V6:
+                EntryV6 = (PAPI_SET_NAMESPACE_ENTRY_V6)RtlOffsetToPointer(ApiSetNamespace,
+                    ApiSet.v6->NamespaceEntryOffset + i * sizeof(API_SET_NAMESPACE_ENTRY_V6));
+                if (!ApiSetpIndexInsert(Index, EntryV6,
+                    API_SET_NAMESPACE_ENTRY_NAME_V6(ApiSet.v6, EntryV6),
+                    EntryV6->HashNameLength / sizeof(WCHAR)))
+                {
+                    __leave;
+                }
+                break;
+            }
+        }
+
+        bResult = TRUE;
+
+    }
+    __except (ex_filter(GetExceptionCode(), GetExceptionInformation())) {
+        bResult = FALSE;
+    }
+
+    if (!bResult && Index) {
+        ApiSetDestroyIndex(Index);
+        Index = NULL;
+    }
+
+    return Index;
+}
+
+/*
+* ApiSetDestroyIndex
+*
+* Purpose:
+*
+* Release index memory.
+*
+*/
+VOID
+NTAPI
+ApiSetDestroyIndex(
+    _In_ PAPI_SET_INDEX Index
+)
+{
+    if (Index->Entries) heap_free(NULL, Index->Entries);
+    if (Index->Buckets) heap_free(NULL, Index->Buckets);
+    if (Index->KeyBuffer) heap_free(NULL, Index->KeyBuffer);
+    heap_free(NULL, Index);
+}
+
+/*
+* ApiSetIndexResolveToHost
+*
+* Purpose:
+*
+* Resolve contract name using prebuilt index.
+* Host selection is the same as in ApiSetResolveToHost* routines.
+*
+*/
+NTSTATUS
+NTAPI
+ApiSetIndexResolveToHost(
+    _In_ PAPI_SET_INDEX Index,
+    _In_ PCUNICODE_STRING ApiSetNameToResolve,
+    _In_opt_ PCUNICODE_STRING ParentName,
+    _Out_ PUNICODE_STRING Output
+)
+{
+    ULONG i, hash, KeyLength, next;
+    WCHAR* Key;
+    PAPI_SET_INDEX_ENTRY IndexEntry;
+
+    if (!ApiSetpGetLookupKey(Index->Version, ApiSetNameToResolve, &Key, &KeyLength))
+        return STATUS_APISET_NOT_PRESENT;
+
+    hash = ApiSetpHashKey(Key, KeyLength);
+
+    for (next = Index->Buckets[hash & (Index->BucketCount - 1)]; next != 0; next = IndexEntry->Next) {
+
+        IndexEntry = &Index->Entries[next - 1];
+
+        if (IndexEntry->Hash != hash || IndexEntry->KeyLength != KeyLength)
+            continue;
+
+        for (i = 0; i < KeyLength; i++) {
+            if (IndexEntry->Key[i] != locase_w(Key[i]))
+                break;
+        }
+
+        if (i != KeyLength)
+            continue;
+
+        switch (Index->Version) {
+
+        case API_SET_SCHEMA_VERSION_V2:
+            return ApiSetpResolveEntryToHostV2(Index->Namespace,
+                (PAPI_SET_NAMESPACE_ENTRY_V2)IndexEntry->NamespaceEntry,
+                ParentName,
+                Output);
+
+        case API_SET_SCHEMA_VERSION_V4:
+            return ApiSetpResolveEntryToHostV4(Index->Namespace,
+                (PAPI_SET_NAMESPACE_ENTRY_V4)IndexEntry->NamespaceEntry,
+                ParentName,
+                Output);
+
+        case API_SET_SCHEMA_VERSION_V6:
+            return ApiSetpResolveEntryToHostV6(Index->Namespace,
+                (PAPI_SET_NAMESPACE_ENTRY_V6)IndexEntry->NamespaceEntry,
+                ParentName,
+                Output);
+
+        default:
+            return STATUS_APISET_NOT_PRESENT;
+        }
+    }
+
+    return STATUS_APISET_NOT_PRESENT;
+}
+
+/*
+* ApiSetFindSchemaSection
+*
+* Purpose:
+*
+* Locate apiset namespace inside raw (not loader mapped) schema file image.
+* Only file buffer is parsed, every header and section is bounds checked.
+*
+*/
+PAPI_SET_NAMESPACE
+NTAPI
+ApiSetFindSchemaSection(
+    _In_reads_bytes_(FileSize) PVOID FileBuffer,
+    _In_ SIZE_T FileSize,
+    _Out_opt_ PULONG DataSize
+)
+{
+    ULONG i, NumberOfSections;
+    ULONG_PTR SectionTableOffset;
+    PBYTE Base = (PBYTE)FileBuffer;
+    PIMAGE_DOS_HEADER DosHeader;
+    PIMAGE_FILE_HEADER FileHeader;
+    PIMAGE_SECTION_HEADER Section;
+
+    if (DataSize)
+        *DataSize = 0;
+
+    if (FileSize < sizeof(IMAGE_DOS_HEADER))
+        return NULL;
+
+    DosHeader = (PIMAGE_DOS_HEADER)Base;
+    if (DosHeader->e_magic != IMAGE_DOS_SIGNATURE ||
+        DosHeader->e_lfanew <= 0 ||
+        (ULONG_PTR)DosHeader->e_lfanew > FileSize - sizeof(ULONG) - sizeof(IMAGE_FILE_HEADER))
+    {
+        return NULL;
+    }
+
+    if (*(PULONG)(Base + DosHeader->e_lfanew) != IMAGE_NT_SIGNATURE)
+        return NULL;
+
+    FileHeader = (PIMAGE_FILE_HEADER)(Base + DosHeader->e_lfanew + sizeof(ULONG));
+    NumberOfSections = FileHeader->NumberOfSections;
+
+    SectionTableOffset = (ULONG_PTR)DosHeader->e_lfanew + sizeof(ULONG) +
+        sizeof(IMAGE_FILE_HEADER) + FileHeader->SizeOfOptionalHeader;
+
+    if (SectionTableOffset > FileSize ||
+        (FileSize - SectionTableOffset) / sizeof(IMAGE_SECTION_HEADER) < NumberOfSections)
+    {
+        return NULL;
+    }
+
+    Section = (PIMAGE_SECTION_HEADER)(Base + SectionTableOffset);
+
+    for (i = 0; i < NumberOfSections; i++, Section++) {
+
+        if (_strnicmp((CHAR*)&Section->Name, API_SET_SECTION_NAME,
+            sizeof(API_SET_SECTION_NAME)) != 0)
+        {
+            continue;
+        }
+
+        if (Section->PointerToRawData >= FileSize ||
+            Section->SizeOfRawData > FileSize - Section->PointerToRawData ||
+            Section->SizeOfRawData < sizeof(API_SET_NAMESPACE))
+        {
+            return NULL;
+        }
+
+        if (DataSize)
+            *DataSize = Section->SizeOfRawData;
+
+        return (PAPI_SET_NAMESPACE)(Base + Section->PointerToRawData);
+    }
+
+    return NULL;
 }
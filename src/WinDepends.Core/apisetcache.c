@@ -0,0 +1,218 @@
+/*
+*  File: apisetcache.c
+*
+*  Created on: Oct 18, 2026
+*
+*  Modified on: Oct 18, 2026
+*
+*      Project: WinDepends.Core
+*
+*      Author: WinDepends dev team
+*/
+
+#include "core.h"
+
+//
+// Schemas mapped from files, shared by all client sessions.
+// Process namespace schema is static and never released.
+//
+static SRWLOCK g_schema_lock = SRWLOCK_INIT;
+static PAPISET_SCHEMA g_schema_list = NULL;
+static APISET_SCHEMA g_process_schema;
+
+/*
+* apiset_cache_init
+*
+* Purpose:
+*
+* Setup process namespace schema, must be called once during server init.
+*
+*/
+VOID apiset_cache_init(
+    VOID
+)
+{
+    RtlSecureZeroMemory(&g_process_schema, sizeof(g_process_schema));
+
+    g_process_schema.RefCount = 1;
+    g_process_schema.Namespace = (PAPI_SET_NAMESPACE)gsup.ApiSetMap;
+    if (g_process_schema.Namespace) {
+        g_process_schema.Index = ApiSetCreateIndex(g_process_schema.Namespace);
+    }
+}
+
+/*
+* apiset_schema_lookup
+*
+* Purpose:
+*
+* Find cached schema by file identity, cache lock must be held.
+*
+*/
+PAPISET_SCHEMA apiset_schema_lookup(
+    _In_ LPBY_HANDLE_FILE_INFORMATION file_info
+)
+{
+    PAPISET_SCHEMA schema;
+
+    for (schema = g_schema_list; schema != NULL; schema = schema->Next) {
+        if (schema->VolumeSerialNumber == file_info->dwVolumeSerialNumber &&
+            schema->FileIndex.LowPart == file_info->nFileIndexLow &&
+            schema->FileIndex.HighPart == file_info->nFileIndexHigh &&
+            CompareFileTime(&schema->LastWriteTime, &file_info->ftLastWriteTime) == 0)
+        {
+            return schema;
+        }
+    }
+
+    return NULL;
+}
+
+/*
+* apiset_schema_free
+*
+* Purpose:
+*
+* Unmap schema file and release schema memory.
+*
+*/
+VOID apiset_schema_free(
+    _In_ PAPISET_SCHEMA schema
+)
+{
+    if (schema->Index) {
+        ApiSetDestroyIndex(schema->Index);
+    }
+
+    unmap_apiset_namespace(schema->ViewBase);
+    heap_free(NULL, schema);
+}
+
+/*
+* apiset_schema_acquire
+*
+* Purpose:
+*
+* Return referenced schema for the given file, mapping it if not cached.
+* NULL file name selects process namespace.
+* Every acquired schema must be released with apiset_schema_release.
+*
+*/
+_Success_(return != NULL)
+PAPISET_SCHEMA apiset_schema_acquire(
+    _In_opt_ LPCWSTR file_name
+)
+{
+    HANDLE file_handle;
+    PAPISET_SCHEMA schema, new_schema;
+    BY_HANDLE_FILE_INFORMATION fi;
+
+    if (file_name == NULL) {
+        return (g_process_schema.Namespace != NULL) ? &g_process_schema : NULL;
+    }
+
+    file_handle = open_apiset_schema(file_name, &fi);
+    if (file_handle == INVALID_HANDLE_VALUE) {
+        return NULL;
+    }
+
+    AcquireSRWLockExclusive(&g_schema_lock);
+    schema = apiset_schema_lookup(&fi);
+    if (schema) {
+        schema->RefCount++;
+    }
+    ReleaseSRWLockExclusive(&g_schema_lock);
+
+    if (schema) {
+        CloseHandle(file_handle);
+        return schema;
+    }
+
+    //
+    // Map and index outside of the lock, it only takes a file view.
+    //
+    new_schema = (PAPISET_SCHEMA)heap_calloc(NULL, sizeof(APISET_SCHEMA));
+    if (new_schema) {
+        new_schema->VolumeSerialNumber = fi.dwVolumeSerialNumber;
+        new_schema->FileIndex.LowPart = fi.nFileIndexLow;
+        new_schema->FileIndex.HighPart = fi.nFileIndexHigh;
+        new_schema->LastWriteTime = fi.ftLastWriteTime;
+        new_schema->Namespace = (PAPI_SET_NAMESPACE)map_apiset_namespace(file_handle, &fi, &new_schema->ViewBase);
+        if (new_schema->Namespace) {
+            new_schema->Index = ApiSetCreateIndex(new_schema->Namespace);
+        }
+    }
+
+    CloseHandle(file_handle);
+
+    if (new_schema == NULL) {
+        return NULL;
+    }
+
+    if (new_schema->Namespace == NULL) {
+        apiset_schema_free(new_schema);
+        return NULL;
+    }
+
+    AcquireSRWLockExclusive(&g_schema_lock);
+
+    //
+    // Other session could map the same file meanwhile.
+    //
+    schema = apiset_schema_lookup(&fi);
+    if (schema == NULL) {
+        new_schema->RefCount = 1;
+        new_schema->Next = g_schema_list;
+        g_schema_list = new_schema;
+        schema = new_schema;
+        new_schema = NULL;
+    }
+    else {
+        schema->RefCount++;
+    }
+
+    ReleaseSRWLockExclusive(&g_schema_lock);
+
+    if (new_schema) {
+        apiset_schema_free(new_schema);
+    }
+
+    return schema;
+}
+
+/*
+* apiset_schema_release
+*
+* Purpose:
+*
+* Dereference schema, unloading it when no session uses it anymore.
+*
+*/
+VOID apiset_schema_release(
+    _In_opt_ PAPISET_SCHEMA schema
+)
+{
+    PAPISET_SCHEMA* link;
+
+    if (schema == NULL || schema == &g_process_schema) {
+        return;
+    }
+
+    AcquireSRWLockExclusive(&g_schema_lock);
+
+    if (--schema->RefCount > 0) {
+        ReleaseSRWLockExclusive(&g_schema_lock);
+        return;
+    }
+
+    for (link = &g_schema_list; *link != NULL; link = &(*link)->Next) {
+        if (*link == schema) {
+            *link = schema->Next;
+            break;
+        }
+    }
+
+    ReleaseSRWLockExclusive(&g_schema_lock);
+
+    apiset_schema_free(schema);
+}
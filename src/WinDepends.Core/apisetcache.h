@@ -0,0 +1,47 @@
+/*
+*  File: apisetcache.h
+*
+*  Created on: Oct 18, 2026
+*
+*  Modified on: Oct 18, 2026
+*
+*      Project: WinDepends.Core
+*
+*      Author: WinDepends dev team
+*/
+
+#pragma once
+
+#ifndef _APISETCACHE_H_
+#define _APISETCACHE_H_
+
+//
+// Mapped apiset schema shared between client sessions.
+// File schemas are identified by volume, file index and last write time,
+// so different paths to the same file share one mapping.
+//
+typedef struct _APISET_SCHEMA {
+    struct _APISET_SCHEMA* Next;
+    LONG RefCount;                  // protected by cache lock
+    DWORD VolumeSerialNumber;
+    ULARGE_INTEGER FileIndex;
+    FILETIME LastWriteTime;
+    PAPI_SET_NAMESPACE Namespace;
+    PVOID ViewBase;                 // NULL for the process namespace
+    PAPI_SET_INDEX Index;
+} APISET_SCHEMA, * PAPISET_SCHEMA;
+
+VOID apiset_cache_init(
+    VOID
+);
+
+_Success_(return != NULL)
+PAPISET_SCHEMA apiset_schema_acquire(
+    _In_opt_ LPCWSTR file_name
+);
+
+VOID apiset_schema_release(
+    _In_opt_ PAPISET_SCHEMA schema
+);
+
+#endif /* _APISETCACHE_H_ */
@@ -3,7 +3,7 @@
 *
 *  Created on: Aug 27, 2024
 *
-*  Modified on: Jun 04, 2025
+*  Modified on: Oct 18, 2026
 *
 *      Project: WinDepends.Core
 *
@@ -255,4 +255,73 @@ ApiSetResolveToHostV2(
     _In_opt_ PCUNICODE_STRING ParentName,
     _Out_ PUNICODE_STRING Output);
 
+//
+// Lowercase hash index over namespace contract names, built once per loaded namespace.
+//
+
+#define API_SET_INDEX_MAX_ENTRIES 0x100000
+
+typedef struct _API_SET_INDEX_ENTRY {
+    ULONG Hash;
+    ULONG Next;             // 1-based index of the next entry in bucket chain, 0 terminates
+    ULONG KeyLength;        // in chars
+    PWCHAR Key;             // lowercased lookup key
+    PVOID NamespaceEntry;   // PAPI_SET_NAMESPACE_ENTRY_V2/V4/V6
+} API_SET_INDEX_ENTRY, * PAPI_SET_INDEX_ENTRY;
+
+typedef struct _API_SET_INDEX {
+    PAPI_SET_NAMESPACE Namespace;
+    ULONG Version;
+    ULONG Count;
+    ULONG Capacity;
+    ULONG BucketCount;      // power of two
+    PULONG Buckets;         // 1-based index of the first entry, 0 if empty
+    PAPI_SET_INDEX_ENTRY Entries;
+    PWCHAR KeyBuffer;
+    ULONG KeyBufferLength;  // in chars
+    ULONG KeyBufferUsed;    // in chars
+} API_SET_INDEX, * PAPI_SET_INDEX;
+
+PAPI_SET_INDEX
+NTAPI
+ApiSetCreateIndex(
+    _In_ PAPI_SET_NAMESPACE ApiSetNamespace);
+
+VOID
+NTAPI
+ApiSetDestroyIndex(
+    _In_ PAPI_SET_INDEX Index);
+
+NTSTATUS
+NTAPI
+ApiSetIndexResolveToHost(
+    _In_ PAPI_SET_INDEX Index,
+    _In_ PCUNICODE_STRING ApiSetNameToResolve,
+    _In_opt_ PCUNICODE_STRING ParentName,
+    _Out_ PUNICODE_STRING Output);
+
+//
+// Namespace enumeration callback, ParentName is NULL for the default host value.
+// Return FALSE to stop enumeration.
+//
+typedef BOOL(CALLBACK* PAPI_SET_ENUMERATE_CALLBACK)(
+    _In_ PCUNICODE_STRING ContractName,
+    _In_opt_ PCUNICODE_STRING ParentName,
+    _In_ PCUNICODE_STRING HostName,
+    _In_opt_ PVOID Context);
+
+BOOL
+NTAPI
+ApiSetEnumerateNamespace(
+    _In_ PAPI_SET_NAMESPACE ApiSetNamespace,
+    _In_ PAPI_SET_ENUMERATE_CALLBACK Callback,
+    _In_opt_ PVOID Context);
+
+PAPI_SET_NAMESPACE
+NTAPI
+ApiSetFindSchemaSection(
+    _In_reads_bytes_(FileSize) PVOID FileBuffer,
+    _In_ SIZE_T FileSize,
+    _Out_opt_ PULONG DataSize);
+
 #endif /* _APISETX_H_ */
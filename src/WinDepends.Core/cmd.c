@@ -3,7 +3,7 @@
 *
 *  Created on: Aug 30, 2024
 *
-*  Modified on: Feb 11, 2026
+*  Modified on: Oct 18, 2026
 *
 *      Project: WinDepends.Core
 *
@@ -17,21 +17,34 @@ typedef struct {
     cmd_entry_type type;
 } cmd_entry, * pcmd_entry;
 
+typedef struct {
+    PLIST_ENTRY msg_lh;
+    SIZE_T count;
+} apiset_dump_ctx, * papiset_dump_ctx;
+
 // Command line array sorted for binary search.
 static const cmd_entry cmds[] = {
+    {L"apisetdump",     ce_apisetdump },
     {L"apisetmapsrc",   ce_apisetmapsrc },
     {L"apisetnsinfo",   ce_apisetnsinfo },
     {L"apisetresolve",  ce_apisetresolve },
+    {L"apisetresolvebatch", ce_apisetresolvebatch },
     {L"callstats",      ce_callstats },
     {L"close",          ce_close },
     {L"datadirs",       ce_datadirs },
+    {L"debuginfo",      ce_debuginfo },
     {L"exit",           ce_exit },
     {L"exports",        ce_exports },
     {L"headers",        ce_headers },
     {L"imports",        ce_imports },
     {L"knowndlls",      ce_knowndlls },
+    {L"knowndllsload",  ce_knowndllsload },
+    {L"knowndllsver",   ce_knowndllsver },
     {L"open",           ce_open },
-    {L"shutdown",       ce_shutdown }
+    {L"openresolve",    ce_openresolve },
+    {L"shutdown",       ce_shutdown },
+    {L"stats",          ce_stats },
+    {L"trace",          ce_trace }
 };
 
 /*
@@ -62,6 +75,28 @@ cmd_entry_type get_command_entry(
     return ce_unknown;
 }
 
+/*
+* get_command_name
+*
+* Purpose:
+*
+* Returns command name for the given cmd_entry_type.
+*
+*/
+LPCWSTR get_command_name(
+    _In_ cmd_entry_type type
+)
+{
+    ULONG i;
+
+    for (i = 0; i < ARRAYSIZE(cmds); i++) {
+        if (cmds[i].type == type)
+            return cmds[i].cmd;
+    }
+
+    return L"unknown";
+}
+
 /*
 * cmd_unknown_command
 *
@@ -125,94 +160,337 @@ void cmd_callstats(
 }
 
 /*
-* cmd_query_knowndlls_list
+* cmd_stats
 *
 * Purpose:
 *
-* Return KnownDlls list.
+* Server wide per-command counters and latency histograms.
+* With "reset" option counters are zeroed after being reported.
 *
 */
-void cmd_query_knowndlls_list(
+void cmd_stats(
     _In_ SOCKET s,
     _In_opt_ LPCWSTR params
 )
 {
-    BOOL is_wow64, send_ok, response_ok;
+    BOOL response_ok;
+    ULONG i, j, count = 0;
     LIST_ENTRY msg_lh;
-    PSUP_PATH_ELEMENT_ENTRY dlls_head, dll_entry;
-    PWSTR dlls_path;
-    PWCH buffer;
-    SIZE_T sz, i;
+    STATS_COUNTERS counters;
+    WCHAR buffer[WDEP_MSG_LENGTH_MEDIUM];
+    PWCH endPtr;
+    SIZE_T remaining;
     HRESULT hr;
-    PWSTR endPtr;
-    SIZE_T remaining, len;
-    WCHAR escapedName[1024];
-    PWSTR escapedPath;
-    SIZE_T pathLen, escPathLen, escPathAlloc;
 
-    if (params == NULL || !gsup.Initialized) {
+    InitializeListHead(&msg_lh);
+
+    StringCchPrintf(buffer, ARRAYSIZE(buffer),
+        L"%ws{\"uptime\":%llu, \"buckets\":%u, \"commands\":[",
+        WDEP_STATUS_OK,
+        stats_uptime(),
+        STATS_LATENCY_BUCKETS);
+
+    response_ok = mlist_add(&msg_lh, buffer, wcslen(buffer));
+
+    for (i = 0; i < ARRAYSIZE(cmds) && response_ok; i++) {
+
+        if (!stats_query(cmds[i].type, &counters))
+            continue;
+
+        hr = StringCchPrintfEx(buffer,
+            ARRAYSIZE(buffer),
+            &endPtr,
+            (size_t*)&remaining,
+            0,
+            L"%ws{\"name\":\"%ws\",\"calls\":%lld,\"totalTime\":%lld,\"maxTime\":%lld,"
+            L"\"bytesRead\":%lld,\"bytesSent\":%lld,\"allocations\":%lld,\"latency\":[",
+            (count > 0) ? JSON_COMMA : L"",
+            cmds[i].cmd,
+            counters.Calls,
+            counters.TotalTime,
+            counters.MaxTime,
+            counters.BytesRead,
+            counters.BytesSent,
+            counters.Allocations);
+
+        for (j = 0; j < STATS_LATENCY_BUCKETS && SUCCEEDED(hr); j++) {
+            hr = StringCchPrintfEx(endPtr,
+                remaining,
+                &endPtr,
+                (size_t*)&remaining,
+                0,
+                (j > 0) ? L",%lld" : L"%lld",
+                counters.Latency[j]);
+        }
+
+        if (SUCCEEDED(hr)) {
+            hr = StringCchCopyEx(endPtr, remaining, L"]}", &endPtr, (size_t*)&remaining, 0);
+        }
+
+        response_ok = SUCCEEDED(hr) && mlist_add(&msg_lh, buffer, (SIZE_T)(endPtr - buffer));
+        count++;
+    }
+
+    if (response_ok) {
+        response_ok = mlist_add(&msg_lh, L"]}\r\n", WSTRING_LEN(L"]}\r\n"));
+    }
+
+    if (!response_ok) {
+        mlist_traverse(&msg_lh, mlist_free, s, NULL);
         sendstring_plaintext_no_track(s, WDEP_STATUS_500);
         return;
     }
 
-    is_wow64 = (wcsncmp(params, L"32", 2) == 0);
+    if (!mlist_traverse(&msg_lh, mlist_send, s, NULL)) {
+        sendstring_plaintext_no_track(s, WDEP_STATUS_500);
+    }
 
-    if (is_wow64) {
-        dlls_head = &gsup.KnownDlls32Head;
-        dlls_path = gsup.KnownDlls32Path;
-        sz = (MAX_PATH * sizeof(WCHAR)) + gsup.KnownDlls32NameCbMax + gsup.KnownDlls32PathCbMax;
+    if (params && get_params_option(params, L"reset", FALSE, NULL, 0, NULL)) {
+        stats_reset();
     }
-    else {
-        dlls_head = &gsup.KnownDllsHead;
-        dlls_path = gsup.KnownDllsPath;
-        sz = (MAX_PATH * sizeof(WCHAR)) + gsup.KnownDllsNameCbMax + gsup.KnownDllsPathCbMax;
+}
+
+/*
+* cmd_query_debuginfo
+*
+* Purpose:
+*
+* Return CodeView (PDB identity), POGO and VC feature debug records for
+* every file of the list, in request order. Files are read directly,
+* no module needs to be opened. Paths that do not fit the buffer are
+* reported with empty path and status 414.
+*
+*/
+void cmd_query_debuginfo(
+    _In_ SOCKET s,
+    _In_opt_ LPCWSTR params,
+    _In_opt_ pmodule_ctx context
+)
+{
+    BOOL response_ok, token_fits;
+    LIST_ENTRY msg_lh;
+    ULONG i, token_len;
+    LPCWSTR cursor;
+    WCHAR buffer[WDEP_MSG_LENGTH_SMALL];
+
+    if (params == NULL) {
+        sendstring_plaintext_no_track(s, WDEP_STATUS_400);
+        return;
+    }
+
+    InitializeListHead(&msg_lh);
+
+    StringCchPrintf(buffer, ARRAYSIZE(buffer), L"%ws{\"entries\":[", WDEP_STATUS_OK);
+    response_ok = mlist_add(&msg_lh, buffer, wcslen(buffer));
+
+    cursor = params;
+
+    for (i = 0; response_ok; i++) {
+
+        token_len = 0;
+        token_fits = get_params_next_token(&cursor, buffer, ARRAYSIZE(buffer), &token_len);
+        if (token_len == 0)
+            break;
+
+        //
+        // Oversized path gets an error entry so the reply keeps request order.
+        //
+        if (!token_fits) {
+            StringCchPrintf(buffer, ARRAYSIZE(buffer), L"%ws{\"path\":\"\",\"status\":414}",
+                (i > 0) ? JSON_COMMA : L"");
+            response_ok = mlist_add(&msg_lh, buffer, wcslen(buffer));
+            continue;
+        }
+
+        response_ok = debuginfo_query_file(buffer, (i == 0), &msg_lh);
     }
 
-    if (sz == 0 || dlls_path == NULL) {
+    if (response_ok) {
+        response_ok = mlist_add(&msg_lh, L"]}\r\n", WSTRING_LEN(L"]}\r\n"));
+    }
+
+    if (!response_ok) {
+        mlist_traverse(&msg_lh, mlist_free, s, NULL);
         sendstring_plaintext_no_track(s, WDEP_STATUS_500);
+    }
+    else {
+        if (!mlist_traverse(&msg_lh, mlist_send, s, context)) {
+            sendstring_plaintext_no_track(s, WDEP_STATUS_500);
+        }
+    }
+}
+
+/*
+* cmd_trace
+*
+* Purpose:
+*
+* Control trace of commands handled in this session.
+* "on" starts (or restarts) trace, "off" stops it, without parameters
+* recorded events are reported and discarded.
+*
+*/
+void cmd_trace(
+    _In_ SOCKET s,
+    _In_opt_ LPCWSTR params
+)
+{
+    BOOL response_ok;
+    ULONG i;
+    LIST_ENTRY msg_lh;
+    PSTATS_TRACE trace;
+    PSTATS_TRACE_EVENT event;
+    WCHAR buffer[WDEP_MSG_LENGTH_SMALL];
+
+    if (params) {
+        if (get_params_option(params, L"on", FALSE, NULL, 0, NULL)) {
+            response_ok = stats_trace_enable(TRUE);
+        }
+        else if (get_params_option(params, L"off", FALSE, NULL, 0, NULL)) {
+            response_ok = stats_trace_enable(FALSE);
+        }
+        else {
+            sendstring_plaintext_no_track(s, WDEP_STATUS_400);
+            return;
+        }
+
+        sendstring_plaintext_no_track(s, response_ok ? WDEP_STATUS_OK : WDEP_STATUS_500);
         return;
     }
 
-    pathLen = wcslen(dlls_path);
-    escPathAlloc = (pathLen * 6) + 1;
-    escapedPath = (PWSTR)heap_calloc(NULL, escPathAlloc * sizeof(WCHAR));
-    if (escapedPath == NULL) {
-        sendstring_plaintext_no_track(s, WDEP_STATUS_500);
+    trace = stats_trace_get();
+    if (trace == NULL) {
+        sendstring_plaintext_no_track(s, WDEP_STATUS_501);
         return;
     }
 
-    if (!json_escape_string(dlls_path, escapedPath, escPathAlloc, &escPathLen)) {
-        heap_free(NULL, escapedPath);
+    InitializeListHead(&msg_lh);
+
+    StringCchPrintf(buffer, ARRAYSIZE(buffer),
+        L"%ws{\"dropped\":%u, \"events\":[",
+        WDEP_STATUS_OK,
+        trace->Dropped);
+
+    response_ok = mlist_add(&msg_lh, buffer, wcslen(buffer));
+
+    for (i = 0; i < trace->Count && response_ok; i++) {
+        event = &trace->Events[i];
+
+        response_ok = SUCCEEDED(StringCchPrintf(buffer, ARRAYSIZE(buffer),
+            L"%ws{\"name\":\"%ws\",\"ts\":%lld,\"dur\":%lld,\"bytesSent\":%lld}",
+            (i > 0) ? JSON_COMMA : L"",
+            get_command_name(event->Type),
+            event->Start,
+            event->Duration,
+            event->BytesSent)) && mlist_add(&msg_lh, buffer, wcslen(buffer));
+    }
+
+    if (response_ok) {
+        response_ok = mlist_add(&msg_lh, L"]}\r\n", WSTRING_LEN(L"]}\r\n"));
+    }
+
+    if (!response_ok) {
+        mlist_traverse(&msg_lh, mlist_free, s, NULL);
         sendstring_plaintext_no_track(s, WDEP_STATUS_500);
         return;
     }
 
-    buffer = (PWCH)heap_calloc(NULL, sz);
-    if (buffer == NULL) {
-        heap_free(NULL, escapedPath);
+    trace->Count = 0;
+    trace->Dropped = 0;
+
+    if (!mlist_traverse(&msg_lh, mlist_send, s, NULL)) {
+        sendstring_plaintext_no_track(s, WDEP_STATUS_500);
+    }
+}
+
+/*
+* cmd_query_knowndlls_list
+*
+* Purpose:
+*
+* Return KnownDlls list with its version, snapshot of this client if loaded.
+*
+*/
+void cmd_query_knowndlls_list(
+    _In_ SOCKET s,
+    _In_opt_ LPCWSTR params,
+    _In_ PSUP_KNOWNDLLS_SNAPSHOT snapshot
+)
+{
+    BOOL is_wow64, send_ok, response_ok;
+    ULONG64 version;
+    LIST_ENTRY msg_lh;
+    PSUP_KNOWNDLLS_SET dlls_set;
+    PSUP_PATH_ELEMENT_ENTRY dll_entry;
+    PWCH buffer = NULL;
+    SIZE_T sz, i;
+    HRESULT hr;
+    PWSTR endPtr;
+    SIZE_T remaining, len;
+    WCHAR escapedName[1024];
+    PWSTR escapedPath = NULL;
+    SIZE_T pathLen, escPathLen, escPathAlloc;
+
+    if (params == NULL || !gsup.Initialized) {
         sendstring_plaintext_no_track(s, WDEP_STATUS_500);
         return;
     }
 
+    is_wow64 = (wcsncmp(params, L"32", 2) == 0);
+
     InitializeListHead(&msg_lh);
     response_ok = FALSE;
 
-    hr = StringCchPrintfEx(buffer,
-        sz / sizeof(WCHAR),
-        &endPtr,
-        (size_t*)&remaining,
-        0,
-        L"%ws{\"path\":\"%ws\", \"entries\":[",
-        WDEP_STATUS_OK,
-        escapedPath);
-
-    if (SUCCEEDED(hr)) {
-        response_ok = mlist_add(&msg_lh, buffer, endPtr - buffer);
+    //
+    // Snapshot is owned by this client thread, server wide sets are shared.
+    //
+    if (snapshot->Loaded) {
+        dlls_set = is_wow64 ? &snapshot->KnownDlls32 : &snapshot->KnownDlls;
+        version = snapshot->Version;
+    }
+    else {
+        AcquireSRWLockShared(&gsup.KnownDllsLock);
+        dlls_set = is_wow64 ? &gsup.KnownDlls32 : &gsup.KnownDlls;
+        version = gsup.KnownDllsVersion;
     }
 
+    do {
+        sz = (MAX_PATH * sizeof(WCHAR)) + dlls_set->NameCbMax + dlls_set->PathCbMax;
+        if (dlls_set->Path == NULL)
+            break;
+
+        pathLen = wcslen(dlls_set->Path);
+        escPathAlloc = (pathLen * 6) + 1;
+        escapedPath = (PWSTR)heap_calloc(NULL, escPathAlloc * sizeof(WCHAR));
+        if (escapedPath == NULL)
+            break;
+
+        if (!json_escape_string(dlls_set->Path, escapedPath, escPathAlloc, &escPathLen))
+            break;
+
+        buffer = (PWCH)heap_calloc(NULL, sz);
+        if (buffer == NULL)
+            break;
+
+        hr = StringCchPrintfEx(buffer,
+            sz / sizeof(WCHAR),
+            &endPtr,
+            (size_t*)&remaining,
+            0,
+            L"%ws{\"version\":\"%016llx\", \"path\":\"%ws\", \"entries\":[",
+            WDEP_STATUS_OK,
+            version,
+            escapedPath);
+
+        if (SUCCEEDED(hr)) {
+            response_ok = mlist_add(&msg_lh, buffer, endPtr - buffer);
+        }
+
+    } while (FALSE);
+
     if (response_ok) {
         i = 0;
-        dll_entry = dlls_head->Next;
+        dll_entry = dlls_set->Head.Next;
 
         while (dll_entry && response_ok) {
 
@@ -260,6 +538,10 @@ void cmd_query_knowndlls_list(
         }
     }
 
+    if (!snapshot->Loaded) {
+        ReleaseSRWLockShared(&gsup.KnownDllsLock);
+    }
+
     if (!response_ok) {
         mlist_traverse(&msg_lh, mlist_free, s, NULL);
         sendstring_plaintext_no_track(s, WDEP_STATUS_500);
@@ -271,8 +553,119 @@ void cmd_query_knowndlls_list(
         }
     }
 
-    heap_free(NULL, buffer);
-    heap_free(NULL, escapedPath);
+    if (buffer) heap_free(NULL, buffer);
+    if (escapedPath) heap_free(NULL, escapedPath);
+}
+
+/*
+* cmd_query_knowndlls_version
+*
+* Purpose:
+*
+* Return version of KnownDlls sets, so client can reuse lists it already has.
+*
+*/
+void cmd_query_knowndlls_version(
+    _In_ SOCKET s,
+    _In_ PSUP_KNOWNDLLS_SNAPSHOT snapshot
+)
+{
+    WCHAR buffer[100];
+    ULONG64 version;
+
+    if (!gsup.Initialized) {
+        sendstring_plaintext_no_track(s, WDEP_STATUS_500);
+        return;
+    }
+
+    if (snapshot->Loaded) {
+        version = snapshot->Version;
+    }
+    else {
+        AcquireSRWLockShared(&gsup.KnownDllsLock);
+        version = gsup.KnownDllsVersion;
+        ReleaseSRWLockShared(&gsup.KnownDllsLock);
+    }
+
+    StringCchPrintf(buffer, ARRAYSIZE(buffer),
+        L"%ws{\"version\":\"%016llx\"}\r\n",
+        WDEP_STATUS_OK,
+        version);
+
+    sendstring_plaintext_no_track(s, buffer);
+}
+
+/*
+* cmd_load_knowndlls
+*
+* Purpose:
+*
+* Replace KnownDlls sets of this client with the snapshot from file.
+* Without parameters the snapshot is dropped and server wide sets are used again,
+* other clients are never affected.
+*
+*/
+void cmd_load_knowndlls(
+    _In_ SOCKET s,
+    _In_opt_ LPCWSTR params,
+    _Inout_ PSUP_KNOWNDLLS_SNAPSHOT snapshot
+)
+{
+    BOOL bResult = FALSE;
+    ULONG param_length;
+    SIZE_T sz;
+    PWCH file_name = NULL;
+    SUP_KNOWNDLLS_SET set, set32;
+
+    if (!gsup.Initialized) {
+        sendstring_plaintext_no_track(s, WDEP_STATUS_500);
+        return;
+    }
+
+    if (params == NULL) {
+        free_knowndlls_list(&snapshot->KnownDlls);
+        free_knowndlls_list(&snapshot->KnownDlls32);
+        snapshot->Version = 0;
+        snapshot->Loaded = FALSE;
+        sendstring_plaintext_no_track(s, WDEP_STATUS_OK);
+        return;
+    }
+
+    RtlSecureZeroMemory(&set, sizeof(set));
+    RtlSecureZeroMemory(&set32, sizeof(set32));
+
+    sz = (wcslen(params) + 1) * sizeof(WCHAR);
+    file_name = (PWCH)heap_calloc(NULL, sz);
+    if (file_name != NULL) {
+        param_length = 0;
+        if (get_params_option(
+            params,
+            L"file",
+            TRUE,
+            file_name,
+            (ULONG)sz,
+            &param_length))
+        {
+            bResult = load_knowndlls_snapshot(file_name, &set, &set32);
+        }
+        heap_free(NULL, file_name);
+    }
+
+    if (!bResult) {
+        free_knowndlls_list(&set);
+        free_knowndlls_list(&set32);
+        sendstring_plaintext_no_track(s, WDEP_STATUS_500);
+        return;
+    }
+
+    free_knowndlls_list(&snapshot->KnownDlls);
+    free_knowndlls_list(&snapshot->KnownDlls32);
+    snapshot->KnownDlls = set;
+    snapshot->KnownDlls32 = set32;
+    snapshot->Version = get_knowndlls_version(&set, &set32);
+    snapshot->Loaded = TRUE;
+
+    sendstring_plaintext_no_track(s, WDEP_STATUS_OK);
 }
 
 /*
@@ -281,21 +674,21 @@ void cmd_query_knowndlls_list(
 * Purpose:
 *
 * Retrieve apiset namespace information.
-* If params is provided, loads namespace from specified file temporarily for query.
-* If params is NULL, uses current gsup.ApiSetMap.
+* If params is provided, takes namespace from specified file through schema cache.
+* If params is NULL, uses session schema.
 *
 */
 void cmd_apisetnamespace_info(
     _In_ SOCKET s,
-    _In_opt_ LPCWSTR params
+    _In_opt_ LPCWSTR params,
+    _In_opt_ PAPISET_SCHEMA schema
 )
 {
-    BOOL bTempLoad = FALSE, bError = FALSE;
+    BOOL bError = FALSE;
     LPCWSTR ErrorCode = NULL;
     ULONG version = 0, count = 0, param_length;
     PAPI_SET_NAMESPACE ApiSetNamespace = NULL;
-    PVOID TempApiSetMap = NULL;
-    HMODULE hTempModule = NULL;
+    PAPISET_SCHEMA TempSchema = NULL;
     WCHAR buffer[200];
     PWCH file_name = NULL;
     SIZE_T sz;
@@ -316,7 +709,7 @@ void cmd_apisetnamespace_info(
 
     __try {
 
-        // If params provided, load ApiSet from file temporarily
+        // If params provided, take ApiSet from file temporarily
         if (params != NULL) {
             sz = (wcslen(params) + 1) * sizeof(WCHAR);
             file_name = (PWCH)heap_calloc(NULL, sz);
@@ -330,11 +723,10 @@ void cmd_apisetnamespace_info(
                     (ULONG)sz,
                     &param_length))
                 {
-                    TempApiSetMap = load_apiset_namespace(file_name, &hTempModule);
-                    if (TempApiSetMap) {
-                        bTempLoad = TRUE;
-                        ApiSetNamespace = (PAPI_SET_NAMESPACE)TempApiSetMap;
-                        ApiSet.Data = TempApiSetMap;
+                    TempSchema = apiset_schema_acquire(file_name);
+                    if (TempSchema) {
+                        ApiSetNamespace = TempSchema->Namespace;
+                        ApiSet.Data = TempSchema->Namespace;
                     }
                     else {
                         // Failed to load file
@@ -346,10 +738,15 @@ void cmd_apisetnamespace_info(
             }
         }
 
-        // Use current ApiSet if no temp load
-        if (!bTempLoad) {
-            ApiSetNamespace = (PAPI_SET_NAMESPACE)gsup.ApiSetMap;
-            ApiSet.Data = gsup.ApiSetMap;
+        // Use session ApiSet if no temp load
+        if (TempSchema == NULL) {
+            if (schema == NULL) {
+                schema = apiset_schema_acquire(NULL);
+            }
+            if (schema) {
+                ApiSetNamespace = schema->Namespace;
+                ApiSet.Data = schema->Namespace;
+            }
         }
 
         if (!ApiSetNamespace || ApiSet.Data == NULL) {
@@ -382,9 +779,9 @@ void cmd_apisetnamespace_info(
     }
     __finally {
 
-        // Unload temporary module if we loaded one
-        if (bTempLoad && hTempModule != NULL) {
-            unload_apiset_namespace(hTempModule);
+        // Release temporary schema if we took one
+        if (TempSchema != NULL) {
+            apiset_schema_release(TempSchema);
         }
 
         if (file_name != NULL) {
@@ -410,20 +807,21 @@ void cmd_apisetnamespace_info(
 *
 * Purpose:
 *
-* Change apiset namespace source.
+* Change apiset namespace source of the client session.
+* Previous session schema is released, other sessions are not affected.
 *
 */
 void cmd_set_apisetmap_src(
     _In_ SOCKET s,
-    _In_opt_ LPCWSTR params
+    _In_opt_ LPCWSTR params,
+    _Inout_ PAPISET_SCHEMA* schema
 )
 {
     BOOL bResult = FALSE;
     ULONG param_length;
     SIZE_T sz;
     PWCH file_name = NULL;
-    PVOID api_set_namespace;
-    HMODULE hModule = NULL;
+    PAPISET_SCHEMA new_schema;
 
     if (!gsup.Initialized) {
         sendstring_plaintext_no_track(s, WDEP_STATUS_500);
@@ -431,14 +829,9 @@ void cmd_set_apisetmap_src(
     }
 
     if (params == NULL) {
-        // Unload any previously loaded custom ApiSet
-        if (gsup.UseApiSetMapFile && gsup.ApiSetMapModule != NULL) {
-            unload_apiset_namespace(gsup.ApiSetMapModule);
-            gsup.ApiSetMapModule = NULL;
-        }
-
-        gsup.UseApiSetMapFile = FALSE;
-        gsup.ApiSetMap = NtCurrentPeb()->ApiSetMap;
+        // Switch back to process ApiSet
+        apiset_schema_release(*schema);
+        *schema = apiset_schema_acquire(NULL);
         sendstring_plaintext_no_track(s, WDEP_STATUS_OK);
     }
     else {
@@ -455,16 +848,11 @@ void cmd_set_apisetmap_src(
                 (ULONG)sz,
                 &param_length))
             {
-                api_set_namespace = load_apiset_namespace(file_name, &hModule);
-                if (api_set_namespace) {
-                    // Unload previous custom ApiSet if any
-                    if (gsup.UseApiSetMapFile && gsup.ApiSetMapModule != NULL) {
-                        unload_apiset_namespace(gsup.ApiSetMapModule);
-                    }
-
-                    gsup.UseApiSetMapFile = TRUE;
-                    gsup.ApiSetMap = api_set_namespace;
-                    gsup.ApiSetMapModule = hModule;
+                new_schema = apiset_schema_acquire(file_name);
+                if (new_schema) {
+                    // Release previous session ApiSet if any
+                    apiset_schema_release(*schema);
+                    *schema = new_schema;
                     bResult = TRUE;
                 }
             }
@@ -489,6 +877,7 @@ void cmd_set_apisetmap_src(
 void cmd_resolve_apiset_name(
     _In_ SOCKET s,
     _In_ LPCWSTR api_set_name,
+    _In_opt_ PAPISET_SCHEMA schema,
     _In_ pmodule_ctx context
 )
 {
@@ -496,7 +885,7 @@ void cmd_resolve_apiset_name(
     PWCH buffer;
     SIZE_T name_length = 0, sz;
 
-    resolved_name = resolve_apiset_name(api_set_name, NULL, &name_length);
+    resolved_name = resolve_apiset_name(schema, api_set_name, NULL, &name_length);
     if (resolved_name && name_length) {
 
         sz = (MAX_PATH * sizeof(WCHAR)) + name_length + sizeof(UNICODE_NULL);
@@ -518,6 +907,256 @@ void cmd_resolve_apiset_name(
     }
 }
 
+/*
+* apiset_copy_escaped
+*
+* Purpose:
+*
+* Copy counted apiset string to the buffer with JSON escaping.
+*
+*/
+_Success_(return)
+BOOL apiset_copy_escaped(
+    _In_opt_ PCUNICODE_STRING source,
+    _Out_writes_(dest_cch) LPWSTR dest,
+    _In_ SIZE_T dest_cch
+)
+{
+    WCHAR raw[MAX_PATH + 1];
+
+    if (source == NULL || source->Length == 0) {
+        dest[0] = 0;
+        return TRUE;
+    }
+
+    if (FAILED(StringCbCopyN(raw, sizeof(raw), source->Buffer, source->Length)))
+        return FALSE;
+
+    return json_escape_string(raw, dest, dest_cch, NULL);
+}
+
+/*
+* cmd_resolve_apiset_batch
+*
+* Purpose:
+*
+* Resolve list of apiset library names in a single reply.
+* Each parameter token is either "contract" or "contract:parent",
+* unresolved contracts are reported with empty path, tokens longer than
+* MAX_PATH with empty name and path.
+*
+*/
+void cmd_resolve_apiset_batch(
+    _In_ SOCKET s,
+    _In_opt_ LPCWSTR params,
+    _In_opt_ PAPISET_SCHEMA schema,
+    _In_opt_ pmodule_ctx context
+)
+{
+    BOOL response_ok, token_fits;
+    LIST_ENTRY msg_lh;
+    ULONG i, token_len;
+    PWCH parent_name;
+    LPCWSTR cursor;
+    UNICODE_STRING host_name;
+    PWSTR endPtr;
+    SIZE_T remaining;
+    WCHAR token[MAX_PATH + 1];
+    WCHAR name[MAX_PATH * 2], path[MAX_PATH * 2];
+    WCHAR buffer[WDEP_MSG_LENGTH_MEDIUM];
+
+    if (params == NULL || gsup.Initialized == FALSE) {
+        sendstring_plaintext_no_track(s, WDEP_STATUS_500);
+        return;
+    }
+
+    InitializeListHead(&msg_lh);
+
+    StringCchPrintf(buffer, ARRAYSIZE(buffer), L"%ws{\"entries\":[", WDEP_STATUS_OK);
+    response_ok = mlist_add(&msg_lh, buffer, wcslen(buffer));
+
+    cursor = params;
+
+    for (i = 0; response_ok; i++) {
+
+        token_len = 0;
+        token_fits = get_params_next_token(&cursor, token, ARRAYSIZE(token), &token_len);
+        if (token_len == 0)
+            break;
+
+        //
+        // Oversized name gets an empty entry so the reply keeps request order.
+        //
+        if (!token_fits) {
+            token[0] = 0;
+        }
+
+        parent_name = wcschr(token, L':');
+        if (parent_name) {
+            *parent_name++ = 0;
+            if (*parent_name == 0)
+                parent_name = NULL;
+        }
+
+        if (!json_escape_string(token, name, ARRAYSIZE(name), NULL)) {
+            response_ok = FALSE;
+            break;
+        }
+
+        path[0] = 0;
+        if (token[0] != 0 && resolve_apiset_host(schema, token, parent_name, &host_name)) {
+            if (!apiset_copy_escaped(&host_name, path, ARRAYSIZE(path))) {
+                path[0] = 0;
+            }
+        }
+
+        if (FAILED(StringCchPrintfEx(buffer,
+            ARRAYSIZE(buffer),
+            &endPtr,
+            (size_t*)&remaining,
+            0,
+            L"%ws{\"name\":\"%ws\",\"path\":\"%ws\"}",
+            (i > 0) ? JSON_COMMA : L"",
+            name,
+            path)))
+        {
+            response_ok = FALSE;
+            break;
+        }
+
+        response_ok = mlist_add(&msg_lh, buffer, endPtr - buffer);
+    }
+
+    if (response_ok) {
+        response_ok = mlist_add(&msg_lh, L"]}\r\n", WSTRING_LEN(L"]}\r\n"));
+    }
+
+    if (!response_ok) {
+        mlist_traverse(&msg_lh, mlist_free, s, NULL);
+        sendstring_plaintext_no_track(s, WDEP_STATUS_500);
+    }
+    else {
+        if (!mlist_traverse(&msg_lh, mlist_send, s, context)) {
+            sendstring_plaintext_no_track(s, WDEP_STATUS_500);
+        }
+    }
+}
+
+/*
+* apiset_dump_callback
+*
+* Purpose:
+*
+* Namespace enumeration callback, appends single JSON entry to the reply.
+*
+*/
+BOOL CALLBACK apiset_dump_callback(
+    _In_ PCUNICODE_STRING ContractName,
+    _In_opt_ PCUNICODE_STRING ParentName,
+    _In_ PCUNICODE_STRING HostName,
+    _In_opt_ PVOID Context
+)
+{
+    papiset_dump_ctx ctx = (papiset_dump_ctx)Context;
+    WCHAR name[MAX_PATH * 2], parent[MAX_PATH * 2], host[MAX_PATH * 2];
+    WCHAR buffer[WDEP_MSG_LENGTH_MEDIUM];
+    PWSTR endPtr;
+    SIZE_T remaining;
+
+    if (ctx == NULL)
+        return FALSE;
+
+    if (!apiset_copy_escaped(ContractName, name, ARRAYSIZE(name)) ||
+        !apiset_copy_escaped(ParentName, parent, ARRAYSIZE(parent)) ||
+        !apiset_copy_escaped(HostName, host, ARRAYSIZE(host)))
+    {
+        return FALSE;
+    }
+
+    if (FAILED(StringCchPrintfEx(buffer,
+        ARRAYSIZE(buffer),
+        &endPtr,
+        (size_t*)&remaining,
+        0,
+        L"%ws{\"name\":\"%ws\",\"parent\":\"%ws\",\"host\":\"%ws\"}",
+        (ctx->count > 0) ? JSON_COMMA : L"",
+        name,
+        parent,
+        host)))
+    {
+        return FALSE;
+    }
+
+    if (!mlist_add(ctx->msg_lh, buffer, endPtr - buffer))
+        return FALSE;
+
+    ctx->count++;
+    return TRUE;
+}
+
+/*
+* cmd_apiset_dump
+*
+* Purpose:
+*
+* Send whole session apiset namespace in a single reply.
+*
+*/
+void cmd_apiset_dump(
+    _In_ SOCKET s,
+    _In_opt_ PAPISET_SCHEMA schema
+)
+{
+    BOOL response_ok = FALSE;
+    LIST_ENTRY msg_lh;
+    PAPI_SET_NAMESPACE ApiSetNamespace;
+    WCHAR buffer[200];
+    apiset_dump_ctx ctx;
+
+    if (schema == NULL) {
+        schema = apiset_schema_acquire(NULL);
+    }
+
+    if (gsup.Initialized == FALSE || schema == NULL) {
+        sendstring_plaintext_no_track(s, WDEP_STATUS_500);
+        return;
+    }
+
+    InitializeListHead(&msg_lh);
+    ctx.msg_lh = &msg_lh;
+    ctx.count = 0;
+
+    __try {
+
+        ApiSetNamespace = schema->Namespace;
+
+        StringCchPrintf(buffer, ARRAYSIZE(buffer),
+            L"%ws{\"version\":%u, \"entries\":[",
+            WDEP_STATUS_OK,
+            ApiSetNamespace->Version);
+
+        if (mlist_add(&msg_lh, buffer, wcslen(buffer)) &&
+            ApiSetEnumerateNamespace(ApiSetNamespace, apiset_dump_callback, &ctx))
+        {
+            response_ok = mlist_add(&msg_lh, L"]}\r\n", WSTRING_LEN(L"]}\r\n"));
+        }
+
+    }
+    __except (ex_filter(GetExceptionCode(), GetExceptionInformation())) {
+        response_ok = FALSE;
+    }
+
+    if (!response_ok) {
+        mlist_traverse(&msg_lh, mlist_free, s, NULL);
+        sendstring_plaintext_no_track(s, WDEP_STATUS_500);
+    }
+    else {
+        if (!mlist_traverse(&msg_lh, mlist_send, s, NULL)) {
+            sendstring_plaintext_no_track(s, WDEP_STATUS_500);
+        }
+    }
+}
+
 /*
 * cmd_close
 *
@@ -547,22 +1186,22 @@ void cmd_close(
 }
 
 /*
-* cmd_open
+* open_module_context
 *
 * Purpose:
 *
-* Open module and allocate associated context.
+* Open module file with options from params and allocate associated context.
 *
 */
-pmodule_ctx cmd_open(
+pmodule_ctx open_module_context(
     _In_ SOCKET s,
-    _In_ LPCWSTR params
+    _In_ LPCWSTR params,
+    _In_ LPCWSTR file_name
 )
 {
     BOOL bResult = FALSE;
     ULONG param_length;
     SIZE_T sz;
-    PWCH file_name = NULL;
     pmodule_ctx context;
     WCHAR option_buffer[100];
 
@@ -573,12 +1212,6 @@ pmodule_ctx cmd_open(
             break;
         }
 
-        sz = (wcslen(params) + 1) * sizeof(WCHAR);
-        file_name = (PWCH)heap_calloc(NULL, sz);
-        if (file_name == NULL) {
-            break;
-        }
-
         context->allocation_granularity = gsup.dwAllocationGranularity;
 
         param_length = 0;
@@ -614,6 +1247,18 @@ pmodule_ctx cmd_open(
             context->custom_image_base = strtoul_w(option_buffer);
         }
 
+        //
+        // Read lazy_relocs command, relocate pages on first access.
+        //
+        param_length = 0;
+        context->lazy_relocs = get_params_option(
+            params,
+            L"lazy_relocs",
+            FALSE,
+            NULL,
+            0,
+            &param_length);
+
         //
         // Read usestats command.
         //
@@ -629,42 +1274,32 @@ pmodule_ctx cmd_open(
         //
         // pe32open take place here.
         //
-        param_length = 0;
-        if (get_params_option(
-            params,
-            L"file",
-            TRUE,
-            file_name,
-            (ULONG)sz,
-            &param_length))
-        {
-            sz = (1 + wcslen(file_name)) * sizeof(WCHAR);
-            context->filename = (PWCH)heap_calloc(NULL, sz);
-            if (context->filename) {
-                wcscpy_s(context->filename, sz / sizeof(WCHAR), file_name);
-            }
-            else {
-                break;
-            }
+        sz = (1 + wcslen(file_name)) * sizeof(WCHAR);
+        context->filename = (PWCH)heap_calloc(NULL, sz);
+        if (context->filename) {
+            wcscpy_s(context->filename, sz / sizeof(WCHAR), file_name);
+        }
+        else {
+            break;
+        }
 
-            context->directory = (PWCH)heap_calloc(NULL, sz);
-            if (context->directory) {
-                _filepath_w(file_name, context->directory);
-            }
-            else {
-                // Clean up filename if directory alloc fails
-                heap_free(NULL, context->filename);
-                context->filename = NULL;
-                break;
-            }
+        context->directory = (PWCH)heap_calloc(NULL, sz);
+        if (context->directory) {
+            _filepath_w(file_name, context->directory);
+        }
+        else {
+            // Clean up filename if directory alloc fails
+            heap_free(NULL, context->filename);
+            context->filename = NULL;
+            break;
+        }
 
-            context->module = pe32open(s, context);
-            bResult = context->module != NULL;
-            if (bResult) {
-                // Remember common fields.
-                context->dos_hdr = (PIMAGE_DOS_HEADER)context->module;
-                context->nt_file_hdr = (PIMAGE_FILE_HEADER)(context->module + sizeof(DWORD) + context->dos_hdr->e_lfanew);
-            }
+        context->module = pe32open(s, context);
+        bResult = context->module != NULL;
+        if (bResult) {
+            // Remember common fields.
+            context->dos_hdr = (PIMAGE_DOS_HEADER)context->module;
+            context->nt_file_hdr = (PIMAGE_FILE_HEADER)(context->module + sizeof(DWORD) + context->dos_hdr->e_lfanew);
         }
 
     } while (FALSE);
@@ -682,9 +1317,144 @@ pmodule_ctx cmd_open(
         }
     }
 
-    if (file_name != NULL) {
-        heap_free(NULL, file_name);
+    return context;
+}
+
+/*
+* cmd_open
+*
+* Purpose:
+*
+* Open module and allocate associated context.
+*
+*/
+pmodule_ctx cmd_open(
+    _In_ SOCKET s,
+    _In_ LPCWSTR params
+)
+{
+    ULONG param_length;
+    SIZE_T sz;
+    PWCH file_name;
+    pmodule_ctx context = NULL;
+
+    sz = (wcslen(params) + 1) * sizeof(WCHAR);
+    file_name = (PWCH)heap_calloc(NULL, sz);
+    if (file_name == NULL) {
+        return NULL;
+    }
+
+    param_length = 0;
+    if (get_params_option(
+        params,
+        L"file",
+        TRUE,
+        file_name,
+        (ULONG)sz,
+        &param_length))
+    {
+        context = open_module_context(s, params, file_name);
     }
 
+    heap_free(NULL, file_name);
+
+    return context;
+}
+
+/*
+* cmd_open_resolve
+*
+* Purpose:
+*
+* Find module file in the list of search directories and open it.
+* Directories are probed in the given order using server wide listing cache.
+* Sends resolved path and directory index first, then the same replies as open.
+*
+*/
+pmodule_ctx cmd_open_resolve(
+    _In_ SOCKET s,
+    _In_ LPCWSTR params
+)
+{
+    BOOL found = FALSE;
+    ULONG param_length, index = 0;
+    SIZE_T sz, path_cch, reply_cch;
+    PWCH name = NULL, dirs = NULL, dir, next, path = NULL, escaped = NULL, reply = NULL;
+    pmodule_ctx context = NULL;
+
+    do {
+
+        sz = (wcslen(params) + 1) * sizeof(WCHAR);
+        name = (PWCH)heap_calloc(NULL, sz);
+        dirs = (PWCH)heap_calloc(NULL, sz);
+        if (name == NULL || dirs == NULL) {
+            sendstring_plaintext_no_track(s, WDEP_STATUS_500);
+            break;
+        }
+
+        param_length = 0;
+        if (!get_params_option(params, L"name", TRUE, name, (ULONG)(sz / sizeof(WCHAR)), &param_length) ||
+            param_length == 0 ||
+            !get_params_option(params, L"dirs", TRUE, dirs, (ULONG)(sz / sizeof(WCHAR)), &param_length))
+        {
+            sendstring_plaintext_no_track(s, WDEP_STATUS_400);
+            break;
+        }
+
+        //
+        // Directories are separated by semicolon, empty entries keep their index.
+        //
+        for (dir = dirs; dir != NULL; dir = next, index++) {
+            next = wcschr(dir, L';');
+            if (next) {
+                *next++ = 0;
+            }
+            if (*dir && dircache_probe(dir, name)) {
+                found = TRUE;
+                break;
+            }
+        }
+
+        if (!found) {
+            sendstring_plaintext_no_track(s, WDEP_STATUS_404);
+            break;
+        }
+
+        path_cch = wcslen(dir) + wcslen(name) + 2;
+        path = (PWCH)heap_calloc(NULL, path_cch * sizeof(WCHAR));
+        escaped = (PWCH)heap_calloc(NULL, path_cch * 6 * sizeof(WCHAR));
+        reply_cch = path_cch * 6 + 100;
+        reply = (PWCH)heap_calloc(NULL, reply_cch * sizeof(WCHAR));
+        if (path == NULL || escaped == NULL || reply == NULL) {
+            sendstring_plaintext_no_track(s, WDEP_STATUS_500);
+            break;
+        }
+
+        StringCchPrintf(path, path_cch,
+            (dir[wcslen(dir) - 1] == L'\\') ? L"%ws%ws" : L"%ws\\%ws", dir, name);
+
+        if (!json_escape_string(path, escaped, path_cch * 6, NULL) ||
+            FAILED(StringCchPrintf(reply, reply_cch,
+                L"%ws{\"path\":\"%ws\",\"index\":%lu}\r\n",
+                WDEP_STATUS_OK,
+                escaped,
+                index)))
+        {
+            sendstring_plaintext_no_track(s, WDEP_STATUS_500);
+            break;
+        }
+
+        sendstring_plaintext_no_track(s, reply);
+
+        context = open_module_context(s, params, path);
+
+    } while (FALSE);
+
+    if (reply) heap_free(NULL, reply);
+    if (escaped) heap_free(NULL, escaped);
+    if (path) heap_free(NULL, path);
+    if (dirs) heap_free(NULL, dirs);
+    if (name) heap_free(NULL, name);
+
     return context;
 }
@@ -3,7 +3,7 @@
 *
 *  Created on: Aug 30, 2024
 *
-*  Modified on: Dec 20, 2025
+*  Modified on: Oct 18, 2026
 *
 *      Project: WinDepends.Core
 *
@@ -29,15 +29,38 @@ typedef enum {
     ce_apisetmapsrc,
     ce_apisetnsinfo,
     ce_callstats,
+    ce_apisetdump,
+    ce_apisetresolvebatch,
+    ce_knowndllsload,
+    ce_knowndllsver,
+    ce_openresolve,
+    ce_stats,
+    ce_trace,
+    ce_debuginfo,
     ce_unknown = 0xffff
 } cmd_entry_type;
 
 cmd_entry_type get_command_entry(
     _In_ LPCWSTR cmd);
 
+LPCWSTR get_command_name(
+    _In_ cmd_entry_type type);
+
 void cmd_query_knowndlls_list(
     _In_ SOCKET s,
-    _In_opt_ LPCWSTR params
+    _In_opt_ LPCWSTR params,
+    _In_ PSUP_KNOWNDLLS_SNAPSHOT snapshot
+);
+
+void cmd_query_knowndlls_version(
+    _In_ SOCKET s,
+    _In_ PSUP_KNOWNDLLS_SNAPSHOT snapshot
+);
+
+void cmd_load_knowndlls(
+    _In_ SOCKET s,
+    _In_opt_ LPCWSTR params,
+    _Inout_ PSUP_KNOWNDLLS_SNAPSHOT snapshot
 );
 
 void cmd_unknown_command(
@@ -46,20 +69,51 @@ void cmd_unknown_command(
 
 void cmd_apisetnamespace_info(
     _In_ SOCKET s,
-    _In_opt_ LPCWSTR params
+    _In_opt_ LPCWSTR params,
+    _In_opt_ PAPISET_SCHEMA schema
 );
 
 void cmd_resolve_apiset_name(
     _In_ SOCKET s,
     _In_ LPCWSTR api_set_name,
+    _In_opt_ PAPISET_SCHEMA schema,
     _In_ pmodule_ctx context
 );
 
+void cmd_resolve_apiset_batch(
+    _In_ SOCKET s,
+    _In_opt_ LPCWSTR params,
+    _In_opt_ PAPISET_SCHEMA schema,
+    _In_opt_ pmodule_ctx context
+);
+
 void cmd_set_apisetmap_src(
+    _In_ SOCKET s,
+    _In_opt_ LPCWSTR params,
+    _Inout_ PAPISET_SCHEMA* schema
+);
+
+void cmd_apiset_dump(
+    _In_ SOCKET s,
+    _In_opt_ PAPISET_SCHEMA schema
+);
+
+void cmd_stats(
+    _In_ SOCKET s,
+    _In_opt_ LPCWSTR params
+);
+
+void cmd_trace(
     _In_ SOCKET s,
     _In_opt_ LPCWSTR params
 );
 
+void cmd_query_debuginfo(
+    _In_ SOCKET s,
+    _In_opt_ LPCWSTR params,
+    _In_opt_ pmodule_ctx context
+);
+
 void cmd_callstats(
     _In_ SOCKET s,
     _In_opt_ pmodule_ctx context
@@ -70,6 +124,11 @@ pmodule_ctx cmd_open(
     _In_ LPCWSTR params
 );
 
+pmodule_ctx cmd_open_resolve(
+    _In_ SOCKET s,
+    _In_ LPCWSTR params
+);
+
 void cmd_close(
     _In_ pmodule_ctx module
 );
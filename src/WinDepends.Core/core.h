@@ -3,7 +3,7 @@
 *
 *  Created on: Jul 17, 2024
 *
-*  Modified on: Feb 11, 2026
+*  Modified on: Oct 18, 2026
 *
 *      Project: WinDepends.Core
 *
@@ -64,6 +64,10 @@ typedef struct {
     wchar_t* filename;
     wchar_t* directory;
     LARGE_INTEGER file_size;
+
+    // In-memory file image, read instead of filename when set (fuzzing).
+    const unsigned char* image_buffer;
+    SIZE_T image_buffer_size;
   
     PIMAGE_DOS_HEADER dos_hdr;
     PIMAGE_FILE_HEADER nt_file_hdr;
@@ -72,6 +76,7 @@ typedef struct {
     BOOL image_fixed;
     BOOL image_dotnet;
     BOOL process_relocs;
+    BOOL lazy_relocs;
     BOOL enable_custom_image_base;
     BOOL enable_call_stats;
 
@@ -86,8 +91,13 @@ typedef struct {
 } module_ctx, * pmodule_ctx;
 
 #include "pe32plus.h"
+#include "reloc.h"
+#include "apisetcache.h"
+#include "dircache.h"
+#include "debuginfo.h"
 #include "util.h"
 #include "cmd.h"
+#include "stats.h"
 #include "mlist.h"
 
 #pragma comment(lib, "ws2_32.lib")
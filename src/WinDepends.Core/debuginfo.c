@@ -0,0 +1,478 @@
+/*
+*  File: debuginfo.c
+*
+*  Created on: Oct 18, 2026
+*
+*  Modified on: Oct 18, 2026
+*
+*      Project: WinDepends.Core
+*
+*      Author: WinDepends dev team
+*/
+
+#include "core.h"
+
+/*
+* debuginfo_append
+*
+* Purpose:
+*
+* Format text and append it to the reply list.
+*
+*/
+static BOOL debuginfo_append(
+    _In_ PLIST_ENTRY msg_lh,
+    _In_ _Printf_format_string_ LPCWSTR format,
+    ...
+)
+{
+    va_list args;
+    HRESULT hr;
+    PWSTR endPtr;
+    SIZE_T remaining;
+    WCHAR buffer[WDEP_MSG_LENGTH_BIG];
+
+    va_start(args, format);
+    hr = StringCchVPrintfEx(buffer, ARRAYSIZE(buffer), &endPtr, (size_t*)&remaining, 0, format, args);
+    va_end(args);
+
+    if (FAILED(hr))
+        return FALSE;
+
+    return mlist_add(msg_lh, buffer, endPtr - buffer);
+}
+
+/*
+* debuginfo_read
+*
+* Purpose:
+*
+* Read exactly size bytes at the given file offset.
+*
+*/
+static BOOL debuginfo_read(
+    _In_ HANDLE hf,
+    _In_ DWORD offset,
+    _Out_writes_bytes_(size) LPVOID buffer,
+    _In_ DWORD size
+)
+{
+    OVERLAPPED ovl;
+    DWORD iobytes = 0;
+
+    RtlSecureZeroMemory(&ovl, sizeof(ovl));
+    ovl.Offset = offset;
+
+    return ReadFile(hf, buffer, size, &iobytes, &ovl) && (iobytes == size);
+}
+
+/*
+* debuginfo_rva_to_offset
+*
+* Purpose:
+*
+* Convert RVA to file offset using section table, 0 if RVA has no file data.
+*
+*/
+static DWORD debuginfo_rva_to_offset(
+    _In_ PIMAGE_SECTION_HEADER sections,
+    _In_ WORD section_count,
+    _In_ DWORD size_of_headers,
+    _In_ DWORD rva
+)
+{
+    WORD c;
+    DWORD delta;
+
+    if (rva < size_of_headers)
+        return rva;
+
+    for (c = 0; c < section_count; c++) {
+        if (rva < sections[c].VirtualAddress)
+            continue;
+
+        delta = rva - sections[c].VirtualAddress;
+        if (delta < max(sections[c].Misc.VirtualSize, sections[c].SizeOfRawData)) {
+            return (delta < sections[c].SizeOfRawData) ? sections[c].PointerToRawData + delta : 0;
+        }
+    }
+
+    return 0;
+}
+
+/*
+* debuginfo_read_data
+*
+* Purpose:
+*
+* Read raw data of debug directory entry, result is zero terminated.
+*
+*/
+static PBYTE debuginfo_read_data(
+    _In_ HANDLE hf,
+    _In_ ULONG64 file_size,
+    _In_ PIMAGE_DEBUG_DIRECTORY entry,
+    _In_ PIMAGE_SECTION_HEADER sections,
+    _In_ WORD section_count,
+    _In_ DWORD size_of_headers
+)
+{
+    PBYTE data;
+    DWORD offset = entry->PointerToRawData;
+
+    if (entry->SizeOfData == 0 || entry->SizeOfData > DEBUGINFO_MAX_DATA_SIZE)
+        return NULL;
+
+    if (offset == 0) {
+        offset = debuginfo_rva_to_offset(sections, section_count, size_of_headers, entry->AddressOfRawData);
+    }
+
+    if (offset == 0 || (ULONG64)offset + entry->SizeOfData > file_size)
+        return NULL;
+
+    data = (PBYTE)heap_calloc(NULL, (SIZE_T)entry->SizeOfData + sizeof(WCHAR));
+    if (data == NULL)
+        return NULL;
+
+    if (!debuginfo_read(hf, offset, data, entry->SizeOfData)) {
+        heap_free(NULL, data);
+        return NULL;
+    }
+
+    return data;
+}
+
+/*
+* debuginfo_add_codeview
+*
+* Purpose:
+*
+* Append RSDS or NB10 record to the "codeView" array, other formats are skipped.
+*
+*/
+static BOOL debuginfo_add_codeview(
+    _In_ PLIST_ENTRY msg_lh,
+    _In_reads_bytes_(size) PBYTE data,
+    _In_ DWORD size,
+    _Inout_ PULONG count
+)
+{
+    PCV_INFO_PDB70 pdb70 = (PCV_INFO_PDB70)data;
+    PCV_INFO_PDB20 pdb20 = (PCV_INFO_PDB20)data;
+    const char* pdb_name;
+    DWORD signature = 0, age;
+    WCHAR guid[40], name[MAX_PATH * 2], escaped[MAX_PATH * 4];
+    LPCWSTR format;
+
+    if (size < sizeof(DWORD))
+        return TRUE;
+
+    guid[0] = 0;
+
+    switch (pdb70->CvSignature) {
+    case CV_SIGNATURE_RSDS:
+        if (size < FIELD_OFFSET(CV_INFO_PDB70, PdbFileName))
+            return TRUE;
+
+        StringCchPrintf(guid, ARRAYSIZE(guid),
+            L"%08X-%04X-%04X-%02X%02X-%02X%02X%02X%02X%02X%02X",
+            pdb70->Signature.Data1, pdb70->Signature.Data2, pdb70->Signature.Data3,
+            pdb70->Signature.Data4[0], pdb70->Signature.Data4[1],
+            pdb70->Signature.Data4[2], pdb70->Signature.Data4[3],
+            pdb70->Signature.Data4[4], pdb70->Signature.Data4[5],
+            pdb70->Signature.Data4[6], pdb70->Signature.Data4[7]);
+
+        format = L"RSDS";
+        age = pdb70->Age;
+        pdb_name = (const char*)pdb70->PdbFileName;
+        break;
+
+    case CV_SIGNATURE_NB10:
+        if (size < FIELD_OFFSET(CV_INFO_PDB20, PdbFileName))
+            return TRUE;
+
+        format = L"NB10";
+        signature = pdb20->Signature;
+        age = pdb20->Age;
+        pdb_name = (const char*)pdb20->PdbFileName;
+        break;
+
+    default:
+        return TRUE;
+    }
+
+    // Data buffer is zero terminated by debuginfo_read_data, PDB path is UTF-8.
+    if (MultiByteToWideChar(CP_UTF8, 0, pdb_name, -1, name, ARRAYSIZE(name)) == 0)
+        name[0] = 0;
+
+    if (!json_escape_string(name, escaped, ARRAYSIZE(escaped), NULL))
+        escaped[0] = 0;
+
+    if (!debuginfo_append(msg_lh,
+        L"%ws{\"format\":\"%ws\",\"guid\":\"%ws\",\"signature\":%u,\"age\":%u,\"pdb\":\"%ws\"}",
+        (*count > 0) ? JSON_COMMA : L"",
+        format,
+        guid,
+        signature,
+        age,
+        escaped))
+    {
+        return FALSE;
+    }
+
+    *count += 1;
+    return TRUE;
+}
+
+/*
+* debuginfo_add_pogo
+*
+* Purpose:
+*
+* Append POGO (link time code generation) section contributions.
+* Record is signature followed by {rva, size, zero terminated name}
+* entries aligned on 4 bytes.
+*
+*/
+static BOOL debuginfo_add_pogo(
+    _In_ PLIST_ENTRY msg_lh,
+    _In_reads_bytes_(size) PBYTE data,
+    _In_ DWORD size
+)
+{
+    DWORD offset, name_length, count = 0;
+    PDWORD record;
+    const char* name_ptr;
+    WCHAR name[MAX_PATH], escaped[MAX_PATH * 2];
+
+    if (size < sizeof(DWORD))
+        return TRUE;
+
+    if (!debuginfo_append(msg_lh, L",\"pogo\":{\"signature\":%u,\"entries\":[", *(PDWORD)data))
+        return FALSE;
+
+    offset = sizeof(DWORD);
+    while (offset + 2 * sizeof(DWORD) < size && count < DEBUGINFO_MAX_POGO_ENTRIES) {
+
+        record = (PDWORD)(data + offset);
+        name_ptr = (const char*)(data + offset + 2 * sizeof(DWORD));
+        name_length = (DWORD)strnlen(name_ptr, size - offset - 2 * sizeof(DWORD));
+        if (offset + 2 * sizeof(DWORD) + name_length >= size)
+            break;
+
+        if (ansi_to_wide_copy(name_ptr, name, ARRAYSIZE(name)) == 0 ||
+            !json_escape_string(name, escaped, ARRAYSIZE(escaped), NULL))
+        {
+            escaped[0] = 0;
+        }
+
+        if (!debuginfo_append(msg_lh, L"%ws{\"rva\":%u,\"size\":%u,\"name\":\"%ws\"}",
+            (count > 0) ? JSON_COMMA : L"",
+            record[0],
+            record[1],
+            escaped))
+        {
+            return FALSE;
+        }
+
+        count++;
+        offset = (offset + 2 * sizeof(DWORD) + name_length + 1 + 3) & ~3UL;
+    }
+
+    return mlist_add(msg_lh, L"]}", WSTRING_LEN(L"]}"));
+}
+
+/*
+* debuginfo_query_file
+*
+* Purpose:
+*
+* Append JSON object with CodeView, POGO and VC feature records of the file.
+* Only headers and debug data are read, image is not loaded. File errors are
+* reported in "status", FALSE is returned only if reply cannot be built.
+*
+*/
+BOOL debuginfo_query_file(
+    _In_ LPCWSTR file_name,
+    _In_ BOOL first_entry,
+    _In_ PLIST_ENTRY msg_lh
+)
+{
+    HANDLE hf;
+    LARGE_INTEGER file_size;
+    PBYTE headers = NULL, data;
+    PIMAGE_DOS_HEADER dos_hdr;
+    PIMAGE_FILE_HEADER file_hdr;
+    PIMAGE_SECTION_HEADER sections;
+    PIMAGE_DEBUG_DIRECTORY dbg = NULL;
+    PVC_FEATURE_INFO vc_feature;
+    DWORD headers_size, needed, nt_offset, dir_base = 0, dir_size = 0, dir_offset;
+    DWORD size_of_image = 0, size_of_headers = 0, entry_count, i;
+    ULONG cv_count = 0, status = 404;
+    BOOL response_ok = TRUE, pogo_found = FALSE, vc_feature_found = FALSE;
+    WCHAR escaped[WDEP_MSG_LENGTH_SMALL * 2];
+
+    define_3264_union(IMAGE_OPTIONAL_HEADER, opt_file_hdr);
+
+    if (!json_escape_string(file_name, escaped, ARRAYSIZE(escaped), NULL))
+        escaped[0] = 0;
+
+    if (!debuginfo_append(msg_lh, L"%ws{\"path\":\"%ws\"", first_entry ? L"" : JSON_COMMA, escaped))
+        return FALSE;
+
+    hf = CreateFile(file_name, GENERIC_READ | SYNCHRONIZE, FILE_SHARE_READ, NULL, OPEN_EXISTING, 0, NULL);
+    if (hf == INVALID_HANDLE_VALUE) {
+        return debuginfo_append(msg_lh, L",\"status\":%u}", status);
+    }
+
+    __try {
+
+        status = 415;
+
+        if (!GetFileSizeEx(hf, &file_size) || file_size.QuadPart < (LONGLONG)sizeof(IMAGE_DOS_HEADER))
+            __leave;
+
+        headers_size = (DWORD)min(file_size.QuadPart, DEBUGINFO_HEADERS_SIZE);
+        headers = (PBYTE)heap_calloc(NULL, DEBUGINFO_MAX_HEADERS_SIZE);
+        if (headers == NULL || !debuginfo_read(hf, 0, headers, headers_size))
+            __leave;
+
+        dos_hdr = (PIMAGE_DOS_HEADER)headers;
+        if (dos_hdr->e_magic != IMAGE_DOS_SIGNATURE ||
+            (DWORD)dos_hdr->e_lfanew > DEBUGINFO_MAX_HEADERS_SIZE - sizeof(IMAGE_NT_HEADERS64))
+        {
+            __leave;
+        }
+
+        // Read rest of headers if section table does not fit in the first page.
+        nt_offset = (DWORD)dos_hdr->e_lfanew;
+        needed = nt_offset + sizeof(DWORD) + sizeof(IMAGE_FILE_HEADER);
+        if (needed > headers_size) {
+            headers_size = (DWORD)min(file_size.QuadPart, DEBUGINFO_MAX_HEADERS_SIZE);
+            if (needed > headers_size || !debuginfo_read(hf, 0, headers, headers_size))
+                __leave;
+        }
+
+        if (*(PDWORD)(headers + nt_offset) != IMAGE_NT_SIGNATURE)
+            __leave;
+
+        file_hdr = (PIMAGE_FILE_HEADER)(headers + nt_offset + sizeof(DWORD));
+        needed += file_hdr->SizeOfOptionalHeader + file_hdr->NumberOfSections * sizeof(IMAGE_SECTION_HEADER);
+        if (needed > DEBUGINFO_MAX_HEADERS_SIZE)
+            __leave;
+
+        if (needed > headers_size) {
+            headers_size = (DWORD)min(file_size.QuadPart, DEBUGINFO_MAX_HEADERS_SIZE);
+            if (needed > headers_size || !debuginfo_read(hf, 0, headers, headers_size))
+                __leave;
+        }
+
+        opt_file_hdr.uptr = (LPVOID)(file_hdr + 1);
+        sections = (PIMAGE_SECTION_HEADER)((PBYTE)opt_file_hdr.uptr + file_hdr->SizeOfOptionalHeader);
+
+        switch (opt_file_hdr.opt_file_hdr32->Magic) {
+        case IMAGE_NT_OPTIONAL_HDR32_MAGIC:
+            if (file_hdr->SizeOfOptionalHeader < sizeof(IMAGE_OPTIONAL_HEADER32))
+                __leave;
+            size_of_image = opt_file_hdr.opt_file_hdr32->SizeOfImage;
+            size_of_headers = opt_file_hdr.opt_file_hdr32->SizeOfHeaders;
+            get_pe_dirbase_size(opt_file_hdr.opt_file_hdr32, IMAGE_DIRECTORY_ENTRY_DEBUG, dir_base, dir_size);
+            break;
+        case IMAGE_NT_OPTIONAL_HDR64_MAGIC:
+            if (file_hdr->SizeOfOptionalHeader < sizeof(IMAGE_OPTIONAL_HEADER64))
+                __leave;
+            size_of_image = opt_file_hdr.opt_file_hdr64->SizeOfImage;
+            size_of_headers = opt_file_hdr.opt_file_hdr64->SizeOfHeaders;
+            get_pe_dirbase_size(opt_file_hdr.opt_file_hdr64, IMAGE_DIRECTORY_ENTRY_DEBUG, dir_base, dir_size);
+            break;
+        default:
+            __leave;
+        }
+
+        status = 200;
+
+        response_ok = debuginfo_append(msg_lh,
+            L",\"status\":%u,\"machine\":%u,\"timeDateStamp\":%u,\"sizeOfImage\":%u,\"codeView\":[",
+            status,
+            file_hdr->Machine,
+            file_hdr->TimeDateStamp,
+            size_of_image);
+
+        entry_count = min(dir_size / sizeof(IMAGE_DEBUG_DIRECTORY), DEBUGINFO_MAX_ENTRIES);
+        dir_offset = (dir_base && entry_count) ?
+            debuginfo_rva_to_offset(sections, file_hdr->NumberOfSections, size_of_headers, dir_base) : 0;
+
+        if (dir_offset && (ULONG64)dir_offset + entry_count * sizeof(IMAGE_DEBUG_DIRECTORY) <= (ULONG64)file_size.QuadPart) {
+            dbg = (PIMAGE_DEBUG_DIRECTORY)heap_calloc(NULL, entry_count * sizeof(IMAGE_DEBUG_DIRECTORY));
+            if (dbg && !debuginfo_read(hf, dir_offset, dbg, entry_count * sizeof(IMAGE_DEBUG_DIRECTORY))) {
+                heap_free(NULL, dbg);
+                dbg = NULL;
+            }
+        }
+
+        if (dbg == NULL)
+            entry_count = 0;
+
+        for (i = 0; response_ok && i < entry_count; i++) {
+            if (dbg[i].Type != IMAGE_DEBUG_TYPE_CODEVIEW)
+                continue;
+
+            data = debuginfo_read_data(hf, file_size.QuadPart, &dbg[i], sections, file_hdr->NumberOfSections, size_of_headers);
+            if (data) {
+                response_ok = debuginfo_add_codeview(msg_lh, data, dbg[i].SizeOfData, &cv_count);
+                heap_free(NULL, data);
+            }
+        }
+
+        if (response_ok)
+            response_ok = mlist_add(msg_lh, JSON_ARRAY_END, JSON_ARRAY_END_LEN);
+
+        // Only first POGO and VC feature records are meaningful.
+        for (i = 0; response_ok && i < entry_count; i++) {
+
+            if ((dbg[i].Type == IMAGE_DEBUG_TYPE_POGO && !pogo_found) ||
+                (dbg[i].Type == IMAGE_DEBUG_TYPE_VC_FEATURE && !vc_feature_found))
+            {
+                data = debuginfo_read_data(hf, file_size.QuadPart, &dbg[i], sections, file_hdr->NumberOfSections, size_of_headers);
+                if (data == NULL)
+                    continue;
+
+                if (dbg[i].Type == IMAGE_DEBUG_TYPE_POGO) {
+                    pogo_found = TRUE;
+                    response_ok = debuginfo_add_pogo(msg_lh, data, dbg[i].SizeOfData);
+                }
+                else if (dbg[i].SizeOfData >= sizeof(VC_FEATURE_INFO)) {
+                    vc_feature_found = TRUE;
+                    vc_feature = (PVC_FEATURE_INFO)data;
+                    response_ok = debuginfo_append(msg_lh,
+                        L",\"vcFeature\":{\"preVC11\":%u,\"cCpp\":%u,\"gs\":%u,\"sdl\":%u,\"guardN\":%u}",
+                        vc_feature->PreVC11,
+                        vc_feature->CCpp,
+                        vc_feature->Gs,
+                        vc_feature->Sdl,
+                        vc_feature->GuardN);
+                }
+
+                heap_free(NULL, data);
+            }
+        }
+
+        if (response_ok)
+            response_ok = mlist_add(msg_lh, L"}", WSTRING_LEN(L"}"));
+
+    }
+    __finally {
+        if (status != 200) {
+            response_ok = debuginfo_append(msg_lh, L",\"status\":%u}", status);
+        }
+        if (dbg) {
+            heap_free(NULL, dbg);
+        }
+        if (headers) {
+            heap_free(NULL, headers);
+        }
+        CloseHandle(hf);
+    }
+
+    return response_ok;
+}
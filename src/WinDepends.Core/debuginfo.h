@@ -0,0 +1,59 @@
+/*
+*  File: debuginfo.h
+*
+*  Created on: Oct 18, 2026
+*
+*  Modified on: Oct 18, 2026
+*
+*      Project: WinDepends.Core
+*
+*      Author: WinDepends dev team
+*/
+
+#pragma once
+
+#ifndef _DEBUGINFO_H_
+#define _DEBUGINFO_H_
+
+//
+// Debug directory records read straight from the file, without loading the image.
+//
+#define DEBUGINFO_HEADERS_SIZE      0x1000
+#define DEBUGINFO_MAX_HEADERS_SIZE  0x10000
+#define DEBUGINFO_MAX_ENTRIES       64
+#define DEBUGINFO_MAX_DATA_SIZE     0x100000
+#define DEBUGINFO_MAX_POGO_ENTRIES  4096
+
+#define CV_SIGNATURE_RSDS   0x53445352  // "RSDS"
+#define CV_SIGNATURE_NB10   0x3031424E  // "NB10"
+
+typedef struct _CV_INFO_PDB70 {
+    DWORD CvSignature;
+    GUID Signature;
+    DWORD Age;
+    BYTE PdbFileName[1];
+} CV_INFO_PDB70, * PCV_INFO_PDB70;
+
+typedef struct _CV_INFO_PDB20 {
+    DWORD CvSignature;
+    DWORD Offset;
+    DWORD Signature;
+    DWORD Age;
+    BYTE PdbFileName[1];
+} CV_INFO_PDB20, * PCV_INFO_PDB20;
+
+typedef struct _VC_FEATURE_INFO {
+    DWORD PreVC11;
+    DWORD CCpp;
+    DWORD Gs;
+    DWORD Sdl;
+    DWORD GuardN;
+} VC_FEATURE_INFO, * PVC_FEATURE_INFO;
+
+BOOL debuginfo_query_file(
+    _In_ LPCWSTR file_name,
+    _In_ BOOL first_entry,
+    _In_ PLIST_ENTRY msg_lh
+);
+
+#endif /* _DEBUGINFO_H_ */
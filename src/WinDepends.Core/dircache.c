@@ -0,0 +1,436 @@
+/*
+*  File: dircache.c
+*
+*  Created on: Oct 18, 2026
+*
+*  Modified on: Oct 18, 2026
+*
+*      Project: WinDepends.Core
+*
+*      Author: WinDepends dev team
+*/
+
+#include "core.h"
+
+//
+// Most recently used directory first.
+//
+static SRWLOCK g_dircache_lock = SRWLOCK_INIT;
+static PDIRCACHE_ENTRY g_dircache_list = NULL;
+
+/*
+* dircache_entry_free
+*
+* Purpose:
+*
+* Release directory listing memory.
+*
+*/
+VOID dircache_entry_free(
+    _In_ PDIRCACHE_ENTRY entry
+)
+{
+    if (entry->Names) {
+        heap_free(NULL, entry->Names);
+    }
+    if (entry->NameBuffer) {
+        heap_free(NULL, entry->NameBuffer);
+    }
+    if (entry->Directory) {
+        heap_free(NULL, entry->Directory);
+    }
+    heap_free(NULL, entry);
+}
+
+/*
+* dircache_lookup
+*
+* Purpose:
+*
+* Find cached listing by directory name, cache lock must be held.
+*
+*/
+PDIRCACHE_ENTRY dircache_lookup(
+    _In_ LPCWSTR directory
+)
+{
+    PDIRCACHE_ENTRY entry;
+
+    for (entry = g_dircache_list; entry != NULL; entry = entry->Next) {
+        if (CompareStringOrdinal(entry->Directory, -1, directory, -1, TRUE) == CSTR_EQUAL) {
+            return entry;
+        }
+    }
+
+    return NULL;
+}
+
+/*
+* dircache_search
+*
+* Purpose:
+*
+* Binary search file name in the sorted listing.
+*
+*/
+BOOL dircache_search(
+    _In_ PDIRCACHE_ENTRY entry,
+    _In_ LPCWSTR file_name
+)
+{
+    LONG left = 0, right = (LONG)entry->NameCount - 1, mid;
+    int cmp;
+
+    while (left <= right) {
+        mid = left + (right - left) / 2;
+        cmp = CompareStringOrdinal(entry->Names[mid], -1, file_name, -1, TRUE);
+        if (cmp == CSTR_EQUAL)
+            return TRUE;
+        if (cmp == CSTR_LESS_THAN)
+            left = mid + 1;
+        else
+            right = mid - 1;
+    }
+
+    return FALSE;
+}
+
+/*
+* dircache_compare_names
+*
+* Purpose:
+*
+* qsort callback, case insensitive ordinal order.
+*
+*/
+int __cdecl dircache_compare_names(
+    _In_ const void* first,
+    _In_ const void* second
+)
+{
+    return CompareStringOrdinal(*(PWCH*)first, -1, *(PWCH*)second, -1, TRUE) - CSTR_EQUAL;
+}
+
+/*
+* dircache_grow
+*
+* Purpose:
+*
+* Reallocate buffer to the new size, old buffer is released.
+*
+*/
+PVOID dircache_grow(
+    _In_opt_ PVOID buffer,
+    _In_ SIZE_T used_size,
+    _In_ SIZE_T new_size
+)
+{
+    PVOID new_buffer;
+
+    new_buffer = heap_calloc(NULL, new_size);
+    if (new_buffer && buffer) {
+        RtlCopyMemory(new_buffer, buffer, used_size);
+    }
+
+    if (buffer) {
+        heap_free(NULL, buffer);
+    }
+
+    return new_buffer;
+}
+
+/*
+* dircache_build_listing
+*
+* Purpose:
+*
+* Enumerate directory files into a new sorted listing.
+* Directories with more than DIRCACHE_MAX_NAMES files are marked as not listed.
+*
+*/
+PDIRCACHE_ENTRY dircache_build_listing(
+    _In_ LPCWSTR directory,
+    _In_ PFILETIME last_write_time
+)
+{
+    BOOL success = FALSE, truncated = FALSE;
+    HANDLE find_handle;
+    WIN32_FIND_DATA fd;
+    WCHAR search_mask[MAX_PATH * 2];
+    SIZE_T cch, buffer_cch = 0, buffer_used = 0;
+    ULONG i, count = 0, capacity = 0;
+    ULONG_PTR* offsets = NULL;
+    PWCH buffer = NULL;
+    PDIRCACHE_ENTRY entry;
+
+    cch = wcslen(directory);
+    if (cch == 0) {
+        return NULL;
+    }
+
+    if (FAILED(StringCchPrintf(search_mask, ARRAYSIZE(search_mask),
+        (directory[cch - 1] == L'\\') ? L"%s*" : L"%s\\*", directory)))
+    {
+        return NULL;
+    }
+
+    entry = (PDIRCACHE_ENTRY)heap_calloc(NULL, sizeof(DIRCACHE_ENTRY));
+    if (entry == NULL) {
+        return NULL;
+    }
+
+    entry->Directory = (PWCH)heap_calloc(NULL, (cch + 1) * sizeof(WCHAR));
+    if (entry->Directory == NULL) {
+        heap_free(NULL, entry);
+        return NULL;
+    }
+
+    wcscpy_s(entry->Directory, cch + 1, directory);
+    entry->LastWriteTime = *last_write_time;
+
+    find_handle = FindFirstFileEx(search_mask,
+        FindExInfoBasic,
+        &fd,
+        FindExSearchNameMatch,
+        NULL,
+        FIND_FIRST_EX_LARGE_FETCH);
+
+    if (find_handle == INVALID_HANDLE_VALUE) {
+        dircache_entry_free(entry);
+        return NULL;
+    }
+
+    do {
+
+        if (fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+            continue;
+
+        if (count >= DIRCACHE_MAX_NAMES) {
+            truncated = TRUE;
+            break;
+        }
+
+        if (count == capacity) {
+            capacity = (capacity == 0) ? 256 : capacity * 2;
+            offsets = (ULONG_PTR*)dircache_grow(offsets,
+                count * sizeof(ULONG_PTR),
+                capacity * sizeof(ULONG_PTR));
+            if (offsets == NULL) {
+                truncated = TRUE;
+                break;
+            }
+        }
+
+        cch = wcslen(fd.cFileName) + 1;
+        if (buffer_used + cch > buffer_cch) {
+            buffer_cch = (buffer_cch == 0) ? 8192 : buffer_cch * 2;
+            if (buffer_used + cch > buffer_cch)
+                buffer_cch = buffer_used + cch;
+            buffer = (PWCH)dircache_grow(buffer,
+                buffer_used * sizeof(WCHAR),
+                buffer_cch * sizeof(WCHAR));
+            if (buffer == NULL) {
+                truncated = TRUE;
+                break;
+            }
+        }
+
+        RtlCopyMemory(&buffer[buffer_used], fd.cFileName, cch * sizeof(WCHAR));
+        offsets[count++] = buffer_used;
+        buffer_used += cch;
+
+    } while (FindNextFile(find_handle, &fd));
+
+    success = (!truncated && GetLastError() == ERROR_NO_MORE_FILES);
+    FindClose(find_handle);
+
+    if (success && offsets && buffer) {
+
+        //
+        // Buffer does not move anymore, turn offsets into name pointers.
+        //
+        for (i = 0; i < count; i++) {
+            offsets[i] = (ULONG_PTR)&buffer[offsets[i]];
+        }
+
+        qsort(offsets, count, sizeof(PWCH), dircache_compare_names);
+
+        entry->Names = (PWCH*)offsets;
+        entry->NameBuffer = buffer;
+        entry->NameCount = count;
+        entry->Listed = TRUE;
+    }
+    else {
+
+        if (offsets) heap_free(NULL, offsets);
+        if (buffer) heap_free(NULL, buffer);
+
+        //
+        // Empty directory is a valid listing.
+        //
+        entry->Listed = (success && count == 0);
+    }
+
+    return entry;
+}
+
+/*
+* dircache_insert
+*
+* Purpose:
+*
+* Put listing to the head of cache replacing previous listing of the same directory.
+*
+*/
+VOID dircache_insert(
+    _In_ PDIRCACHE_ENTRY new_entry
+)
+{
+    ULONG count = 0;
+    PDIRCACHE_ENTRY* link;
+    PDIRCACHE_ENTRY entry, free_list = NULL;
+
+    AcquireSRWLockExclusive(&g_dircache_lock);
+
+    for (link = &g_dircache_list; *link != NULL; ) {
+        entry = *link;
+        if (CompareStringOrdinal(entry->Directory, -1, new_entry->Directory, -1, TRUE) == CSTR_EQUAL ||
+            count >= DIRCACHE_MAX_DIRECTORIES - 1)
+        {
+            *link = entry->Next;
+            entry->Next = free_list;
+            free_list = entry;
+            continue;
+        }
+        count++;
+        link = &entry->Next;
+    }
+
+    new_entry->Next = g_dircache_list;
+    g_dircache_list = new_entry;
+
+    ReleaseSRWLockExclusive(&g_dircache_lock);
+
+    while (free_list) {
+        entry = free_list;
+        free_list = entry->Next;
+        dircache_entry_free(entry);
+    }
+}
+
+/*
+* dircache_probe_file
+*
+* Purpose:
+*
+* Check file existence directly on the file system.
+*
+*/
+BOOL dircache_probe_file(
+    _In_ LPCWSTR directory,
+    _In_ LPCWSTR file_name
+)
+{
+    DWORD attributes;
+    SIZE_T cch;
+    WCHAR path[MAX_PATH * 2];
+
+    cch = wcslen(directory);
+    if (FAILED(StringCchPrintf(path, ARRAYSIZE(path),
+        (directory[cch - 1] == L'\\') ? L"%s%s" : L"%s\\%s", directory, file_name)))
+    {
+        return FALSE;
+    }
+
+    attributes = GetFileAttributes(path);
+    return (attributes != INVALID_FILE_ATTRIBUTES && !(attributes & FILE_ATTRIBUTE_DIRECTORY));
+}
+
+/*
+* dircache_probe
+*
+* Purpose:
+*
+* Check whether file exists in the given directory.
+* Plain file names are answered from cached listing, everything else
+* and directories that cannot be listed go to the file system.
+*
+*/
+BOOL dircache_probe(
+    _In_ LPCWSTR directory,
+    _In_ LPCWSTR file_name
+)
+{
+    BOOL found = FALSE, answered = FALSE, unlisted = FALSE;
+    ULONGLONG tick;
+    PDIRCACHE_ENTRY entry;
+    WIN32_FILE_ATTRIBUTE_DATA fad;
+
+    if (*directory == 0 || *file_name == 0) {
+        return FALSE;
+    }
+
+    if (wcspbrk(file_name, L"\\/:*?\"<>|") == NULL) {
+
+        tick = GetTickCount64();
+
+        AcquireSRWLockShared(&g_dircache_lock);
+        entry = dircache_lookup(directory);
+        if (entry && (tick - entry->CheckTick) < DIRCACHE_REVALIDATE_MS) {
+            if (entry->Listed)
+                found = dircache_search(entry, file_name);
+            else
+                unlisted = TRUE;
+            answered = TRUE;
+        }
+        ReleaseSRWLockShared(&g_dircache_lock);
+
+        if (answered) {
+            return unlisted ? dircache_probe_file(directory, file_name) : found;
+        }
+
+        if (!GetFileAttributesEx(directory, GetFileExInfoStandard, &fad) ||
+            !(fad.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY))
+        {
+            return FALSE;
+        }
+
+        //
+        // Directory was not modified since listing, only refresh check time.
+        //
+        AcquireSRWLockExclusive(&g_dircache_lock);
+        entry = dircache_lookup(directory);
+        if (entry && CompareFileTime(&entry->LastWriteTime, &fad.ftLastWriteTime) == 0) {
+            entry->CheckTick = tick;
+            if (entry->Listed)
+                found = dircache_search(entry, file_name);
+            else
+                unlisted = TRUE;
+            answered = TRUE;
+        }
+        ReleaseSRWLockExclusive(&g_dircache_lock);
+
+        if (answered) {
+            return unlisted ? dircache_probe_file(directory, file_name) : found;
+        }
+
+        //
+        // Enumerate outside of the lock, other sessions keep using old listings.
+        //
+        entry = dircache_build_listing(directory, &fad.ftLastWriteTime);
+        if (entry) {
+            entry->CheckTick = tick;
+            if (entry->Listed) {
+                found = dircache_search(entry, file_name);
+                answered = TRUE;
+            }
+            dircache_insert(entry);
+        }
+
+        if (answered) {
+            return found;
+        }
+    }
+
+    return dircache_probe_file(directory, file_name);
+}
@@ -0,0 +1,43 @@
+/*
+*  File: dircache.h
+*
+*  Created on: Oct 18, 2026
+*
+*  Modified on: Oct 18, 2026
+*
+*      Project: WinDepends.Core
+*
+*      Author: WinDepends dev team
+*/
+
+#pragma once
+
+#ifndef _DIRCACHE_H_
+#define _DIRCACHE_H_
+
+//
+// Directory listings shared between client sessions.
+// Listing is revalidated against directory last write time
+// no more often than once per DIRCACHE_REVALIDATE_MS.
+//
+#define DIRCACHE_MAX_DIRECTORIES    64
+#define DIRCACHE_MAX_NAMES          65536
+#define DIRCACHE_REVALIDATE_MS      1000
+
+typedef struct _DIRCACHE_ENTRY {
+    struct _DIRCACHE_ENTRY* Next;
+    PWCH Directory;
+    FILETIME LastWriteTime;
+    ULONGLONG CheckTick;
+    ULONG NameCount;
+    PWCH* Names;                    // sorted, case insensitive
+    PWCH NameBuffer;
+    BOOL Listed;                    // FALSE if directory is too big to list
+} DIRCACHE_ENTRY, * PDIRCACHE_ENTRY;
+
+BOOL dircache_probe(
+    _In_ LPCWSTR directory,
+    _In_ LPCWSTR file_name
+);
+
+#endif /* _DIRCACHE_H_ */
@@ -0,0 +1,462 @@
+/*
+*  File: fuzz.c
+*
+*  Created on: Oct 18, 2026
+*
+*  Modified on: Oct 18, 2026
+*
+*      Project: WinDepends.Core
+*
+*      Author: WinDepends dev team
+*/
+
+#include "core.h"
+#include "fuzz.h"
+
+#if defined(WDEP_FUZZER) || defined(WDEP_FUZZ_MODE)
+
+#define FUZZ_DEFAULT_NAME L"fuzz.bin"
+
+/*
+* fuzz_reply_sink
+*
+* Purpose:
+*
+* Discard parser replies, count produced bytes.
+*
+*/
+static int CALLBACK fuzz_reply_sink(
+    _In_reads_bytes_(length) const char* data,
+    _In_ int length,
+    _In_opt_ PVOID sink_context
+)
+{
+    UNREFERENCED_PARAMETER(data);
+
+    if (sink_context)
+        *(PLONG64)sink_context += length;
+
+    return length;
+}
+
+/*
+* fuzz_one_input
+*
+* Purpose:
+*
+* Run module open and every module query over in-memory file image.
+* File name is only used to name crash dumps.
+*
+*/
+int fuzz_one_input(
+    _In_reads_bytes_(size) const BYTE* data,
+    _In_ SIZE_T size,
+    _In_opt_ LPCWSTR file_name
+)
+{
+    SIZE_T sz;
+    PBYTE image;
+    pmodule_ctx context;
+    LONG64 reply_bytes = 0;
+
+    if (size > FUZZ_MAX_INPUT_SIZE)
+        return 0;
+
+    if (file_name == NULL)
+        file_name = FUZZ_DEFAULT_NAME;
+
+    // Checksum calculation reads whole words, keep odd sized input padded with zero.
+    image = (PBYTE)heap_calloc(NULL, size + sizeof(WCHAR));
+    if (image == NULL)
+        return 0;
+
+    if (size)
+        RtlCopyMemory(image, data, size);
+
+    context = (pmodule_ctx)heap_calloc(NULL, sizeof(module_ctx));
+    if (context == NULL) {
+        heap_free(NULL, image);
+        return 0;
+    }
+
+    context->allocation_granularity = gsup.dwAllocationGranularity;
+    context->process_relocs = TRUE;
+    context->image_buffer = image;
+    context->image_buffer_size = size;
+
+    sz = (1 + wcslen(file_name)) * sizeof(WCHAR);
+    context->filename = (PWCH)heap_calloc(NULL, sz);
+    if (context->filename) {
+        wcscpy_s(context->filename, sz / sizeof(WCHAR), file_name);
+    }
+
+    set_reply_sink(fuzz_reply_sink, &reply_bytes);
+
+    if (context->filename) {
+        context->module = pe32open(INVALID_SOCKET, context);
+        if (context->module) {
+            context->dos_hdr = (PIMAGE_DOS_HEADER)context->module;
+            context->nt_file_hdr = (PIMAGE_FILE_HEADER)(context->module + sizeof(DWORD) + context->dos_hdr->e_lfanew);
+
+            get_headers(INVALID_SOCKET, context);
+            get_datadirs(INVALID_SOCKET, context);
+            get_imports(INVALID_SOCKET, context);
+            get_exports(INVALID_SOCKET, context);
+        }
+    }
+
+    set_reply_sink(NULL, NULL);
+
+    cmd_close(context);
+    heap_free(NULL, image);
+
+    return (int)min(reply_bytes, MAXINT);
+}
+
+/*
+* fuzz_file
+*
+* Purpose:
+*
+* Run parser over the file contents, target function for in-process
+* fuzzers that work with files (WinAFL -target_method fuzz_file).
+*
+*/
+BOOL fuzz_file(
+    _In_ LPCWSTR file_name
+)
+{
+    HANDLE hf;
+    PBYTE data;
+    LARGE_INTEGER file_size;
+    DWORD iobytes = 0;
+    BOOL result = FALSE;
+
+    hf = CreateFile(file_name, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, 0, NULL);
+    if (hf == INVALID_HANDLE_VALUE)
+        return FALSE;
+
+    if (GetFileSizeEx(hf, &file_size) &&
+        file_size.QuadPart <= FUZZ_MAX_INPUT_SIZE)
+    {
+        data = (PBYTE)heap_malloc(NULL, (SIZE_T)file_size.QuadPart + 1);
+        if (data) {
+            if (ReadFile(hf, data, file_size.LowPart, &iobytes, NULL)) {
+                fuzz_one_input(data, iobytes, file_name);
+                result = TRUE;
+            }
+            heap_free(NULL, data);
+        }
+    }
+
+    CloseHandle(hf);
+    return result;
+}
+
+#ifdef WDEP_FUZZ_MODE
+
+typedef VOID(*PFUZZ_FILE_CALLBACK)(
+    _In_reads_bytes_(size) const BYTE* data,
+    _In_ DWORD size,
+    _In_ LPCWSTR file_name,
+    _In_ ULONG iterations,
+    _In_ PVOID callback_context
+    );
+
+typedef struct _FUZZ_RUN_STATS {
+    ULONG Files;
+    LONG64 Execs;
+    LONG64 ReplyBytes;
+    LARGE_INTEGER Elapsed;
+} FUZZ_RUN_STATS, * PFUZZ_RUN_STATS;
+
+typedef struct _RELOC_BENCH_STATS {
+    ULONG Files;
+    ULONG Compared;
+    LARGE_INTEGER LegacyTime;
+    LARGE_INTEGER EngineTime;
+} RELOC_BENCH_STATS, * PRELOC_BENCH_STATS;
+
+/*
+* fuzz_enum_files
+*
+* Purpose:
+*
+* Read every sample of the directory into memory and pass it to the callback.
+*
+*/
+static BOOL fuzz_enum_files(
+    _In_ LPCWSTR directory,
+    _In_ ULONG iterations,
+    _In_ PFUZZ_FILE_CALLBACK callback,
+    _In_ PVOID callback_context
+)
+{
+    HANDLE hFind, hf;
+    LPCWSTR ext;
+    WIN32_FIND_DATA fd;
+    WCHAR search_mask[MAX_PATH * 2], file_name[MAX_PATH * 2];
+    PBYTE data;
+    DWORD iobytes;
+
+    if (FAILED(StringCchPrintf(search_mask, ARRAYSIZE(search_mask), L"%ws\\*", directory)))
+        return FALSE;
+
+    hFind = FindFirstFile(search_mask, &fd);
+    if (hFind == INVALID_HANDLE_VALUE) {
+        printf("[FUZZ][ERROR] FindFirstFile failed (err=%lu)\r\n", GetLastError());
+        return FALSE;
+    }
+
+    if (iterations == 0)
+        iterations = FUZZ_DEFAULT_ITERATIONS;
+
+    do {
+        if (fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+            continue;
+
+        // Skip minidumps written for previous crashes.
+        ext = wcsrchr(fd.cFileName, L'.');
+        if (ext && (_wcsicmp(ext, L".dmp") == 0))
+            continue;
+
+        if (fd.nFileSizeHigh || fd.nFileSizeLow > FUZZ_MAX_INPUT_SIZE)
+            continue;
+
+        if (FAILED(StringCchPrintf(file_name, ARRAYSIZE(file_name), L"%ws\\%ws", directory, fd.cFileName)))
+            continue;
+
+        hf = CreateFile(file_name, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, 0, NULL);
+        if (hf == INVALID_HANDLE_VALUE)
+            continue;
+
+        data = (PBYTE)heap_malloc(NULL, (SIZE_T)fd.nFileSizeLow + 1);
+        iobytes = 0;
+        if (data && ReadFile(hf, data, fd.nFileSizeLow, &iobytes, NULL)) {
+            wprintf(L"[FUZZ] File %ws\r\n", fd.cFileName);
+            callback(data, iobytes, file_name, iterations, callback_context);
+        }
+
+        if (data)
+            heap_free(NULL, data);
+        CloseHandle(hf);
+
+    } while (FindNextFile(hFind, &fd));
+
+    FindClose(hFind);
+    return TRUE;
+}
+
+/*
+* fuzz_run_file
+*
+* Purpose:
+*
+* fuzz_directory callback, run parser over the sample.
+*
+*/
+static VOID fuzz_run_file(
+    _In_reads_bytes_(size) const BYTE* data,
+    _In_ DWORD size,
+    _In_ LPCWSTR file_name,
+    _In_ ULONG iterations,
+    _In_ PVOID callback_context
+)
+{
+    PFUZZ_RUN_STATS stats = (PFUZZ_RUN_STATS)callback_context;
+    LARGE_INTEGER start_count, end_count;
+    ULONG i;
+
+    QueryPerformanceCounter(&start_count);
+    for (i = 0; i < iterations; i++) {
+        stats->ReplyBytes += fuzz_one_input(data, size, file_name);
+    }
+    QueryPerformanceCounter(&end_count);
+
+    stats->Elapsed.QuadPart += end_count.QuadPart - start_count.QuadPart;
+    stats->Execs += iterations;
+    stats->Files++;
+}
+
+/*
+* fuzz_directory
+*
+* Purpose:
+*
+* Run parser over every file of the directory, report executions per second.
+* Files are read once, only parsing is measured.
+*
+*/
+int fuzz_directory(
+    _In_ LPCWSTR directory,
+    _In_ ULONG iterations
+)
+{
+    FUZZ_RUN_STATS stats;
+    double seconds;
+
+    RtlSecureZeroMemory(&stats, sizeof(stats));
+
+    if (!fuzz_enum_files(directory, iterations, fuzz_run_file, &stats))
+        return 1;
+
+    seconds = (double)stats.Elapsed.QuadPart / (double)gsup.PerformanceFrequency.QuadPart;
+    printf("[FUZZ][SUMMARY] Files=%lu Execs=%lld Seconds=%.3f Execs/sec=%.1f ReplyBytes=%lld\r\n",
+        stats.Files,
+        stats.Execs,
+        seconds,
+        (seconds > 0) ? (double)stats.Execs / seconds : 0.0,
+        stats.ReplyBytes);
+
+    return 0;
+}
+
+/*
+* fuzz_reloc_file
+*
+* Purpose:
+*
+* fuzz_relocs callback, load sample without relocations and time
+* both relocation routines over the loaded image.
+*
+*/
+static VOID fuzz_reloc_file(
+    _In_reads_bytes_(size) const BYTE* data,
+    _In_ DWORD size,
+    _In_ LPCWSTR file_name,
+    _In_ ULONG iterations,
+    _In_ PVOID callback_context
+)
+{
+    PRELOC_BENCH_STATS stats = (PRELOC_BENCH_STATS)callback_context;
+    PIMAGE_NT_HEADERS nt_headers;
+    PIMAGE_DATA_DIRECTORY reloc_dir = NULL;
+    LARGE_INTEGER legacy_time, engine_time;
+    ULONG64 image_base = 0;
+    DWORD image_size = 0;
+    module_ctx context;
+
+    RtlSecureZeroMemory(&context, sizeof(context));
+    context.allocation_granularity = gsup.dwAllocationGranularity;
+    context.image_buffer = data;
+    context.image_buffer_size = size;
+    context.filename = (PWCH)file_name;
+
+    set_reply_sink(fuzz_reply_sink, NULL);
+    context.module = pe32open(INVALID_SOCKET, &context);
+    set_reply_sink(NULL, NULL);
+
+    if (context.module == NULL)
+        return;
+
+    stats->Files++;
+
+    nt_headers = (PIMAGE_NT_HEADERS)(context.module + ((PIMAGE_DOS_HEADER)context.module)->e_lfanew);
+    if (context.image_64bit) {
+        PIMAGE_OPTIONAL_HEADER64 opt_hdr = &((PIMAGE_NT_HEADERS64)nt_headers)->OptionalHeader;
+        image_base = opt_hdr->ImageBase;
+        image_size = opt_hdr->SizeOfImage;
+        if (opt_hdr->NumberOfRvaAndSizes > IMAGE_DIRECTORY_ENTRY_BASERELOC)
+            reloc_dir = &opt_hdr->DataDirectory[IMAGE_DIRECTORY_ENTRY_BASERELOC];
+    }
+    else {
+        PIMAGE_OPTIONAL_HEADER32 opt_hdr = &((PIMAGE_NT_HEADERS32)nt_headers)->OptionalHeader;
+        image_base = opt_hdr->ImageBase;
+        image_size = opt_hdr->SizeOfImage;
+        if (opt_hdr->NumberOfRvaAndSizes > IMAGE_DIRECTORY_ENTRY_BASERELOC)
+            reloc_dir = &opt_hdr->DataDirectory[IMAGE_DIRECTORY_ENTRY_BASERELOC];
+    }
+
+    // pe32open verified SizeOfImage against section layout.
+    image_size = PAGE_ALIGN(image_size);
+
+    if (reloc_dir && reloc_dir->VirtualAddress &&
+        reloc_benchmark(context.module, image_size, nt_headers->FileHeader.Machine, image_base,
+            reloc_dir->VirtualAddress, reloc_dir->Size, iterations, &legacy_time, &engine_time))
+    {
+        stats->LegacyTime.QuadPart += legacy_time.QuadPart;
+        stats->EngineTime.QuadPart += engine_time.QuadPart;
+        stats->Compared++;
+    }
+
+    pe32close(context.module);
+}
+
+/*
+* fuzz_relocs
+*
+* Purpose:
+*
+* Compare new relocation engine against the previous routine over every
+* file of the directory. Only files accepted by both routines are timed.
+*
+*/
+int fuzz_relocs(
+    _In_ LPCWSTR directory,
+    _In_ ULONG iterations
+)
+{
+    RELOC_BENCH_STATS stats;
+    double legacy_seconds, engine_seconds;
+
+    RtlSecureZeroMemory(&stats, sizeof(stats));
+
+    if (!fuzz_enum_files(directory, iterations, fuzz_reloc_file, &stats))
+        return 1;
+
+    legacy_seconds = (double)stats.LegacyTime.QuadPart / (double)gsup.PerformanceFrequency.QuadPart;
+    engine_seconds = (double)stats.EngineTime.QuadPart / (double)gsup.PerformanceFrequency.QuadPart;
+    printf("[FUZZ][RELOCS] Files=%lu Compared=%lu LegacySeconds=%.3f EngineSeconds=%.3f Speedup=%.2f\r\n",
+        stats.Files,
+        stats.Compared,
+        legacy_seconds,
+        engine_seconds,
+        (engine_seconds > 0) ? legacy_seconds / engine_seconds : 0.0);
+
+    return 0;
+}
+
+#endif /* WDEP_FUZZ_MODE */
+
+#ifdef WDEP_FUZZER
+
+/*
+* LLVMFuzzerInitialize
+*
+* Purpose:
+*
+* libFuzzer one time initialization.
+*
+*/
+int LLVMFuzzerInitialize(
+    int* argc,
+    char*** argv
+)
+{
+    UNREFERENCED_PARAMETER(argc);
+    UNREFERENCED_PARAMETER(argv);
+
+    utils_init();
+    return 0;
+}
+
+/*
+* LLVMFuzzerTestOneInput
+*
+* Purpose:
+*
+* libFuzzer entry point, libFuzzer reports exec/s itself.
+*
+*/
+int LLVMFuzzerTestOneInput(
+    const unsigned char* data,
+    size_t size
+)
+{
+    fuzz_one_input(data, size, NULL);
+    return 0;
+}
+
+#endif /* WDEP_FUZZER */
+
+#endif /* WDEP_FUZZER || WDEP_FUZZ_MODE */
@@ -0,0 +1,52 @@
+/*
+*  File: fuzz.h
+*
+*  Created on: Oct 18, 2026
+*
+*  Modified on: Oct 18, 2026
+*
+*      Project: WinDepends.Core
+*
+*      Author: WinDepends dev team
+*/
+
+#pragma once
+
+#ifndef _FUZZ_H_
+#define _FUZZ_H_
+
+//
+// In-process fuzzing entry points over the PE parser, replies go to a null sink
+// instead of a socket. None of them is part of the shipped server.
+// Defining WDEP_FUZZER builds libFuzzer harness in place of the server entry point,
+// defining WDEP_FUZZ_MODE builds console server with the "fuzz <directory>" mode,
+// see WinDepends.Core.vcxproj WdepFuzzer and WdepFuzzMode properties.
+//
+#define FUZZ_MAX_INPUT_SIZE     (64 * 1024 * 1024)
+#define FUZZ_DEFAULT_ITERATIONS 1
+
+int fuzz_one_input(
+    _In_reads_bytes_(size) const BYTE* data,
+    _In_ SIZE_T size,
+    _In_opt_ LPCWSTR file_name
+);
+
+BOOL fuzz_file(
+    _In_ LPCWSTR file_name
+);
+
+#ifdef WDEP_FUZZ_MODE
+
+int fuzz_directory(
+    _In_ LPCWSTR directory,
+    _In_ ULONG iterations
+);
+
+int fuzz_relocs(
+    _In_ LPCWSTR directory,
+    _In_ ULONG iterations
+);
+
+#endif /* WDEP_FUZZ_MODE */
+
+#endif /* _FUZZ_H_ */
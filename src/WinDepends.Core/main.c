@@ -3,7 +3,7 @@
 *
 *  Created on: Jul 8, 2024
 *
-*  Modified on: Dec 20, 2025
+*  Modified on: Oct 18, 2026
 *
 *      Project: WinDepends.Core
 *
@@ -12,10 +12,14 @@
 
 #include "core.h"
 #include "pe32plus.h"
+#ifdef WDEP_FUZZ_MODE
+#include "fuzz.h"
+#endif
 
 #define APP_PORT_DEFAULT    8209
 #define APP_ADDR            "127.0.0.1"
 #define APP_MAXUSERS        1
+#define APP_MAXUSERS_LIMIT  64
 #define APP_KEEPALIVE       1
 #define MIN_WCHAR_CMD_BYTES 4
 
@@ -26,6 +30,7 @@ typedef struct _SERVER_CONTEXT {
     volatile LONG64 sockets_created;
     volatile LONG64 sockets_closed;
     volatile LONG shutdown;
+    LONG max_users;
     SOCKET app_socket;
 } SERVER_CONTEXT, * PSERVER_CONTEXT;
 
@@ -118,12 +123,19 @@ DWORD WINAPI client_thread(
 {
     int         rcv_buffer_size = (sizeof(wchar_t) * 65536) + 4096;
     wchar_t*    rcvbuf = NULL, * cmd, * params;
+    cmd_entry_type cmd_type;
     HANDLE      hheap = NULL;
     WCHAR       hello_msg[200];
 
     // Variable used to hold module context data.
     module_ctx  *pmctx = NULL;
 
+    // ApiSet schema selected by this client, process namespace by default.
+    PAPISET_SCHEMA apiset_schema;
+
+    // KnownDlls snapshot loaded by this client, server wide sets by default.
+    SUP_KNOWNDLLS_SNAPSHOT knowndlls_snapshot;
+
     SOCKET s;
     PSERVER_CONTEXT server_ctx;
     PCLIENT_THREAD_PARAM thread_param;
@@ -134,6 +146,8 @@ DWORD WINAPI client_thread(
     heap_free(NULL, thread_param);
 
     InterlockedIncrement(&server_ctx->threads);
+    apiset_schema = apiset_schema_acquire(NULL);
+    RtlSecureZeroMemory(&knowndlls_snapshot, sizeof(knowndlls_snapshot));
     
     StringCchPrintf(hello_msg, 
         ARRAYSIZE(hello_msg), 
@@ -176,7 +190,10 @@ DWORD WINAPI client_thread(
 
             wprintf(cmd_debug_log, cmd, (params == NULL) ? L"no params" : params);
 
-            switch (get_command_entry(cmd)) {
+            cmd_type = get_command_entry(cmd);
+            stats_command_begin();
+
+            switch (cmd_type) {
 
                 //
                 // Open module file for analysis and allocate designated context.
@@ -189,6 +206,17 @@ DWORD WINAPI client_thread(
                 }
                 break;
 
+                //
+                // Resolve module file in search directories and open it.
+                //
+            case ce_openresolve:
+                if (params != NULL) {
+                    if (pmctx != NULL)
+                        cmd_close(pmctx);
+                    pmctx = cmd_open_resolve(s, params);
+                }
+                break;
+
                 //
                 // Close module file and deallocate module context.
                 //
@@ -252,14 +280,28 @@ DWORD WINAPI client_thread(
                 // Query known dlls lists.
                 //
             case ce_knowndlls:
-                cmd_query_knowndlls_list(s, params);
+                cmd_query_knowndlls_list(s, params, &knowndlls_snapshot);
+                break;
+
+                //
+                // Query version of known dlls lists.
+                //
+            case ce_knowndllsver:
+                cmd_query_knowndlls_version(s, &knowndlls_snapshot);
+                break;
+
+                //
+                // Load known dlls lists of this client from snapshot (server wide if no params).
+                //
+            case ce_knowndllsload:
+                cmd_load_knowndlls(s, params, &knowndlls_snapshot);
                 break;
 
                 //
                 // Retrieve apiset namespace information.
                 //
             case ce_apisetnsinfo:
-                cmd_apisetnamespace_info(s, params);
+                cmd_apisetnamespace_info(s, params, apiset_schema);
                 break;
 
                 //
@@ -267,15 +309,50 @@ DWORD WINAPI client_thread(
                 //
             case ce_apisetresolve:
                 if (params && pmctx) {
-                    cmd_resolve_apiset_name(s, params, pmctx);
+                    cmd_resolve_apiset_name(s, params, apiset_schema, pmctx);
                 }
                 break;
+
+                //
+                // Resolve list of apiset contract filenames.
+                //
+            case ce_apisetresolvebatch:
+                cmd_resolve_apiset_batch(s, params, apiset_schema, pmctx);
+                break;
             
                 //
-                // Select source of apiset map (peb or file).
+                // Select source of apiset map (peb or file) for this client.
                 //
             case ce_apisetmapsrc:
-                cmd_set_apisetmap_src(s, params);
+                cmd_set_apisetmap_src(s, params, &apiset_schema);
+                break;
+
+                //
+                // Dump whole apiset namespace of this client.
+                //
+            case ce_apisetdump:
+                cmd_apiset_dump(s, apiset_schema);
+                break;
+
+                //
+                // Server wide per-command statistics.
+                //
+            case ce_stats:
+                cmd_stats(s, params);
+                break;
+
+                //
+                // Control and query trace of this session commands.
+                //
+            case ce_trace:
+                cmd_trace(s, params);
+                break;
+
+                //
+                // Query CodeView, POGO and VC feature records of the list of files.
+                //
+            case ce_debuginfo:
+                cmd_query_debuginfo(s, params, pmctx);
                 break;
 
                 //
@@ -287,6 +364,8 @@ DWORD WINAPI client_thread(
                 break;
             }
 
+            stats_command_end(cmd_type);
+
         }
 
 recv_loop_end:
@@ -304,13 +383,18 @@ recv_loop_end:
         cmd_close(pmctx);
     }
 
+    apiset_schema_release(apiset_schema);
+    free_knowndlls_list(&knowndlls_snapshot.KnownDlls);
+    free_knowndlls_list(&knowndlls_snapshot.KnownDlls32);
+    stats_trace_enable(FALSE);
+
     closesocket(s);
     InterlockedIncrement64(&server_ctx->sockets_closed);
     InterlockedDecrement(&server_ctx->threads);
 
     printf("MAIN LOOP stats: threads=%i, max_users=%i, sockets_created=%lli, sockets_closed=%lli\r\n",
         InterlockedCompareExchange(&server_ctx->threads, 0, 0),
-        APP_MAXUSERS,
+        server_ctx->max_users,
         InterlockedCompareExchange64(&server_ctx->sockets_created, 0, 0),
         InterlockedCompareExchange64(&server_ctx->sockets_closed, 0, 0)
     );
@@ -391,7 +475,7 @@ void connect_loop(
 
         InterlockedIncrement64(&ctx->sockets_created);
 
-        if (InterlockedCompareExchange(&ctx->threads, 0, 0) < APP_MAXUSERS)
+        if (InterlockedCompareExchange(&ctx->threads, 0, 0) < ctx->max_users)
         {
             thread_param = (PCLIENT_THREAD_PARAM)heap_calloc(NULL, sizeof(CLIENT_THREAD_PARAM));
             if (thread_param) {
@@ -426,7 +510,7 @@ void connect_loop(
 
         printf("MAIN LOOP stats: threads=%i, max_users=%i, sockets_created=%lli, sockets_closed=%lli\r\n",
             InterlockedCompareExchange(&ctx->threads, 0, 0),
-            APP_MAXUSERS,
+            ctx->max_users,
             InterlockedCompareExchange64(&ctx->sockets_created, 0, 0),
             InterlockedCompareExchange64(&ctx->sockets_closed, 0, 0)
         );
@@ -513,6 +597,102 @@ u_short select_server_port(
     return APP_PORT_DEFAULT;
 }
 
+/*
+* select_max_users
+*
+* Purpose:
+*
+* Parse maximum number of simultaneous clients from command line or return default.
+*
+*/
+LONG select_max_users(
+    VOID
+)
+{
+    ULONG   param_length = 0, value;
+    WCHAR   option_buffer[32];
+    LPCWSTR params = GetCommandLineW();
+
+    if (get_params_option(
+        params,
+        L"clients",
+        TRUE,
+        option_buffer,
+        ARRAYSIZE(option_buffer),
+        &param_length))
+    {
+        value = strtoul_w(option_buffer);
+        if (value > 0 && value <= APP_MAXUSERS_LIMIT)
+            return (LONG)value;
+    }
+
+    return APP_MAXUSERS;
+}
+
+#ifdef WDEP_FUZZ_MODE
+
+/*
+* run_fuzz_mode
+*
+* Purpose:
+*
+* Run parser in-process over a directory of samples if requested from command line,
+* "fuzz <directory> [iterations <n>] [relocs]". With relocs only relocation
+* processing is timed against the previous routine.
+*
+*/
+BOOL run_fuzz_mode(
+    VOID
+)
+{
+    ULONG   param_length = 0, iterations = FUZZ_DEFAULT_ITERATIONS;
+    WCHAR   directory[MAX_PATH + 1];
+    WCHAR   option_buffer[32];
+    LPCWSTR params = GetCommandLineW();
+
+    if (!get_params_option(
+        params,
+        L"fuzz",
+        TRUE,
+        directory,
+        ARRAYSIZE(directory),
+        &param_length) || param_length == 0)
+    {
+        return FALSE;
+    }
+
+    if (get_params_option(
+        params,
+        L"iterations",
+        TRUE,
+        option_buffer,
+        ARRAYSIZE(option_buffer),
+        &param_length))
+    {
+        iterations = strtoul_w(option_buffer);
+    }
+
+    if (get_params_option(
+        params,
+        L"relocs",
+        FALSE,
+        NULL,
+        0,
+        &param_length))
+    {
+        fuzz_relocs(directory, iterations);
+    }
+    else {
+        fuzz_directory(directory, iterations);
+    }
+
+    return TRUE;
+}
+
+#endif /* WDEP_FUZZ_MODE */
+
+#ifndef WDEP_FUZZER
+
 #if defined _DEBUG || defined _CONSOLE
 void main()
 {
@@ -550,7 +730,14 @@ int CALLBACK WinMain(
 
     utils_init();
 
+#ifdef WDEP_FUZZ_MODE
+    if (run_fuzz_mode()) {
+        ExitProcess(SERVER_ERROR_SUCCESS);
+    }
+#endif
+
     server_port = select_server_port();
+    server_ctx.max_users = select_max_users();
 
     th = CreateThread(NULL, 0, (LPTHREAD_START_ROUTINE)server_watchdog_thread, &server_ctx, 0, &tid);
     if (th) {
@@ -618,3 +805,5 @@ int CALLBACK WinMain(
     WSACleanup();
     ExitProcess(error_code);
 }
+
+#endif /* WDEP_FUZZER */
@@ -3,7 +3,7 @@
 *
 *  Created on: Jul 11, 2024
 *
-*  Modified on: Oct 27, 2025
+*  Modified on: Oct 18, 2026
 *
 *      Project: WinDepends.Core
 *
@@ -54,100 +54,6 @@ static BOOL is_power_of_two(DWORD x)
     return (x & (x - 1)) == 0;
 }
 
-/*
-* relocimage
-*
-* Purpose:
-*
-* Send exception information to the client.
-*
-*/
-BOOL relocimage(
-    _In_ LPVOID MappedView,
-    _In_ LPVOID RebaseFrom,
-    _In_ PIMAGE_BASE_RELOCATION RelData,
-    _In_ ULONG RelDataSize)
-{
-    ULONG       p = 0, block_size;
-    LPWORD      entry;
-    LONG64      delta = (ULONG_PTR)MappedView - (ULONG_PTR)RebaseFrom;
-    LONG64      rel, * ptr;
-
-    PIMAGE_BASE_RELOCATION next_block, RelData0 = RelData;
-
-    if (RelDataSize < sizeof(IMAGE_BASE_RELOCATION))
-        return FALSE;
-
-    /* validate */
-    while (p < RelDataSize)
-    {
-        block_size = RelData->SizeOfBlock;
-        if ((block_size < sizeof(IMAGE_BASE_RELOCATION)) ||
-            (p + block_size > RelDataSize) ||
-            (block_size % sizeof(WORD) != 0))
-        {
-            return FALSE;
-        }
-
-        next_block = (PIMAGE_BASE_RELOCATION)((LPBYTE)RelData + block_size);
-        for (entry = (LPWORD)(RelData + 1); entry < (LPWORD)next_block; ++entry)
-        {
-            switch (*entry >> 12)
-            {
-            case IMAGE_REL_BASED_HIGHLOW:
-            case IMAGE_REL_BASED_DIR64:
-            case IMAGE_REL_BASED_ABSOLUTE:
-                break;
-            default:
-                /* unsupported reloc found */
-                return FALSE;
-            }
-        }
-        p += block_size;
-        RelData = next_block;
-    }
-
-    if (p != RelDataSize)
-        return FALSE;
-
-    /* do relocate */
-    p = 0;
-    RelData = RelData0;
-    while (p < RelDataSize)
-    {
-        block_size = RelData->SizeOfBlock;
-        next_block = (PIMAGE_BASE_RELOCATION)((LPBYTE)RelData + block_size);
-        for (entry = (LPWORD)(RelData + 1); entry < (LPWORD)next_block; ++entry)
-        {
-            switch (*entry >> 12)
-            {
-            case IMAGE_REL_BASED_HIGHLOW:
-                ptr = (LONG64*)((LPBYTE)MappedView + RelData->VirtualAddress + (*entry & 0x0fff));
-                rel = *(PULONG)ptr; // need zero extend value here (movzx)
-                rel += delta;
-                *(PLONG)ptr = (LONG)rel;
-                break;
-            case IMAGE_REL_BASED_DIR64:
-                ptr = (LONG64*)((LPBYTE)MappedView + RelData->VirtualAddress + (*entry & 0x0fff));
-                rel = *ptr;
-                rel += delta;
-                *ptr = rel;
-                break;
-            case IMAGE_REL_BASED_ABSOLUTE:
-                // no relocation needed
-                break;
-            default:
-                /* unsupported reloc found */
-                return FALSE;
-            }
-        }
-        p += block_size;
-        RelData = next_block;
-    }
-
-    return TRUE;
-}
-
 /*
 * get_datadirs
 *
@@ -1538,6 +1444,44 @@ BOOL get_imports(
     return status;
 }
 
+/*
+* pe32read
+*
+* Purpose:
+*
+* Read file data at offset, either from file or from in-memory file image.
+*
+*/
+static BOOL pe32read(
+    _In_ pmodule_ctx context,
+    _In_ HANDLE hf,
+    _In_ DWORD offset,
+    _Out_writes_bytes_(size) LPVOID buffer,
+    _In_ DWORD size,
+    _Out_ LPDWORD iobytes
+)
+{
+    OVERLAPPED ovl;
+    SIZE_T available;
+
+    if (context->image_buffer) {
+        // Same as ReadFile past end of file, short read is not an error.
+        available = (offset < context->image_buffer_size) ? context->image_buffer_size - offset : 0;
+        *iobytes = (DWORD)min(available, size);
+        if (*iobytes)
+            RtlCopyMemory(buffer, context->image_buffer + offset, *iobytes);
+    }
+    else {
+        RtlZeroMemory(&ovl, sizeof(ovl));
+        ovl.Offset = offset;
+        if (!ReadFile(hf, buffer, size, iobytes, &ovl))
+            return FALSE;
+    }
+
+    stats_add_bytes_read(*iobytes);
+    return TRUE;
+}
+
 /*
 * pe32open
 *
@@ -1555,8 +1499,7 @@ LPBYTE pe32open(
     IMAGE_DOS_HEADER    dos_hdr = { 0 };
     IMAGE_FILE_HEADER   nt_file_hdr = { 0 };
     DWORD               iobytes = 0, dwSignature = 0, szOptAndSections,
-        vsize, psize, tsize, status = 0, dwRealChecksum = 0, dwLastError = 0, dir_base = 0, dir_size = 0;
-    OVERLAPPED          ovl;
+        vsize, psize, tsize, status = 0, dwRealChecksum = 0, dwLastError = 0, dir_base = 0, dir_size = 0, offset;
     PBYTE               module = NULL;
     INT64               c, image_base;
 
@@ -1580,27 +1523,40 @@ LPBYTE pe32open(
         context->image_fixed = TRUE;
         context->image_64bit = FALSE;
 
-        // Open input file
-        hf = CreateFile(context->filename, GENERIC_READ | SYNCHRONIZE, FILE_SHARE_READ, NULL, OPEN_EXISTING, 0, NULL);
-        if (hf == INVALID_HANDLE_VALUE)
+        if (context->image_buffer)
         {
-            DEBUG_PRINT_LASTERROR("pe32open: CreateFile");
-            sendstring_plaintext_no_track(s, WDEP_STATUS_404);
-            __leave;
+            // In-memory image, there is no file to take information from.
+            if (context->image_buffer_size > MAXDWORD)
+            {
+                sendstring_plaintext_no_track(s, WDEP_STATUS_415);
+                __leave;
+            }
+            fileinfo.nFileSizeLow = (DWORD)context->image_buffer_size;
         }
-
-        // Get file information
-        if (!GetFileInformationByHandle(hf, &fileinfo))
+        else
         {
-            sendstring_plaintext_no_track(s, WDEP_STATUS_404);
-            __leave;
+            // Open input file
+            hf = CreateFile(context->filename, GENERIC_READ | SYNCHRONIZE, FILE_SHARE_READ, NULL, OPEN_EXISTING, 0, NULL);
+            if (hf == INVALID_HANDLE_VALUE)
+            {
+                DEBUG_PRINT_LASTERROR("pe32open: CreateFile");
+                sendstring_plaintext_no_track(s, WDEP_STATUS_404);
+                __leave;
+            }
+
+            // Get file information
+            if (!GetFileInformationByHandle(hf, &fileinfo))
+            {
+                sendstring_plaintext_no_track(s, WDEP_STATUS_404);
+                __leave;
+            }
         }
 
         context->file_size.LowPart = fileinfo.nFileSizeLow;
         context->file_size.HighPart = fileinfo.nFileSizeHigh;
 
         // Read DOS header
-        if (!ReadFile(hf, &dos_hdr, sizeof(dos_hdr), &iobytes, NULL))
+        if (!pe32read(context, hf, 0, &dos_hdr, sizeof(dos_hdr), &iobytes))
         {
             sendstring_plaintext_no_track(s, WDEP_STATUS_403);
             __leave;
@@ -1614,9 +1570,7 @@ LPBYTE pe32open(
             __leave;
         }
 
-        RtlZeroMemory(&ovl, sizeof(ovl));
-        ovl.Offset = dos_hdr.e_lfanew;
-        if (!ReadFile(hf, &dwSignature, sizeof(dwSignature), &iobytes, &ovl))
+        if (!pe32read(context, hf, dos_hdr.e_lfanew, &dwSignature, sizeof(dwSignature), &iobytes))
         {
             sendstring_plaintext_no_track(s, WDEP_STATUS_403);
             __leave;
@@ -1630,9 +1584,7 @@ LPBYTE pe32open(
         }
 
         // Read COFF header
-        RtlZeroMemory(&ovl, sizeof(ovl));
-        ovl.Offset = dos_hdr.e_lfanew + sizeof(dwSignature);
-        if (!ReadFile(hf, &nt_file_hdr, sizeof(nt_file_hdr), &iobytes, &ovl))
+        if (!pe32read(context, hf, dos_hdr.e_lfanew + sizeof(dwSignature), &nt_file_hdr, sizeof(nt_file_hdr), &iobytes))
         {
             sendstring_plaintext_no_track(s, WDEP_STATUS_403);
             __leave;
@@ -1643,22 +1595,35 @@ LPBYTE pe32open(
             __leave;
         }
 
-        RtlZeroMemory(&ovl, sizeof(ovl));
-        ovl.Offset = dos_hdr.e_lfanew + sizeof(dwSignature) + IMAGE_SIZEOF_FILE_HEADER;
+        offset = dos_hdr.e_lfanew + sizeof(dwSignature) + IMAGE_SIZEOF_FILE_HEADER;
 
 #pragma region CHECKSUM
-        // Calculate checksum via memory mapping
-        HANDLE hm = CreateFileMapping(hf, NULL, PAGE_READONLY, 0, 0, NULL);
-        if (hm != NULL)
+        // Checksum field of a truncated file may lie beyond its end.
+        if ((ULONG64)offset + FIELD_OFFSET(IMAGE_OPTIONAL_HEADER64, CheckSum) + sizeof(DWORD) <= fileinfo.nFileSizeLow)
         {
-            PVOID mapping = MapViewOfFile(hm, FILE_MAP_READ, 0, 0, 0);
-            if (mapping != NULL)
+            if (context->image_buffer)
             {
-                opt_file_hdr.opt_file_hdr64 = (PIMAGE_OPTIONAL_HEADER64)((PBYTE)mapping + ovl.Offset);
-                dwRealChecksum = calc_mapped_file_chksum(mapping, fileinfo.nFileSizeLow, (PUSHORT)&opt_file_hdr.opt_file_hdr64->CheckSum);
-                UnmapViewOfFile(mapping);
+                dwRealChecksum = calc_mapped_file_chksum((PVOID)context->image_buffer, fileinfo.nFileSizeLow,
+                    (PUSHORT)(context->image_buffer + offset + FIELD_OFFSET(IMAGE_OPTIONAL_HEADER64, CheckSum)));
+                stats_add_bytes_read(fileinfo.nFileSizeLow);
+            }
+            else
+            {
+                // Calculate checksum via memory mapping
+                HANDLE hm = CreateFileMapping(hf, NULL, PAGE_READONLY, 0, 0, NULL);
+                if (hm != NULL)
+                {
+                    PVOID mapping = MapViewOfFile(hm, FILE_MAP_READ, 0, 0, 0);
+                    if (mapping != NULL)
+                    {
+                        opt_file_hdr.opt_file_hdr64 = (PIMAGE_OPTIONAL_HEADER64)((PBYTE)mapping + offset);
+                        dwRealChecksum = calc_mapped_file_chksum(mapping, fileinfo.nFileSizeLow, (PUSHORT)&opt_file_hdr.opt_file_hdr64->CheckSum);
+                        stats_add_bytes_read(fileinfo.nFileSizeLow);
+                        UnmapViewOfFile(mapping);
+                    }
+                    CloseHandle(hm);
+                }
             }
-            CloseHandle(hm);
         }
 #pragma endregion
 
@@ -1677,7 +1642,7 @@ LPBYTE pe32open(
         }
 
         // Read optional header and section headers
-        if (!ReadFile(hf, opt_file_hdr.opt_file_hdr64, szOptAndSections, &iobytes, &ovl))
+        if (!pe32read(context, hf, offset, opt_file_hdr.opt_file_hdr64, szOptAndSections, &iobytes))
         {
             sendstring_plaintext_no_track(s, WDEP_STATUS_403);
             __leave;
@@ -1824,7 +1789,6 @@ LPBYTE pe32open(
         DEBUG_PRINT("pe32open: module allocated at 0x%p\r\n", module);
 
         // Read PE headers into memory
-        RtlZeroMemory(&ovl, sizeof(ovl));
         if (nt_file_hdr.NumberOfSections == 0)
         {
             psize = PAGE_ALIGN(
@@ -1838,7 +1802,7 @@ LPBYTE pe32open(
                 opt_file_hdr.opt_file_hdr64->FileAlignment);
         }
 
-        if (!ReadFile(hf, module, psize, &iobytes, &ovl))
+        if (!pe32read(context, hf, 0, module, psize, &iobytes))
         {
             sendstring_plaintext_no_track(s, WDEP_STATUS_403);
             __leave;
@@ -1850,8 +1814,7 @@ LPBYTE pe32open(
             if (sections[c].PointerToRawData == 0)
                 continue;
 
-            RtlZeroMemory(&ovl, sizeof(ovl));
-            ovl.Offset = ALIGN_DOWN(sections[c].PointerToRawData, opt_file_hdr.opt_file_hdr64->FileAlignment);
+            offset = ALIGN_DOWN(sections[c].PointerToRawData, opt_file_hdr.opt_file_hdr64->FileAlignment);
 
             tsize = sections[c].Misc.VirtualSize;
             psize = sections[c].SizeOfRawData;
@@ -1859,7 +1822,7 @@ LPBYTE pe32open(
             tsize = min(tsize, psize);
             tsize = ALIGN_UP(tsize, opt_file_hdr.opt_file_hdr64->FileAlignment);
 
-            if (!ReadFile(hf, module + sections[c].VirtualAddress, tsize, &iobytes, &ovl))
+            if (!pe32read(context, hf, offset, module + sections[c].VirtualAddress, tsize, &iobytes))
             {
                 sendstring_plaintext_no_track(s, WDEP_STATUS_403);
                 __leave;
@@ -1870,19 +1833,25 @@ LPBYTE pe32open(
         if ((!image_fixed) && context->process_relocs) {
 
             BOOL relocs_processed = FALSE;
+            ULONG64 rebase_from;
 
             if (context->image_64bit) {
                 get_pe_dirbase_size(opt_file_hdr.opt_file_hdr64, IMAGE_DIRECTORY_ENTRY_BASERELOC, dir_base, dir_size);
-                if (dir_base) {
-                    relocs_processed = relocimage(module, (LPVOID)(DWORD_PTR)opt_file_hdr.opt_file_hdr64->ImageBase,
-                        (PIMAGE_BASE_RELOCATION)(module + dir_base), dir_size);
-                }
+                rebase_from = opt_file_hdr.opt_file_hdr64->ImageBase;
             }
             else {
                 get_pe_dirbase_size(opt_file_hdr.opt_file_hdr32, IMAGE_DIRECTORY_ENTRY_BASERELOC, dir_base, dir_size);
-                if (dir_base) {
-                    relocs_processed = relocimage(module, (LPVOID)(ULONG_PTR)opt_file_hdr.opt_file_hdr32->ImageBase,
-                        (PIMAGE_BASE_RELOCATION)(module + dir_base), dir_size);
+                rebase_from = opt_file_hdr.opt_file_hdr32->ImageBase;
+            }
+
+            if (dir_base) {
+                if (context->lazy_relocs) {
+                    relocs_processed = reloc_lazy_init(module, vsize, nt_file_hdr.Machine,
+                        rebase_from, dir_base, dir_size);
+                }
+                else {
+                    relocs_processed = reloc_apply(module, vsize, nt_file_hdr.Machine,
+                        rebase_from, dir_base, dir_size);
                 }
             }
 
@@ -1952,8 +1921,10 @@ LPBYTE pe32open(
 */
 BOOL pe32close(PBYTE module)
 {
-    if (module)
+    if (module) {
+        reloc_lazy_release(module);
         return VirtualFreeEx(GetCurrentProcess(), module, 0, MEM_RELEASE);
+    }
 
     return FALSE;
 }
@@ -0,0 +1,952 @@
+/*
+*  File: reloc.c
+*
+*  Created on: Oct 18, 2026
+*
+*  Modified on: Oct 18, 2026
+*
+*      Project: WinDepends.Core
+*
+*      Author: WinDepends dev team
+*/
+
+#include "core.h"
+
+#define RELOC_OFFSET_MASK   0x0fff
+#define RELOC_TYPE_SHIFT    12
+
+//
+// Lazily relocated images of all client sessions. Bounds cover all registered
+// images and are read without the lock, so unrelated faults do not serialize
+// on it; they are updated under the lock before pages are guarded.
+//
+static SRWLOCK g_reloc_lazy_lock = SRWLOCK_INIT;
+static PRELOC_LAZY_IMAGE g_reloc_lazy_list = NULL;
+static PVOID g_reloc_lazy_handler = NULL;
+static PVOID g_reloc_lazy_low = NULL;
+static PVOID g_reloc_lazy_high = NULL;
+
+#ifdef WDEP_FUZZ_MODE
+
+/*
+* reloc_apply_legacy
+*
+* Purpose:
+*
+* Previous two pass relocation routine, validate whole directory then apply.
+* Kept only as the reference for reloc_benchmark.
+*
+*/
+static BOOL reloc_apply_legacy(
+    _In_ LPVOID MappedView,
+    _In_ LPVOID RebaseFrom,
+    _In_ PIMAGE_BASE_RELOCATION RelData,
+    _In_ ULONG RelDataSize)
+{
+    ULONG       p = 0, block_size;
+    LPWORD      entry;
+    LONG64      delta = (ULONG_PTR)MappedView - (ULONG_PTR)RebaseFrom;
+    LONG64      rel, * ptr;
+
+    PIMAGE_BASE_RELOCATION next_block, RelData0 = RelData;
+
+    if (RelDataSize < sizeof(IMAGE_BASE_RELOCATION))
+        return FALSE;
+
+    /* validate */
+    while (p < RelDataSize)
+    {
+        block_size = RelData->SizeOfBlock;
+        if ((block_size < sizeof(IMAGE_BASE_RELOCATION)) ||
+            (p + block_size > RelDataSize) ||
+            (block_size % sizeof(WORD) != 0))
+        {
+            return FALSE;
+        }
+
+        next_block = (PIMAGE_BASE_RELOCATION)((LPBYTE)RelData + block_size);
+        for (entry = (LPWORD)(RelData + 1); entry < (LPWORD)next_block; ++entry)
+        {
+            switch (*entry >> 12)
+            {
+            case IMAGE_REL_BASED_HIGHLOW:
+            case IMAGE_REL_BASED_DIR64:
+            case IMAGE_REL_BASED_ABSOLUTE:
+                break;
+            default:
+                /* unsupported reloc found */
+                return FALSE;
+            }
+        }
+        p += block_size;
+        RelData = next_block;
+    }
+
+    if (p != RelDataSize)
+        return FALSE;
+
+    /* do relocate */
+    p = 0;
+    RelData = RelData0;
+    while (p < RelDataSize)
+    {
+        block_size = RelData->SizeOfBlock;
+        next_block = (PIMAGE_BASE_RELOCATION)((LPBYTE)RelData + block_size);
+        for (entry = (LPWORD)(RelData + 1); entry < (LPWORD)next_block; ++entry)
+        {
+            switch (*entry >> 12)
+            {
+            case IMAGE_REL_BASED_HIGHLOW:
+                ptr = (LONG64*)((LPBYTE)MappedView + RelData->VirtualAddress + (*entry & 0x0fff));
+                rel = *(PULONG)ptr; // need zero extend value here (movzx)
+                rel += delta;
+                *(PLONG)ptr = (LONG)rel;
+                break;
+            case IMAGE_REL_BASED_DIR64:
+                ptr = (LONG64*)((LPBYTE)MappedView + RelData->VirtualAddress + (*entry & 0x0fff));
+                rel = *ptr;
+                rel += delta;
+                *ptr = rel;
+                break;
+            case IMAGE_REL_BASED_ABSOLUTE:
+                // no relocation needed
+                break;
+            default:
+                /* unsupported reloc found */
+                return FALSE;
+            }
+        }
+        p += block_size;
+        RelData = next_block;
+    }
+
+    return TRUE;
+}
+
+#endif /* WDEP_FUZZ_MODE */
+
+/*
+* reloc_target_size
+*
+* Purpose:
+*
+* Return number of bytes patched by the relocation type, FALSE if type
+* is not supported for the machine. ARM64 images only use DIR64.
+*
+*/
+static __forceinline BOOL reloc_target_size(
+    _In_ WORD type,
+    _In_ WORD machine,
+    _Out_ PDWORD size
+)
+{
+    switch (type) {
+    case IMAGE_REL_BASED_ABSOLUTE:
+        *size = 0;
+        return TRUE;
+    case IMAGE_REL_BASED_HIGH:
+    case IMAGE_REL_BASED_LOW:
+        *size = sizeof(WORD);
+        return TRUE;
+    case IMAGE_REL_BASED_HIGHLOW:
+        *size = sizeof(ULONG32);
+        return TRUE;
+    case IMAGE_REL_BASED_DIR64:
+        *size = sizeof(ULONG64);
+        return TRUE;
+    case IMAGE_REL_BASED_ARM_MOV32:
+    case IMAGE_REL_BASED_THUMB_MOV32:
+        // MOVW followed by MOVT, type value is reused by other machines.
+        if (machine == IMAGE_FILE_MACHINE_ARM ||
+            machine == IMAGE_FILE_MACHINE_ARMNT ||
+            machine == IMAGE_FILE_MACHINE_THUMB)
+        {
+            *size = 2 * sizeof(ULONG32);
+            return TRUE;
+        }
+        break;
+    default:
+        break;
+    }
+
+    *size = 0;
+    return FALSE;
+}
+
+/*
+* reloc_entry_target
+*
+* Purpose:
+*
+* Validate relocation entry, return address of its target or NULL
+* if entry type is not supported or target is outside of the image.
+*
+*/
+static __forceinline PBYTE reloc_entry_target(
+    _In_ PBYTE image,
+    _In_ DWORD image_size,
+    _In_ WORD machine,
+    _In_ PRELOC_PAGE page,
+    _In_ WORD entry
+)
+{
+    DWORD size, offset = entry & RELOC_OFFSET_MASK;
+
+    if (!reloc_target_size(entry >> RELOC_TYPE_SHIFT, machine, &size))
+        return NULL;
+
+    if (size && !valid_image_range((ULONG64)page->PageRva + offset, size, 0, image_size))
+        return NULL;
+
+    return image + page->PageRva + offset;
+}
+
+/*
+* arm_mov32_get
+*
+* Purpose:
+*
+* Decode 32 bit value loaded by ARM mode MOVW/MOVT pair.
+*
+*/
+static __forceinline ULONG32 arm_mov32_get(
+    _In_ PBYTE target
+)
+{
+    ULONG32 movw = *(UNALIGNED ULONG32*)target;
+    ULONG32 movt = *(UNALIGNED ULONG32*)(target + sizeof(ULONG32));
+
+    return (((movw >> 4) & 0xf000) | (movw & 0x0fff)) |
+        ((((movt >> 4) & 0xf000) | (movt & 0x0fff)) << 16);
+}
+
+/*
+* arm_mov32_set
+*
+* Purpose:
+*
+* Encode 32 bit value into ARM mode MOVW/MOVT pair.
+*
+*/
+static __forceinline VOID arm_mov32_set(
+    _In_ PBYTE target,
+    _In_ ULONG32 value
+)
+{
+    UNALIGNED ULONG32* movw = (UNALIGNED ULONG32*)target;
+    UNALIGNED ULONG32* movt = (UNALIGNED ULONG32*)(target + sizeof(ULONG32));
+    ULONG32 imm = value & 0xffff;
+
+    *movw = (*movw & ~0x000f0fffU) | ((imm & 0xf000) << 4) | (imm & 0x0fff);
+    imm = value >> 16;
+    *movt = (*movt & ~0x000f0fffU) | ((imm & 0xf000) << 4) | (imm & 0x0fff);
+}
+
+/*
+* thumb_mov_get
+*
+* Purpose:
+*
+* Decode 16 bit immediate of Thumb-2 MOVW/MOVT (T3 encoding).
+*
+*/
+static __forceinline ULONG32 thumb_mov_get(
+    _In_ PBYTE target
+)
+{
+    WORD h0 = *(UNALIGNED WORD*)target;
+    WORD h1 = *(UNALIGNED WORD*)(target + sizeof(WORD));
+
+    return ((h0 & 0x000f) << 12) | ((h0 & 0x0400) << 1) | ((h1 & 0x7000) >> 4) | (h1 & 0x00ff);
+}
+
+/*
+* thumb_mov_set
+*
+* Purpose:
+*
+* Encode 16 bit immediate into Thumb-2 MOVW/MOVT (T3 encoding).
+*
+*/
+static __forceinline VOID thumb_mov_set(
+    _In_ PBYTE target,
+    _In_ ULONG32 imm
+)
+{
+    UNALIGNED WORD* h0 = (UNALIGNED WORD*)target;
+    UNALIGNED WORD* h1 = (UNALIGNED WORD*)(target + sizeof(WORD));
+
+    *h0 = (WORD)((*h0 & ~0x040f) | ((imm >> 12) & 0x000f) | ((imm >> 1) & 0x0400));
+    *h1 = (WORD)((*h1 & ~0x70ff) | ((imm << 4) & 0x7000) | (imm & 0x00ff));
+}
+
+/*
+* reloc_fixup
+*
+* Purpose:
+*
+* Apply relocation to the target, or revert it when undo is set.
+* Every adjustment is modular so revert is exact.
+*
+*/
+static __forceinline VOID reloc_fixup(
+    _In_ PBYTE target,
+    _In_ WORD type,
+    _In_ ULONG64 delta,
+    _In_ BOOL undo
+)
+{
+    ULONG32 value;
+    ULONG64 adjust = (type == IMAGE_REL_BASED_HIGH) ? (delta >> 16) : delta;
+
+    if (undo)
+        adjust = 0 - adjust;
+
+    switch (type) {
+    case IMAGE_REL_BASED_HIGH:
+    case IMAGE_REL_BASED_LOW:
+        *(UNALIGNED WORD*)target = (WORD)(*(UNALIGNED WORD*)target + (WORD)adjust);
+        break;
+    case IMAGE_REL_BASED_HIGHLOW:
+        *(UNALIGNED ULONG32*)target += (ULONG32)adjust;
+        break;
+    case IMAGE_REL_BASED_DIR64:
+        *(UNALIGNED ULONG64*)target += adjust;
+        break;
+    case IMAGE_REL_BASED_ARM_MOV32:
+        arm_mov32_set(target, arm_mov32_get(target) + (ULONG32)adjust);
+        break;
+    case IMAGE_REL_BASED_THUMB_MOV32:
+        value = thumb_mov_get(target) | (thumb_mov_get(target + sizeof(ULONG32)) << 16);
+        value += (ULONG32)adjust;
+        thumb_mov_set(target, value & 0xffff);
+        thumb_mov_set(target + sizeof(ULONG32), value >> 16);
+        break;
+    default:
+        // IMAGE_REL_BASED_ABSOLUTE, padding.
+        break;
+    }
+}
+
+/*
+* reloc_page_compare
+*
+* Purpose:
+*
+* qsort callback, page RVA order.
+*
+*/
+int __cdecl reloc_page_compare(
+    _In_ const void* first,
+    _In_ const void* second
+)
+{
+    DWORD a = ((PRELOC_PAGE)first)->PageRva;
+    DWORD b = ((PRELOC_PAGE)second)->PageRva;
+
+    return (a > b) - (a < b);
+}
+
+/*
+* reloc_decode
+*
+* Purpose:
+*
+* Split relocation directory into per-page list, checking block layout only.
+* Returns number of pages with entries or -1 if directory is malformed.
+*
+*/
+static LONG reloc_decode(
+    _In_ PBYTE image,
+    _In_ DWORD reloc_rva,
+    _In_ DWORD reloc_size,
+    _Out_writes_(reloc_size / sizeof(IMAGE_BASE_RELOCATION)) PRELOC_PAGE pages
+)
+{
+    PIMAGE_BASE_RELOCATION block;
+    DWORD offset, block_size, count;
+    LONG page_count = 0;
+    BOOL sorted = TRUE;
+
+    for (offset = 0; offset < reloc_size; offset += block_size) {
+
+        if (reloc_size - offset < sizeof(IMAGE_BASE_RELOCATION))
+            return -1;
+
+        block = (PIMAGE_BASE_RELOCATION)(image + reloc_rva + offset);
+        block_size = block->SizeOfBlock;
+        if ((block_size < sizeof(IMAGE_BASE_RELOCATION)) ||
+            (block_size > reloc_size - offset) ||
+            (block_size % sizeof(WORD) != 0))
+        {
+            return -1;
+        }
+
+        count = (block_size - sizeof(IMAGE_BASE_RELOCATION)) / sizeof(WORD);
+        if (count == 0)
+            continue;
+
+        if (page_count && block->VirtualAddress < pages[page_count - 1].PageRva)
+            sorted = FALSE;
+
+        pages[page_count].PageRva = block->VirtualAddress;
+        pages[page_count].Count = count;
+        pages[page_count].Entries = (const WORD*)(block + 1);
+        page_count++;
+    }
+
+    // Linkers emit pages in ascending order, sort only if someone did not.
+    if (!sorted) {
+        qsort(pages, page_count, sizeof(RELOC_PAGE), reloc_page_compare);
+    }
+
+    return page_count;
+}
+
+/*
+* reloc_rollback
+*
+* Purpose:
+*
+* Revert entries applied before the failing one, in reverse order.
+*
+*/
+static VOID reloc_rollback(
+    _In_ PBYTE image,
+    _In_ DWORD image_size,
+    _In_ WORD machine,
+    _In_ ULONG64 delta,
+    _In_ PRELOC_PAGE pages,
+    _In_ LONG page_index,
+    _In_ DWORD entry_index
+)
+{
+    PBYTE target;
+    WORD entry;
+
+    for (;;) {
+        while (entry_index > 0) {
+            entry = pages[page_index].Entries[--entry_index];
+            target = reloc_entry_target(image, image_size, machine, &pages[page_index], entry);
+            if (target) {
+                reloc_fixup(target, entry >> RELOC_TYPE_SHIFT, delta, TRUE);
+            }
+        }
+
+        if (page_index == 0)
+            break;
+
+        page_index--;
+        entry_index = pages[page_index].Count;
+    }
+}
+
+/*
+* reloc_apply
+*
+* Purpose:
+*
+* Relocate image loaded at image to its new address.
+* Directory is decoded once into page list, then every entry is validated
+* and applied in a single page ordered walk. Image is left unmodified on failure.
+*
+*/
+BOOL reloc_apply(
+    _In_ PBYTE image,
+    _In_ DWORD image_size,
+    _In_ WORD machine,
+    _In_ ULONG64 image_base,
+    _In_ DWORD reloc_rva,
+    _In_ DWORD reloc_size
+)
+{
+    PRELOC_PAGE pages;
+    PBYTE target;
+    LONG page_count, i;
+    DWORD j;
+    WORD entry;
+    ULONG64 delta = (ULONG64)(ULONG_PTR)image - image_base;
+
+    if (reloc_size < sizeof(IMAGE_BASE_RELOCATION) ||
+        !valid_image_range((ULONG64)reloc_rva, reloc_size, 0, image_size))
+    {
+        return FALSE;
+    }
+
+    pages = (PRELOC_PAGE)heap_malloc(NULL, (reloc_size / sizeof(IMAGE_BASE_RELOCATION)) * sizeof(RELOC_PAGE));
+    if (pages == NULL)
+        return FALSE;
+
+    page_count = reloc_decode(image, reloc_rva, reloc_size, pages);
+
+    for (i = 0; i < page_count; i++) {
+        for (j = 0; j < pages[i].Count; j++) {
+
+            entry = pages[i].Entries[j];
+            target = reloc_entry_target(image, image_size, machine, &pages[i], entry);
+            if (target == NULL) {
+                reloc_rollback(image, image_size, machine, delta, pages, i, j);
+                heap_free(NULL, pages);
+                return FALSE;
+            }
+
+            reloc_fixup(target, entry >> RELOC_TYPE_SHIFT, delta, FALSE);
+        }
+    }
+
+    heap_free(NULL, pages);
+    return (page_count >= 0);
+}
+
+/*
+* reloc_lazy_free
+*
+* Purpose:
+*
+* Release lazy relocation index memory.
+*
+*/
+static VOID reloc_lazy_free(
+    _In_ PRELOC_LAZY_IMAGE lazy
+)
+{
+    if (lazy->PageStart) {
+        heap_free(NULL, lazy->PageStart);
+    }
+    if (lazy->PageState) {
+        heap_free(NULL, lazy->PageState);
+    }
+    if (lazy->Entries) {
+        heap_free(NULL, lazy->Entries);
+    }
+    heap_free(NULL, lazy);
+}
+
+/*
+* reloc_lazy_materialize
+*
+* Purpose:
+*
+* Make page writable and apply its pending fixups, lazy list lock must be held.
+* Fixup crossing a page boundary needs both pages, so pending neighbours
+* linked by such fixups are relocated together, in either direction.
+*
+*/
+static BOOL reloc_lazy_materialize(
+    _In_ PRELOC_LAZY_IMAGE lazy,
+    _In_ DWORD page
+)
+{
+    DWORD first = page, last = page, p, i, target_rva;
+    ULONG old_protect;
+
+    while ((lazy->PageState[first] & RELOC_PAGE_STRADDLE_IN) &&
+        (first > 0) &&
+        (lazy->PageState[first - 1] & RELOC_PAGE_PENDING))
+    {
+        first--;
+    }
+
+    while ((lazy->PageState[last] & RELOC_PAGE_STRADDLE) &&
+        (last + 1 < lazy->PageCount) &&
+        (lazy->PageState[last + 1] & RELOC_PAGE_PENDING))
+    {
+        last++;
+    }
+
+    if (!VirtualProtect(lazy->Image + (SIZE_T)first * PAGE_SIZE,
+        (SIZE_T)(last - first + 1) * PAGE_SIZE,
+        PAGE_READWRITE,
+        &old_protect))
+    {
+        return FALSE;
+    }
+
+    for (p = first; p <= last; p++) {
+        lazy->PageState[p] &= ~RELOC_PAGE_PENDING;
+        lazy->PendingPages--;
+        lazy->RelocatedPages++;
+
+        for (i = lazy->PageStart[p]; i < lazy->PageStart[p + 1]; i++) {
+            // Straddling fixup is also indexed under the next page, apply it once.
+            target_rva = lazy->Entries[i].TargetRva;
+            if (target_rva / PAGE_SIZE == p) {
+                reloc_fixup(lazy->Image + target_rva, lazy->Entries[i].Type, lazy->Delta, FALSE);
+            }
+        }
+    }
+
+    return TRUE;
+}
+
+/*
+* reloc_lazy_update_bounds
+*
+* Purpose:
+*
+* Recalculate address range covered by registered images, lazy list lock must be held.
+* Returns handler to be removed by the caller once the list is empty, NULL otherwise.
+*
+*/
+static PVOID reloc_lazy_update_bounds(
+    VOID
+)
+{
+    PRELOC_LAZY_IMAGE lazy;
+    PBYTE low = NULL, high = NULL, end;
+    PVOID handler = NULL;
+
+    for (lazy = g_reloc_lazy_list; lazy != NULL; lazy = lazy->Next) {
+        end = lazy->Image + (SIZE_T)lazy->PageCount * PAGE_SIZE;
+        if (low == NULL || lazy->Image < low)
+            low = lazy->Image;
+        if (end > high)
+            high = end;
+    }
+
+    WritePointerRelease(&g_reloc_lazy_low, low);
+    WritePointerRelease(&g_reloc_lazy_high, high);
+
+    if (g_reloc_lazy_list == NULL) {
+        handler = g_reloc_lazy_handler;
+        g_reloc_lazy_handler = NULL;
+    }
+
+    return handler;
+}
+
+/*
+* reloc_lazy_exception_handler
+*
+* Purpose:
+*
+* Vectored handler, relocate page of a lazily relocated image on first touch.
+*
+*/
+static LONG CALLBACK reloc_lazy_exception_handler(
+    _In_ PEXCEPTION_POINTERS ExceptionInfo
+)
+{
+    PEXCEPTION_RECORD record = ExceptionInfo->ExceptionRecord;
+    PRELOC_LAZY_IMAGE lazy;
+    ULONG_PTR address;
+    DWORD page;
+    BOOL handled = FALSE;
+
+    if (record->ExceptionCode != EXCEPTION_ACCESS_VIOLATION ||
+        record->NumberParameters < 2)
+    {
+        return EXCEPTION_CONTINUE_SEARCH;
+    }
+
+    address = record->ExceptionInformation[1];
+
+    // Faults outside of all lazily relocated images are not ours, leave without the lock.
+    if (address < (ULONG_PTR)ReadPointerAcquire(&g_reloc_lazy_low) ||
+        address >= (ULONG_PTR)ReadPointerAcquire(&g_reloc_lazy_high))
+    {
+        return EXCEPTION_CONTINUE_SEARCH;
+    }
+
+    AcquireSRWLockExclusive(&g_reloc_lazy_lock);
+
+    for (lazy = g_reloc_lazy_list; lazy != NULL; lazy = lazy->Next) {
+        if (address >= (ULONG_PTR)lazy->Image &&
+            address - (ULONG_PTR)lazy->Image < (ULONG_PTR)lazy->PageCount * PAGE_SIZE)
+        {
+            page = (DWORD)((address - (ULONG_PTR)lazy->Image) / PAGE_SIZE);
+            if (lazy->PageState[page] & RELOC_PAGE_PENDING) {
+                handled = reloc_lazy_materialize(lazy, page);
+            }
+            break;
+        }
+    }
+
+    ReleaseSRWLockExclusive(&g_reloc_lazy_lock);
+
+    return handled ? EXCEPTION_CONTINUE_EXECUTION : EXCEPTION_CONTINUE_SEARCH;
+}
+
+/*
+* reloc_lazy_init
+*
+* Purpose:
+*
+* Validate relocation directory and index fixups by target page, then
+* protect pages with fixups so they are relocated only when first read.
+* Image is left unmodified on failure.
+*
+*/
+BOOL reloc_lazy_init(
+    _In_ PBYTE image,
+    _In_ DWORD image_size,
+    _In_ WORD machine,
+    _In_ ULONG64 image_base,
+    _In_ DWORD reloc_rva,
+    _In_ DWORD reloc_size
+)
+{
+    PRELOC_LAZY_IMAGE lazy = NULL;
+    PRELOC_PAGE pages = NULL;
+    PVOID unused_handler = NULL;
+    PBYTE target;
+    LONG page_count, i;
+    DWORD j, p, last, size, target_rva, entry_count = 0;
+    ULONG old_protect;
+    WORD entry, type;
+    BOOL result = FALSE, registered = FALSE;
+
+    if (reloc_size < sizeof(IMAGE_BASE_RELOCATION) ||
+        !valid_image_range((ULONG64)reloc_rva, reloc_size, 0, image_size))
+    {
+        return FALSE;
+    }
+
+    __try {
+
+        lazy = (PRELOC_LAZY_IMAGE)heap_calloc(NULL, sizeof(RELOC_LAZY_IMAGE));
+        if (lazy == NULL)
+            __leave;
+
+        lazy->Image = image;
+        lazy->ImageSize = image_size;
+        lazy->PageCount = PAGE_ALIGN(image_size) / PAGE_SIZE;
+        lazy->Delta = (ULONG64)(ULONG_PTR)image - image_base;
+        lazy->PageStart = (PDWORD)heap_calloc(NULL, ((SIZE_T)lazy->PageCount + 1) * sizeof(DWORD));
+        lazy->PageState = (PBYTE)heap_calloc(NULL, lazy->PageCount);
+        pages = (PRELOC_PAGE)heap_malloc(NULL, (reloc_size / sizeof(IMAGE_BASE_RELOCATION)) * sizeof(RELOC_PAGE));
+        if (lazy->PageStart == NULL || lazy->PageState == NULL || pages == NULL)
+            __leave;
+
+        page_count = reloc_decode(image, reloc_rva, reloc_size, pages);
+        if (page_count < 0)
+            __leave;
+
+        // Validate every entry and count fixups per target page, image is not touched yet.
+        for (i = 0; i < page_count; i++) {
+            for (j = 0; j < pages[i].Count; j++) {
+                entry = pages[i].Entries[j];
+                target = reloc_entry_target(image, image_size, machine, &pages[i], entry);
+                if (target == NULL)
+                    __leave;
+
+                reloc_target_size(entry >> RELOC_TYPE_SHIFT, machine, &size);
+                if (size == 0)
+                    continue;
+
+                target_rva = (DWORD)(target - image);
+                p = target_rva / PAGE_SIZE;
+                lazy->PageStart[p + 1]++;
+                entry_count++;
+
+                // Target is inside the image, so the next page exists.
+                if ((target_rva % PAGE_SIZE) + size > PAGE_SIZE) {
+                    lazy->PageState[p] |= RELOC_PAGE_STRADDLE;
+                    lazy->PageState[p + 1] |= RELOC_PAGE_STRADDLE_IN;
+                    lazy->PageStart[p + 2]++;
+                    entry_count++;
+                }
+            }
+        }
+
+        if (entry_count == 0) {
+            result = TRUE;
+            __leave;
+        }
+
+        lazy->Entries = (PRELOC_LAZY_ENTRY)heap_malloc(NULL, (SIZE_T)entry_count * sizeof(RELOC_LAZY_ENTRY));
+        if (lazy->Entries == NULL)
+            __leave;
+
+        // Counting sort by target page, PageStart[p] is used as fill cursor of page p - 1.
+        for (p = 0; p < lazy->PageCount; p++) {
+            lazy->PageStart[p + 1] += lazy->PageStart[p];
+        }
+
+        for (i = 0; i < page_count; i++) {
+            for (j = 0; j < pages[i].Count; j++) {
+                entry = pages[i].Entries[j];
+                type = entry >> RELOC_TYPE_SHIFT;
+                reloc_target_size(type, machine, &size);
+                if (size == 0)
+                    continue;
+
+                target_rva = pages[i].PageRva + (entry & RELOC_OFFSET_MASK);
+                for (p = target_rva / PAGE_SIZE; p <= (target_rva + size - 1) / PAGE_SIZE; p++) {
+                    lazy->Entries[lazy->PageStart[p]].TargetRva = target_rva;
+                    lazy->Entries[lazy->PageStart[p]].Type = type;
+                    lazy->Entries[lazy->PageStart[p]].Reserved = 0;
+                    lazy->PageStart[p]++;
+                }
+            }
+        }
+
+        // Cursors now hold end of each page, shift them back to starts.
+        for (p = lazy->PageCount; p > 0; p--) {
+            lazy->PageStart[p] = lazy->PageStart[p - 1];
+        }
+        lazy->PageStart[0] = 0;
+
+        for (p = 0; p < lazy->PageCount; p++) {
+            if (lazy->PageStart[p + 1] > lazy->PageStart[p]) {
+                lazy->PageState[p] |= RELOC_PAGE_PENDING;
+                lazy->PendingPages++;
+            }
+        }
+
+        AcquireSRWLockExclusive(&g_reloc_lazy_lock);
+
+        if (g_reloc_lazy_handler == NULL) {
+            g_reloc_lazy_handler = AddVectoredExceptionHandler(1, reloc_lazy_exception_handler);
+        }
+
+        if (g_reloc_lazy_handler) {
+
+            lazy->Next = g_reloc_lazy_list;
+            g_reloc_lazy_list = lazy;
+            registered = TRUE;
+            reloc_lazy_update_bounds();
+
+            // Guard runs of pending pages.
+            for (p = 0; p < lazy->PageCount; p = last) {
+                last = p + 1;
+                if ((lazy->PageState[p] & RELOC_PAGE_PENDING) == 0)
+                    continue;
+
+                while (last < lazy->PageCount && (lazy->PageState[last] & RELOC_PAGE_PENDING))
+                    last++;
+
+                if (!VirtualProtect(image + (SIZE_T)p * PAGE_SIZE,
+                    (SIZE_T)(last - p) * PAGE_SIZE,
+                    PAGE_NOACCESS,
+                    &old_protect))
+                {
+                    VirtualProtect(image, (SIZE_T)lazy->PageCount * PAGE_SIZE, PAGE_READWRITE, &old_protect);
+                    g_reloc_lazy_list = lazy->Next;
+                    registered = FALSE;
+                    unused_handler = reloc_lazy_update_bounds();
+                    break;
+                }
+            }
+
+            result = registered;
+        }
+
+        ReleaseSRWLockExclusive(&g_reloc_lazy_lock);
+
+        if (unused_handler) {
+            RemoveVectoredExceptionHandler(unused_handler);
+        }
+
+        DEBUG_PRINT("reloc_lazy_init: %lu fixups over %lu pages deferred\r\n", entry_count, lazy->PendingPages);
+
+    }
+    __finally {
+        if (pages) {
+            heap_free(NULL, pages);
+        }
+        if (lazy && !registered) {
+            reloc_lazy_free(lazy);
+        }
+    }
+
+    return result;
+}
+
+/*
+* reloc_lazy_release
+*
+* Purpose:
+*
+* Forget lazily relocated image before its memory is released.
+*
+*/
+VOID reloc_lazy_release(
+    _In_ PBYTE image
+)
+{
+    PRELOC_LAZY_IMAGE lazy = NULL, * link;
+    PVOID unused_handler = NULL;
+
+    AcquireSRWLockExclusive(&g_reloc_lazy_lock);
+
+    for (link = &g_reloc_lazy_list; *link != NULL; link = &(*link)->Next) {
+        if ((*link)->Image == image) {
+            lazy = *link;
+            *link = lazy->Next;
+            unused_handler = reloc_lazy_update_bounds();
+            break;
+        }
+    }
+
+    ReleaseSRWLockExclusive(&g_reloc_lazy_lock);
+
+    // Last lazy image is gone, stop intercepting access violations of the process.
+    if (unused_handler) {
+        RemoveVectoredExceptionHandler(unused_handler);
+    }
+
+    if (lazy) {
+        DEBUG_PRINT("reloc_lazy_release: %lu of %lu pages relocated\r\n",
+            lazy->RelocatedPages, lazy->RelocatedPages + lazy->PendingPages);
+        reloc_lazy_free(lazy);
+    }
+}
+
+#ifdef WDEP_FUZZ_MODE
+
+/*
+* reloc_benchmark
+*
+* Purpose:
+*
+* Time reloc_apply against the previous two pass routine on the same image.
+* Returns FALSE if either routine rejects the image, legacy routine does not
+* check target bounds so it only runs after reloc_apply accepted the image.
+*
+*/
+BOOL reloc_benchmark(
+    _In_ PBYTE image,
+    _In_ DWORD image_size,
+    _In_ WORD machine,
+    _In_ ULONG64 image_base,
+    _In_ DWORD reloc_rva,
+    _In_ DWORD reloc_size,
+    _In_ ULONG iterations,
+    _Out_ PLARGE_INTEGER legacy_time,
+    _Out_ PLARGE_INTEGER engine_time
+)
+{
+    ULONG i;
+    LARGE_INTEGER start_count, end_count;
+    LPVOID rebase_from = (LPVOID)(ULONG_PTR)image_base;
+    PIMAGE_BASE_RELOCATION reloc_data = (PIMAGE_BASE_RELOCATION)(image + reloc_rva);
+
+    legacy_time->QuadPart = 0;
+    engine_time->QuadPart = 0;
+
+    // Each run shifts targets by the same delta again, values are not used.
+    if (!reloc_apply(image, image_size, machine, image_base, reloc_rva, reloc_size))
+        return FALSE;
+
+    if (!reloc_apply_legacy(image, rebase_from, reloc_data, reloc_size))
+        return FALSE;
+
+    QueryPerformanceCounter(&start_count);
+    for (i = 0; i < iterations; i++) {
+        reloc_apply_legacy(image, rebase_from, reloc_data, reloc_size);
+    }
+    QueryPerformanceCounter(&end_count);
+    legacy_time->QuadPart = end_count.QuadPart - start_count.QuadPart;
+
+    QueryPerformanceCounter(&start_count);
+    for (i = 0; i < iterations; i++) {
+        reloc_apply(image, image_size, machine, image_base, reloc_rva, reloc_size);
+    }
+    QueryPerformanceCounter(&end_count);
+    engine_time->QuadPart = end_count.QuadPart - start_count.QuadPart;
+
+    return TRUE;
+}
+
+#endif /* WDEP_FUZZ_MODE */
@@ -0,0 +1,96 @@
+/*
+*  File: reloc.h
+*
+*  Created on: Oct 18, 2026
+*
+*  Modified on: Oct 18, 2026
+*
+*      Project: WinDepends.Core
+*
+*      Author: WinDepends dev team
+*/
+
+#pragma once
+
+#ifndef _RELOC_H_
+#define _RELOC_H_
+
+//
+// Base relocation blocks decoded into per-page list, sorted by page RVA.
+// Entries point into the image .reloc data, no copy is made.
+//
+typedef struct _RELOC_PAGE {
+    DWORD PageRva;
+    DWORD Count;
+    const WORD* Entries;
+} RELOC_PAGE, * PRELOC_PAGE;
+
+//
+// Lazily relocated image. Fixups are indexed by the image page of their
+// target, pages with pending fixups are kept PAGE_NOACCESS until first
+// touched, then relocated from the vectored exception handler.
+// Fixup crossing a page boundary is indexed under both pages and applied
+// only from the page it starts in.
+//
+typedef struct _RELOC_LAZY_ENTRY {
+    DWORD TargetRva;
+    WORD Type;
+    WORD Reserved;
+} RELOC_LAZY_ENTRY, * PRELOC_LAZY_ENTRY;
+
+typedef struct _RELOC_LAZY_IMAGE {
+    struct _RELOC_LAZY_IMAGE* Next;
+    PBYTE Image;
+    DWORD ImageSize;
+    DWORD PageCount;
+    ULONG64 Delta;
+    PDWORD PageStart;               // PageCount + 1 indices into Entries
+    PRELOC_LAZY_ENTRY Entries;
+    PBYTE PageState;                // RELOC_PAGE_xxx flags
+    DWORD PendingPages;
+    DWORD RelocatedPages;
+} RELOC_LAZY_IMAGE, * PRELOC_LAZY_IMAGE;
+
+#define RELOC_PAGE_PENDING      0x01
+#define RELOC_PAGE_STRADDLE     0x02    // fixup crosses into the next page
+#define RELOC_PAGE_STRADDLE_IN  0x04    // fixup of the previous page crosses into this one
+
+BOOL reloc_apply(
+    _In_ PBYTE image,
+    _In_ DWORD image_size,
+    _In_ WORD machine,
+    _In_ ULONG64 image_base,
+    _In_ DWORD reloc_rva,
+    _In_ DWORD reloc_size
+);
+
+BOOL reloc_lazy_init(
+    _In_ PBYTE image,
+    _In_ DWORD image_size,
+    _In_ WORD machine,
+    _In_ ULONG64 image_base,
+    _In_ DWORD reloc_rva,
+    _In_ DWORD reloc_size
+);
+
+VOID reloc_lazy_release(
+    _In_ PBYTE image
+);
+
+#ifdef WDEP_FUZZ_MODE
+
+BOOL reloc_benchmark(
+    _In_ PBYTE image,
+    _In_ DWORD image_size,
+    _In_ WORD machine,
+    _In_ ULONG64 image_base,
+    _In_ DWORD reloc_rva,
+    _In_ DWORD reloc_size,
+    _In_ ULONG iterations,
+    _Out_ PLARGE_INTEGER legacy_time,
+    _Out_ PLARGE_INTEGER engine_time
+);
+
+#endif /* WDEP_FUZZ_MODE */
+
+#endif /* _RELOC_H_ */
@@ -0,0 +1,315 @@
+/*
+*  File: stats.c
+*
+*  Created on: Oct 18, 2026
+*
+*  Modified on: Oct 18, 2026
+*
+*      Project: WinDepends.Core
+*
+*      Author: WinDepends dev team
+*/
+
+#include "core.h"
+
+//
+// Counters of the command being handled by the current client thread,
+// merged into the server wide table when command completes.
+//
+typedef struct _STATS_THREAD {
+    LARGE_INTEGER StartCount;
+    ULONG64 BytesRead;
+    ULONG64 BytesSent;
+    ULONG64 Allocations;
+    PSTATS_TRACE Trace;             // NULL unless session trace is enabled
+} STATS_THREAD;
+
+static __declspec(thread) STATS_THREAD g_stats_thread;
+static STATS_COUNTERS g_stats[STATS_MAX_COMMANDS];
+static ULONGLONG g_stats_start_tick;
+
+/*
+* stats_init
+*
+* Purpose:
+*
+* Remember server start time, must be called once during server init.
+*
+*/
+VOID stats_init(
+    VOID
+)
+{
+    g_stats_start_tick = GetTickCount64();
+}
+
+/*
+* stats_command_begin
+*
+* Purpose:
+*
+* Start measuring command on the current thread.
+*
+*/
+VOID stats_command_begin(
+    VOID
+)
+{
+    g_stats_thread.BytesRead = 0;
+    g_stats_thread.BytesSent = 0;
+    g_stats_thread.Allocations = 0;
+    QueryPerformanceCounter(&g_stats_thread.StartCount);
+}
+
+/*
+* stats_qpc_to_us
+*
+* Purpose:
+*
+* Convert performance counter value to microseconds without overflow.
+*
+*/
+LONG64 stats_qpc_to_us(
+    _In_ LONG64 count
+)
+{
+    LONG64 frequency = gsup.PerformanceFrequency.QuadPart;
+
+    return (count / frequency) * 1000000 + (count % frequency) * 1000000 / frequency;
+}
+
+/*
+* stats_command_end
+*
+* Purpose:
+*
+* Add measured command to the server wide counters.
+*
+*/
+VOID stats_command_end(
+    _In_ cmd_entry_type type
+)
+{
+    LARGE_INTEGER end_count;
+    LONG64 elapsed, max_time;
+    ULONG64 value;
+    ULONG bucket = 0;
+    PSTATS_COUNTERS counters;
+    PSTATS_TRACE trace;
+    PSTATS_TRACE_EVENT event;
+
+    if ((ULONG)type >= STATS_MAX_COMMANDS)
+        return;
+
+    QueryPerformanceCounter(&end_count);
+    elapsed = (LONG64)((end_count.QuadPart - g_stats_thread.StartCount.QuadPart) * 1000000 /
+        gsup.PerformanceFrequency.QuadPart);
+
+    for (value = (ULONG64)elapsed; value > 1 && bucket < STATS_LATENCY_BUCKETS - 1; value >>= 1)
+        bucket++;
+
+    trace = g_stats_thread.Trace;
+    if (trace && type != ce_trace) {
+        if (trace->Count < STATS_TRACE_MAX_EVENTS) {
+            event = &trace->Events[trace->Count++];
+            event->Type = type;
+            event->Start = stats_qpc_to_us(g_stats_thread.StartCount.QuadPart);
+            event->Duration = elapsed;
+            event->BytesSent = (LONG64)g_stats_thread.BytesSent;
+        }
+        else {
+            trace->Dropped++;
+        }
+    }
+
+    counters = &g_stats[type];
+
+    InterlockedIncrement64(&counters->Calls);
+    InterlockedAdd64(&counters->TotalTime, elapsed);
+    InterlockedAdd64(&counters->BytesRead, (LONG64)g_stats_thread.BytesRead);
+    InterlockedAdd64(&counters->BytesSent, (LONG64)g_stats_thread.BytesSent);
+    InterlockedAdd64(&counters->Allocations, (LONG64)g_stats_thread.Allocations);
+    InterlockedIncrement64(&counters->Latency[bucket]);
+
+    max_time = InterlockedCompareExchange64(&counters->MaxTime, 0, 0);
+    while (elapsed > max_time) {
+        value = (ULONG64)InterlockedCompareExchange64(&counters->MaxTime, elapsed, max_time);
+        if ((LONG64)value == max_time)
+            break;
+        max_time = (LONG64)value;
+    }
+}
+
+/*
+* stats_add_bytes_read
+*
+* Purpose:
+*
+* Account file data read by the current command.
+*
+*/
+VOID stats_add_bytes_read(
+    _In_ ULONG64 bytes
+)
+{
+    g_stats_thread.BytesRead += bytes;
+}
+
+/*
+* stats_add_bytes_sent
+*
+* Purpose:
+*
+* Account reply data sent by the current command.
+*
+*/
+VOID stats_add_bytes_sent(
+    _In_ ULONG64 bytes
+)
+{
+    g_stats_thread.BytesSent += bytes;
+}
+
+/*
+* stats_add_allocation
+*
+* Purpose:
+*
+* Account heap allocation made by the current command.
+*
+*/
+VOID stats_add_allocation(
+    VOID
+)
+{
+    g_stats_thread.Allocations++;
+}
+
+/*
+* stats_query
+*
+* Purpose:
+*
+* Read counters of the given command, returns FALSE if command was never called.
+*
+*/
+BOOL stats_query(
+    _In_ cmd_entry_type type,
+    _Out_ PSTATS_COUNTERS counters
+)
+{
+    ULONG i;
+    PSTATS_COUNTERS source;
+
+    RtlSecureZeroMemory(counters, sizeof(STATS_COUNTERS));
+
+    if ((ULONG)type >= STATS_MAX_COMMANDS)
+        return FALSE;
+
+    source = &g_stats[type];
+
+    counters->Calls = InterlockedCompareExchange64(&source->Calls, 0, 0);
+    counters->TotalTime = InterlockedCompareExchange64(&source->TotalTime, 0, 0);
+    counters->MaxTime = InterlockedCompareExchange64(&source->MaxTime, 0, 0);
+    counters->BytesRead = InterlockedCompareExchange64(&source->BytesRead, 0, 0);
+    counters->BytesSent = InterlockedCompareExchange64(&source->BytesSent, 0, 0);
+    counters->Allocations = InterlockedCompareExchange64(&source->Allocations, 0, 0);
+
+    for (i = 0; i < STATS_LATENCY_BUCKETS; i++) {
+        counters->Latency[i] = InterlockedCompareExchange64(&source->Latency[i], 0, 0);
+    }
+
+    return (counters->Calls != 0);
+}
+
+/*
+* stats_uptime
+*
+* Purpose:
+*
+* Return time since server start in milliseconds.
+*
+*/
+ULONG64 stats_uptime(
+    VOID
+)
+{
+    return GetTickCount64() - g_stats_start_tick;
+}
+
+/*
+* stats_reset
+*
+* Purpose:
+*
+* Zero all server wide counters.
+*
+*/
+VOID stats_reset(
+    VOID
+)
+{
+    ULONG i, j;
+    PSTATS_COUNTERS counters;
+
+    for (i = 0; i < STATS_MAX_COMMANDS; i++) {
+        counters = &g_stats[i];
+        InterlockedExchange64(&counters->Calls, 0);
+        InterlockedExchange64(&counters->TotalTime, 0);
+        InterlockedExchange64(&counters->MaxTime, 0);
+        InterlockedExchange64(&counters->BytesRead, 0);
+        InterlockedExchange64(&counters->BytesSent, 0);
+        InterlockedExchange64(&counters->Allocations, 0);
+        for (j = 0; j < STATS_LATENCY_BUCKETS; j++) {
+            InterlockedExchange64(&counters->Latency[j], 0);
+        }
+    }
+}
+
+/*
+* stats_trace_enable
+*
+* Purpose:
+*
+* Start or stop trace of commands handled by the current client thread.
+* Enabling already enabled trace discards recorded events.
+*
+*/
+BOOL stats_trace_enable(
+    _In_ BOOL enable
+)
+{
+    PSTATS_TRACE trace = g_stats_thread.Trace;
+
+    if (enable) {
+        if (trace == NULL) {
+            trace = (PSTATS_TRACE)heap_calloc(NULL, sizeof(STATS_TRACE));
+            if (trace == NULL)
+                return FALSE;
+            g_stats_thread.Trace = trace;
+        }
+        trace->Count = 0;
+        trace->Dropped = 0;
+    }
+    else if (trace) {
+        g_stats_thread.Trace = NULL;
+        heap_free(NULL, trace);
+    }
+
+    return TRUE;
+}
+
+/*
+* stats_trace_get
+*
+* Purpose:
+*
+* Return trace of the current client thread, NULL if not enabled.
+*
+*/
+PSTATS_TRACE stats_trace_get(
+    VOID
+)
+{
+    return g_stats_thread.Trace;
+}
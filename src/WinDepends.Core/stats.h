@@ -0,0 +1,100 @@
+/*
+*  File: stats.h
+*
+*  Created on: Oct 18, 2026
+*
+*  Modified on: Oct 18, 2026
+*
+*      Project: WinDepends.Core
+*
+*      Author: WinDepends dev team
+*/
+
+#pragma once
+
+#ifndef _STATS_H_
+#define _STATS_H_
+
+//
+// Server wide per-command counters, always enabled.
+// Latency bucket n counts calls that took [2^n, 2^(n+1)) microseconds,
+// first bucket also holds calls below 1us, last bucket is open ended.
+//
+#define STATS_MAX_COMMANDS      32
+#define STATS_LATENCY_BUCKETS   24
+
+typedef struct _STATS_COUNTERS {
+    LONG64 Calls;
+    LONG64 TotalTime;               // microseconds
+    LONG64 MaxTime;                 // microseconds
+    LONG64 BytesRead;               // file data read while handling the command
+    LONG64 BytesSent;               // reply size
+    LONG64 Allocations;             // heap allocations
+    LONG64 Latency[STATS_LATENCY_BUCKETS];
+} STATS_COUNTERS, * PSTATS_COUNTERS;
+
+//
+// Optional per-session trace of handled commands. Timestamps are QPC based,
+// so clients on the same machine can align them with their own timeline.
+//
+#define STATS_TRACE_MAX_EVENTS  65536
+
+typedef struct _STATS_TRACE_EVENT {
+    cmd_entry_type Type;
+    LONG64 Start;                   // microseconds, QPC based
+    LONG64 Duration;                // microseconds
+    LONG64 BytesSent;
+} STATS_TRACE_EVENT, * PSTATS_TRACE_EVENT;
+
+typedef struct _STATS_TRACE {
+    ULONG Count;
+    ULONG Dropped;
+    STATS_TRACE_EVENT Events[STATS_TRACE_MAX_EVENTS];
+} STATS_TRACE, * PSTATS_TRACE;
+
+VOID stats_init(
+    VOID
+);
+
+VOID stats_command_begin(
+    VOID
+);
+
+VOID stats_command_end(
+    _In_ cmd_entry_type type
+);
+
+VOID stats_add_bytes_read(
+    _In_ ULONG64 bytes
+);
+
+VOID stats_add_bytes_sent(
+    _In_ ULONG64 bytes
+);
+
+VOID stats_add_allocation(
+    VOID
+);
+
+BOOL stats_query(
+    _In_ cmd_entry_type type,
+    _Out_ PSTATS_COUNTERS counters
+);
+
+ULONG64 stats_uptime(
+    VOID
+);
+
+VOID stats_reset(
+    VOID
+);
+
+BOOL stats_trace_enable(
+    _In_ BOOL enable
+);
+
+PSTATS_TRACE stats_trace_get(
+    VOID
+);
+
+#endif /* _STATS_H_ */
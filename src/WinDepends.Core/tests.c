@@ -3,7 +3,7 @@
 *
 *  Created on: Mar 07, 2025
 *
-*  Modified on: Mar 07, 2025
+*  Modified on: Oct 18, 2026
 *
 *      Project: WinDepends.Core
 *
@@ -12,8 +12,9 @@
 
 #include "core.h"
 
-void test_api_setV6(PAPI_SET_NAMESPACE ApiSetNamespace)
+void test_api_setV6(PAPISET_SCHEMA Schema)
 {
+    PAPI_SET_NAMESPACE ApiSetNamespace = Schema->Namespace;
     LPWSTR ToResolve6[] = {
        L"hui-ms-win-core-app-l1-2-3.dll",
         L"api-ms-win-nevedomaya-ebanaya-hyinua-l1-1-3.dll",
@@ -34,9 +35,10 @@ void test_api_setV6(PAPI_SET_NAMESPACE ApiSetNamespace)
     WCHAR test[2000];
 
     SIZE_T length = 0;
-    LPWSTR name = resolve_apiset_name(L"ext-ms-win-core-app-package-registration-l1-1-1", NULL, &length);
+    LPWSTR name = resolve_apiset_name(Schema, L"ext-ms-win-core-app-package-registration-l1-1-1", NULL, &length);
     if (name) {
         wprintf(L"DLL: %s\r\n", name);
+        heap_free(NULL, name);
     }
     gsup.RtlInitUnicodeString(&Name, L"ext-ms-win-core-app-package-registration-l1-1-1");
     if (NT_SUCCESS(ApiSetResolveToHostV6(ApiSetNamespace, &Name, NULL, &Resolved)))
@@ -117,45 +119,185 @@ void test_api_setV2(PAPI_SET_NAMESPACE ApiSetNamespace)
     }
 }
 
-void test_api_set()
+#define TEST_APISET_INDEX_LOOKUPS   1000000
+#define TEST_APISET_NAME_MAX        MAX_PATH
+
+typedef struct {
+    ULONG Version;
+    ULONG Count;
+    ULONG Capacity;
+    PWCHAR Names;   // Capacity * TEST_APISET_NAME_MAX
+} TEST_APISET_NAMES, * PTEST_APISET_NAMES;
+
+BOOL CALLBACK test_api_set_collect_names(
+    _In_ PCUNICODE_STRING ContractName,
+    _In_opt_ PCUNICODE_STRING ParentName,
+    _In_ PCUNICODE_STRING HostName,
+    _In_opt_ PVOID Context
+)
 {
-    PAPI_SET_NAMESPACE ApiSetNamespace;
-    HMODULE hModule = NULL;
+    PTEST_APISET_NAMES names = (PTEST_APISET_NAMES)Context;
+    PWCHAR name;
+    WCHAR key[TEST_APISET_NAME_MAX];
+
+    UNREFERENCED_PARAMETER(HostName);
+
+    // Default value only, one name per contract.
+    if (ParentName != NULL || names->Count >= names->Capacity)
+        return TRUE;
 
-    ApiSetNamespace = load_apiset_namespace(L"C:\\ApiSetSchema\\apisetschemaV6.dll", &hModule);
-    if (ApiSetNamespace) {
-        gsup.ApiSetMap = ApiSetNamespace;
+    if (FAILED(StringCbCopyN(key, sizeof(key), ContractName->Buffer, ContractName->Length)))
+        return TRUE;
+
+    // Turn lookup key back into a contract file name.
+    name = names->Names + (SIZE_T)names->Count * TEST_APISET_NAME_MAX;
+    if (names->Version == API_SET_SCHEMA_VERSION_V6) {
+        StringCchPrintf(name, TEST_APISET_NAME_MAX, L"%ws-0.dll", key);
+    }
+    else {
+        StringCchPrintf(name, TEST_APISET_NAME_MAX, L"api-%ws.dll", key);
     }
-    else
+
+    names->Count++;
+    return TRUE;
+}
+
+void test_api_set_index(PAPI_SET_NAMESPACE ApiSetNamespace)
+{
+    TEST_APISET_NAMES names;
+    PAPI_SET_INDEX Index;
+    UNICODE_STRING Name, Resolved, ResolvedIndex;
+    NTSTATUS Status, StatusIndex;
+    LARGE_INTEGER t0, t1, freq;
+    ULONG i, mismatches = 0;
+    double searchMs, indexMs;
+
+    RtlSecureZeroMemory(&names, sizeof(names));
+    names.Version = ApiSetNamespace->Version;
+    names.Capacity = 0x2000;
+    names.Names = (PWCHAR)heap_calloc(NULL, (SIZE_T)names.Capacity * TEST_APISET_NAME_MAX * sizeof(WCHAR));
+    if (names.Names == NULL)
+        return;
+
+    Index = ApiSetCreateIndex(ApiSetNamespace);
+    if (Index == NULL ||
+        !ApiSetEnumerateNamespace(ApiSetNamespace, test_api_set_collect_names, &names) ||
+        names.Count == 0)
     {
+        wprintf(L"APISET INDEX V%lu: failed to build\r\n", ApiSetNamespace->Version);
+        if (Index) ApiSetDestroyIndex(Index);
+        heap_free(NULL, names.Names);
         return;
     }
 
-    test_api_setV6(ApiSetNamespace);
-    FreeLibrary(hModule);
+    //
+    // Both lookups must give the same answer for every contract.
+    //
+    for (i = 0; i < names.Count; i++) {
+
+        gsup.RtlInitUnicodeString(&Name, names.Names + (SIZE_T)i * TEST_APISET_NAME_MAX);
+        RtlInitEmptyUnicodeString(&Resolved, NULL, 0);
+        RtlInitEmptyUnicodeString(&ResolvedIndex, NULL, 0);
 
-    ApiSetNamespace = load_apiset_namespace(L"C:\\ApiSetSchema\\apisetschemaV4.dll", &hModule);
-    if (ApiSetNamespace) {
-        gsup.ApiSetMap = ApiSetNamespace;
+        switch (ApiSetNamespace->Version) {
+        case API_SET_SCHEMA_VERSION_V2:
+            Status = ApiSetResolveToHostV2(ApiSetNamespace, &Name, NULL, &Resolved);
+            break;
+        case API_SET_SCHEMA_VERSION_V4:
+            Status = ApiSetResolveToHostV4(ApiSetNamespace, &Name, NULL, &Resolved);
+            break;
+        default:
+            Status = ApiSetResolveToHostV6(ApiSetNamespace, &Name, NULL, &Resolved);
+            break;
+        }
+
+        StatusIndex = ApiSetIndexResolveToHost(Index, &Name, NULL, &ResolvedIndex);
+
+        if (Status != StatusIndex ||
+            Resolved.Buffer != ResolvedIndex.Buffer ||
+            Resolved.Length != ResolvedIndex.Length)
+        {
+            wprintf(L"APISET INDEX V%lu: mismatch for %s\r\n", ApiSetNamespace->Version, Name.Buffer);
+            mismatches++;
+        }
     }
-    else
-    {
+
+    QueryPerformanceFrequency(&freq);
+
+    QueryPerformanceCounter(&t0);
+    for (i = 0; i < TEST_APISET_INDEX_LOOKUPS; i++) {
+        gsup.RtlInitUnicodeString(&Name, names.Names + (SIZE_T)(i % names.Count) * TEST_APISET_NAME_MAX);
+        switch (ApiSetNamespace->Version) {
+        case API_SET_SCHEMA_VERSION_V2:
+            ApiSetResolveToHostV2(ApiSetNamespace, &Name, NULL, &Resolved);
+            break;
+        case API_SET_SCHEMA_VERSION_V4:
+            ApiSetResolveToHostV4(ApiSetNamespace, &Name, NULL, &Resolved);
+            break;
+        default:
+            ApiSetResolveToHostV6(ApiSetNamespace, &Name, NULL, &Resolved);
+            break;
+        }
+    }
+    QueryPerformanceCounter(&t1);
+    searchMs = (double)(t1.QuadPart - t0.QuadPart) * 1000.0 / (double)freq.QuadPart;
+
+    QueryPerformanceCounter(&t0);
+    for (i = 0; i < TEST_APISET_INDEX_LOOKUPS; i++) {
+        gsup.RtlInitUnicodeString(&Name, names.Names + (SIZE_T)(i % names.Count) * TEST_APISET_NAME_MAX);
+        ApiSetIndexResolveToHost(Index, &Name, NULL, &ResolvedIndex);
+    }
+    QueryPerformanceCounter(&t1);
+    indexMs = (double)(t1.QuadPart - t0.QuadPart) * 1000.0 / (double)freq.QuadPart;
+
+    wprintf(L"APISET INDEX V%lu: %lu contracts, %lu mismatches, %u lookups: search %.2f ms, index %.2f ms\r\n",
+        ApiSetNamespace->Version,
+        names.Count,
+        mismatches,
+        TEST_APISET_INDEX_LOOKUPS,
+        searchMs,
+        indexMs);
+
+    ApiSetDestroyIndex(Index);
+    heap_free(NULL, names.Names);
+}
+
+void test_api_set()
+{
+    PAPISET_SCHEMA Schema, SchemaRef;
+
+    Schema = apiset_schema_acquire(L"C:\\ApiSetSchema\\apisetschemaV6.dll");
+    if (Schema == NULL) {
         return;
     }
 
-    test_api_setV4(ApiSetNamespace);
-    FreeLibrary(hModule);
+    //
+    // Same file must be served from the schema cache.
+    //
+    SchemaRef = apiset_schema_acquire(L"C:\\APISETSCHEMA\\apisetschemaV6.dll");
+    wprintf(L"APISET CACHE: shared schema %s\r\n", (SchemaRef == Schema) ? L"OK" : L"FAILED");
+    apiset_schema_release(SchemaRef);
+
+    test_api_setV6(Schema);
+    test_api_set_index(Schema->Namespace);
+    apiset_schema_release(Schema);
 
-    ApiSetNamespace = load_apiset_namespace(L"C:\\ApiSetSchema\\apisetschemaV2.dll", &hModule);
-    if (ApiSetNamespace) {
-        gsup.ApiSetMap = ApiSetNamespace;
+    Schema = apiset_schema_acquire(L"C:\\ApiSetSchema\\apisetschemaV4.dll");
+    if (Schema == NULL) {
+        return;
     }
-    else
-    {
+
+    test_api_setV4(Schema->Namespace);
+    test_api_set_index(Schema->Namespace);
+    apiset_schema_release(Schema);
+
+    Schema = apiset_schema_acquire(L"C:\\ApiSetSchema\\apisetschemaV2.dll");
+    if (Schema == NULL) {
         return;
     }
 
-    test_api_setV2(ApiSetNamespace);
-    FreeLibrary(hModule);
+    test_api_setV2(Schema->Namespace);
+    test_api_set_index(Schema->Namespace);
+    apiset_schema_release(Schema);
 }
 
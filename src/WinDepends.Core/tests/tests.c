@@ -3,6 +3,8 @@
 #include <wchar.h>
 #include "../src/WinDepends.Core/cmd.h"
 #include "../src/WinDepends.Core/mlist.h"
+#include "../src/WinDepends.Core/util.h"
+#include "../src/WinDepends.Core/reloc.h"
 
 void test_cmd_entry_parsing(void) {
     assert(get_command_entry(L"open") == ce_open);
@@ -18,6 +20,14 @@ void test_cmd_entry_parsing(void) {
     assert(get_command_entry(L"apisetmapsrc") == ce_apisetmapsrc);
     assert(get_command_entry(L"apisetnsinfo") == ce_apisetnsinfo);
     assert(get_command_entry(L"callstats") == ce_callstats);
+    assert(get_command_entry(L"apisetdump") == ce_apisetdump);
+    assert(get_command_entry(L"apisetresolvebatch") == ce_apisetresolvebatch);
+    assert(get_command_entry(L"knowndllsload") == ce_knowndllsload);
+    assert(get_command_entry(L"knowndllsver") == ce_knowndllsver);
+    assert(get_command_entry(L"openresolve") == ce_openresolve);
+    assert(get_command_entry(L"stats") == ce_stats);
+    assert(get_command_entry(L"trace") == ce_trace);
+    assert(get_command_entry(L"debuginfo") == ce_debuginfo);
     assert(get_command_entry(L"notacommand") == ce_unknown);
 }
 
@@ -75,6 +85,73 @@ void test_mlist_traverse_send_and_cleanup(void) {
     InitializeListHead(&head);
 }
 
+void test_params_option_after_long_token(void) {
+    static wchar_t params[4 * MAX_PATH];
+    wchar_t value[32];
+    ULONG len;
+    size_t pos;
+
+    wcscpy_s(params, ARRAYSIZE(params), L"openresolve name \"a.dll\" dirs \"");
+    pos = wcslen(params);
+    wmemset(params + pos, L'x', 2 * MAX_PATH);
+    params[pos + 2 * MAX_PATH] = 0;
+    wcscat_s(params, ARRAYSIZE(params), L"\" use_stats custom_image_base 4096");
+
+    assert(get_params_option(params, L"use_stats", FALSE, NULL, 0, NULL) == TRUE);
+    assert(get_params_option(params, L"custom_image_base", TRUE, value, ARRAYSIZE(value), &len) == TRUE);
+    assert(wcscmp(value, L"4096") == 0 && len == 4);
+    assert(get_params_option(params, L"lazy_relocs", FALSE, NULL, 0, NULL) == FALSE);
+    assert(get_params_token(params, 2, value, ARRAYSIZE(value), &len) == TRUE);
+    assert(wcscmp(value, L"a.dll") == 0);
+    assert(get_params_token(params, 4, value, ARRAYSIZE(value), &len) == FALSE);
+    assert(len == 2 * MAX_PATH);
+}
+
+static int test_reloc_lazy_straddle_order(DWORD first_page) {
+    const ULONG64 image_base = 0x140000000ULL;
+    const DWORD image_size = 3 * PAGE_SIZE;
+    PBYTE eager, lazy;
+    PIMAGE_BASE_RELOCATION block;
+    PWORD entries;
+    static BYTE first_read[PAGE_SIZE];
+    int same;
+
+    eager = (PBYTE)VirtualAlloc(NULL, image_size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+    lazy = (PBYTE)VirtualAlloc(NULL, image_size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+    assert(eager != NULL && lazy != NULL);
+
+    // Relocation directory in page 0, DIR64 fixup at 0x1ffc crosses into page 2.
+    block = (PIMAGE_BASE_RELOCATION)(eager + 0x100);
+    block->VirtualAddress = PAGE_SIZE;
+    block->SizeOfBlock = sizeof(IMAGE_BASE_RELOCATION) + 2 * sizeof(WORD);
+    entries = (PWORD)(block + 1);
+    entries[0] = (IMAGE_REL_BASED_DIR64 << 12) | 0xffc;
+    entries[1] = (IMAGE_REL_BASED_DIR64 << 12) | 0x010;
+
+    *(UNALIGNED ULONG64*)(eager + 0x1ffc) = image_base + 0x1234;
+    *(UNALIGNED ULONG64*)(eager + 0x1010) = image_base + 0x5678;
+    memcpy(lazy, eager, image_size);
+
+    assert(reloc_apply(eager, image_size, IMAGE_FILE_MACHINE_AMD64, image_base, 0x100, block->SizeOfBlock));
+    assert(reloc_lazy_init(lazy, image_size, IMAGE_FILE_MACHINE_AMD64, image_base, 0x100, block->SizeOfBlock));
+
+    // Contents seen by the first read must already be relocated, not only the final image.
+    memcpy(first_read, lazy + (SIZE_T)first_page * PAGE_SIZE, PAGE_SIZE);
+    same = (memcmp(first_read, eager + (SIZE_T)first_page * PAGE_SIZE, PAGE_SIZE) == 0) &&
+        (memcmp(eager, lazy, image_size) == 0);
+
+    reloc_lazy_release(lazy);
+    VirtualFree(lazy, 0, MEM_RELEASE);
+    VirtualFree(eager, 0, MEM_RELEASE);
+    return same;
+}
+
+void test_reloc_lazy_straddle(void) {
+    // Lazy image must match eagerly relocated one whichever page is read first.
+    assert(test_reloc_lazy_straddle_order(1));
+    assert(test_reloc_lazy_straddle_order(2));
+}
+
 void test_cmd_unknown_command_handler(void) {
     SOCKET fake_sock = 0;
     cmd_unknown_command(fake_sock);
@@ -85,6 +162,8 @@ int main(void) {
     test_mlist_add_and_traverse();
     test_mlist_add_empty_and_failure();
     test_mlist_traverse_send_and_cleanup();
+    test_params_option_after_long_token();
+    test_reloc_lazy_straddle();
     test_cmd_unknown_command_handler();
 
     printf("All detailed WinDepends.Core tests passed.\n");
@@ -3,7 +3,7 @@
 *
 *  Created on: Aug 04, 2024
 *
-*  Modified on: Feb 11, 2026
+*  Modified on: Oct 18, 2026
 *
 *      Project: WinDepends.Core
 *
@@ -147,6 +147,13 @@ int ex_filter_dbg(
     _In_ struct _EXCEPTION_POINTERS* ep
 )
 {
+#ifdef WDEP_FUZZER
+    // Let the fuzzer crash handler see the fault.
+    UNREFERENCED_PARAMETER(fileName);
+    UNREFERENCED_PARAMETER(code);
+    UNREFERENCED_PARAMETER(ep);
+    return EXCEPTION_CONTINUE_SEARCH;
+#else
     if (code == EXCEPTION_ACCESS_VIOLATION)
     {
         ex_write_dump(ep, fileName);
@@ -156,6 +163,7 @@ int ex_filter_dbg(
     {
         return EXCEPTION_CONTINUE_SEARCH;
     };
+#endif
 }
 
 int ex_filter(
@@ -179,6 +187,7 @@ LPVOID heap_malloc(_In_opt_ HANDLE heap, _In_ SIZE_T size)
 {
     HANDLE hHeap = (heap == NULL) ? GetProcessHeap() : heap;
 
+    stats_add_allocation();
     return HeapAlloc(hHeap, 0, size);
 }
 
@@ -186,6 +195,7 @@ LPVOID heap_calloc(_In_opt_ HANDLE heap, _In_ SIZE_T size)
 {
     HANDLE hHeap = (heap == NULL) ? GetProcessHeap() : heap;
 
+    stats_add_allocation();
     return HeapAlloc(hHeap, HEAP_ZERO_MEMORY, size);
 }
 
@@ -196,12 +206,63 @@ BOOL heap_free(_In_opt_ HANDLE heap, _In_ LPVOID memory)
     return HeapFree(hHeap, 0, memory);
 }
 
+//
+// Per thread replacement of the client socket, used by in-process callers.
+//
+static __declspec(thread) PREPLY_SINK g_reply_sink;
+static __declspec(thread) PVOID g_reply_sink_context;
+
+/*
+* set_reply_sink
+*
+* Purpose:
+*
+* Redirect replies of the calling thread to the given callback instead of the socket.
+* NULL sink restores socket output.
+*
+*/
+VOID set_reply_sink(
+    _In_opt_ PREPLY_SINK sink,
+    _In_opt_ PVOID sink_context
+)
+{
+    g_reply_sink = sink;
+    g_reply_sink_context = sink_context;
+}
+
+/*
+* send_reply
+*
+* Purpose:
+*
+* Send reply data to the client socket or the thread reply sink.
+*
+*/
+static int send_reply(
+    _In_ SOCKET s,
+    _In_reads_bytes_(length) const char* data,
+    _In_ int length
+)
+{
+    if (g_reply_sink)
+        return g_reply_sink(data, length, g_reply_sink_context);
+
+    return send(s, data, length, 0);
+}
+
 int sendstring_plaintext_no_track(
     _In_ SOCKET s, 
     _In_ const wchar_t* Buffer
 )
 {
-    return (send(s, (const char*)Buffer, (int)wcslen(Buffer) * sizeof(wchar_t), 0) >= 0);
+    int result;
+
+    result = send_reply(s, (const char*)Buffer, (int)wcslen(Buffer) * sizeof(wchar_t));
+    if (result > 0) {
+        stats_add_bytes_sent(result);
+    }
+
+    return (result >= 0);
 }
 
 int sendstring_plaintext(
@@ -222,7 +283,10 @@ int sendstring_plaintext(
         QueryPerformanceCounter(&context->start_count);
     }
 
-    result = send(s, (const char*)Buffer, bufferLength, 0);
+    result = send_reply(s, (const char*)Buffer, bufferLength);
+    if (result > 0) {
+        stats_add_bytes_sent(result);
+    }
 
     if (enableStats && result != SOCKET_ERROR) {
         QueryPerformanceCounter(&endCount);
@@ -335,44 +399,196 @@ DWORD calc_mapped_file_chksum(
     return (ULONG)partial_sum + file_length;
 }
 
+/*
+* add_knowndlls_entry
+*
+* Purpose:
+*
+* Insert dll name into KnownDlls set.
+*
+*/
+BOOL add_knowndlls_entry(
+    _Inout_ PSUP_KNOWNDLLS_SET Set,
+    _In_reads_(NameLength) PCWCH Name,
+    _In_ SIZE_T NameLength
+)
+{
+    SIZE_T cbNameEntry;
+    PSUP_PATH_ELEMENT_ENTRY dllEntry;
+
+    dllEntry = (PSUP_PATH_ELEMENT_ENTRY)heap_calloc(NULL, sizeof(SUP_PATH_ELEMENT_ENTRY));
+    if (dllEntry == NULL)
+        return FALSE;
+
+    cbNameEntry = (NameLength + 1) * sizeof(WCHAR);
+    dllEntry->Element = (PWSTR)heap_calloc(NULL, cbNameEntry);
+    if (dllEntry->Element == NULL) {
+        heap_free(NULL, dllEntry);
+        return FALSE;
+    }
+
+    RtlCopyMemory(dllEntry->Element, Name, NameLength * sizeof(WCHAR));
+    dllEntry->Next = Set->Head.Next;
+    Set->Head.Next = dllEntry;
+
+    // Remember max filename size.
+    if (cbNameEntry > Set->NameCbMax) {
+        Set->NameCbMax = cbNameEntry;
+    }
+
+    return TRUE;
+}
+
+/*
+* set_knowndlls_path
+*
+* Purpose:
+*
+* Replace KnownDlls set directory path.
+*
+*/
+BOOL set_knowndlls_path(
+    _Inout_ PSUP_KNOWNDLLS_SET Set,
+    _In_reads_(PathLength) PCWCH Path,
+    _In_ SIZE_T PathLength
+)
+{
+    PWSTR pathBuffer;
+
+    pathBuffer = (PWSTR)heap_calloc(NULL, (PathLength + 1) * sizeof(WCHAR));
+    if (pathBuffer == NULL)
+        return FALSE;
+
+    RtlCopyMemory(pathBuffer, Path, PathLength * sizeof(WCHAR));
+
+    if (Set->Path) {
+        heap_free(NULL, Set->Path);
+    }
+
+    Set->Path = pathBuffer;
+    Set->PathCbMax = PathLength * sizeof(WCHAR);
+    return TRUE;
+}
+
+/*
+* free_knowndlls_list
+*
+* Purpose:
+*
+* Release KnownDlls set entries and path.
+*
+*/
+VOID free_knowndlls_list(
+    _Inout_ PSUP_KNOWNDLLS_SET Set
+)
+{
+    PSUP_PATH_ELEMENT_ENTRY dllEntry, nextEntry;
+
+    for (dllEntry = Set->Head.Next; dllEntry != NULL; dllEntry = nextEntry) {
+        nextEntry = dllEntry->Next;
+        heap_free(NULL, dllEntry->Element);
+        heap_free(NULL, dllEntry);
+    }
+
+    if (Set->Path) {
+        heap_free(NULL, Set->Path);
+    }
+
+    RtlSecureZeroMemory(Set, sizeof(SUP_KNOWNDLLS_SET));
+}
+
+/*
+* hash_knowndlls_string
+*
+* Purpose:
+*
+* Case insensitive FNV-1a hash of KnownDlls name or path.
+*
+*/
+ULONG64 hash_knowndlls_string(
+    _In_opt_ LPCWSTR String
+)
+{
+    ULONG64 hash = 0xcbf29ce484222325ULL;
+    WCHAR c;
+
+    if (String == NULL)
+        return hash;
+
+    while ((c = *String++) != 0) {
+        if (c >= L'A' && c <= L'Z')
+            c += 0x20;
+        hash ^= c;
+        hash *= 0x100000001b3ULL;
+    }
+
+    return hash;
+}
+
+/*
+* get_knowndlls_version
+*
+* Purpose:
+*
+* Calculate KnownDlls version from sets content.
+* Entries are summed so the value does not depend on enumeration order.
+*
+*/
+ULONG64 get_knowndlls_version(
+    _In_ PSUP_KNOWNDLLS_SET Set,
+    _In_ PSUP_KNOWNDLLS_SET Set32
+)
+{
+    ULONG64 version, sum = 0, sum32 = 0;
+    PSUP_PATH_ELEMENT_ENTRY dllEntry;
+
+    for (dllEntry = Set->Head.Next; dllEntry != NULL; dllEntry = dllEntry->Next)
+        sum += hash_knowndlls_string(dllEntry->Element);
+
+    for (dllEntry = Set32->Head.Next; dllEntry != NULL; dllEntry = dllEntry->Next)
+        sum32 += hash_knowndlls_string(dllEntry->Element);
+
+    version = hash_knowndlls_string(Set->Path);
+    version = (version ^ sum) * 0x100000001b3ULL;
+    version = (version ^ hash_knowndlls_string(Set32->Path)) * 0x100000001b3ULL;
+    version = (version ^ sum32) * 0x100000001b3ULL;
+
+    return version;
+}
+
 /*
 * build_knowndlls_list
 *
 * Purpose:
 *
-* Read and remember KnownDlls list from object directory.
+* Read KnownDlls list from object directory.
 *
 */
 BOOL build_knowndlls_list(
-    _In_ BOOL IsWow64
+    _In_ BOOL IsWow64,
+    _Inout_ PSUP_KNOWNDLLS_SET Set
 )
 {
     BOOL bResult = FALSE;
 
     NTSTATUS ntStatus = STATUS_UNSUCCESSFUL;
-    ULONG returnLength = 0, ctx;
+    ULONG returnLength = 0, ctx, cbDirInfo = 0;
 
     HANDLE hDirectory = NULL;
     HANDLE hLink = NULL;
 
-    POBJECT_DIRECTORY_INFORMATION pDirInfo;
+    POBJECT_DIRECTORY_INFORMATION pDirInfo = NULL;
 
     UNICODE_STRING usName, usKnownDllsPath;
     OBJECT_ATTRIBUTES objectAttributes;
 
-    SIZE_T cbNameEntry;
-    SIZE_T cbMaxName = 0, cbPath;
-
     PWCH stringBuffer = NULL;
     PWSTR lpKnownDllsDirName;
-    PSUP_PATH_ELEMENT_ENTRY dllEntry, dllsHead;
 
     if (IsWow64) {
-        dllsHead = &gsup.KnownDlls32Head;
         lpKnownDllsDirName = L"\\KnownDlls32";
     }
     else {
-        dllsHead = &gsup.KnownDllsHead;
         lpKnownDllsDirName = L"\\KnownDlls";
     }
 
@@ -417,77 +633,51 @@ BOOL build_knowndlls_list(
             break;
         }
 
-        cbPath = usKnownDllsPath.Length;
-
-        if (IsWow64) {
-            gsup.KnownDlls32Path = stringBuffer;
-            gsup.KnownDlls32PathCbMax = cbPath;
-        }
-        else {
-            gsup.KnownDllsPath = stringBuffer;
-            gsup.KnownDllsPathCbMax = cbPath;
-        }
+        Set->Path = stringBuffer;
+        Set->PathCbMax = usKnownDllsPath.Length;
+        stringBuffer = NULL;
 
         ctx = 0;
 
+        //
+        // Query buffer is reused between entries and only grows when required.
+        //
         do {
 
-            returnLength = 0;
-            ntStatus = gsup.NtQueryDirectoryObject(hDirectory, NULL, 0, TRUE, FALSE, &ctx, &returnLength);
-            if (ntStatus != STATUS_BUFFER_TOO_SMALL)
-                break;
+            ntStatus = gsup.NtQueryDirectoryObject(hDirectory, pDirInfo, cbDirInfo, TRUE, FALSE, &ctx, &returnLength);
+            if (ntStatus == STATUS_BUFFER_TOO_SMALL) {
 
-            pDirInfo = (POBJECT_DIRECTORY_INFORMATION)heap_calloc(NULL, returnLength);
-            if (pDirInfo == NULL)
-                break;
-
-            ntStatus = gsup.NtQueryDirectoryObject(hDirectory, pDirInfo, returnLength, TRUE, FALSE, &ctx, &returnLength);
-            if (!NT_SUCCESS(ntStatus)) {
-                heap_free(NULL, pDirInfo);
-                break;
-            }
-
-            if (_wcsicmp(pDirInfo->TypeName.Buffer, L"Section") == 0) {
-
-                dllEntry = (PSUP_PATH_ELEMENT_ENTRY)heap_calloc(NULL, sizeof(SUP_PATH_ELEMENT_ENTRY));
-                if (dllEntry) {
-
-                    cbNameEntry = (SIZE_T)pDirInfo->Name.MaximumLength;
-                    dllEntry->Element = (PWSTR)heap_calloc(NULL, cbNameEntry);
+                if (pDirInfo) {
+                    heap_free(NULL, pDirInfo);
+                }
 
-                    if (dllEntry->Element) {
+                cbDirInfo = returnLength + 256;
+                pDirInfo = (POBJECT_DIRECTORY_INFORMATION)heap_calloc(NULL, cbDirInfo);
+                if (pDirInfo == NULL)
+                    break;
 
-                        RtlCopyMemory(dllEntry->Element, pDirInfo->Name.Buffer, pDirInfo->Name.Length);
-                        dllEntry->Next = dllsHead->Next;
+                ntStatus = gsup.NtQueryDirectoryObject(hDirectory, pDirInfo, cbDirInfo, TRUE, FALSE, &ctx, &returnLength);
+            }
 
-                        // Remember max filename size.
-                        if (cbNameEntry > cbMaxName) {
-                            cbMaxName = cbNameEntry;
-                        }
+            if (!NT_SUCCESS(ntStatus))
+                break;
 
-                        dllsHead->Next = dllEntry;
-                    }
-                    else {
-                        heap_free(NULL, dllEntry);
-                    }
-                }
+            if (_wcsicmp(pDirInfo->TypeName.Buffer, L"Section") == 0) {
+                add_knowndlls_entry(Set,
+                    pDirInfo->Name.Buffer,
+                    pDirInfo->Name.Length / sizeof(WCHAR));
             }
 
-            heap_free(NULL, pDirInfo);
-
         } while (TRUE);
 
-        if (IsWow64) {
-            gsup.KnownDlls32NameCbMax = cbMaxName;
-        }
-        else {
-            gsup.KnownDllsNameCbMax = cbMaxName;
-        }
-
         bResult = TRUE;
 
     } while (FALSE);
 
+    if (pDirInfo) {
+        heap_free(NULL, pDirInfo);
+    }
+
     if (hLink) {
         gsup.NtClose(hLink);
     }
@@ -496,106 +686,326 @@ BOOL build_knowndlls_list(
         gsup.NtClose(hDirectory);
     }
 
-    if (!bResult && stringBuffer)
+    if (stringBuffer)
         heap_free(NULL, stringBuffer);
 
     return bResult;
 }
 
 /*
-* load_apiset_namespace
+* trim_snapshot_token
 *
 * Purpose:
 *
-* Query apiset table from schema dll.
-* Returns the ApiSet data pointer and optionally the HMODULE handle.
+* Strip blanks and quotes around snapshot line token.
 *
 */
-PVOID load_apiset_namespace(
-    _In_ LPCWSTR apiset_schema_dll,
-    _Out_opt_ HMODULE* phModule
+PWCH trim_snapshot_token(
+    _In_ PWCH Token,
+    _Out_ PSIZE_T Length
 )
 {
-    ULONG dataSize = 0;
-    UINT i;
-    HMODULE hApiSetDll;
+    PWCH end;
 
-    PIMAGE_NT_HEADERS ntHeaders;
-    IMAGE_SECTION_HEADER* sectionTableEntry;
-    PBYTE baseAddress;
-    PBYTE dataPtr = NULL;
+    while (*Token == L' ' || *Token == L'\t' || *Token == L'"')
+        Token++;
 
-#ifndef _WIN64
-    PVOID oldValue;
-#endif
+    end = Token + wcslen(Token);
+    while (end > Token && (end[-1] == L' ' || end[-1] == L'\t' || end[-1] == L'"'))
+        end--;
 
-    if (phModule) {
-        *phModule = NULL;
-    }
+    *end = 0;
+    *Length = end - Token;
+    return Token;
+}
 
-#ifndef _WIN64
-    Wow64DisableWow64FsRedirection(&oldValue);
-#endif
-    hApiSetDll = LoadLibraryEx(apiset_schema_dll, NULL, LOAD_LIBRARY_AS_DATAFILE);
-    if (hApiSetDll) {
+/*
+* load_knowndlls_snapshot
+*
+* Purpose:
+*
+* Load KnownDlls sets from text snapshot file (UTF-8 or UTF-16LE with BOM).
+*
+* [KnownDlls]
+* DllDirectory=C:\Windows\System32
+* kernel32.dll
+* "user32"="user32.dll"
+* [KnownDlls32]
+* DllDirectory=C:\Windows\SysWOW64
+* ...
+*
+* Lines starting with ';' or '#' are comments. Name=value pairs take value
+* as dll name, so values of the registry KnownDLLs key can be pasted as is.
+*
+*/
+BOOL load_knowndlls_snapshot(
+    _In_ LPCWSTR file_name,
+    _Inout_ PSUP_KNOWNDLLS_SET Set,
+    _Inout_ PSUP_KNOWNDLLS_SET Set32
+)
+{
+    BOOL bResult = FALSE;
+    HANDLE hFile;
+    LARGE_INTEGER fileSize;
+    DWORD bytesRead = 0;
+    PBYTE fileBuffer = NULL;
+    PWCH text = NULL, line, next, value, name;
+    SIZE_T cchText, nameLength, valueLength;
+    PSUP_KNOWNDLLS_SET current = NULL;
+    int cch;
+
+    hFile = CreateFile(file_name,
+        GENERIC_READ,
+        FILE_SHARE_READ,
+        NULL,
+        OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL,
+        NULL);
+
+    if (hFile == INVALID_HANDLE_VALUE)
+        return FALSE;
 
-        baseAddress = (PBYTE)(((ULONG_PTR)hApiSetDll) & ~3);
+    do {
 
-        ntHeaders = gsup.RtlImageNtHeader(baseAddress);
+        if (!GetFileSizeEx(hFile, &fileSize) ||
+            fileSize.QuadPart < 2 ||
+            fileSize.QuadPart > KNOWNDLLS_SNAPSHOT_MAX_SIZE)
+        {
+            break;
+        }
 
-        sectionTableEntry = IMAGE_FIRST_SECTION(ntHeaders);
+        fileBuffer = (PBYTE)heap_calloc(NULL, (SIZE_T)fileSize.LowPart + sizeof(WCHAR));
+        if (fileBuffer == NULL)
+            break;
 
-        i = ntHeaders->FileHeader.NumberOfSections;
-        while (i > 0) {
-            if (_strnicmp((CHAR*)&sectionTableEntry->Name, API_SET_SECTION_NAME,
-                sizeof(API_SET_SECTION_NAME)) == 0)
-            {
-                dataSize = sectionTableEntry->SizeOfRawData;
+        if (!ReadFile(hFile, fileBuffer, fileSize.LowPart, &bytesRead, NULL) ||
+            bytesRead != fileSize.LowPart)
+        {
+            break;
+        }
 
-                dataPtr = (PBYTE)RtlOffsetToPointer(
-                    baseAddress,
-                    sectionTableEntry->PointerToRawData);
+        stats_add_bytes_read(bytesRead);
 
+        if (fileBuffer[0] == 0xFF && fileBuffer[1] == 0xFE) {
+            cchText = (bytesRead - 2) / sizeof(WCHAR);
+            text = (PWCH)heap_calloc(NULL, (cchText + 1) * sizeof(WCHAR));
+            if (text == NULL)
                 break;
+            RtlCopyMemory(text, fileBuffer + 2, cchText * sizeof(WCHAR));
+        }
+        else {
+            line = (PWCH)fileBuffer;
+            cch = (int)bytesRead;
+            if (bytesRead >= 3 && fileBuffer[0] == 0xEF && fileBuffer[1] == 0xBB && fileBuffer[2] == 0xBF) {
+                line = (PWCH)(fileBuffer + 3);
+                cch -= 3;
             }
-            i -= 1;
-            sectionTableEntry += 1;
+
+            cchText = MultiByteToWideChar(CP_UTF8, 0, (LPCCH)line, cch, NULL, 0);
+            if (cchText == 0)
+                break;
+
+            text = (PWCH)heap_calloc(NULL, (cchText + 1) * sizeof(WCHAR));
+            if (text == NULL)
+                break;
+
+            MultiByteToWideChar(CP_UTF8, 0, (LPCCH)line, cch, text, (int)cchText);
         }
 
-        // If we didn't find the section, free the module
-        if (dataPtr == NULL) {
-            FreeLibrary(hApiSetDll);
-            hApiSetDll = NULL;
+        bResult = TRUE;
+
+        for (line = text; line != NULL && bResult; line = next) {
+
+            next = wcspbrk(line, L"\r\n");
+            if (next) {
+                *next++ = 0;
+            }
+
+            name = trim_snapshot_token(line, &nameLength);
+            if (nameLength == 0 || *name == L';' || *name == L'#')
+                continue;
+
+            if (*name == L'[') {
+                if (_wcsicmp(name, L"[KnownDlls]") == 0)
+                    current = Set;
+                else if (_wcsicmp(name, L"[KnownDlls32]") == 0)
+                    current = Set32;
+                else
+                    current = NULL;
+                continue;
+            }
+
+            if (current == NULL)
+                continue;
+
+            value = wcschr(name, L'=');
+            if (value) {
+                *value++ = 0;
+                name = trim_snapshot_token(name, &nameLength);
+                value = trim_snapshot_token(value, &valueLength);
+                if (valueLength == 0)
+                    continue;
+
+                if (_wcsicmp(name, L"DllDirectory") == 0) {
+                    bResult = set_knowndlls_path(current, value, valueLength);
+                    continue;
+                }
+
+                name = value;
+                nameLength = valueLength;
+            }
+
+            if (nameLength >= MAX_PATH)
+                continue;
+
+            bResult = add_knowndlls_entry(current, name, nameLength);
         }
-        else {
-            // Return the module handle if caller wants it
-            if (phModule) {
-                *phModule = hApiSetDll;
+
+        //
+        // Every non empty set must have directory, empty sets get empty path.
+        //
+        if (bResult) {
+            if ((Set->Head.Next && Set->Path == NULL) ||
+                (Set32->Head.Next && Set32->Path == NULL))
+            {
+                bResult = FALSE;
+            }
+            else {
+                if (Set->Path == NULL)
+                    bResult = set_knowndlls_path(Set, L"", 0);
+                if (bResult && Set32->Path == NULL)
+                    bResult = set_knowndlls_path(Set32, L"", 0);
             }
         }
+
+    } while (FALSE);
+
+    CloseHandle(hFile);
+
+    if (text) heap_free(NULL, text);
+    if (fileBuffer) heap_free(NULL, fileBuffer);
+
+    if (!bResult) {
+        free_knowndlls_list(Set);
+        free_knowndlls_list(Set32);
     }
 
+    return bResult;
+}
+
+/*
+* open_apiset_schema
+*
+* Purpose:
+*
+* Open apiset schema file for read, file identity is returned in file_info.
+*
+*/
+HANDLE open_apiset_schema(
+    _In_ LPCWSTR apiset_schema_dll,
+    _Out_ LPBY_HANDLE_FILE_INFORMATION file_info
+)
+{
+    HANDLE hFile;
+
+#ifndef _WIN64
+    PVOID oldValue;
+#endif
+
+    RtlSecureZeroMemory(file_info, sizeof(BY_HANDLE_FILE_INFORMATION));
+
+#ifndef _WIN64
+    Wow64DisableWow64FsRedirection(&oldValue);
+#endif
+    hFile = CreateFile(apiset_schema_dll,
+        GENERIC_READ,
+        FILE_SHARE_READ | FILE_SHARE_DELETE,
+        NULL,
+        OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL,
+        NULL);
 #ifndef _WIN64
     Wow64RevertWow64FsRedirection(oldValue);
 #endif
 
+    if (hFile != INVALID_HANDLE_VALUE) {
+        if (!GetFileInformationByHandle(hFile, file_info)) {
+            CloseHandle(hFile);
+            hFile = INVALID_HANDLE_VALUE;
+        }
+    }
+
+    return hFile;
+}
+
+/*
+* map_apiset_namespace
+*
+* Purpose:
+*
+* Map schema file as plain data and locate apiset table in it.
+* No loader is involved, so schema of any architecture/version can be used.
+* Returns the ApiSet data pointer and the view base to be unmapped by caller.
+*
+*/
+PVOID map_apiset_namespace(
+    _In_ HANDLE file_handle,
+    _In_ LPBY_HANDLE_FILE_INFORMATION file_info,
+    _Out_ PVOID* view_base
+)
+{
+    HANDLE hMapping;
+    PVOID viewBase = NULL, dataPtr = NULL;
+    ULARGE_INTEGER fileSize;
+
+    *view_base = NULL;
+
+    fileSize.LowPart = file_info->nFileSizeLow;
+    fileSize.HighPart = file_info->nFileSizeHigh;
+    if (fileSize.QuadPart == 0 || fileSize.QuadPart > MAXSIZE_T)
+        return NULL;
+
+    hMapping = CreateFileMapping(file_handle, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (hMapping == NULL)
+        return NULL;
+
+    viewBase = MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(hMapping);
+
+    if (viewBase == NULL)
+        return NULL;
+
+    __try {
+        dataPtr = ApiSetFindSchemaSection(viewBase, (SIZE_T)fileSize.QuadPart, NULL);
+    }
+    __except (ex_filter(GetExceptionCode(), GetExceptionInformation())) {
+        dataPtr = NULL;
+    }
+
+    if (dataPtr == NULL) {
+        UnmapViewOfFile(viewBase);
+        return NULL;
+    }
+
+    stats_add_bytes_read(fileSize.QuadPart);
+    *view_base = viewBase;
     return dataPtr;
 }
 
 /*
-* unload_apiset_namespace
+* unmap_apiset_namespace
 *
 * Purpose:
 *
-* Unload a previously loaded ApiSet schema DLL.
+* Unmap a previously mapped ApiSet schema file.
 *
 */
-VOID unload_apiset_namespace(
-    _In_ HMODULE hModule
+VOID unmap_apiset_namespace(
+    _In_opt_ PVOID view_base
 )
 {
-    if (hModule != NULL) {
-        FreeLibrary(hModule);
+    if (view_base != NULL) {
+        UnmapViewOfFile(view_base);
     }
 }
 
@@ -611,6 +1021,7 @@ void utils_init()
 {
     RtlSecureZeroMemory(&gsup, sizeof(SUP_CONTEXT));
     QueryPerformanceFrequency(&gsup.PerformanceFrequency);
+    stats_init();
 
     gsup.ApiSetMap = NtCurrentPeb()->ApiSetMap;
     if (gsup.ApiSetMap == NULL) {
@@ -663,41 +1074,44 @@ void utils_init()
 
     }
 
-    if (build_knowndlls_list(FALSE) &&
-        build_knowndlls_list(TRUE))
+    if (build_knowndlls_list(FALSE, &gsup.KnownDlls) &&
+        build_knowndlls_list(TRUE, &gsup.KnownDlls32))
     {
+        gsup.KnownDllsVersion = get_knowndlls_version(&gsup.KnownDlls, &gsup.KnownDlls32);
+        apiset_cache_init();
         gsup.Initialized = TRUE;
     }
 
 }
 
 /*
-* resolve_apiset_name
+* resolve_apiset_host
 *
 * Purpose:
 *
-* Lookup apiset target dll by contract name.
+* Lookup apiset target dll by contract name without allocating memory.
+* On success host_name points directly into the schema namespace.
+* If schema is NULL the process apiset namespace is used.
 *
 */
-_Success_(return != NULL)
-LPWSTR resolve_apiset_name(
+_Success_(return)
+BOOL resolve_apiset_host(
+    _In_opt_ PAPISET_SCHEMA schema,
     _In_ LPCWSTR apiset_name,
     _In_opt_ LPCWSTR parent_name,
-    _Out_ SIZE_T * name_length
+    _Out_ PUNICODE_STRING host_name
 )
 {
     NTSTATUS Status = STATUS_NOT_FOUND;
     PAPI_SET_NAMESPACE ApiSetNamespace;
-    UNICODE_STRING Name, ParentName, ResolvedName;
-    LPWSTR ResolvedNameBuffer;
-    SIZE_T NameBufferSize;
+    UNICODE_STRING Name, ParentName;
 
-    __try {
+    RtlInitEmptyUnicodeString(host_name, NULL, 0);
 
-        *name_length = 0;
+    __try {
 
         if (gsup.Initialized == FALSE) {
-            return NULL;
+            return FALSE;
         }
         RtlInitEmptyUnicodeString(&ParentName, NULL, 0);
         gsup.RtlInitUnicodeString(&Name, apiset_name);
@@ -705,52 +1119,96 @@ LPWSTR resolve_apiset_name(
             gsup.RtlInitUnicodeString(&ParentName, parent_name);
         }
 
-        ApiSetNamespace = (PAPI_SET_NAMESPACE)gsup.ApiSetMap;
-        RtlInitEmptyUnicodeString(&ResolvedName, NULL, 0);
-
-        switch (ApiSetNamespace->Version) {
-
-        case API_SET_SCHEMA_VERSION_V2:
-            Status = ApiSetResolveToHostV2(ApiSetNamespace, &Name, (parent_name != NULL) ? &ParentName : NULL, &ResolvedName);
-            break;
-
-        case API_SET_SCHEMA_VERSION_V4:
-            Status = ApiSetResolveToHostV4(ApiSetNamespace, &Name, (parent_name != NULL) ? &ParentName : NULL, &ResolvedName);
-            break;
+        if (schema == NULL) {
+            schema = apiset_schema_acquire(NULL);
+            if (schema == NULL) {
+                return FALSE;
+            }
+        }
 
-        case API_SET_SCHEMA_VERSION_V6:
-            Status = ApiSetResolveToHostV6(ApiSetNamespace, &Name, (parent_name != NULL) ? &ParentName : NULL, &ResolvedName);
-            break;
+        ApiSetNamespace = schema->Namespace;
 
-        default:
-            break;
+        //
+        // Use lookup index if it was built for this namespace.
+        //
+        if (schema->Index && schema->Index->Namespace == ApiSetNamespace) {
+            Status = ApiSetIndexResolveToHost(schema->Index,
+                &Name,
+                (parent_name != NULL) ? &ParentName : NULL,
+                host_name);
         }
+        else {
 
-        if (NT_SUCCESS(Status) && ResolvedName.Length) {
+            switch (ApiSetNamespace->Version) {
 
-            NameBufferSize = ResolvedName.Length + sizeof(UNICODE_NULL);
-            ResolvedNameBuffer = (LPWSTR)heap_calloc(NULL, NameBufferSize);
-            if (ResolvedNameBuffer) {
+            case API_SET_SCHEMA_VERSION_V2:
+                Status = ApiSetResolveToHostV2(ApiSetNamespace, &Name, (parent_name != NULL) ? &ParentName : NULL, host_name);
+                break;
 
-                if (S_OK == StringCbCopyN(ResolvedNameBuffer, 
-                    NameBufferSize,
-                    ResolvedName.Buffer, 
-                    ResolvedName.Length)) 
-                {
-                    *name_length = ResolvedName.Length;
-                    return ResolvedNameBuffer;
-                }
-                else {
-                    heap_free(NULL, ResolvedNameBuffer);
-                    return NULL;
-                }
+            case API_SET_SCHEMA_VERSION_V4:
+                Status = ApiSetResolveToHostV4(ApiSetNamespace, &Name, (parent_name != NULL) ? &ParentName : NULL, host_name);
+                break;
+
+            case API_SET_SCHEMA_VERSION_V6:
+                Status = ApiSetResolveToHostV6(ApiSetNamespace, &Name, (parent_name != NULL) ? &ParentName : NULL, host_name);
+                break;
 
+            default:
+                break;
             }
         }
 
     }
     __except (ex_filter(GetExceptionCode(), GetExceptionInformation())) {
-        printf("exception in resolve_apiset_name\r\n");
+        printf("exception in resolve_apiset_host\r\n");
+        RtlInitEmptyUnicodeString(host_name, NULL, 0);
+        return FALSE;
+    }
+
+    return (NT_SUCCESS(Status) && host_name->Length != 0);
+}
+
+/*
+* resolve_apiset_name
+*
+* Purpose:
+*
+* Lookup apiset target dll by contract name.
+* Returned buffer must be released with heap_free.
+*
+*/
+_Success_(return != NULL)
+LPWSTR resolve_apiset_name(
+    _In_opt_ PAPISET_SCHEMA schema,
+    _In_ LPCWSTR apiset_name,
+    _In_opt_ LPCWSTR parent_name,
+    _Out_ SIZE_T * name_length
+)
+{
+    UNICODE_STRING ResolvedName;
+    LPWSTR ResolvedNameBuffer;
+    SIZE_T NameBufferSize;
+
+    *name_length = 0;
+
+    if (!resolve_apiset_host(schema, apiset_name, parent_name, &ResolvedName)) {
+        return NULL;
+    }
+
+    NameBufferSize = ResolvedName.Length + sizeof(UNICODE_NULL);
+    ResolvedNameBuffer = (LPWSTR)heap_calloc(NULL, NameBufferSize);
+    if (ResolvedNameBuffer) {
+
+        if (S_OK == StringCbCopyN(ResolvedNameBuffer, 
+            NameBufferSize,
+            ResolvedName.Buffer, 
+            ResolvedName.Length)) 
+        {
+            *name_length = ResolvedName.Length;
+            return ResolvedNameBuffer;
+        }
+
+        heap_free(NULL, ResolvedNameBuffer);
     }
 
     return NULL;
@@ -831,32 +1289,24 @@ LPVOID get_manifest_base64(
 }
 
 /*
-* get_params_token
+* get_params_next_token
 *
 * Purpose:
 *
-* Query tokens from parameters string.
+* Query token at the cursor from parameters string and move the cursor past it.
+* Token that does not fit the buffer is truncated, the cursor still moves past it.
 *
 */
-/*
-* get_params_token
-*
-* Purpose:
-*
-* Query tokens from parameters string.
-*
-*/
-_Success_(return) BOOL get_params_token(
-    _In_ LPCWSTR params,
-    _In_ ULONG token_index,
-    _Out_ LPWSTR buffer,
+_Success_(return) BOOL get_params_next_token(
+    _Inout_ LPCWSTR* cursor,
+    _Out_opt_ LPWSTR buffer,
     _In_ ULONG buffer_length,
     _Out_ PULONG token_len
 )
 {
-    ULONG c, plen = 0;
+    ULONG plen = 0;
     WCHAR divider;
-    BOOL overflow = FALSE;
+    LPCWSTR params = *cursor;
 
     *token_len = 0;
 
@@ -867,54 +1317,63 @@ _Success_(return) BOOL get_params_token(
         return FALSE;
     }
 
-    for (c = 0; c <= token_index; c++) {
-        plen = 0;
-
-        while (*params == ' ') {
-            params++;
-        }
-
-        switch (*params) {
-        case 0:
-            goto zero_term_exit;
-
-        case '"':
-            params++;
-            divider = '"';
-            break;
+    while (*params == ' ') {
+        params++;
+    }
 
-        default:
-            divider = ' ';
-        }
+    if (*params == '"') {
+        params++;
+        divider = '"';
+    }
+    else {
+        divider = ' ';
+    }
 
-        while ((*params != '"') && (*params != divider) && (*params != 0)) {
-            plen++;
-            if (c == token_index) {
-                if (plen < buffer_length) {
-                    if (buffer != NULL) {
-                        *buffer = *params;
-                        buffer++;
-                    }
-                }
-                else {
-                    overflow = TRUE;
-                }
-            }
-            params++;
+    while ((*params != '"') && (*params != divider) && (*params != 0)) {
+        plen++;
+        if ((buffer != NULL) && (plen < buffer_length)) {
+            *buffer = *params;
+            buffer++;
         }
-
-        if (*params != 0)
-            params++;
+        params++;
     }
 
-zero_term_exit:
+    if (*params != 0)
+        params++;
 
     if ((buffer != NULL) && (buffer_length > 0))
         *buffer = 0;
 
+    *cursor = params;
     *token_len = plen;
 
-    return (plen < buffer_length && !overflow) ? TRUE : FALSE;
+    return (plen < buffer_length) ? TRUE : FALSE;
+}
+
+/*
+* get_params_token
+*
+* Purpose:
+*
+* Query tokens from parameters string.
+*
+*/
+_Success_(return) BOOL get_params_token(
+    _In_ LPCWSTR params,
+    _In_ ULONG token_index,
+    _Out_ LPWSTR buffer,
+    _In_ ULONG buffer_length,
+    _Out_ PULONG token_len
+)
+{
+    ULONG c, plen;
+    LPCWSTR cursor = params;
+
+    for (c = 0; c < token_index && cursor != NULL; c++) {
+        get_params_next_token(&cursor, NULL, 0, &plen);
+    }
+
+    return get_params_next_token(&cursor, buffer, buffer_length, token_len);
 }
 
 /*
@@ -923,6 +1382,7 @@ zero_term_exit:
 * Purpose:
 *
 * Query parameters options by name and type.
+* Tokens too long to be an option name (e.g. long values) are skipped.
 *
 */
 _Success_(return) BOOL get_params_option(
@@ -937,7 +1397,7 @@ _Success_(return) BOOL get_params_option(
     BOOL result;
     WCHAR param_buffer[MAX_PATH + 1];
     ULONG rlen;
-    INT	i = 0;
+    LPCWSTR cursor = params;
 
     if (param_length)
         *param_length = 0;
@@ -952,21 +1412,25 @@ _Success_(return) BOOL get_params_option(
     if (value)
         *value = L'\0';
 
+    if (params == NULL)
+        return FALSE;
+
     RtlSecureZeroMemory(param_buffer, sizeof(param_buffer));
 
-    while (get_params_token(
-        params,
-        i,
-        param_buffer,
-        MAX_PATH,
-        &rlen))
-    {
+    while (TRUE) {
+
+        result = get_params_next_token(
+            &cursor,
+            param_buffer,
+            MAX_PATH,
+            &rlen);
+
         if (rlen == 0)
             break;
 
-        if (wcscmp(param_buffer, option_name) == 0) {
+        if (result && wcscmp(param_buffer, option_name) == 0) {
             if (is_parametric) {
-                result = get_params_token(params, i + 1, value, value_length, &rlen);
+                result = get_params_next_token(&cursor, value, value_length, &rlen);
                 if (param_length)
                     *param_length = rlen;
                 return result;
@@ -974,7 +1438,6 @@ _Success_(return) BOOL get_params_option(
 
             return TRUE;
         }
-        ++i;
     }
 
     return FALSE;
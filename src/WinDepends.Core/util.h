@@ -3,7 +3,7 @@
 *
 *  Created on: Aug 04, 2024
 *
-*  Modified on: Dec 21, 2025
+*  Modified on: Oct 18, 2026
 *
 *      Project: WinDepends.Core
 *
@@ -20,24 +20,39 @@ typedef struct _SUP_PATH_ELEMENT_ENTRY {
     PWSTR Element;
 } SUP_PATH_ELEMENT_ENTRY, * PSUP_PATH_ELEMENT_ENTRY;
 
+typedef struct _SUP_KNOWNDLLS_SET {
+    SUP_PATH_ELEMENT_ENTRY Head;
+    PWSTR Path;
+    SIZE_T NameCbMax;
+    SIZE_T PathCbMax;
+} SUP_KNOWNDLLS_SET, * PSUP_KNOWNDLLS_SET;
+
+//
+// KnownDlls sets loaded from a snapshot file by a single client,
+// used instead of the server wide sets until the client drops them.
+//
+typedef struct _SUP_KNOWNDLLS_SNAPSHOT {
+    BOOL Loaded;
+    ULONG64 Version;
+    SUP_KNOWNDLLS_SET KnownDlls;
+    SUP_KNOWNDLLS_SET KnownDlls32;
+} SUP_KNOWNDLLS_SNAPSHOT, * PSUP_KNOWNDLLS_SNAPSHOT;
+
+#define KNOWNDLLS_SNAPSHOT_MAX_SIZE (4 * 1024 * 1024)
+
 typedef struct _SUP_CONTEXT {
     BOOL Initialized;
 
-    SIZE_T KnownDllsNameCbMax;
-    SIZE_T KnownDlls32NameCbMax;
-
-    SUP_PATH_ELEMENT_ENTRY KnownDllsHead;
-    SUP_PATH_ELEMENT_ENTRY KnownDlls32Head;
-
-    PWSTR KnownDllsPath;
-    PWSTR KnownDlls32Path;
-
-    SIZE_T KnownDllsPathCbMax;
-    SIZE_T KnownDlls32PathCbMax;
+    //
+    // Server wide KnownDlls sets read from object directories, version is
+    // a hash of their content. Snapshots are kept per client connection.
+    //
+    SRWLOCK KnownDllsLock;
+    ULONG64 KnownDllsVersion;
+    SUP_KNOWNDLLS_SET KnownDlls;
+    SUP_KNOWNDLLS_SET KnownDlls32;
 
-    BOOL UseApiSetMapFile;
     PVOID ApiSetMap;
-    HMODULE ApiSetMapModule;
 
     BOOL EnableCallStats;
     LARGE_INTEGER PerformanceFrequency;
@@ -97,6 +112,37 @@ extern SUP_CONTEXT gsup;
 
 void utils_init();
 
+BOOL build_knowndlls_list(
+    _In_ BOOL IsWow64,
+    _Inout_ PSUP_KNOWNDLLS_SET Set
+);
+
+VOID free_knowndlls_list(
+    _Inout_ PSUP_KNOWNDLLS_SET Set
+);
+
+ULONG64 get_knowndlls_version(
+    _In_ PSUP_KNOWNDLLS_SET Set,
+    _In_ PSUP_KNOWNDLLS_SET Set32
+);
+
+BOOL load_knowndlls_snapshot(
+    _In_ LPCWSTR file_name,
+    _Inout_ PSUP_KNOWNDLLS_SET Set,
+    _Inout_ PSUP_KNOWNDLLS_SET Set32
+);
+
+typedef int(CALLBACK* PREPLY_SINK)(
+    _In_reads_bytes_(length) const char* data,
+    _In_ int length,
+    _In_opt_ PVOID sink_context
+    );
+
+VOID set_reply_sink(
+    _In_opt_ PREPLY_SINK sink,
+    _In_opt_ PVOID sink_context
+);
+
 int sendstring_plaintext(
     _In_ SOCKET s,
     _In_ const wchar_t* Buffer,
@@ -108,16 +154,30 @@ int sendstring_plaintext_no_track(
     _In_ const wchar_t* Buffer
 );
 
-PVOID load_apiset_namespace(
+HANDLE open_apiset_schema(
     _In_ LPCWSTR apiset_schema_dll,
-    _Out_opt_ HMODULE* phModule
+    _Out_ LPBY_HANDLE_FILE_INFORMATION file_info
+);
+
+PVOID map_apiset_namespace(
+    _In_ HANDLE file_handle,
+    _In_ LPBY_HANDLE_FILE_INFORMATION file_info,
+    _Out_ PVOID* view_base
+);
+
+VOID unmap_apiset_namespace(
+    _In_opt_ PVOID view_base
 );
 
-VOID unload_apiset_namespace(
-    _In_ HMODULE hModule
+_Success_(return) BOOL resolve_apiset_host(
+    _In_opt_ PAPISET_SCHEMA schema,
+    _In_ LPCWSTR apiset_name,
+    _In_opt_ LPCWSTR parent_name,
+    _Out_ PUNICODE_STRING host_name
 );
 
 _Success_(return != NULL) LPWSTR resolve_apiset_name(
+    _In_opt_ PAPISET_SCHEMA schema,
     _In_ LPCWSTR apiset_name,
     _In_opt_ LPCWSTR parent_name,
     _Out_ SIZE_T * name_length
@@ -136,6 +196,13 @@ DWORD calc_mapped_file_chksum(
 LPVOID get_manifest_base64(
     _In_ HMODULE module);
 
+_Success_(return) BOOL get_params_next_token(
+    _Inout_ LPCWSTR* cursor,
+    _Out_opt_ LPWSTR buffer,
+    _In_ ULONG buffer_length, //in chars
+    _Out_ PULONG token_len
+);
+
 _Success_(return) BOOL get_params_token(
     _In_ LPCWSTR params,
     _In_ ULONG token_index,
@@ -6,7 +6,7 @@
 *
 *  VERSION:     1.00
 *
-*  DATE:        12 Jul 2026
+*  DATE:        18 Oct 2026
 *
 * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF
 * ANY KIND, EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED
@@ -73,6 +73,7 @@ public static class CConsts
     public const int TagUseCustomImageBase = 605;
     public const int TagEnableExperimentalFeatures = 606;
     public const int TagExpandForwarders = 607;
+    public const int TagSymbolsPrefetch = 608;
 
     public const int TagTbUseClassic = 1000;
     public const int TagTbUseModern = 1001;
@@ -127,6 +128,47 @@ public static class CConsts
     public const int FindDialogVerticalOffset = 100;
     public const int MaxTreeNodeStackSize = 1024;
 
+    /// <summary>
+    /// Maximum count of module tree nodes appended in a single TVModules update.
+    /// </summary>
+    public const int ModuleTreeBatchSize = 64;
+    /// <summary>
+    /// Time in milliseconds the UI thread waits for analyzed modules before pumping messages.
+    /// </summary>
+    public const int ModuleTreeBatchWaitMs = 50;
+    /// <summary>
+    /// Maximum count of API Set contracts sent in a single batched resolve request.
+    /// </summary>
+    public const int ApiSetResolveBatchSize = 256;
+    /// <summary>
+    /// Maximum length of a contract token in a batched resolve request, longer names are resolved one by one.
+    /// </summary>
+    public const int ApiSetResolveBatchMaxName = 260;
+    /// <summary>
+    /// Maximum count of files sent in a single debug information request.
+    /// </summary>
+    public const int DebugInfoBatchSize = 64;
+    /// <summary>
+    /// Count of symbol prefetch workers copying PDB files from local symbol stores.
+    /// </summary>
+    public const int SymbolPrefetchWorkerCount = 4;
+    /// <summary>
+    /// Maximum count of symbol modules kept loaded by the symbol resolver.
+    /// </summary>
+    public const int SymbolLoadedModulesMax = 64;
+    /// <summary>
+    /// Maximum count of undecorated names kept by the process-wide undecoration cache.
+    /// </summary>
+    public const int UndecoratedNameCacheMax = 65536;
+    /// <summary>
+    /// Count of names dropped from the undecoration cache when it grows over the limit.
+    /// </summary>
+    public const int UndecoratedNameCacheTrim = 16384;
+    /// <summary>
+    /// Size of the output buffer used by the exporters, pending output is flushed to file when it is full.
+    /// </summary>
+    public const int ExportBufferSize = 65536;
+
     public const float DefaultGuiFontSize = 9f;
     public static readonly float[] AvailableGuiFontSizes = [8f, 9f, 10f, 11f, 12f];
 
@@ -161,8 +203,15 @@ public static class CConsts
     public const string CMD_DATADIRS = "datadirs\r\n";
     public const string CMD_KNOWNDLLS32 = "knowndlls 32\r\n";
     public const string CMD_KNOWNDLLS64 = "knowndlls 64\r\n";
+    public const string CMD_KNOWNDLLSVER = "knowndllsver\r\n";
     public const string CMD_CALLSTATS = "callstats\r\n";
+    public const string CMD_STATS = "stats\r\n";
+    public const string CMD_STATS_RESET = "stats reset\r\n";
+    public const string CMD_TRACE = "trace\r\n";
+    public const string CMD_TRACE_ON = "trace on\r\n";
+    public const string CMD_TRACE_OFF = "trace off\r\n";
     public const string CMD_APISETNINFO = "apisetnsinfo\r\n";
+    public const string CMD_APISETDUMP = "apisetdump\r\n";
     public const string CMD_CLOSE = "close\r\n";
     public const string CMD_EXIT = "exit\r\n";
     public const string CMD_SHUTDOWN = "shutdown\r\n";
@@ -177,6 +226,11 @@ public static class CConsts
     //
     public const string ShortcutFileExt = ".lnk";
 
+    //
+    // Environment variable with trace-event output file name for GUI sessions.
+    //
+    public const string TraceEnvironmentVariable = "WINDEPENDS_TRACE";
+
     // File extensions
     public const string DllFileExt = ".dll";
     public const string ExeFileExt = ".exe";
@@ -262,6 +316,10 @@ public static class CConsts
     /// </summary>
     public const string WDEP_STATUS_404 = "WDEP/1.0 404 File not found or can not be accessed\r\n";
     /// <summary>
+    /// Msg: Command unknown or not allowed
+    /// </summary>
+    public const string WDEP_STATUS_405 = "WDEP/1.0 405 Command unknown or not allowed\r\n";
+    /// <summary>
     /// Msg: Invaild file headers or signatures
     /// </summary>
     public const string WDEP_STATUS_415 = "WDEP/1.0 415 Invalid file headers or signatures\r\n";
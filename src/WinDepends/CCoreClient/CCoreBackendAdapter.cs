@@ -6,7 +6,7 @@
 *
 *  VERSION:     1.00
 *
-*  DATE:        14 Jul 2026
+*  DATE:        18 Oct 2026
 *
 *  Core backend transport/protocol/domain adapter objects.
 *
@@ -137,17 +137,64 @@ internal static class CCoreProtocolMapper
     {
         var sb = new StringBuilder($"open file \"{module.FileName}\"");
 
+        AppendOpenOptions(sb, settings);
+
+        sb.Append("\r\n");
+        return new CCoreBackendRequest(sb.ToString());
+    }
+
+    /// <summary>
+    /// Constructs the "openresolve" command request, the server probes search directories
+    /// for the module file name in the given order and opens the first match.
+    /// </summary>
+    /// <param name="module">Module descriptor whose FileName is the file name to look for.</param>
+    /// <param name="searchDirectories">Ordered list of directories to probe.</param>
+    /// <param name="settings">File-open options controlling which optional flags are appended.</param>
+    /// <returns>
+    /// A <see cref="CCoreBackendRequest"/> containing the fully formed "openresolve name ... dirs ..." command
+    /// terminated with CRLF.
+    /// </returns>
+    /// <remarks>
+    /// Options go before the directory list, which is usually longer than the server option scanner buffer.
+    /// </remarks>
+    public static CCoreBackendRequest BuildOpenResolveRequest(CModule module,
+        IReadOnlyList<(string Directory, SearchOrderType SearchOrder)> searchDirectories,
+        CFileOpenSettings settings)
+    {
+        var sb = new StringBuilder($"openresolve name \"{module.FileName}\"");
+
+        AppendOpenOptions(sb, settings);
+
+        sb.Append(" dirs \"");
+        for (int i = 0; i < searchDirectories.Count; i++)
+        {
+            if (i > 0)
+                sb.Append(';');
+            sb.Append(searchDirectories[i].Directory);
+        }
+        sb.Append("\"\r\n");
+        return new CCoreBackendRequest(sb.ToString());
+    }
+
+    /// <summary>
+    /// Appends optional processing flags shared by "open" and "openresolve" commands.
+    /// </summary>
+    /// <param name="sb">Command being built.</param>
+    /// <param name="settings">File-open options.</param>
+    private static void AppendOpenOptions(StringBuilder sb, CFileOpenSettings settings)
+    {
         if (settings.UseStats)
             sb.Append(" use_stats");
 
         if (settings.ProcessRelocsForImage)
+        {
             sb.Append(" process_relocs");
+            if (settings.LazyRelocs)
+                sb.Append(" lazy_relocs");
+        }
 
         if (settings.UseCustomImageBase)
             sb.Append($" custom_image_base {settings.CustomImageBase}");
-
-        sb.Append("\r\n");
-        return new CCoreBackendRequest(sb.ToString());
     }
 
     /// <summary>
@@ -270,6 +317,49 @@ internal static class CCoreProtocolMapper
         return new(CConsts.CMD_APISETNINFO);
     }
 
+    /// <summary>
+    /// Constructs the request that resolves a list of API set contracts in a single round trip.
+    /// </summary>
+    /// <remarks>
+    /// Each contract is sent as "contract" or "contract:parent" token; the reply lists
+    /// resolutions in request order.
+    /// </remarks>
+    /// <param name="contracts">Contract names with optional importing module names.</param>
+    /// <returns>A <see cref="CCoreBackendRequest"/> for the "apisetresolvebatch" command.</returns>
+    public static CCoreBackendRequest BuildApiSetResolveBatchRequest(IEnumerable<(string Contract, string Parent)> contracts)
+    {
+        var sb = new StringBuilder("apisetresolvebatch");
+
+        foreach (var (contract, parent) in contracts)
+        {
+            sb.Append(' ').Append(contract);
+            if (!string.IsNullOrEmpty(parent))
+                sb.Append(':').Append(parent);
+        }
+
+        sb.Append("\r\n");
+        return new CCoreBackendRequest(sb.ToString());
+    }
+
+    /// <summary>
+    /// Constructs the request that reads debug directory records (PDB identity, POGO, VC features)
+    /// of a list of files in a single round trip.
+    /// </summary>
+    /// <param name="fileNames">Full paths of the files.</param>
+    /// <returns>A <see cref="CCoreBackendRequest"/> for the "debuginfo" command.</returns>
+    public static CCoreBackendRequest BuildDebugInfoRequest(IEnumerable<string> fileNames)
+    {
+        var sb = new StringBuilder("debuginfo");
+
+        foreach (var fileName in fileNames)
+        {
+            sb.Append(" \"").Append(fileName).Append('"');
+        }
+
+        sb.Append("\r\n");
+        return new CCoreBackendRequest(sb.ToString());
+    }
+
     /// <summary>
     /// Constructs the request that instructs the server which API set schema source to use
     /// for subsequent resolve operations.
@@ -291,6 +381,25 @@ internal static class CCoreProtocolMapper
         return new($"apisetmapsrc file \"{fileName}\"\r\n");
     }
 
+    /// <summary>
+    /// Builds a request that replaces server KnownDlls sets with a snapshot file.
+    /// </summary>
+    /// <remarks>
+    /// Snapshot is kept by the server for this connection only, other clients keep the running system sets.
+    /// </remarks>
+    /// <param name="fileName">
+    /// Path to the KnownDlls snapshot file,
+    /// or null/empty to drop the snapshot and use the running system sets again.
+    /// </param>
+    /// <returns>A <see cref="CCoreBackendRequest"/> for the "knowndllsload" command.</returns>
+    public static CCoreBackendRequest BuildKnownDllsLoadRequest(string fileName)
+    {
+        if (string.IsNullOrEmpty(fileName))
+            return new("knowndllsload\r\n");
+
+        return new($"knowndllsload file \"{fileName}\"\r\n");
+    }
+
     /// <summary>
     /// Applies error flags to a module descriptor and returns the specified status code.
     /// </summary>
@@ -337,20 +446,22 @@ internal static class CCoreDomainMapper
         if (module == null || fileInformation == null)
             return ModuleOpenStatus.ErrorUnspecified;
 
-        module.ModuleData.Attributes = (ModuleFileAttributes)fileInformation.FileAttributes;
-        module.ModuleData.RealChecksum = fileInformation.RealChecksum;
-        module.ModuleData.ImageFixed = fileInformation.ImageFixed;
-        module.ModuleData.ImageDotNet = fileInformation.ImageDotNet;
-        module.ModuleData.FileSize = fileInformation.FileSizeLow | ((ulong)fileInformation.FileSizeHigh << 32);
+        CModuleData moduleData = module.GetWritableModuleData();
+
+        moduleData.Attributes = (ModuleFileAttributes)fileInformation.FileAttributes;
+        moduleData.RealChecksum = fileInformation.RealChecksum;
+        moduleData.ImageFixed = fileInformation.ImageFixed;
+        moduleData.ImageDotNet = fileInformation.ImageDotNet;
+        moduleData.FileSize = fileInformation.FileSizeLow | ((ulong)fileInformation.FileSizeHigh << 32);
 
         long fileTime = ((long)fileInformation.LastWriteTimeHigh << 32) | fileInformation.LastWriteTimeLow;
         try
         {
-            module.ModuleData.FileTimeStamp = DateTime.FromFileTime(fileTime < 0 ? 0 : fileTime);
+            moduleData.FileTimeStamp = DateTime.FromFileTime(fileTime < 0 ? 0 : fileTime);
         }
         catch
         {
-            module.ModuleData.FileTimeStamp = DateTime.MinValue;
+            moduleData.FileTimeStamp = DateTime.MinValue;
         }
 
         return ModuleOpenStatus.Okay;
@@ -371,6 +482,18 @@ internal sealed class CCoreTransportAdapter
     private readonly Func<TcpClient?> _clientAccessor;
     private readonly Func<NetworkStream?> _streamAccessor;
     private readonly AddLogMessageCallback _addLogMessage;
+    private long _bytesSent;
+    private long _bytesReceived;
+
+    /// <summary>
+    /// Total bytes written to the server.
+    /// </summary>
+    public long BytesSent => _bytesSent;
+
+    /// <summary>
+    /// Total bytes read from the server.
+    /// </summary>
+    public long BytesReceived => _bytesReceived;
 
     public CCoreTransportAdapter(
         Func<TcpClient?> clientAccessor,
@@ -417,7 +540,9 @@ internal sealed class CCoreTransportAdapter
         try
         {
             using BinaryWriter bw = new(stream, Encoding.Unicode, true);
-            bw.Write(Encoding.Unicode.GetBytes(request.Command));
+            byte[] data = Encoding.Unicode.GetBytes(request.Command);
+            bw.Write(data);
+            _bytesSent += data.Length;
         }
         catch (Exception ex)
         {
@@ -466,6 +591,7 @@ internal sealed class CCoreTransportAdapter
                     {
                         bufferChain.Data[i] = br.ReadChar();
                         bufferChain.DataSize++;
+                        _bytesReceived += sizeof(char);
 
                         if (bufferChain.Data[i] == '\n' && previousChar == '\r')
                         {
@@ -6,7 +6,7 @@
 *
 *  VERSION:     1.00
 *
-*  DATE:        17 Jul 2026
+*  DATE:        18 Oct 2026
 *  
 *  Module dependency/import/export analysis for 
 *  Core Server communication class.
@@ -137,11 +137,17 @@ public partial class CCoreClient
         }
 
         // Resolve module path.
-        var moduleFileName = CPathResolver.ResolvePathForModule(moduleName,
-                                                                parentModule,
-                                                                searchOrderUM,
-                                                                searchOrderKM,
-                                                                out SearchOrderType resolvedBy);
+        string moduleFileName;
+        SearchOrderType resolvedBy;
+        using (CTraceRecorder.BeginSpan("resolve", "client", moduleName))
+        {
+            moduleFileName = CPathResolver.ResolvePathForModule(moduleName,
+                                                                    parentModule,
+                                                                    searchOrderUM,
+                                                                    searchOrderKM,
+                                                                    out resolvedBy,
+                                                                    DeferDirectorySearch && !_openResolveUnavailable);
+        }
 
         if (!string.IsNullOrEmpty(moduleFileName))
         {
@@ -177,12 +183,13 @@ public partial class CCoreClient
             {
                 netDependent = new(reference.Name, reference.Name, SearchOrderType.None, false);
             }
-            netDependent.ModuleData.RuntimeVersion = module.ModuleData.RuntimeVersion;
-            netDependent.ModuleData.FrameworkKind = module.ModuleData.FrameworkKind;
-            netDependent.ModuleData.ResolutionSource = reference.ResolutionSource;
-            netDependent.ModuleData.ReferenceVersion = reference.Version;
-            netDependent.ModuleData.ReferencePublicKeyToken = reference.PublicKeyToken;
-            netDependent.ModuleData.ReferenceCulture = reference.Culture;
+            var netDependentData = netDependent.GetWritableModuleData();
+            netDependentData.RuntimeVersion = module.ModuleData.RuntimeVersion;
+            netDependentData.FrameworkKind = module.ModuleData.FrameworkKind;
+            netDependentData.ResolutionSource = reference.ResolutionSource;
+            netDependentData.ReferenceVersion = reference.Version;
+            netDependentData.ReferencePublicKeyToken = reference.PublicKeyToken;
+            netDependentData.ReferenceCulture = reference.Culture;
             netDependent.IsDotNetModule = true;
             module.Dependents.Add(netDependent);
         }
@@ -206,6 +213,8 @@ public partial class CCoreClient
                                 List<SearchOrderType> searchOrderKM,
                                 Dictionary<int, FunctionHashObject> parentImportsHashTable)
     {
+        PrefetchApiSetNames(LibraryList.Select(entry => entry.Name), module);
+
         foreach (var entry in LibraryList)
         {
             var dependent = AddDependentModule(module, DelayLibraries,
@@ -234,10 +243,12 @@ public partial class CCoreClient
         if (module == null || rawExports?.Library == null)
             return;
 
+        var moduleData = module.GetWritableModuleData();
+
         foreach (var entry in rawExports.Library.Function)
         {
             var cf = new CFunction(entry);
-            module.ModuleData.Exports.Add(cf);
+            moduleData.Exports.Add(cf);
 
             // Collect forwarder metadata
             if (collectForwarders && !string.IsNullOrEmpty(cf.ForwardName))
@@ -337,15 +348,19 @@ public partial class CCoreClient
         //
         // Process exports.
         //
-        CCoreExports rawExports = (CCoreExports)GetModuleInformationByType(ModuleInformationType.Exports, module);
-        if (rawExports != null)
+        using (CTraceRecorder.BeginSpan("exports", "core", module.FileName))
         {
-            ProcessExports(module, CollectForwarders, rawExports);
+            CCoreExports rawExports = (CCoreExports)GetModuleInformationByType(ModuleInformationType.Exports, module);
+            if (rawExports != null)
+            {
+                ProcessExports(module, CollectForwarders, rawExports);
+            }
         }
 
         //
         // Process imports.
         //
+        using var importsSpan = CTraceRecorder.BeginSpan("imports", "core", module.FileName);
         CCoreImports rawImports = (CCoreImports)GetModuleInformationByType(ModuleInformationType.Imports, module);
         if (rawImports != null)
         {
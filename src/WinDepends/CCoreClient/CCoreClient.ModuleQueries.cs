@@ -6,7 +6,7 @@
 *
 *  VERSION:     1.00
 *
-*  DATE:        23 May 2026
+*  DATE:        18 Oct 2026
 *  
 *  Module and server query routines for 
 *  Core Server communication class.
@@ -22,33 +22,148 @@ namespace WinDepends;
 
 public partial class CCoreClient
 {
+    private static readonly char[] ApiSetBatchSeparators = [' ', '"', ':'];
+
     /// <summary>
     /// Resolves an API Set contract name to its implementation module name.
     /// </summary>
     /// <param name="moduleName">The API Set contract name to resolve.</param>
-    /// <param name="contextModule">The module context for resolution.</param>
+    /// <param name="contextModule">The importing module, selects parent specific host if any.</param>
     /// <returns>The resolved module name, or the original name if resolution fails.</returns>
+    /// <remarks>
+    /// Single contract server request has no parent argument and always returns the default host;
+    /// parent specific hosts are honored with the namespace snapshot and batched prefetch.
+    /// </remarks>
     private string ResolveApiSetName(string moduleName, CModule contextModule)
     {
+        string parentName = GetApiSetParentName(contextModule);
+
         // Try cache first
-        string resolvedName = CApiSetCacheManager.GetResolvedNameByApiSetName(moduleName);
+        string resolvedName = CApiSetCacheManager.GetResolvedNameByApiSetName(moduleName, parentName);
         if (resolvedName != null)
             return resolvedName;
 
-        // Cache miss - resolve via server request
+        // Resolve locally from namespace snapshot when server supports it
+        var snapshot = GetApiSetNamespaceSnapshot();
+        if (snapshot != null)
+        {
+            if (!snapshot.TryResolve(moduleName, parentName, out resolvedName))
+                return moduleName;
+
+            CApiSetCacheManager.AddApiSet(moduleName, parentName, resolvedName);
+            return resolvedName;
+        }
+
+        // Resolve via server request
         var resolvedInfo = (CCoreResolvedFileName)GetModuleInformationByType(
             ModuleInformationType.ApiSetName, contextModule, moduleName);
 
         if (resolvedInfo != null)
         {
             resolvedName = resolvedInfo.Name;
-            CApiSetCacheManager.AddApiSet(moduleName, resolvedName);
+            CApiSetCacheManager.AddApiSet(moduleName, parentName, resolvedName);
             return resolvedName;
         }
 
         return moduleName;
     }
 
+    /// <summary>
+    /// Resolves all not yet cached API Set contracts from the list with batched server requests.
+    /// </summary>
+    /// <remarks>
+    /// Used only when the namespace snapshot is not available; results are placed into
+    /// <see cref="CApiSetCacheManager"/> so subsequent <see cref="ResolveApiSetName"/> calls are cache hits.
+    /// </remarks>
+    /// <param name="moduleNames">Imported module names, non-contract names are skipped.</param>
+    /// <param name="contextModule">The importing module, sent as parent of every contract.</param>
+    private void PrefetchApiSetNames(IEnumerable<string> moduleNames, CModule contextModule)
+    {
+        if (_apiSetBatchUnavailable || GetApiSetNamespaceSnapshot() != null)
+            return;
+
+        string parentName = GetApiSetParentName(contextModule);
+        int parentLength = 0;
+
+        if (!string.IsNullOrEmpty(parentName))
+        {
+            // Parent must fit the same token, otherwise results would be cached for the wrong key.
+            if (parentName.IndexOfAny(ApiSetBatchSeparators) >= 0)
+                return;
+
+            parentLength = parentName.Length + 1;
+        }
+
+        // Names the server cannot take as a single token are left to per-contract requests.
+        var pending = moduleNames
+            .Where(name => CUtils.IsModuleNameApiSetContract(name) &&
+                name.Length + parentLength <= CConsts.ApiSetResolveBatchMaxName &&
+                name.IndexOfAny(ApiSetBatchSeparators) < 0 &&
+                CApiSetCacheManager.GetResolvedNameByApiSetName(name, parentName) == null)
+            .Distinct(StringComparer.OrdinalIgnoreCase)
+            .ToList();
+
+        if (pending.Count < 2)
+            return;
+
+        foreach (var chunk in pending.Chunk(CConsts.ApiSetResolveBatchSize))
+        {
+            var batch = ResolveApiSetNames(chunk.Select(name => (name, parentName)));
+            if (batch?.Entries == null)
+            {
+                // Older server, keep resolving contracts one by one. Other failures only skip this prefetch.
+                if (_lastCommandUnknown)
+                    _apiSetBatchUnavailable = true;
+                return;
+            }
+
+            foreach (var entry in batch.Entries)
+            {
+                if (!string.IsNullOrEmpty(entry.Name) && !string.IsNullOrEmpty(entry.Path))
+                    CApiSetCacheManager.AddApiSet(entry.Name, parentName, entry.Path);
+            }
+        }
+    }
+
+    /// <summary>
+    /// Returns file name of the importing module as used by parent specific API Set hosts.
+    /// </summary>
+    private static string GetApiSetParentName(CModule contextModule)
+    {
+        return string.IsNullOrEmpty(contextModule?.FileName) ? null : Path.GetFileName(contextModule.FileName);
+    }
+
+    /// <summary>
+    /// Returns snapshot of the active server API Set namespace, requesting it once if required.
+    /// </summary>
+    /// <returns>Namespace snapshot, or null if the server cannot provide it.</returns>
+    private CApiSetNamespaceSnapshot GetApiSetNamespaceSnapshot()
+    {
+        var snapshot = CApiSetCacheManager.NamespaceSnapshot;
+        if (snapshot != null || _apiSetDumpUnavailable)
+            return snapshot;
+
+        var dump = GetApiSetNamespaceDump();
+        if (dump == null)
+        {
+            // Older server, fall back to per-contract requests. Other failures are retried on next call.
+            if (_lastCommandUnknown)
+                _apiSetDumpUnavailable = true;
+            return null;
+        }
+
+        snapshot = CApiSetNamespaceSnapshot.FromDump(dump);
+        if (snapshot == null)
+        {
+            // Unsupported schema, the same namespace gives the same result on retry.
+            _apiSetDumpUnavailable = true;
+            return null;
+        }
+
+        CApiSetCacheManager.NamespaceSnapshot = snapshot;
+        return snapshot;
+    }
+
     /// <summary>
     /// Opens a COFF module on the server for analysis.
     /// </summary>
@@ -62,12 +177,130 @@ public partial class CCoreClient
         ArgumentNullException.ThrowIfNull(module);
         ThrowIfDisposed();
 
+        using var span = CTraceRecorder.BeginSpan("open", "core", module.FileName);
+
         var openRequest = CCoreProtocolMapper.BuildOpenModuleRequest(module, settings);
         if (!SendRequest(openRequest))
         {
             return ModuleOpenStatus.ErrorSendCommand;
         }
 
+        return ReceiveOpenModuleReply(module);
+    }
+
+    /// <summary>
+    /// Opens a module on the server, letting the server find a not yet resolved module file.
+    /// </summary>
+    /// <param name="module">The module to open, its FileName is replaced with the found path.</param>
+    /// <param name="settings">Settings for opening the module.</param>
+    /// <param name="searchDirectories">
+    /// Ordered directories to probe, see <see cref="CPathResolver.GetSearchDirectories"/>.
+    /// </param>
+    /// <returns>A <see cref="ModuleOpenStatus"/> indicating the result of the operation.</returns>
+    /// <remarks>
+    /// Used for dependents whose directory search was deferred, see <see cref="DeferDirectorySearch"/>.
+    /// Lookup and open take a single request, the server answers probes from its shared directory
+    /// listing cache. Rooted file names use the plain open, servers without "openresolve" get
+    /// the directories probed on the client first.
+    /// </remarks>
+    /// <exception cref="ArgumentNullException">Thrown when module is null.</exception>
+    /// <exception cref="ObjectDisposedException">Thrown when the client has been disposed.</exception>
+    public ModuleOpenStatus OpenModule(ref CModule module, CFileOpenSettings settings,
+        IReadOnlyList<(string Directory, SearchOrderType SearchOrder)> searchDirectories)
+    {
+        ArgumentNullException.ThrowIfNull(module);
+        ThrowIfDisposed();
+
+        if (searchDirectories == null ||
+            searchDirectories.Count == 0 ||
+            string.IsNullOrEmpty(module.FileName) ||
+            Path.IsPathRooted(module.FileName))
+        {
+            return OpenModule(ref module, settings);
+        }
+
+        if (_openResolveUnavailable)
+        {
+            return OpenModuleFromSearchDirectories(ref module, settings, searchDirectories);
+        }
+
+        using var span = CTraceRecorder.BeginSpan("openresolve", "core", module.FileName);
+
+        var request = CCoreProtocolMapper.BuildOpenResolveRequest(module, searchDirectories, settings);
+        if (!SendRequest(request))
+        {
+            return ModuleOpenStatus.ErrorSendCommand;
+        }
+
+        CBufferChain idata = ReceiveReply();
+        if (IsNullOrEmptyResponse(idata))
+        {
+            return ModuleOpenStatus.ErrorReceivedDataInvalid;
+        }
+
+        var resolveStatus = CCoreProtocolMapper.CreateStatusResponse(idata);
+        if (!resolveStatus.IsSuccess)
+        {
+            if (string.Equals(resolveStatus.Value, CConsts.WDEP_STATUS_405, StringComparison.Ordinal))
+            {
+                // Older server, probe the directories here.
+                _openResolveUnavailable = true;
+                return OpenModuleFromSearchDirectories(ref module, settings, searchDirectories);
+            }
+
+            return CCoreProtocolMapper.MapOpenModuleStatus(resolveStatus, module);
+        }
+
+        idata = ReceiveReply();
+        if (IsNullOrEmptyResponse(idata))
+        {
+            return ModuleOpenStatus.ErrorReceivedDataInvalid;
+        }
+
+        var payloadResponse = CCoreProtocolMapper.CreatePayloadResponse(idata);
+        if (payloadResponse.IsEmpty ||
+            DeserializeDataJSON(typeof(CCoreOpenResolveResult), payloadResponse.Value) is not CCoreOpenResolveResult resolveResult ||
+            string.IsNullOrEmpty(resolveResult.Path))
+        {
+            return ModuleOpenStatus.ErrorReceivedDataInvalid;
+        }
+
+        module.FileName = resolveResult.Path;
+        if (resolveResult.Index >= 0 && resolveResult.Index < searchDirectories.Count)
+        {
+            module.FileNameResolvedBy = searchDirectories[resolveResult.Index].SearchOrder;
+        }
+
+        return ReceiveOpenModuleReply(module);
+    }
+
+    /// <summary>
+    /// Probes search directories on the client and opens the found module file.
+    /// </summary>
+    /// <param name="module">The module to open, its FileName is replaced with the found path.</param>
+    /// <param name="settings">Settings for opening the module.</param>
+    /// <param name="searchDirectories">Ordered directories to probe.</param>
+    /// <returns>A <see cref="ModuleOpenStatus"/> indicating the result of the operation.</returns>
+    private ModuleOpenStatus OpenModuleFromSearchDirectories(ref CModule module, CFileOpenSettings settings,
+        IReadOnlyList<(string Directory, SearchOrderType SearchOrder)> searchDirectories)
+    {
+        string path = CPathResolver.PathFromSearchDirectories(module.FileName, searchDirectories, out var resolver);
+        if (!string.IsNullOrEmpty(path))
+        {
+            module.FileName = path;
+            module.FileNameResolvedBy = resolver;
+        }
+
+        return OpenModule(ref module, settings);
+    }
+
+    /// <summary>
+    /// Receives status and file information replies of the open commands.
+    /// </summary>
+    /// <param name="module">The module being opened.</param>
+    /// <returns>A <see cref="ModuleOpenStatus"/> indicating the result of the operation.</returns>
+    private ModuleOpenStatus ReceiveOpenModuleReply(CModule module)
+    {
         CBufferChain idata = ReceiveReply();
         if (IsNullOrEmptyResponse(idata))
         {
@@ -103,6 +336,7 @@ public partial class CCoreClient
     /// <returns>true if the close command was sent successfully; otherwise, false.</returns>
     public bool CloseModule()
     {
+        using var span = CTraceRecorder.BeginSpan("close", "core");
         return SendRequest(CConsts.CMD_CLOSE);
     }
 
@@ -149,6 +383,45 @@ public partial class CCoreClient
                     request.Command, typeof(CCoreApiSetNamespaceInfo), null);
     }
 
+    /// <summary>
+    /// Gets the whole active API Set namespace from the server.
+    /// </summary>
+    /// <returns>API Set namespace dump, or null if the request fails.</returns>
+    public CCoreApiSetDump GetApiSetNamespaceDump()
+    {
+        return (CCoreApiSetDump)SendCommandAndReceiveReplyAsObjectJSON(
+                    CConsts.CMD_APISETDUMP, typeof(CCoreApiSetDump), null);
+    }
+
+    /// <summary>
+    /// Resolves a list of API Set contracts with a single server request.
+    /// </summary>
+    /// <param name="contracts">Contract names with optional importing module names.</param>
+    /// <returns>Resolutions in request order, or null if the request fails.</returns>
+    public CCoreApiSetBatch ResolveApiSetNames(IEnumerable<(string Contract, string Parent)> contracts)
+    {
+        var request = CCoreProtocolMapper.BuildApiSetResolveBatchRequest(contracts);
+        return (CCoreApiSetBatch)SendCommandAndReceiveReplyAsObjectJSON(
+                    request.Command, typeof(CCoreApiSetBatch), null);
+    }
+
+    /// <summary>
+    /// Reads CodeView, POGO and VC feature debug records of a list of files with a single server request.
+    /// </summary>
+    /// <remarks>
+    /// Files do not need to be opened; only headers and debug data are read by the server.
+    /// </remarks>
+    /// <param name="fileNames">Full paths of the files.</param>
+    /// <returns>Debug information in request order, or null if the request fails.</returns>
+    public CCoreDebugInfoBatch GetDebugInfo(IEnumerable<string> fileNames)
+    {
+        using var span = CTraceRecorder.BeginSpan("debuginfo", "core");
+
+        var request = CCoreProtocolMapper.BuildDebugInfoRequest(fileNames);
+        return (CCoreDebugInfoBatch)SendCommandAndReceiveReplyAsObjectJSON(
+                    request.Command, typeof(CCoreDebugInfoBatch), null);
+    }
+
     /// <summary>
     /// Sets the API Set schema namespace source for the server.
     /// </summary>
@@ -170,6 +443,37 @@ public partial class CCoreClient
               CConsts.CMD_CALLSTATS, typeof(CCoreCallStats), null);
     }
 
+    /// <summary>
+    /// Gets server wide per-command statistics, collected for all clients since server start.
+    /// </summary>
+    /// <param name="reset">Zero server counters after reading them.</param>
+    /// <returns>Server statistics, or null if the request fails.</returns>
+    public CCoreServerStats GetServerStats(bool reset = false)
+    {
+        return (CCoreServerStats)SendCommandAndReceiveReplyAsObjectJSON(
+              reset ? CConsts.CMD_STATS_RESET : CConsts.CMD_STATS, typeof(CCoreServerStats), null);
+    }
+
+    /// <summary>
+    /// Enables or disables server side trace of this client session.
+    /// </summary>
+    /// <param name="enable">True to start recording command events, false to stop and discard them.</param>
+    /// <returns>true if the command was sent and acknowledged successfully; otherwise, false.</returns>
+    public bool SetServerTrace(bool enable)
+    {
+        return SendRequest(enable ? CConsts.CMD_TRACE_ON : CConsts.CMD_TRACE_OFF) && IsRequestSuccessful();
+    }
+
+    /// <summary>
+    /// Gets command events recorded by the server since the previous query.
+    /// </summary>
+    /// <returns>Server trace events, or null if trace is not enabled or the request fails.</returns>
+    public CCoreTraceEvents GetServerTrace()
+    {
+        return (CCoreTraceEvents)SendCommandAndReceiveReplyAsObjectJSON(
+              CConsts.CMD_TRACE, typeof(CCoreTraceEvents), null);
+    }
+
     /// <summary>
     /// Retrieves and populates module header information.
     /// </summary>
@@ -182,13 +486,15 @@ public partial class CCoreClient
             return false;
         }
 
+        using var span = CTraceRecorder.BeginSpan("headers", "core", module.FileName);
+
         var fh = (CCoreImageHeaders)GetModuleInformationByType(ModuleInformationType.Headers, module);
         if (fh == null)
         {
             return false;
         }
 
-        CModuleData moduleData = module.ModuleData;
+        CModuleData moduleData = module.GetWritableModuleData();
 
         // Set various module data properties
         moduleData.LinkerVersion = $"{fh.OptionalHeader.MajorLinkerVersion}.{fh.OptionalHeader.MinorLinkerVersion}";
@@ -252,9 +558,12 @@ public partial class CCoreClient
     /// <param name="command">The command to send to the server.</param>
     /// <param name="knownDllsList">List to populate with Known DLL names.</param>
     /// <param name="knownDllsPath">Outputs the Known DLLs directory path.</param>
+    /// <param name="version">Outputs the Known DLLs version, empty if server does not report it.</param>
     /// <returns>true if the information was retrieved successfully; otherwise, false.</returns>
-    private bool GetKnownDllsByType(string command, List<string> knownDllsList, out string knownDllsPath)
+    private bool GetKnownDllsByType(string command, List<string> knownDllsList, out string knownDllsPath, out string version)
     {
+        version = string.Empty;
+
         if (knownDllsList == null)
         {
             knownDllsPath = string.Empty;
@@ -270,6 +579,7 @@ public partial class CCoreClient
                 knownDllsList.AddRange(knownDllsObject.Entries);
             }
             knownDllsPath = knownDllsObject.DllPath ?? string.Empty;
+            version = knownDllsObject.Version ?? string.Empty;
             return true;
         }
 
@@ -277,6 +587,39 @@ public partial class CCoreClient
         return false;
     }
 
+    /// <summary>
+    /// Retrieves version of the server Known DLLs sets.
+    /// </summary>
+    /// <returns>Version string, or null if the server does not support the query.</returns>
+    public string GetKnownDllsVersion()
+    {
+        if (_knownDllsVersionUnavailable)
+            return null;
+
+        if (SendCommandAndReceiveReplyAsObjectJSON(CConsts.CMD_KNOWNDLLSVER, typeof(CCoreKnownDllsVersion), null)
+            is CCoreKnownDllsVersion versionObject && !string.IsNullOrEmpty(versionObject.Version))
+        {
+            return versionObject.Version;
+        }
+
+        _knownDllsVersionUnavailable = true;
+        return null;
+    }
+
+    /// <summary>
+    /// Replaces Known DLLs sets of this connection with a snapshot file, e.g. captured from another OS image.
+    /// </summary>
+    /// <remarks>
+    /// Snapshot is released by the server when the connection is closed.
+    /// </remarks>
+    /// <param name="fileName">Snapshot file, or null/empty to return to the running system sets.</param>
+    /// <returns>true if the server accepted the snapshot; otherwise, false.</returns>
+    public bool LoadKnownDllsSnapshot(string fileName)
+    {
+        var request = CCoreProtocolMapper.BuildKnownDllsLoadRequest(fileName);
+        return SendRequest(request) && IsRequestSuccessful();
+    }
+
     /// <summary>
     /// Retrieves both 32-bit and 64-bit Known DLLs information from the server.
     /// </summary>
@@ -285,6 +628,9 @@ public partial class CCoreClient
     /// <param name="knownDllsPath">Outputs the 64-bit Known DLLs directory path.</param>
     /// <param name="knownDllsPath32">Outputs the 32-bit Known DLLs directory path.</param>
     /// <returns>true if both 32-bit and 64-bit information was retrieved successfully; otherwise, false.</returns>
+    /// <remarks>
+    /// Lists are downloaded only if the server version differs from the cached one.
+    /// </remarks>
     public bool GetKnownDllsAll(List<string> knownDlls, List<string> knownDlls32, out string knownDllsPath, out string knownDllsPath32)
     {
         if (knownDlls == null || knownDlls32 == null)
@@ -294,8 +640,33 @@ public partial class CCoreClient
             return false;
         }
 
-        bool result32 = GetKnownDllsByType(CConsts.CMD_KNOWNDLLS32, knownDlls32, out knownDllsPath32);
-        bool result64 = GetKnownDllsByType(CConsts.CMD_KNOWNDLLS64, knownDlls, out knownDllsPath);
+        var cached = CKnownDllsCache.TryGet(GetKnownDllsVersion());
+        if (cached != null)
+        {
+            knownDlls.Clear();
+            knownDlls.AddRange(cached.Entries);
+            knownDlls32.Clear();
+            knownDlls32.AddRange(cached.Entries32);
+            knownDllsPath = cached.Path;
+            knownDllsPath32 = cached.Path32;
+            return true;
+        }
+
+        bool result32 = GetKnownDllsByType(CConsts.CMD_KNOWNDLLS32, knownDlls32, out knownDllsPath32, out string version32);
+        bool result64 = GetKnownDllsByType(CConsts.CMD_KNOWNDLLS64, knownDlls, out knownDllsPath, out string version);
+
+        // Both replies must come from the same sets, another client may load a snapshot in between.
+        if (result32 && result64 && !string.IsNullOrEmpty(version) && version == version32)
+        {
+            CKnownDllsCache.Store(new CKnownDllsSet
+            {
+                Version = version,
+                Path = knownDllsPath,
+                Path32 = knownDllsPath32,
+                Entries = [.. knownDlls],
+                Entries32 = [.. knownDlls32]
+            });
+        }
 
         return result32 && result64;
     }
@@ -6,7 +6,7 @@
 *
 *  VERSION:     1.00
 *
-*  DATE:        14 Jul 2026
+*  DATE:        18 Oct 2026
 *  
 *  Data serialization for Core Server communication class.
 *
@@ -53,6 +53,7 @@ public partial class CCoreClient
         {
             // Try to find pre-created serializer
             DataContractJsonSerializer serializer = GetSerializerForType(objectType);
+            using var span = CTraceRecorder.BeginSpan("deserialize", "client", FileName);
             using MemoryStream ms = new(Encoding.Unicode.GetBytes(data));
             return serializer.ReadObject(ms);
         }
@@ -79,6 +80,7 @@ public partial class CCoreClient
         {
             // Try to find pre-created serializer
             DataContractJsonSerializer serializer = GetSerializerForType(objectType);
+            using var span = CTraceRecorder.BeginSpan("deserialize", "client");
             using MemoryStream ms = new(Encoding.Unicode.GetBytes(data));
             return serializer.ReadObject(ms);
         }
@@ -6,7 +6,7 @@
 *
 *  VERSION:     1.00
 *
-*  DATE:        17 Jul 2026
+*  DATE:        18 Oct 2026
 *  
 *  Server process lifecycle routines for Core Server communication class.
 *
@@ -273,6 +273,12 @@ public partial class CCoreClient
             {
                 ErrorStatus = ServerErrorStatus.NoErrors;
                 _addLogMessage($"Server has been started: {idata.BufferToStringNoCRLF()}", LogMessageType.System);
+
+                // Server records its part of the timeline per session.
+                if (CTraceRecorder.Enabled && !SetServerTrace(true))
+                {
+                    _addLogMessage("Server does not support session trace", LogMessageType.System);
+                }
                 return true;
             }
             else
@@ -328,6 +334,10 @@ public partial class CCoreClient
         {
             if (_serverProcess != null && !_serverProcess.HasExited)
             {
+                if (CTraceRecorder.Enabled)
+                {
+                    CTraceRecorder.AddServerEvents(GetServerTrace());
+                }
                 ShutdownRequest();
                 Thread.Sleep(SHUTDOWN_WAIT_MS);
                 if (!_consoleRun && _serverProcess != null)
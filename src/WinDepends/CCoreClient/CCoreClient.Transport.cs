@@ -6,7 +6,7 @@
 *
 *  VERSION:     1.00
 *
-*  DATE:        17 Jul 2026
+*  DATE:        18 Oct 2026
 *  
 *  Transport and reply handling routines for Core Server communication class.
 *
@@ -57,6 +57,8 @@ public partial class CCoreClient
         if (statusResponse.IsSuccess)
             return true;
 
+        _lastCommandUnknown = string.Equals(statusResponse.Value, CConsts.WDEP_STATUS_405, StringComparison.Ordinal);
+
         if (statusResponse.HasServerException)
             CheckExceptionInReply(module);
 
@@ -151,7 +153,9 @@ public partial class CCoreClient
     private bool SendRequest(CCoreBackendRequest request)
     {
         ThrowIfDisposed();
-        
+
+        _lastCommandUnknown = false;
+
         bool result = _transportAdapter.TrySend(request, out var status);
         ErrorStatus = status;
         return result;
@@ -6,7 +6,7 @@
 *
 *  VERSION:     1.00
 *
-*  DATE:        17 Jul 2026
+*  DATE:        18 Oct 2026
 *  
 *  Core Server communication class.
 *
@@ -97,6 +97,11 @@ public partial class CCoreClient : IDisposable
     private readonly AddLogMessageCallback _addLogMessage;
     private string _serverApplication;
     private bool _consoleRun;
+    private bool _apiSetDumpUnavailable;  // Server does not support apisetdump.
+    private bool _apiSetBatchUnavailable; // Server does not support apisetresolvebatch.
+    private bool _knownDllsVersionUnavailable; // Server does not support knowndllsver.
+    private bool _openResolveUnavailable; // Server does not support openresolve.
+    private bool _lastCommandUnknown; // Server rejected the last request as unknown command.
 
     /// <summary>
     /// Gets the TCP client connection to the server.
@@ -113,6 +118,12 @@ public partial class CCoreClient : IDisposable
     /// </summary>
     public int Port { get; set; }
 
+    /// <summary>
+    /// Gets or sets whether trailing directory search of dependents is left to the server.
+    /// Dependents left unresolved must be opened with the "openresolve" overload of OpenModule.
+    /// </summary>
+    public bool DeferDirectorySearch { get; set; }
+
     private readonly Dictionary<Type, DataContractJsonSerializer> _serializerCache;
 
     private const int CORE_CONNECTION_TIMEOUT = 3000;
@@ -132,6 +143,16 @@ public partial class CCoreClient : IDisposable
     /// <returns>The process ID, or -1 if the server is not running.</returns>
     public int ServerProcessId => _serverProcess?.Id ?? -1;
 
+    /// <summary>
+    /// Gets the total number of request bytes sent to the server.
+    /// </summary>
+    public long BytesSent => _transportAdapter.BytesSent;
+
+    /// <summary>
+    /// Gets the total number of reply bytes received from the server.
+    /// </summary>
+    public long BytesReceived => _transportAdapter.BytesReceived;
+
     /// <summary>
     /// Get or set the path to the server application executable.
     /// </summary>
@@ -167,8 +188,15 @@ public partial class CCoreClient : IDisposable
             [typeof(CCoreDirectoryEntry)] = new DataContractJsonSerializer(typeof(CCoreDirectoryEntry)),
             [typeof(CCoreResolvedFileName)] = new DataContractJsonSerializer(typeof(CCoreResolvedFileName)),
             [typeof(CCoreApiSetNamespaceInfo)] = new DataContractJsonSerializer(typeof(CCoreApiSetNamespaceInfo)),
+            [typeof(CCoreApiSetDump)] = new DataContractJsonSerializer(typeof(CCoreApiSetDump)),
+            [typeof(CCoreApiSetBatch)] = new DataContractJsonSerializer(typeof(CCoreApiSetBatch)),
             [typeof(CCoreCallStats)] = new DataContractJsonSerializer(typeof(CCoreCallStats)),
             [typeof(CCoreKnownDlls)] = new DataContractJsonSerializer(typeof(CCoreKnownDlls)),
+            [typeof(CCoreKnownDllsVersion)] = new DataContractJsonSerializer(typeof(CCoreKnownDllsVersion)),
+            [typeof(CCoreOpenResolveResult)] = new DataContractJsonSerializer(typeof(CCoreOpenResolveResult)),
+            [typeof(CCoreServerStats)] = new DataContractJsonSerializer(typeof(CCoreServerStats)),
+            [typeof(CCoreTraceEvents)] = new DataContractJsonSerializer(typeof(CCoreTraceEvents)),
+            [typeof(CCoreDebugInfoBatch)] = new DataContractJsonSerializer(typeof(CCoreDebugInfoBatch)),
             [typeof(CCoreFileInformation)] = new DataContractJsonSerializer(typeof(CCoreFileInformation)),
             [typeof(CCoreException)] = new DataContractJsonSerializer(typeof(CCoreException))
         };
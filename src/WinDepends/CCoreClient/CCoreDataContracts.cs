@@ -1,12 +1,12 @@
 ﻿/*******************************************************************************
 *
-*  (C) COPYRIGHT AUTHORS, 2024 - 2025
+*  (C) COPYRIGHT AUTHORS, 2024 - 2026
 *
 *  TITLE:       CCOREDATACONTRACTS.CS
 *
 *  VERSION:     1.00
 *
-*  DATE:        14 Aug 2025
+*  DATE:        18 Oct 2026
 *  
 *  Core Server reply structures (JSON serialized).
 *
@@ -76,6 +76,78 @@ public class CCoreApiSetNamespaceInfo
     public uint Count { get; set; }
 }
 
+/// <summary>
+/// Represents a single value of the Apiset namespace entry.
+/// </summary>
+[DataContract]
+public class CCoreApiSetDumpEntry
+{
+    /// <summary>
+    /// Contract name in the form used for namespace lookup.
+    /// </summary>
+    [DataMember(Name = "name")]
+    public string Name { get; set; }
+    /// <summary>
+    /// Importing module name for parent specific values, empty for the default host.
+    /// </summary>
+    [DataMember(Name = "parent")]
+    public string Parent { get; set; }
+    /// <summary>
+    /// Host module name, empty if contract is not hosted.
+    /// </summary>
+    [DataMember(Name = "host")]
+    public string Host { get; set; }
+}
+
+/// <summary>
+/// Represents the whole Apiset namespace as reported by server.
+/// </summary>
+[DataContract]
+public class CCoreApiSetDump
+{
+    /// <summary>
+    /// Apiset namespace schema version.
+    /// </summary>
+    [DataMember(Name = "version")]
+    public uint Version { get; set; }
+    /// <summary>
+    /// Namespace values.
+    /// </summary>
+    [DataMember(Name = "entries")]
+    public List<CCoreApiSetDumpEntry> Entries { get; set; }
+}
+
+/// <summary>
+/// Represents a single contract resolution of the batched Apiset request.
+/// </summary>
+[DataContract]
+public class CCoreApiSetBatchEntry
+{
+    /// <summary>
+    /// Contract name as requested.
+    /// </summary>
+    [DataMember(Name = "name")]
+    public string Name { get; set; }
+    /// <summary>
+    /// Host module name, empty if contract cannot be resolved.
+    /// </summary>
+    [DataMember(Name = "path")]
+    public string Path { get; set; }
+}
+
+/// <summary>
+/// Represents the reply to the batched Apiset resolution request.
+/// </summary>
+[DataContract]
+public class CCoreApiSetBatch
+{
+    /// <summary>
+    /// Resolutions in request order.
+    /// </summary>
+    [DataMember(Name = "entries")]
+    public List<CCoreApiSetBatchEntry> Entries { get; set; }
+}
+
 /// <summary>
 /// Represents a resolved file name (typically a DLL or system path).
 /// </summary>
@@ -285,6 +357,12 @@ public class CCoreImports
 [DataContract]
 public class CCoreKnownDlls
 {
+    /// <summary>
+    /// Version of the server KnownDlls sets, absent in older servers.
+    /// </summary>
+    [DataMember(Name = "version", IsRequired = false)]
+    public string Version { get; set; }
+
     /// <summary>
     /// Path to the KnownDlls directory.
     /// </summary>
@@ -298,6 +376,38 @@ public class CCoreKnownDlls
     public List<string> Entries { get; set; }
 }
 
+/// <summary>
+/// Represents version of the server KnownDlls sets.
+/// </summary>
+[DataContract]
+public class CCoreKnownDllsVersion
+{
+    /// <summary>
+    /// Content hash of both KnownDlls sets.
+    /// </summary>
+    [DataMember(Name = "version")]
+    public string Version { get; set; }
+}
+
+/// <summary>
+/// Represents module file found by the server in search directories.
+/// </summary>
+[DataContract]
+public class CCoreOpenResolveResult
+{
+    /// <summary>
+    /// Full path of the found module file.
+    /// </summary>
+    [DataMember(Name = "path")]
+    public string Path { get; set; }
+
+    /// <summary>
+    /// Index of the search directory where the file was found.
+    /// </summary>
+    [DataMember(Name = "index")]
+    public int Index { get; set; }
+}
+
 /// <summary>
 /// Represents basic call statistics for a client session.
 /// </summary>
@@ -323,6 +433,295 @@ public class CCoreCallStats
     public UInt64 TotalTimeSpent { get; set; }
 }
 
+/// <summary>
+/// Represents server wide counters of a single command.
+/// </summary>
+[DataContract]
+public class CCoreCommandStats
+{
+    /// <summary>
+    /// Command name.
+    /// </summary>
+    [DataMember(Name = "name")]
+    public string Name { get; set; }
+
+    /// <summary>
+    /// Number of handled commands.
+    /// </summary>
+    [DataMember(Name = "calls")]
+    public long Calls { get; set; }
+
+    /// <summary>
+    /// Total handling time (in microseconds).
+    /// </summary>
+    [DataMember(Name = "totalTime")]
+    public long TotalTime { get; set; }
+
+    /// <summary>
+    /// Longest handling time (in microseconds).
+    /// </summary>
+    [DataMember(Name = "maxTime")]
+    public long MaxTime { get; set; }
+
+    /// <summary>
+    /// File data read while handling the command.
+    /// </summary>
+    [DataMember(Name = "bytesRead")]
+    public long BytesRead { get; set; }
+
+    /// <summary>
+    /// Reply data sent to clients.
+    /// </summary>
+    [DataMember(Name = "bytesSent")]
+    public long BytesSent { get; set; }
+
+    /// <summary>
+    /// Number of heap allocations.
+    /// </summary>
+    [DataMember(Name = "allocations")]
+    public long Allocations { get; set; }
+
+    /// <summary>
+    /// Latency histogram, bucket n counts calls that took [2^n, 2^(n+1)) microseconds.
+    /// </summary>
+    [DataMember(Name = "latency")]
+    public List<long> Latency { get; set; }
+}
+
+/// <summary>
+/// Represents server wide per-command statistics.
+/// </summary>
+[DataContract]
+public class CCoreServerStats
+{
+    /// <summary>
+    /// Time since server start (in milliseconds).
+    /// </summary>
+    [DataMember(Name = "uptime")]
+    public UInt64 Uptime { get; set; }
+
+    /// <summary>
+    /// Number of latency histogram buckets.
+    /// </summary>
+    [DataMember(Name = "buckets")]
+    public int Buckets { get; set; }
+
+    /// <summary>
+    /// Counters of commands handled at least once.
+    /// </summary>
+    [DataMember(Name = "commands")]
+    public List<CCoreCommandStats> Commands { get; set; }
+}
+
+/// <summary>
+/// Represents a single command handled by the server while session trace was enabled.
+/// </summary>
+[DataContract]
+public class CCoreTraceEvent
+{
+    /// <summary>
+    /// Command name.
+    /// </summary>
+    [DataMember(Name = "name")]
+    public string Name { get; set; }
+
+    /// <summary>
+    /// Command start timestamp (in microseconds, performance counter based).
+    /// </summary>
+    [DataMember(Name = "ts")]
+    public long Timestamp { get; set; }
+
+    /// <summary>
+    /// Command duration (in microseconds).
+    /// </summary>
+    [DataMember(Name = "dur")]
+    public long Duration { get; set; }
+
+    /// <summary>
+    /// Reply data sent to the client.
+    /// </summary>
+    [DataMember(Name = "bytesSent")]
+    public long BytesSent { get; set; }
+}
+
+/// <summary>
+/// Represents events recorded by the server session trace.
+/// </summary>
+[DataContract]
+public class CCoreTraceEvents
+{
+    /// <summary>
+    /// Number of events dropped because the trace buffer was full.
+    /// </summary>
+    [DataMember(Name = "dropped")]
+    public long Dropped { get; set; }
+
+    /// <summary>
+    /// Recorded events in completion order.
+    /// </summary>
+    [DataMember(Name = "events")]
+    public List<CCoreTraceEvent> Events { get; set; }
+}
+
+/// <summary>
+/// Represents a CodeView record (PDB identity) of the module debug directory.
+/// </summary>
+[DataContract]
+public class CCoreCodeViewInfo
+{
+    /// <summary>
+    /// Record format, "RSDS" or "NB10".
+    /// </summary>
+    [DataMember(Name = "format")]
+    public string Format { get; set; }
+
+    /// <summary>
+    /// PDB GUID of RSDS record, empty for NB10.
+    /// </summary>
+    [DataMember(Name = "guid")]
+    public string Guid { get; set; }
+
+    /// <summary>
+    /// PDB signature of NB10 record, zero for RSDS.
+    /// </summary>
+    [DataMember(Name = "signature")]
+    public uint Signature { get; set; }
+
+    /// <summary>
+    /// PDB age.
+    /// </summary>
+    [DataMember(Name = "age")]
+    public uint Age { get; set; }
+
+    /// <summary>
+    /// PDB path as recorded by the linker.
+    /// </summary>
+    [DataMember(Name = "pdb")]
+    public string PdbPath { get; set; }
+}
+
+/// <summary>
+/// Represents a single POGO section contribution.
+/// </summary>
+[DataContract]
+public class CCorePogoEntry
+{
+    [DataMember(Name = "rva")]
+    public uint Rva { get; set; }
+
+    [DataMember(Name = "size")]
+    public uint Size { get; set; }
+
+    [DataMember(Name = "name")]
+    public string Name { get; set; }
+}
+
+/// <summary>
+/// Represents POGO (profile guided / link time code generation) debug record.
+/// </summary>
+[DataContract]
+public class CCorePogoInfo
+{
+    /// <summary>
+    /// Record signature.
+    /// </summary>
+    [DataMember(Name = "signature")]
+    public uint Signature { get; set; }
+
+    /// <summary>
+    /// Section contributions in record order.
+    /// </summary>
+    [DataMember(Name = "entries")]
+    public List<CCorePogoEntry> Entries { get; set; }
+}
+
+/// <summary>
+/// Represents VC feature debug record, counts of objects built with given compiler options.
+/// </summary>
+[DataContract]
+public class CCoreVcFeatureInfo
+{
+    [DataMember(Name = "preVC11")]
+    public uint PreVC11 { get; set; }
+
+    [DataMember(Name = "cCpp")]
+    public uint CCpp { get; set; }
+
+    [DataMember(Name = "gs")]
+    public uint Gs { get; set; }
+
+    [DataMember(Name = "sdl")]
+    public uint Sdl { get; set; }
+
+    [DataMember(Name = "guardN")]
+    public uint GuardN { get; set; }
+}
+
+/// <summary>
+/// Represents debug information of a single file of the batched debug information request.
+/// </summary>
+[DataContract]
+public class CCoreDebugInfo
+{
+    /// <summary>
+    /// File path as requested.
+    /// </summary>
+    [DataMember(Name = "path")]
+    public string Path { get; set; }
+
+    /// <summary>
+    /// Protocol status code, 200 if file was parsed, 404 if it cannot be opened, 415 if it is not a PE image,
+    /// 414 if the path is too long for the server, path is empty then.
+    /// </summary>
+    [DataMember(Name = "status")]
+    public uint Status { get; set; }
+
+    /// <summary>
+    /// Gets whether the file was parsed as PE image.
+    /// </summary>
+    public bool IsImage => Status == 200;
+
+    [DataMember(Name = "machine")]
+    public ushort Machine { get; set; }
+
+    [DataMember(Name = "timeDateStamp")]
+    public uint TimeDateStamp { get; set; }
+
+    [DataMember(Name = "sizeOfImage")]
+    public uint SizeOfImage { get; set; }
+
+    /// <summary>
+    /// CodeView records, usually one.
+    /// </summary>
+    [DataMember(Name = "codeView")]
+    public List<CCoreCodeViewInfo> CodeView { get; set; }
+
+    /// <summary>
+    /// POGO record, null if not present.
+    /// </summary>
+    [DataMember(Name = "pogo")]
+    public CCorePogoInfo Pogo { get; set; }
+
+    /// <summary>
+    /// VC feature record, null if not present.
+    /// </summary>
+    [DataMember(Name = "vcFeature")]
+    public CCoreVcFeatureInfo VcFeature { get; set; }
+}
+
+/// <summary>
+/// Represents the reply to the batched debug information request.
+/// </summary>
+[DataContract]
+public class CCoreDebugInfoBatch
+{
+    /// <summary>
+    /// Files in request order.
+    /// </summary>
+    [DataMember(Name = "entries")]
+    public List<CCoreDebugInfo> Entries { get; set; }
+}
+
 /// <summary>
 /// Represents file information for an opened PE file.
 /// </summary>
@@ -0,0 +1,324 @@
+﻿/*******************************************************************************
+*
+*  (C) COPYRIGHT AUTHORS, 2026
+*
+*  TITLE:       CTRACERECORDER.CS
+*
+*  VERSION:     1.00
+*
+*  DATE:        18 Oct 2026
+*
+*  Analysis timeline recorder, Chrome trace-event format output.
+*
+* THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF
+* ANY KIND, EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED
+* TO THE IMPLIED WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+*******************************************************************************/
+using System.Collections.Concurrent;
+using System.Diagnostics;
+using System.Runtime.Serialization;
+using System.Runtime.Serialization.Json;
+
+namespace WinDepends;
+
+/// <summary>
+/// Single trace-event record, see Chrome "Trace Event Format".
+/// </summary>
+[DataContract]
+public class CTraceEvent
+{
+    [DataMember(Name = "name")]
+    public string Name { get; set; }
+
+    [DataMember(Name = "cat", EmitDefaultValue = false)]
+    public string Category { get; set; }
+
+    [DataMember(Name = "ph")]
+    public string Phase { get; set; }
+
+    [DataMember(Name = "ts")]
+    public long Timestamp { get; set; }
+
+    [DataMember(Name = "dur", EmitDefaultValue = false)]
+    public long Duration { get; set; }
+
+    [DataMember(Name = "pid")]
+    public int ProcessId { get; set; }
+
+    [DataMember(Name = "tid")]
+    public int ThreadId { get; set; }
+
+    [DataMember(Name = "args", EmitDefaultValue = false)]
+    public CTraceEventArgs Args { get; set; }
+}
+
+/// <summary>
+/// Optional trace-event arguments shown in the viewer details pane.
+/// </summary>
+[DataContract]
+public class CTraceEventArgs
+{
+    [DataMember(Name = "name", EmitDefaultValue = false)]
+    public string Name { get; set; }
+
+    [DataMember(Name = "module", EmitDefaultValue = false)]
+    public string Module { get; set; }
+
+    [DataMember(Name = "bytesSent", EmitDefaultValue = false)]
+    public long BytesSent { get; set; }
+}
+
+/// <summary>
+/// Aggregated timings of recorded spans sharing category and name.
+/// </summary>
+[DataContract]
+public class CTracePhaseSummary
+{
+    [DataMember(Name = "category")]
+    public string Category { get; set; }
+
+    [DataMember(Name = "name")]
+    public string Name { get; set; }
+
+    [DataMember(Name = "count")]
+    public long Count { get; set; }
+
+    /// <summary>
+    /// Sum of span durations (in microseconds).
+    /// </summary>
+    [DataMember(Name = "totalTime")]
+    public long TotalTime { get; set; }
+
+    /// <summary>
+    /// Longest span duration (in microseconds).
+    /// </summary>
+    [DataMember(Name = "maxTime")]
+    public long MaxTime { get; set; }
+}
+
+/// <summary>
+/// Trace-event file root object.
+/// </summary>
+[DataContract]
+public class CTraceFile
+{
+    [DataMember(Name = "traceEvents")]
+    public List<CTraceEvent> TraceEvents { get; set; }
+
+    [DataMember(Name = "displayTimeUnit")]
+    public string DisplayTimeUnit { get; set; }
+}
+
+/// <summary>
+/// Records timeline of an analysis run from both client and server.
+/// </summary>
+/// <remarks>
+/// Disabled by default, spans are no-op until <see cref="Start"/> is called. Timestamps are
+/// microseconds of the performance counter, same clock the server uses for its session trace,
+/// so client and server events line up in one view. Output is loadable by chrome://tracing
+/// and Perfetto.
+/// </remarks>
+static class CTraceRecorder
+{
+    const int ClientProcessId = 1;
+    const int ServerProcessId = 2;
+    const int MaxEvents = 1 << 20;
+
+    static readonly ConcurrentQueue<CTraceEvent> events = new();
+    static volatile bool enabled;
+    static int eventCount;
+    static long droppedCount;
+
+    /// <summary>
+    /// Gets whether events are being recorded.
+    /// </summary>
+    public static bool Enabled => enabled;
+
+    /// <summary>
+    /// Gets number of events dropped by client and server because of buffer limits.
+    /// </summary>
+    public static long Dropped => Interlocked.Read(ref droppedCount);
+
+    /// <summary>
+    /// Discards previously recorded events and starts recording.
+    /// </summary>
+    public static void Start()
+    {
+        events.Clear();
+        Interlocked.Exchange(ref eventCount, 0);
+        Interlocked.Exchange(ref droppedCount, 0);
+        enabled = true;
+    }
+
+    /// <summary>
+    /// Stops recording, recorded events are kept until the next <see cref="Start"/>.
+    /// </summary>
+    public static void Stop()
+    {
+        enabled = false;
+    }
+
+    /// <summary>
+    /// Returns current timestamp in microseconds.
+    /// </summary>
+    public static long GetTimestamp()
+    {
+        long count = Stopwatch.GetTimestamp();
+        long frequency = Stopwatch.Frequency;
+
+        // Split to avoid overflow, matches server side conversion.
+        return (count / frequency) * 1000000 + (count % frequency) * 1000000 / frequency;
+    }
+
+    /// <summary>
+    /// Begins a client span, the span is recorded when disposed.
+    /// </summary>
+    /// <param name="name">Span name, e.g. "open".</param>
+    /// <param name="category">Span category, e.g. "core".</param>
+    /// <param name="module">Optional module file name the span relates to.</param>
+    /// <returns>Span to dispose at the end of the traced operation.</returns>
+    public static Span BeginSpan(string name, string category, string module = null)
+    {
+        return enabled ? new Span(name, category, module, GetTimestamp()) : default;
+    }
+
+    /// <summary>
+    /// Adds events of the server session trace.
+    /// </summary>
+    /// <param name="serverEvents">Events received with the "trace" command.</param>
+    public static void AddServerEvents(CCoreTraceEvents serverEvents)
+    {
+        if (serverEvents == null)
+            return;
+
+        Interlocked.Add(ref droppedCount, serverEvents.Dropped);
+
+        if (serverEvents.Events == null)
+            return;
+
+        foreach (var serverEvent in serverEvents.Events)
+        {
+            Add(new CTraceEvent
+            {
+                Name = serverEvent.Name,
+                Category = "server",
+                Phase = "X",
+                Timestamp = serverEvent.Timestamp,
+                Duration = serverEvent.Duration,
+                ProcessId = ServerProcessId,
+                ThreadId = 1,
+                Args = serverEvent.BytesSent != 0 ? new CTraceEventArgs { BytesSent = serverEvent.BytesSent } : null
+            });
+        }
+    }
+
+    /// <summary>
+    /// Writes recorded events as trace-event JSON file.
+    /// </summary>
+    /// <param name="fileName">Output file name.</param>
+    /// <returns>True if the file was written, otherwise false.</returns>
+    public static bool Save(string fileName)
+    {
+        List<CTraceEvent> traceEvents =
+        [
+            CreateProcessNameEvent(ClientProcessId, CConsts.ShortProgramName),
+            CreateProcessNameEvent(ServerProcessId, "WinDepends.Core")
+        ];
+
+        // Viewer does not require ordering, sorting only makes the file easier to read.
+        traceEvents.AddRange(events.OrderBy(e => e.Timestamp));
+
+        try
+        {
+            var serializer = new DataContractJsonSerializer(typeof(CTraceFile));
+            using var stream = File.Create(fileName);
+            serializer.WriteObject(stream, new CTraceFile { TraceEvents = traceEvents, DisplayTimeUnit = "ms" });
+            return true;
+        }
+        catch
+        {
+            return false;
+        }
+    }
+
+    /// <summary>
+    /// Aggregates recorded events by category and name.
+    /// </summary>
+    /// <returns>Phase summaries ordered by total time, longest first.</returns>
+    public static List<CTracePhaseSummary> Summarize()
+    {
+        return events
+            .GroupBy(e => (e.Category, e.Name))
+            .Select(g => new CTracePhaseSummary
+            {
+                Category = g.Key.Category,
+                Name = g.Key.Name,
+                Count = g.LongCount(),
+                TotalTime = g.Sum(e => e.Duration),
+                MaxTime = g.Max(e => e.Duration)
+            })
+            .OrderByDescending(s => s.TotalTime)
+            .ToList();
+    }
+
+    static CTraceEvent CreateProcessNameEvent(int processId, string name)
+    {
+        return new CTraceEvent
+        {
+            Name = "process_name",
+            Phase = "M",
+            ProcessId = processId,
+            Args = new CTraceEventArgs { Name = name }
+        };
+    }
+
+    static void Add(CTraceEvent traceEvent)
+    {
+        if (Interlocked.Increment(ref eventCount) > MaxEvents)
+        {
+            Interlocked.Increment(ref droppedCount);
+            return;
+        }
+
+        events.Enqueue(traceEvent);
+    }
+
+    /// <summary>
+    /// Client span, a no-op when created while recording is disabled.
+    /// </summary>
+    public readonly struct Span : IDisposable
+    {
+        readonly string _name;
+        readonly string _category;
+        readonly string _module;
+        readonly long _start;
+
+        internal Span(string name, string category, string module, long start)
+        {
+            _name = name;
+            _category = category;
+            _module = module;
+            _start = start;
+        }
+
+        public void Dispose()
+        {
+            if (_name == null || !enabled)
+                return;
+
+            Add(new CTraceEvent
+            {
+                Name = _name,
+                Category = _category,
+                Phase = "X",
+                Timestamp = _start,
+                Duration = GetTimestamp() - _start,
+                ProcessId = ClientProcessId,
+                ThreadId = Environment.CurrentManagedThreadId,
+                Args = _module != null ? new CTraceEventArgs { Module = _module } : null
+            });
+        }
+    }
+}
@@ -6,7 +6,7 @@
 *
 *  VERSION:     1.00
 *
-*  DATE:        17 Jul 2026
+*  DATE:        18 Oct 2026
 *
 * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF
 * ANY KIND, EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED
@@ -103,6 +103,11 @@ public class CFileOpenSettings
     public bool UseCustomImageBase { get; set; }
     public uint CustomImageBase { get; set; }
 
+    /// <summary>
+    /// Relocate image pages on first access from a server exception handler, opt-in only.
+    /// </summary>
+    public bool LazyRelocs { get; set; }
+
     public CFileOpenSettings(CConfiguration configuration)
     {
         ArgumentNullException.ThrowIfNull(configuration);
@@ -130,6 +135,7 @@ public class CFileOpenSettings
         EnableExperimentalFeatures = other.EnableExperimentalFeatures;
         UseCustomImageBase = other.UseCustomImageBase;
         CustomImageBase = other.CustomImageBase;
+        LazyRelocs = other.LazyRelocs;
     }
 }
 
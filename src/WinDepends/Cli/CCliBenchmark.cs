@@ -0,0 +1,424 @@
+﻿/*******************************************************************************
+*
+*  (C) COPYRIGHT AUTHORS, 2026
+*
+*  TITLE:       CCLIBENCHMARK.CS
+*
+*  VERSION:     1.00
+*
+*  DATE:        18 Oct 2026
+*  
+*  Repeatable end-to-end dependency scan benchmark for command-line mode.
+*
+* THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF
+* ANY KIND, EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED
+* TO THE IMPLIED WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+*******************************************************************************/
+using System.Diagnostics;
+using System.Runtime.Serialization;
+using System.Runtime.Serialization.Json;
+
+namespace WinDepends;
+
+/// <summary>
+/// Results of a single pass over the benchmark corpus.
+/// </summary>
+[DataContract]
+public class CBenchmarkIteration
+{
+    [DataMember(Name = "iteration")]
+    public int Iteration { get; set; }
+
+    /// <summary>
+    /// Wall clock time of the pass (in milliseconds).
+    /// </summary>
+    [DataMember(Name = "elapsed")]
+    public double Elapsed { get; set; }
+
+    /// <summary>
+    /// Unique modules analyzed, summed over corpus files.
+    /// </summary>
+    [DataMember(Name = "modules")]
+    public long Modules { get; set; }
+
+    [DataMember(Name = "modulesPerSecond")]
+    public double ModulesPerSecond { get; set; }
+
+    /// <summary>
+    /// Corpus files that could not be opened.
+    /// </summary>
+    [DataMember(Name = "failed")]
+    public int Failed { get; set; }
+
+    [DataMember(Name = "bytesSent")]
+    public long BytesSent { get; set; }
+
+    [DataMember(Name = "bytesReceived")]
+    public long BytesReceived { get; set; }
+}
+
+/// <summary>
+/// Benchmark report, written as JSON so runs can be compared over time.
+/// </summary>
+[DataContract]
+public class CBenchmarkReport
+{
+    [DataMember(Name = "version")]
+    public string Version { get; set; }
+
+    [DataMember(Name = "timestamp")]
+    public string Timestamp { get; set; }
+
+    [DataMember(Name = "files")]
+    public List<string> Files { get; set; }
+
+    /// <summary>
+    /// First pass, excluded from totals because it fills server and filesystem caches.
+    /// </summary>
+    [DataMember(Name = "warmup")]
+    public CBenchmarkIteration Warmup { get; set; }
+
+    [DataMember(Name = "iterations")]
+    public List<CBenchmarkIteration> Iterations { get; set; }
+
+    /// <summary>
+    /// Median throughput of measured passes.
+    /// </summary>
+    [DataMember(Name = "modulesPerSecond")]
+    public double ModulesPerSecond { get; set; }
+
+    [DataMember(Name = "clientPeakWorkingSet")]
+    public long ClientPeakWorkingSet { get; set; }
+
+    [DataMember(Name = "serverPeakWorkingSet")]
+    public long ServerPeakWorkingSet { get; set; }
+
+    /// <summary>
+    /// Extra pass with client and server trace enabled, excluded from totals.
+    /// </summary>
+    [DataMember(Name = "traced")]
+    public CBenchmarkIteration Traced { get; set; }
+
+    /// <summary>
+    /// Client and server span timings of the traced pass.
+    /// </summary>
+    [DataMember(Name = "phases")]
+    public List<CTracePhaseSummary> Phases { get; set; }
+
+    [DataMember(Name = "droppedEvents")]
+    public long DroppedEvents { get; set; }
+}
+
+/// <summary>
+/// Runs the command-line analysis path repeatedly over a fixed corpus of files.
+/// </summary>
+/// <remarks>
+/// Uses the real core server over loopback, same as a regular CLI run. Throughput, peak
+/// working sets and bytes on the wire are measured with tracing off, per-phase timings from
+/// <see cref="CTraceRecorder"/> come from a separate traced pass. Results are printed and
+/// optionally written as JSON report with -o.
+/// </remarks>
+static class CCliBenchmark
+{
+    /// <summary>
+    /// Runs the benchmark.
+    /// </summary>
+    /// <param name="options">Command-line options.</param>
+    /// <returns>Process exit code.</returns>
+    internal static int Run(CliOptions options)
+    {
+        var files = LoadCorpus(options);
+        if (files == null)
+            return 1;
+
+        var config = CConfigManager.LoadConfiguration();
+        config.ResolveAPIsets = options.ResolveApiSets;
+        config.FullPaths = options.FullPaths;
+
+        string serverApp = CCliHandler.ResolveCoreServerPath(config);
+        if (string.IsNullOrEmpty(serverApp))
+        {
+            Console.Error.WriteLine("Error: Core server not found.");
+            return 1;
+        }
+
+        void LogMessage(string message, LogMessageType type, Color? color = null,
+            bool useBold = false, bool moduleMessage = false, CModule relatedModule = null, RichTextBox richTextBox = null)
+        {
+            // Per-module messages would dominate the measurement, errors only.
+            if (type == LogMessageType.ErrorOrWarning && !options.Quiet)
+            {
+                Console.Error.WriteLine("[!] " + message);
+            }
+        }
+
+        using var coreClient = new CCoreClient(serverApp, CConsts.CoreServerAddress, LogMessage, true);
+
+        if (!coreClient.ConnectClient())
+        {
+            Console.Error.WriteLine("Error: Failed to connect to core server.");
+            return 1;
+        }
+
+        try
+        {
+            if (!string.IsNullOrEmpty(options.KnownDllsSnapshot) &&
+                !coreClient.LoadKnownDllsSnapshot(options.KnownDllsSnapshot))
+            {
+                Console.Error.WriteLine($"Error: Failed to load KnownDlls snapshot: {options.KnownDllsSnapshot}");
+                return 1;
+            }
+
+            CCliHandler.PrepareResolver(coreClient, config, options.DeferDirectorySearch);
+
+            if (!options.Quiet)
+            {
+                Console.WriteLine($"Benchmark: {files.Count} file(s), {options.BenchmarkIterations} iteration(s) after warm-up");
+            }
+
+            var report = new CBenchmarkReport
+            {
+                Version = $"{CConsts.VersionMajor}.{CConsts.VersionMinor}.{CConsts.VersionRevision}.{CConsts.VersionBuild}",
+                Timestamp = DateTime.UtcNow.ToString("o"),
+                Files = files,
+                Iterations = []
+            };
+
+            // Throughput passes run untraced, span recording would be part of the measurement.
+            for (int iteration = 0; iteration <= options.BenchmarkIterations; iteration++)
+            {
+                var result = RunIteration(coreClient, config, options, files, iteration);
+
+                if (iteration == 0)
+                    report.Warmup = result;
+                else
+                    report.Iterations.Add(result);
+
+                PrintIteration(options, iteration == 0 ? "warm-up" : $"#{iteration}", result);
+            }
+
+            // Phase timings come from one more pass with client and server trace enabled.
+            CTraceRecorder.Start();
+
+            if (!coreClient.SetServerTrace(true) && !options.Quiet)
+            {
+                Console.Error.WriteLine("[!] Server does not support session trace, phase timings are client only");
+            }
+
+            report.Traced = RunIteration(coreClient, config, options, files, options.BenchmarkIterations + 1);
+            CTraceRecorder.AddServerEvents(coreClient.GetServerTrace());
+            CTraceRecorder.Stop();
+            coreClient.SetServerTrace(false);
+
+            PrintIteration(options, "traced", report.Traced);
+
+            report.ModulesPerSecond = GetMedian(report.Iterations.Select(r => r.ModulesPerSecond).ToList());
+            report.ClientPeakWorkingSet = GetPeakWorkingSet(Environment.ProcessId);
+            report.ServerPeakWorkingSet = GetPeakWorkingSet(coreClient.ServerProcessId);
+            report.Phases = CTraceRecorder.Summarize();
+            report.DroppedEvents = CTraceRecorder.Dropped;
+
+            if (!options.Quiet)
+            {
+                PrintReport(report);
+            }
+
+            if (!string.IsNullOrEmpty(options.TraceFile) && !CTraceRecorder.Save(options.TraceFile))
+            {
+                Console.Error.WriteLine($"Error: Failed to save trace: {options.TraceFile}");
+            }
+
+            if (!string.IsNullOrEmpty(options.OutputFile) && !SaveReport(report, options.OutputFile))
+            {
+                Console.Error.WriteLine($"Error: Failed to save benchmark report: {options.OutputFile}");
+                return 1;
+            }
+
+            return report.Iterations.Any(r => r.Failed > 0) || report.Traced.Failed > 0 ? 1 : 0;
+        }
+        catch (Exception ex)
+        {
+            Console.Error.WriteLine($"Error: {ex.Message}");
+            return 1;
+        }
+        finally
+        {
+            CTraceRecorder.Stop();
+            coreClient.DisconnectClient();
+        }
+    }
+
+    /// <summary>
+    /// Analyzes every corpus file once.
+    /// </summary>
+    private static CBenchmarkIteration RunIteration(CCoreClient coreClient,
+        CConfiguration config,
+        CliOptions options,
+        List<string> files,
+        int iteration)
+    {
+        var result = new CBenchmarkIteration { Iteration = iteration };
+        long bytesSent = coreClient.BytesSent;
+        long bytesReceived = coreClient.BytesReceived;
+
+        var stopwatch = Stopwatch.StartNew();
+
+        foreach (var fileName in files)
+        {
+            var session = CCliHandler.ScanModule(coreClient, config, options, fileName, true,
+                out int uniqueCount, out _);
+
+            if (session == null)
+                result.Failed++;
+            else
+                result.Modules += uniqueCount;
+        }
+
+        stopwatch.Stop();
+
+        result.Elapsed = stopwatch.Elapsed.TotalMilliseconds;
+        result.ModulesPerSecond = result.Elapsed > 0 ? result.Modules * 1000.0 / result.Elapsed : 0;
+        result.BytesSent = coreClient.BytesSent - bytesSent;
+        result.BytesReceived = coreClient.BytesReceived - bytesReceived;
+        return result;
+    }
+
+    /// <summary>
+    /// Reads corpus file names, either the single input file or a list file given with --corpus.
+    /// </summary>
+    /// <returns>Full file names, or null on error.</returns>
+    private static List<string> LoadCorpus(CliOptions options)
+    {
+        List<string> files = [];
+
+        if (!string.IsNullOrEmpty(options.CorpusFile))
+        {
+            string[] lines;
+            try
+            {
+                lines = File.ReadAllLines(options.CorpusFile);
+            }
+            catch (Exception ex)
+            {
+                Console.Error.WriteLine($"Error: Cannot read corpus list {options.CorpusFile}: {ex.Message}");
+                return null;
+            }
+
+            // Relative entries are relative to the list file, so a corpus can be moved as a whole.
+            string baseDirectory = Path.GetDirectoryName(Path.GetFullPath(options.CorpusFile)) ?? string.Empty;
+
+            foreach (var line in lines)
+            {
+                string entry = line.Trim();
+                if (entry.Length == 0 || entry.StartsWith('#'))
+                    continue;
+
+                files.Add(Path.GetFullPath(entry, baseDirectory));
+            }
+        }
+        else if (!string.IsNullOrEmpty(options.InputFile))
+        {
+            files.Add(Path.GetFullPath(options.InputFile));
+        }
+
+        if (files.Count == 0)
+        {
+            Console.Error.WriteLine("Error: No input file or corpus list specified.");
+            return null;
+        }
+
+        foreach (var fileName in files)
+        {
+            if (!File.Exists(fileName))
+            {
+                Console.Error.WriteLine($"Error: File not found: {fileName}");
+                return null;
+            }
+        }
+
+        return files;
+    }
+
+    internal static double GetMedian(List<double> values)
+    {
+        if (values.Count == 0)
+            return 0;
+
+        values.Sort();
+        int middle = values.Count / 2;
+        return (values.Count % 2 != 0) ? values[middle] : (values[middle - 1] + values[middle]) / 2;
+    }
+
+    private static long GetPeakWorkingSet(int processId)
+    {
+        if (processId <= 0)
+            return 0;
+
+        try
+        {
+            using var process = Process.GetProcessById(processId);
+            return process.PeakWorkingSet64;
+        }
+        catch
+        {
+            return 0;
+        }
+    }
+
+    private static void PrintIteration(CliOptions options, string label, CBenchmarkIteration result)
+    {
+        if (!options.Quiet)
+        {
+            Console.WriteLine($"  {label,-8} {result.Elapsed,10:F1} ms  {result.Modules,8} modules  " +
+                $"{result.ModulesPerSecond,10:F1} modules/s  {result.BytesSent + result.BytesReceived,12} bytes");
+        }
+    }
+
+    private static void PrintReport(CBenchmarkReport report)
+    {
+        Console.WriteLine();
+        Console.WriteLine($"Median throughput: {report.ModulesPerSecond:F1} modules/s");
+        Console.WriteLine($"Peak working set: client {report.ClientPeakWorkingSet / 1024} KB, server {report.ServerPeakWorkingSet / 1024} KB");
+
+        if (report.Iterations.Count > 0)
+        {
+            Console.WriteLine($"Bytes on wire per iteration: sent {report.Iterations.Average(r => r.BytesSent):F0}, " +
+                $"received {report.Iterations.Average(r => r.BytesReceived):F0}");
+        }
+
+        if (report.Phases.Count > 0)
+        {
+            // Client spans nest (deserialize runs inside exports/imports), totals overlap.
+            Console.WriteLine();
+            Console.WriteLine($"{"Phase",-24} {"Count",10} {"Total ms",12} {"Avg us",10} {"Max us",10}");
+
+            foreach (var phase in report.Phases)
+            {
+                Console.WriteLine($"{phase.Category + "/" + phase.Name,-24} {phase.Count,10} " +
+                    $"{phase.TotalTime / 1000.0,12:F1} {phase.TotalTime / phase.Count,10} {phase.MaxTime,10}");
+            }
+        }
+
+        if (report.DroppedEvents > 0)
+        {
+            Console.WriteLine($"Warning: {report.DroppedEvents} trace events dropped, phase timings are incomplete");
+        }
+    }
+
+    private static bool SaveReport(CBenchmarkReport report, string fileName)
+    {
+        try
+        {
+            var serializer = new DataContractJsonSerializer(typeof(CBenchmarkReport));
+            using var stream = File.Create(fileName);
+            serializer.WriteObject(stream, report);
+            return true;
+        }
+        catch
+        {
+            return false;
+        }
+    }
+}
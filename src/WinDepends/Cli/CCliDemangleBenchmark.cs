@@ -0,0 +1,147 @@
+﻿/*******************************************************************************
+*
+*  (C) COPYRIGHT AUTHORS, 2026
+*
+*  TITLE:       CCLIDEMANGLEBENCHMARK.CS
+*
+*  VERSION:     1.00
+*
+*  DATE:        18 Oct 2026
+*  
+*  Managed undecorator validation and throughput benchmark for command-line mode.
+*
+* THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF
+* ANY KIND, EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED
+* TO THE IMPLIED WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+*******************************************************************************/
+using System.Diagnostics;
+
+namespace WinDepends;
+
+/// <summary>
+/// Compares <see cref="CMsvcDemangler"/> output and speed with dbghelp over a list of decorated names.
+/// </summary>
+static class CCliDemangleBenchmark
+{
+    /// <summary>
+    /// Validates <see cref="CMsvcDemangler"/> against dbghelp and measures undecoration throughput.
+    /// </summary>
+    /// <remarks>
+    /// Input is a list of decorated names, one per line. Every name is undecorated by both
+    /// implementations, names the managed undecorator does not support are counted separately
+    /// as they are handled by dbghelp fallback at runtime.
+    /// </remarks>
+    /// <param name="options">Command-line options.</param>
+    /// <returns>Process exit code, 1 if any name is undecorated differently.</returns>
+    internal static int Run(CliOptions options)
+    {
+        List<string> names = [];
+
+        try
+        {
+            foreach (var line in File.ReadLines(options.DemangleCorpusFile))
+            {
+                string entry = line.Trim();
+                if (entry.StartsWith('?'))
+                    names.Add(entry);
+            }
+        }
+        catch (Exception ex)
+        {
+            Console.Error.WriteLine($"Error: Cannot read name list {options.DemangleCorpusFile}: {ex.Message}");
+            return 1;
+        }
+
+        if (names.Count == 0)
+        {
+            Console.Error.WriteLine("Error: No decorated names in list.");
+            return 1;
+        }
+
+        var config = CConfigManager.LoadConfiguration();
+        using var symbolResolver = new CSymbolResolver();
+
+        bool nativeReady = symbolResolver.AllocateSymbolResolver(config.SymbolsDllPath, string.Empty, false) ==
+            SymbolResolverInitResult.SuccessForUndecorationOnly;
+
+        if (!nativeReady && !options.Quiet)
+        {
+            Console.Error.WriteLine($"[!] {config.SymbolsDllPath} not loaded, validation skipped");
+        }
+
+        int matched = 0, mismatched = 0, unsupported = 0;
+
+        foreach (var name in names)
+        {
+            bool managedResult = CMsvcDemangler.TryUndecorate(name, CSymbolResolver.UndecorateFlags, out string managed);
+
+            if (!managedResult)
+            {
+                unsupported++;
+                continue;
+            }
+
+            if (!nativeReady)
+                continue;
+
+            // Dbghelp returns input unchanged if it cannot undecorate.
+            if (!symbolResolver.UndecorateNameNative(name, out string native))
+                native = name;
+
+            if (string.Equals(managed, native, StringComparison.Ordinal))
+            {
+                matched++;
+                continue;
+            }
+
+            if (mismatched++ < 20 && !options.Quiet)
+            {
+                Console.WriteLine($"Mismatch: {name}");
+                Console.WriteLine($"  dbghelp: {native}");
+                Console.WriteLine($"  managed: {managed}");
+            }
+        }
+
+        double managedRate = MeasureNamesPerSecond(names, options.BenchmarkIterations,
+            name => CMsvcDemangler.TryUndecorate(name, CSymbolResolver.UndecorateFlags, out _));
+
+        double nativeRate = nativeReady ? MeasureNamesPerSecond(names, options.BenchmarkIterations,
+            name => symbolResolver.UndecorateNameNative(name, out _)) : 0;
+
+        if (!options.Quiet)
+        {
+            Console.WriteLine($"Names: {names.Count}, matched {matched}, mismatched {mismatched}, unsupported {unsupported}");
+            Console.WriteLine($"Median throughput: managed {managedRate:F0} names/s" +
+                (nativeReady ? $", dbghelp {nativeRate:F0} names/s" : string.Empty));
+        }
+
+        return mismatched > 0 ? 1 : 0;
+    }
+
+    /// <summary>
+    /// Median names per second over the given number of passes, after a warm-up pass.
+    /// </summary>
+    private static double MeasureNamesPerSecond(List<string> names, int iterations, Func<string, bool> undecorate)
+    {
+        List<double> rates = [];
+
+        for (int iteration = 0; iteration <= iterations; iteration++)
+        {
+            var stopwatch = Stopwatch.StartNew();
+
+            foreach (var name in names)
+            {
+                undecorate(name);
+            }
+
+            stopwatch.Stop();
+
+            if (iteration > 0 && stopwatch.Elapsed.TotalMilliseconds > 0)
+                rates.Add(names.Count * 1000.0 / stopwatch.Elapsed.TotalMilliseconds);
+        }
+
+        return CCliBenchmark.GetMedian(rates);
+    }
+}
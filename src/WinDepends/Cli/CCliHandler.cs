@@ -6,7 +6,7 @@
 *
 *  VERSION:     1.00
 *
-*  DATE:        17 Jul 2026
+*  DATE:        18 Oct 2026
 *  
 *  Implementation of command-line interface handler.
 *
@@ -37,6 +37,16 @@ public class CliOptions
     public bool ShowHelp { get; set; } = false;
     public bool ShowVersion { get; set; } = false;
     public bool FullPaths { get; set; } = true;
+    public string KnownDllsSnapshot { get; set; }
+    public bool ServerStats { get; set; } = false;
+    public string TraceFile { get; set; }
+    public int BenchmarkIterations { get; set; } = 0;
+    public string CorpusFile { get; set; }
+    public string DemangleCorpusFile { get; set; }
+    public string SessionBenchmarkFile { get; set; }
+    public bool LazyRelocs { get; set; } = false;
+    public bool ResolverTest { get; set; } = false;
+    public bool DeferDirectorySearch { get; set; } = false;
 }
 
 /// <summary>
@@ -54,6 +64,7 @@ public static class CCliHandler
     private static extern bool FreeConsole();
 
     private const int ATTACH_PARENT_PROCESS = -1;
+    private const int DefaultBenchmarkIterations = 5;
 
     private static readonly string[] CliArguments = {
         "-o",
@@ -78,7 +89,17 @@ public static class CCliHandler
         "--no-exports",
         "--no-imports",
         "--no-resolve",
-        "--short-paths"
+        "--short-paths",
+        "--knowndlls",
+        "--server-stats",
+        "--trace",
+        "--benchmark",
+        "--corpus",
+        "--demangle",
+        "--session-bench",
+        "--lazy-relocs",
+        "--resolver-test",
+        "--defer-search"
     };
 
     /// <summary>
@@ -98,7 +119,13 @@ public static class CCliHandler
 
             if (lowerArg.StartsWith("--output=") ||
                 lowerArg.StartsWith("--format=") ||
-                lowerArg.StartsWith("--depth="))
+                lowerArg.StartsWith("--depth=") ||
+                lowerArg.StartsWith("--knowndlls=") ||
+                lowerArg.StartsWith("--trace=") ||
+                lowerArg.StartsWith("--benchmark=") ||
+                lowerArg.StartsWith("--corpus=") ||
+                lowerArg.StartsWith("--demangle=") ||
+                lowerArg.StartsWith("--session-bench="))
             {
                 return true;
             }
@@ -212,6 +239,112 @@ public static class CCliHandler
                 options.FullPaths = false;
                 i++;
             }
+            else if (lowerArg == "--knowndlls")
+            {
+                if (i + 1 < args.Length)
+                {
+                    options.KnownDllsSnapshot = args[++i];
+                }
+                i++;
+            }
+            else if (lowerArg.StartsWith("--knowndlls="))
+            {
+                options.KnownDllsSnapshot = arg.Substring(12);
+                i++;
+            }
+            else if (lowerArg == "--server-stats")
+            {
+                options.ServerStats = true;
+                i++;
+            }
+            else if (lowerArg == "--lazy-relocs")
+            {
+                options.LazyRelocs = true;
+                i++;
+            }
+            else if (lowerArg == "--resolver-test")
+            {
+                options.ResolverTest = true;
+                i++;
+            }
+            else if (lowerArg == "--defer-search")
+            {
+                options.DeferDirectorySearch = true;
+                i++;
+            }
+            else if (lowerArg == "--trace")
+            {
+                if (i + 1 < args.Length)
+                {
+                    options.TraceFile = args[++i];
+                }
+                i++;
+            }
+            else if (lowerArg.StartsWith("--trace="))
+            {
+                options.TraceFile = arg.Substring(8);
+                i++;
+            }
+            else if (lowerArg == "--benchmark")
+            {
+                if (i + 1 < args.Length && int.TryParse(args[i + 1], out int iterations))
+                {
+                    options.BenchmarkIterations = Math.Max(1, iterations);
+                    i++;
+                }
+                else
+                {
+                    options.BenchmarkIterations = DefaultBenchmarkIterations;
+                }
+                i++;
+            }
+            else if (lowerArg.StartsWith("--benchmark="))
+            {
+                if (int.TryParse(arg.Substring(12), out int iterations))
+                {
+                    options.BenchmarkIterations = Math.Max(1, iterations);
+                }
+                i++;
+            }
+            else if (lowerArg == "--corpus")
+            {
+                if (i + 1 < args.Length)
+                {
+                    options.CorpusFile = args[++i];
+                }
+                i++;
+            }
+            else if (lowerArg.StartsWith("--corpus="))
+            {
+                options.CorpusFile = arg.Substring(9);
+                i++;
+            }
+            else if (lowerArg == "--demangle")
+            {
+                if (i + 1 < args.Length)
+                {
+                    options.DemangleCorpusFile = args[++i];
+                }
+                i++;
+            }
+            else if (lowerArg.StartsWith("--demangle="))
+            {
+                options.DemangleCorpusFile = arg.Substring(11);
+                i++;
+            }
+            else if (lowerArg == "--session-bench")
+            {
+                if (i + 1 < args.Length)
+                {
+                    options.SessionBenchmarkFile = args[++i];
+                }
+                i++;
+            }
+            else if (lowerArg.StartsWith("--session-bench="))
+            {
+                options.SessionBenchmarkFile = arg.Substring(16);
+                i++;
+            }
             else if (!arg.StartsWith("-") && string.IsNullOrEmpty(options.InputFile))
             {
                 options.InputFile = arg;
@@ -254,6 +387,42 @@ public static class CCliHandler
                 return 0;
             }
 
+            // Undecorator validation takes a list of decorated names instead of files.
+            if (!string.IsNullOrEmpty(options.DemangleCorpusFile))
+            {
+                if (options.BenchmarkIterations == 0)
+                    options.BenchmarkIterations = DefaultBenchmarkIterations;
+
+                return CCliDemangleBenchmark.Run(options);
+            }
+
+            // Resolver checks run on in-memory filesystem and take no input.
+            if (options.ResolverTest)
+            {
+                if (options.BenchmarkIterations == 0)
+                    options.BenchmarkIterations = DefaultBenchmarkIterations;
+
+                return CCliResolverTest.Run(options);
+            }
+
+            // Session format comparison takes a saved session instead of a module.
+            if (!string.IsNullOrEmpty(options.SessionBenchmarkFile))
+            {
+                if (options.BenchmarkIterations == 0)
+                    options.BenchmarkIterations = DefaultBenchmarkIterations;
+
+                return CCliSessionBenchmark.Run(options);
+            }
+
+            // Benchmark takes a corpus instead of single input and writes report instead of export.
+            if (options.BenchmarkIterations > 0 || !string.IsNullOrEmpty(options.CorpusFile))
+            {
+                if (options.BenchmarkIterations == 0)
+                    options.BenchmarkIterations = DefaultBenchmarkIterations;
+
+                return CCliBenchmark.Run(options);
+            }
+
             if (string.IsNullOrEmpty(options.InputFile))
             {
                 Console.Error.WriteLine("Error: No input file specified.");
@@ -293,7 +462,7 @@ public static class CCliHandler
     /// Resolves the core server application path.
     /// First tries configuration path, then falls back to default location.
     /// </summary>
-    private static string ResolveCoreServerPath(CConfiguration config)
+    internal static string ResolveCoreServerPath(CConfiguration config)
     {
         if (!string.IsNullOrEmpty(config.CoreServerAppLocation) && File.Exists(config.CoreServerAppLocation))
         {
@@ -352,56 +521,187 @@ public static class CCliHandler
 
         using var coreClient = new CCoreClient(serverApp, CConsts.CoreServerAddress, LogMessage, true);
 
+        // Must be started before connect, so the server session trace gets enabled too.
+        if (!string.IsNullOrEmpty(options.TraceFile))
+        {
+            CTraceRecorder.Start();
+        }
+
         if (!coreClient.ConnectClient())
         {
             Console.Error.WriteLine("Error: Failed to connect to core server.");
             return 1;
         }
 
-        CActCtxHelper actCtxHelper = null;
-
         try
         {
-            CPathResolver.KnownDlls.Clear();
-            CPathResolver.KnownDlls32.Clear();
-            coreClient.GetKnownDllsAll(
-                CPathResolver.KnownDlls,
-                CPathResolver.KnownDlls32,
-                out string knownDllsPath,
-                out string knownDllsPath32);
-            CPathResolver.KnownDllsPath = knownDllsPath;
-            CPathResolver.KnownDllsPath32 = knownDllsPath32;
+            if (!string.IsNullOrEmpty(options.KnownDllsSnapshot) &&
+                !coreClient.LoadKnownDllsSnapshot(options.KnownDllsSnapshot))
+            {
+                Console.Error.WriteLine($"Error: Failed to load KnownDlls snapshot: {options.KnownDllsSnapshot}");
+                return 1;
+            }
 
-            CPathResolver.UserDirectoriesUM = config.UserSearchOrderDirectoriesUM;
-            CPathResolver.UserDirectoriesKM = config.UserSearchOrderDirectoriesKM;
+            PrepareResolver(coreClient, config, options.DeferDirectorySearch);
 
-            var session = new CDepends(options.InputFile);
-            var rootModule = session.RootModule;
+            var session = ScanModule(coreClient, config, options, options.InputFile, options.Quiet,
+                out int uniqueCount, out int sharedCount);
+            if (session == null)
+            {
+                return 1;
+            }
 
-            var searchOrderUM = options.UseKernelSearchOrder ? config.SearchOrderListKM : config.SearchOrderListUM;
-            var searchOrderKM = config.SearchOrderListKM;
+            if (!options.Quiet)
+            {
+                Console.WriteLine($"Unique modules: {uniqueCount}, duplicate entries sharing module data: {sharedCount}");
+                Console.WriteLine($"Path probes: {CDirectoryProbeCache.ProbeCount}, answered from directory cache: {CDirectoryProbeCache.ProbesSaved}, " +
+                    $"directories listed: {CDirectoryProbeCache.DirectoriesEnumerated}");
 
-            var fileOpenSettings = new CFileOpenSettings(config);
+                long resolutionHits = CPathResolver.ResolutionCacheHits;
+                long resolutionTotal = resolutionHits + CPathResolver.ResolutionCacheMisses;
+                double hitRate = resolutionTotal > 0 ? resolutionHits * 100.0 / resolutionTotal : 0;
+                Console.WriteLine($"Path resolutions: {resolutionTotal}, memo hits: {resolutionHits} ({hitRate:F1}%)");
+                Console.WriteLine($"Exporting to {options.Format}: {options.OutputFile}");
+            }
+
+            if (options.ServerStats)
+            {
+                PrintServerStats(coreClient.GetServerStats());
+            }
+
+            var exportOptions = new ExportOptions
+            {
+                IncludeExports = options.IncludeExports,
+                IncludeImports = options.IncludeImports,
+                FullPaths = options.FullPaths,
+                MaxDepth = options.MaxDepth
+            };
 
-            var status = coreClient.OpenModule(ref rootModule, fileOpenSettings);
-            if (status != ModuleOpenStatus.Okay)
+            if (CExporter.Export(session, options.OutputFile, options.Format, exportOptions))
             {
                 if (!options.Quiet)
                 {
-                    Console.WriteLine($"Warning: Module open status: {status}");
+                    Console.WriteLine("Export completed successfully.");
                 }
+                return 0;
+            }
+            else
+            {
+                Console.Error.WriteLine("Error: Export failed.");
+                return 1;
+            }
+        }
+        catch (Exception ex)
+        {
+            Console.Error.WriteLine($"Error: {ex.Message}");
+            return 1;
+        }
+        finally
+        {
+            coreClient.DisconnectClient();
 
-                if (rootModule.FileNotFound)
+            // Disconnect collects server events, trace is complete only after it.
+            if (CTraceRecorder.Enabled)
+            {
+                CTraceRecorder.Stop();
+                if (CTraceRecorder.Save(options.TraceFile))
+                {
+                    if (!options.Quiet)
+                    {
+                        Console.WriteLine($"Trace saved: {options.TraceFile}, dropped events: {CTraceRecorder.Dropped}");
+                    }
+                }
+                else
                 {
-                    Console.Error.WriteLine($"Error: File not found or inaccessible: {options.InputFile}");
-                    return 1;
+                    Console.Error.WriteLine($"Error: Failed to save trace: {options.TraceFile}");
                 }
             }
+        }
+    }
+
+    /// <summary>
+    /// Loads KnownDlls and user search directories into the path resolver.
+    /// </summary>
+    /// <param name="coreClient">Connected core client.</param>
+    /// <param name="config">Program configuration.</param>
+    /// <param name="deferDirectorySearch">
+    /// Leave directory search of dependents to the server, which probes the directories
+    /// while opening the module, see <see cref="CCoreClient.DeferDirectorySearch"/>.
+    /// </param>
+    internal static void PrepareResolver(CCoreClient coreClient, CConfiguration config, bool deferDirectorySearch)
+    {
+        coreClient.DeferDirectorySearch = deferDirectorySearch;
+
+        CPathResolver.KnownDlls.Clear();
+        CPathResolver.KnownDlls32.Clear();
+        coreClient.GetKnownDllsAll(
+            CPathResolver.KnownDlls,
+            CPathResolver.KnownDlls32,
+            out string knownDllsPath,
+            out string knownDllsPath32);
+        CPathResolver.KnownDllsPath = knownDllsPath;
+        CPathResolver.KnownDllsPath32 = knownDllsPath32;
+        CPathResolver.SyncKnownDllsCache();
+
+        CPathResolver.UserDirectoriesUM = config.UserSearchOrderDirectoriesUM;
+        CPathResolver.UserDirectoriesKM = config.UserSearchOrderDirectoriesKM;
+    }
+
+    /// <summary>
+    /// Analyzes the module and all its dependencies.
+    /// </summary>
+    /// <param name="coreClient">Connected core client.</param>
+    /// <param name="config">Program configuration.</param>
+    /// <param name="options">Command-line options.</param>
+    /// <param name="fileName">Module to analyze.</param>
+    /// <param name="quiet">Suppress progress output.</param>
+    /// <param name="uniqueCount">Number of unique modules analyzed.</param>
+    /// <param name="sharedCount">Number of duplicate entries sharing module data.</param>
+    /// <returns>Analyzed session, or null if the module cannot be opened.</returns>
+    internal static CDepends ScanModule(CCoreClient coreClient,
+        CConfiguration config,
+        CliOptions options,
+        string fileName,
+        bool quiet,
+        out int uniqueCount,
+        out int sharedCount)
+    {
+        uniqueCount = 0;
+        sharedCount = 0;
+
+        var session = new CDepends(fileName);
+        var rootModule = session.RootModule;
+
+        var searchOrderUM = options.UseKernelSearchOrder ? config.SearchOrderListKM : config.SearchOrderListUM;
+        var searchOrderKM = config.SearchOrderListKM;
+
+        var fileOpenSettings = new CFileOpenSettings(config)
+        {
+            LazyRelocs = options.LazyRelocs
+        };
+
+        var status = coreClient.OpenModule(ref rootModule, fileOpenSettings);
+        if (status != ModuleOpenStatus.Okay)
+        {
+            if (!quiet)
+            {
+                Console.WriteLine($"Warning: Module open status: {status}");
+            }
+
+            if (rootModule.FileNotFound)
+            {
+                Console.Error.WriteLine($"Error: File not found or inaccessible: {fileName}");
+                return null;
+            }
+        }
 
-            coreClient.GetModuleHeadersInformation(rootModule);
+        coreClient.GetModuleHeadersInformation(rootModule);
 
-            actCtxHelper = new CActCtxHelper(rootModule.FileName);
-            CPathResolver.ActCtxHelper = actCtxHelper;
+        using var actCtxHelper = new CActCtxHelper(rootModule.FileName);
+        CPathResolver.ActCtxHelper = actCtxHelper;
+
+        try
+        {
             CPathResolver.Initialized = false;
             CPathResolver.QueryFileInformation(rootModule);
 
@@ -416,7 +716,7 @@ public static class CCliHandler
 
             coreClient.CloseModule();
 
-            if (!options.Quiet)
+            if (!quiet)
             {
                 Console.WriteLine("Processing dependencies...");
             }
@@ -436,47 +736,18 @@ public static class CCliHandler
                 options.MaxDepth,
                 0,
                 processedModulesData,
-                options.Quiet,
-                ref processedCount);
-
-            if (!options.Quiet)
-            {
-                Console.WriteLine($"Exporting to {options.Format}: {options.OutputFile}");
-            }
-
-            var exportOptions = new ExportOptions
-            {
-                IncludeExports = options.IncludeExports,
-                IncludeImports = options.IncludeImports,
-                FullPaths = options.FullPaths,
-                MaxDepth = options.MaxDepth
-            };
+                quiet,
+                ref processedCount,
+                ref sharedCount);
 
-            if (CExporter.Export(session, options.OutputFile, options.Format, exportOptions))
-            {
-                if (!options.Quiet)
-                {
-                    Console.WriteLine("Export completed successfully.");
-                }
-                return 0;
-            }
-            else
-            {
-                Console.Error.WriteLine("Error: Export failed.");
-                return 1;
-            }
-        }
-        catch (Exception ex)
-        {
-            Console.Error.WriteLine($"Error: {ex.Message}");
-            return 1;
+            uniqueCount = processedModulesData.Count;
         }
         finally
         {
-            actCtxHelper?.Dispose();
             CPathResolver.ActCtxHelper = null;
-            coreClient.DisconnectClient();
         }
+
+        return session;
     }
 
     private static void ProcessDependentsRecursive(
@@ -491,28 +762,40 @@ public static class CCliHandler
         int currentDepth,
         Dictionary<string, CModule> processedModulesData,
         bool quiet,
-        ref int processedCount)
+        ref int processedCount,
+        ref int sharedCount)
     {
         if (currentDepth >= maxDepth || parentModule.Dependents == null)
             return;
 
+        // Directory search of dependents left unresolved on our side is done by the server.
+        List<(string Directory, SearchOrderType SearchOrder)> searchDirectories = null;
+        string searchDirectoriesKey = null;
+
         for (int i = 0; i < parentModule.Dependents.Count; i++)
         {
             var dep = parentModule.Dependents[i];
-            string key = dep.FileName?.ToLowerInvariant() ?? "";
 
-            if (string.IsNullOrEmpty(key))
+            if (string.IsNullOrEmpty(dep.FileName))
                 continue;
 
+            // Unresolved name is only a duplicate of a module resolved with the same directory list,
+            // the name the server resolves it to is used as the key once the module is opened.
+            string aliasKey = null;
+            if (!Path.IsPathRooted(dep.FileName))
+            {
+                searchDirectories ??= CPathResolver.GetSearchDirectories(parentModule, searchOrderUM, searchOrderKM);
+                searchDirectoriesKey ??= searchDirectories == null ? string.Empty :
+                    string.Join("|", searchDirectories.Select(entry => entry.Directory));
+                aliasKey = dep.FileName.ToLowerInvariant() + "|" + searchDirectoriesKey;
+            }
+
+            string key = aliasKey ?? dep.FileName.ToLowerInvariant();
+
             if (processedModulesData.TryGetValue(key, out CModule existingModule))
             {
-                dep.ModuleData = new CModuleData(existingModule.ModuleData);
-                dep.FileNotFound = existingModule.FileNotFound;
-                dep.IsInvalid = existingModule.IsInvalid;
-                dep.ExportContainErrors = existingModule.ExportContainErrors;
-                dep.OtherErrorsPresent = existingModule.OtherErrorsPresent;
-                dep.IsDotNetModule = existingModule.IsDotNetModule;
-                dep.OriginalInstanceId = existingModule.InstanceId;
+                ShareDuplicateData(dep, existingModule);
+                sharedCount++;
                 parentModule.Dependents[i] = dep;
                 continue;
             }
@@ -529,7 +812,24 @@ public static class CCliHandler
                 Console.WriteLine($"  [{processedCount}] Analyzing: {Path.GetFileName(dep.FileName)}");
             }
 
-            var status = coreClient.OpenModule(ref dep, fileOpenSettings);
+            var status = coreClient.OpenModule(ref dep, fileOpenSettings, searchDirectories);
+            if (status == ModuleOpenStatus.Okay && aliasKey != null)
+            {
+                // Name was resolved while opening, it could be a module already analyzed by its path.
+                string resolvedKey = dep.FileName.ToLowerInvariant();
+                if (processedModulesData.TryGetValue(resolvedKey, out existingModule))
+                {
+                    coreClient.CloseModule();
+                    ShareDuplicateData(dep, existingModule);
+                    sharedCount++;
+                    processedModulesData[aliasKey] = existingModule;
+                    parentModule.Dependents[i] = dep;
+                    continue;
+                }
+
+                key = resolvedKey;
+            }
+
             if (status == ModuleOpenStatus.Okay)
             {
                 coreClient.GetModuleHeadersInformation(dep);
@@ -553,9 +853,16 @@ public static class CCliHandler
                 dep.IsInvalid = true;
             }
 
-            dep.InstanceId = dep.GetHashCode();
-            processedModulesData[key] = dep;
-            parentModule.Dependents[i] = dep;
+            using (CTraceRecorder.BeginSpan("tree-insert", "client", dep.FileName))
+            {
+                dep.InstanceId = dep.GetHashCode();
+                processedModulesData[key] = dep;
+                if (aliasKey != null)
+                {
+                    processedModulesData[aliasKey] = dep;
+                }
+                parentModule.Dependents[i] = dep;
+            }
 
             ProcessDependentsRecursive(
                 coreClient,
@@ -569,10 +876,27 @@ public static class CCliHandler
                 currentDepth + 1,
                 processedModulesData,
                 quiet,
-                ref processedCount);
+                ref processedCount,
+                ref sharedCount);
         }
     }
 
+    /// <summary>
+    /// Makes the dependent a duplicate of already analyzed module.
+    /// </summary>
+    /// <param name="dep">Duplicate dependent.</param>
+    /// <param name="existingModule">Original module instance.</param>
+    private static void ShareDuplicateData(CModule dep, CModule existingModule)
+    {
+        dep.ModuleData = existingModule.ModuleData.GetSharedDuplicateData();
+        dep.FileNotFound = existingModule.FileNotFound;
+        dep.IsInvalid = existingModule.IsInvalid;
+        dep.ExportContainErrors = existingModule.ExportContainErrors;
+        dep.OtherErrorsPresent = existingModule.OtherErrorsPresent;
+        dep.IsDotNetModule = existingModule.IsDotNetModule;
+        dep.OriginalInstanceId = existingModule.InstanceId;
+    }
+
     private static ExportFormat ParseFormat(string format)
     {
         return format.ToLowerInvariant() switch
@@ -588,6 +912,48 @@ public static class CCliHandler
         };
     }
 
+    /// <summary>
+    /// Returns upper bound of the latency histogram bucket containing the given percentile.
+    /// </summary>
+    private static long GetLatencyPercentile(List<long> latency, long calls, double percentile)
+    {
+        if (latency == null || calls == 0)
+            return 0;
+
+        long threshold = (long)Math.Ceiling(calls * percentile);
+        long count = 0;
+
+        for (int i = 0; i < latency.Count; i++)
+        {
+            count += latency[i];
+            if (count >= threshold)
+                return 1L << (i + 1);
+        }
+
+        return 1L << latency.Count;
+    }
+
+    private static void PrintServerStats(CCoreServerStats stats)
+    {
+        if (stats?.Commands == null)
+        {
+            Console.Error.WriteLine("Warning: Server statistics are not available.");
+            return;
+        }
+
+        Console.WriteLine($"Server statistics, uptime {TimeSpan.FromMilliseconds(stats.Uptime):g}, latencies in microseconds:");
+        Console.WriteLine($"  {"Command",-20} {"Calls",10} {"Avg",10} {"P50<=",10} {"P99<=",10} {"Max",10} {"Read",14} {"Sent",14} {"Allocs",12}");
+
+        foreach (var entry in stats.Commands.OrderByDescending(entry => entry.TotalTime))
+        {
+            long average = entry.Calls > 0 ? entry.TotalTime / entry.Calls : 0;
+            Console.WriteLine($"  {entry.Name,-20} {entry.Calls,10} {average,10} " +
+                $"{GetLatencyPercentile(entry.Latency, entry.Calls, 0.5),10} " +
+                $"{GetLatencyPercentile(entry.Latency, entry.Calls, 0.99),10} " +
+                $"{entry.MaxTime,10} {entry.BytesRead,14} {entry.BytesSent,14} {entry.Allocations,12}");
+        }
+    }
+
     private static void PrintHelp()
     {
         Console.WriteLine($@"
@@ -608,6 +974,21 @@ Options:
   --no-resolve            Don't resolve API set names (default: from configuration)
   -k, --kernel            Use kernel-mode search order
   --short-paths           Use short file names instead of full paths (default: from configuration)
+  --knowndlls <file>      Use KnownDlls snapshot of the target system instead of the running one
+  --server-stats          Print server wide per-command counters and latencies after analysis
+  --lazy-relocs           Relocate image pages on first access instead of at open (experimental)
+  --trace <file>          Write client and server timeline of the analysis as Chrome trace-event JSON
+  --benchmark [n]         Analyze input n times (default: 5) after a warm-up pass and report throughput,
+                          peak memory, bytes on wire and per-phase timings; -o writes JSON report
+  --corpus <file>         Benchmark corpus: list of files to analyze, one per line
+  --demangle <file>       Compare managed C++ name undecoration with dbghelp on decorated names
+                          listed one per line and report names per second for both
+  --session-bench <file>  Save and load session file in JSON and binary session formats and compare
+                          save time, load time and file size
+  --defer-search          Leave directory search of dependents to the server while opening them
+  --resolver-test         Check module path resolution on in-memory filesystem, then replay recorded
+                          search orders over a synthetic tree of 100k files and report resolutions
+                          per second; --corpus <file> adds search orders, one per line
   -h, --help              Show this help message
   -v, --version           Show version information
 
@@ -618,6 +999,8 @@ Examples:
   WinDepends.exe myapp.exe -o report.html -f html
   WinDepends.exe driver.sys -f json -k --no-imports
   WinDepends.exe module.dll -f dot | dot -Tpng -o graph.png
+  WinDepends.exe --corpus corpus.txt --benchmark 10 -o bench.json
+  WinDepends.exe --demangle names.txt --benchmark 20
 
 Formats:
   json      Full structured JSON data
@@ -0,0 +1,567 @@
+﻿/*******************************************************************************
+*
+*  (C) COPYRIGHT AUTHORS, 2026
+*
+*  TITLE:       CCLIRESOLVERTEST.CS
+*
+*  VERSION:     1.00
+*
+*  DATE:        18 Oct 2026
+*
+*  Module path resolution regression checks and benchmark on in-memory filesystem.
+*
+* THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF
+* ANY KIND, EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED
+* TO THE IMPLIED WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+*******************************************************************************/
+using System.Diagnostics;
+using System.Reflection.PortableExecutable;
+
+namespace WinDepends;
+
+/// <summary>
+/// Runs <see cref="CPathResolver"/> against <see cref="CMemoryFileSystem"/> trees.
+/// </summary>
+/// <remarks>
+/// Every check builds its own filesystem, so results do not depend on the host volume,
+/// installed assemblies or PATH. The benchmark replays recorded search orders over a synthetic
+/// tree of 100k files and reports resolutions per second and probe cache statistics.
+/// The harness is a mode of the application, as the repository has no separate test project,
+/// so it runs where the application runs. Host dependent inputs left are the processor
+/// architecture used for redirection decisions and path splitting of the runtime.
+/// </remarks>
+static class CCliResolverTest
+{
+    // 2 * 1000 + 2 * 4000 + 1000 + 1000 + (340 + 16) * 250 = 100000 files.
+    private const int BenchmarkApplicationFiles = 1000;
+    private const int BenchmarkSystemFiles = 4000;
+    private const int BenchmarkDriverFiles = 1000;
+    private const int BenchmarkWindowsFiles = 1000;
+    private const int BenchmarkPathDirectories = 340;
+    private const int BenchmarkUserDirectories = 16;
+    private const int BenchmarkFilesPerDirectory = 250;
+    private const int BenchmarkKnownDlls = 64;
+    private const int BenchmarkNames = 4096;
+
+    private static readonly List<SearchOrderType> SearchOrderUM =
+    [
+        SearchOrderType.WinSXS,
+        SearchOrderType.KnownDlls,
+        SearchOrderType.ApplicationDirectory,
+        SearchOrderType.System32Directory,
+        SearchOrderType.SystemDirectory,
+        SearchOrderType.WindowsDirectory,
+        SearchOrderType.EnvironmentPathDirectories,
+        SearchOrderType.UserDefinedDirectory
+    ];
+
+    private static readonly List<SearchOrderType> SearchOrderKM =
+    [
+        SearchOrderType.ApplicationDirectory,
+        SearchOrderType.System32Directory,
+        SearchOrderType.SystemDriversDirectory,
+        SearchOrderType.UserDefinedDirectory
+    ];
+
+    /// <summary>
+    /// Runs regression checks, then the benchmark.
+    /// </summary>
+    /// <param name="options">Command-line options.</param>
+    /// <returns>Process exit code, 1 if any check failed.</returns>
+    internal static int Run(CliOptions options)
+    {
+        int failed = 0;
+        var previousFileSystem = CPathResolver.FileSystem;
+
+        try
+        {
+            failed += Check(options, "application directory before system directory", CheckApplicationDirectory());
+            failed += Check(options, "KnownDlls resolved from system directory", CheckKnownDlls());
+            failed += Check(options, "PATH entries with mixed separators", CheckPathEnvironment());
+            failed += Check(options, "listing revalidated on next scan", CheckListingRevalidation());
+            failed += Check(options, "activation context result and fallback", CheckActivationContext());
+            failed += Check(options, "deferred directory search", CheckDeferredDirectorySearch());
+            failed += Check(options, "kernel mode drivers directory", CheckKernelMode());
+
+            int replayFailed = RunBenchmark(options);
+            if (replayFailed < 0)
+                return 1;
+
+            failed += replayFailed;
+        }
+        finally
+        {
+            CPathResolver.FileSystem = previousFileSystem;
+        }
+
+        if (!options.Quiet)
+        {
+            Console.WriteLine(failed == 0 ? "All resolver checks passed." : $"{failed} resolver check(s) failed.");
+        }
+
+        return failed > 0 ? 1 : 0;
+    }
+
+    private static int Check(CliOptions options, string name, bool passed)
+    {
+        if (!options.Quiet || !passed)
+        {
+            Console.WriteLine($"[{(passed ? "PASS" : "FAIL")}] {name}");
+        }
+
+        return passed ? 0 : 1;
+    }
+
+    private static ushort GetNativeMachine()
+    {
+        return CUtils.SystemProcessorArchitecture switch
+        {
+            NativeMethods.PROCESSOR_ARCHITECTURE_INTEL => (ushort)Machine.I386,
+            NativeMethods.PROCESSOR_ARCHITECTURE_IA64 => (ushort)Machine.IA64,
+            NativeMethods.PROCESSOR_ARCHITECTURE_ARM64 => (ushort)Machine.Arm64,
+            _ => (ushort)Machine.Amd64
+        };
+    }
+
+    /// <summary>
+    /// Installs the filesystem and starts a new scan for the given root module.
+    /// </summary>
+    private static CModule BeginScan(CMemoryFileSystem fileSystem, string rootFileName, bool kernelMode = false)
+    {
+        CPathResolver.FileSystem = fileSystem;
+        CPathResolver.KnownDlls = [];
+        CPathResolver.KnownDlls32 = [];
+        CPathResolver.KnownDllsPath = string.Empty;
+        CPathResolver.KnownDllsPath32 = string.Empty;
+        CPathResolver.UserDirectoriesUM = [];
+        CPathResolver.UserDirectoriesKM = [];
+        CPathResolver.ActCtxHelper = null;
+
+        fileSystem.AddFile(rootFileName);
+
+        var root = new CModule(rootFileName)
+        {
+            IsKernelModule = kernelMode
+        };
+
+        // Dll root, manifest of an executable would be read from the host volume.
+        var moduleData = root.GetWritableModuleData();
+        moduleData.Machine = GetNativeMachine();
+        moduleData.Characteristics = (ushort)(Characteristics.ExecutableImage | Characteristics.Dll);
+
+        CPathResolver.QueryFileInformation(root);
+        return root;
+    }
+
+    private static string Resolve(CModule root, string fileName, out SearchOrderType resolver, bool deferDirectorySearch = false)
+    {
+        return CPathResolver.ResolvePathForModule(fileName, root, SearchOrderUM, SearchOrderKM,
+            out resolver, deferDirectorySearch);
+    }
+
+    private static string GetSystemDirectory(CMemoryFileSystem fileSystem, CModule root)
+    {
+        return root.Is64bitArchitecture() ? fileSystem.SystemDirectory : fileSystem.SystemX86Directory;
+    }
+
+    private static bool CheckApplicationDirectory()
+    {
+        var fileSystem = new CMemoryFileSystem();
+        var root = BeginScan(fileSystem, "C:\\App\\app.dll");
+        string systemDirectory = GetSystemDirectory(fileSystem, root);
+
+        fileSystem.AddFile("C:\\App\\shared.dll");
+        fileSystem.AddFile($"{systemDirectory}\\shared.dll");
+        fileSystem.AddFile($"{systemDirectory}\\system.dll");
+
+        string shared = Resolve(root, "shared.dll", out var sharedResolver);
+        string system = Resolve(root, "system.dll", out var systemResolver);
+        string missing = Resolve(root, "missing.dll", out _);
+
+        return string.Equals(shared, "C:\\App\\shared.dll", StringComparison.OrdinalIgnoreCase) &&
+            sharedResolver == SearchOrderType.ApplicationDirectory &&
+            string.Equals(system, $"{systemDirectory}\\system.dll", StringComparison.OrdinalIgnoreCase) &&
+            systemResolver == SearchOrderType.System32Directory &&
+            missing.Length == 0;
+    }
+
+    private static bool CheckKnownDlls()
+    {
+        var fileSystem = new CMemoryFileSystem();
+        var root = BeginScan(fileSystem, "C:\\App\\app.dll");
+        string systemDirectory = GetSystemDirectory(fileSystem, root);
+
+        // Known dll wins over a copy in the application directory.
+        fileSystem.AddFile("C:\\App\\kernel32.dll");
+        fileSystem.AddFile($"{systemDirectory}\\kernel32.dll");
+
+        if (root.Is64bitArchitecture())
+            CPathResolver.KnownDlls = ["kernel32.dll"];
+        else
+            CPathResolver.KnownDlls32 = ["kernel32.dll"];
+
+        string result = Resolve(root, "kernel32.dll", out var resolver);
+
+        return string.Equals(result, $"{systemDirectory}\\kernel32.dll", StringComparison.OrdinalIgnoreCase) &&
+            resolver == SearchOrderType.KnownDlls;
+    }
+
+    private static bool CheckPathEnvironment()
+    {
+        var fileSystem = new CMemoryFileSystem
+        {
+            PathEnvironment = ["C:/Tools//bin/", "D:\\Sdk\\bin"]
+        };
+        var root = BeginScan(fileSystem, "C:\\App\\app.dll");
+
+        fileSystem.AddFile("C:\\Tools\\bin\\tool.dll");
+        fileSystem.AddFile("D:/Sdk/bin/sdk.dll");
+
+        string tool = Resolve(root, "tool.dll", out var toolResolver);
+        string sdk = Resolve(root, "sdk.dll", out var sdkResolver);
+
+        return string.Equals(tool, "C:\\Tools\\bin\\tool.dll", StringComparison.OrdinalIgnoreCase) &&
+            toolResolver == SearchOrderType.EnvironmentPathDirectories &&
+            string.Equals(sdk, "D:\\Sdk\\bin\\sdk.dll", StringComparison.OrdinalIgnoreCase) &&
+            sdkResolver == SearchOrderType.EnvironmentPathDirectories;
+    }
+
+    private static bool CheckListingRevalidation()
+    {
+        var fileSystem = new CMemoryFileSystem();
+        var root = BeginScan(fileSystem, "C:\\App\\app.dll");
+
+        bool missingBefore = Resolve(root, "late.dll", out _).Length == 0;
+
+        // File added between scans must be found, cached listing of the directory is outdated.
+        fileSystem.AddFile("C:\\App\\late.dll");
+        CPathResolver.Initialized = false;
+        CPathResolver.QueryFileInformation(root);
+
+        string found = Resolve(root, "late.dll", out var resolver);
+
+        return missingBefore &&
+            string.Equals(found, "C:\\App\\late.dll", StringComparison.OrdinalIgnoreCase) &&
+            resolver == SearchOrderType.ApplicationDirectory;
+    }
+
+    private static bool CheckActivationContext()
+    {
+        var fileSystem = new CMemoryFileSystem();
+        var root = BeginScan(fileSystem, "C:\\App\\app.dll");
+        string sxsPath = $"{CPathResolver.WinSxSDirectory}\\x86_microsoft.vc90.crt\\msvcr90.dll";
+
+        fileSystem.AddActivationContextFile("msvcr90.dll", sxsPath);
+        fileSystem.AddActivationContextFile("fallback.dll", "C:\\Redist\\fallback.dll");
+
+        string sxs = Resolve(root, "msvcr90.dll", out var sxsResolver);
+
+        // Non-WinSxS SearchPath result is used only after the whole search order failed.
+        string fallback = Resolve(root, "fallback.dll", out var fallbackResolver);
+
+        return string.Equals(sxs, sxsPath, StringComparison.OrdinalIgnoreCase) &&
+            sxsResolver == SearchOrderType.WinSXS &&
+            string.Equals(fallback, "C:\\Redist\\fallback.dll", StringComparison.OrdinalIgnoreCase) &&
+            fallbackResolver == SearchOrderType.WinSXS;
+    }
+
+    private static bool CheckDeferredDirectorySearch()
+    {
+        var fileSystem = new CMemoryFileSystem
+        {
+            PathEnvironment = ["C:\\Tools"]
+        };
+        var root = BeginScan(fileSystem, "C:\\App\\app.dll");
+
+        fileSystem.AddFile("C:\\Tools\\deferred.dll");
+
+        // Directory entries are left to the server, the client probe of the same list must agree.
+        string deferred = Resolve(root, "deferred.dll", out _, true);
+        var directories = CPathResolver.GetSearchDirectories(root, SearchOrderUM, SearchOrderKM);
+        string probed = CPathResolver.PathFromSearchDirectories("deferred.dll", directories, out var resolver);
+
+        return deferred.Length == 0 &&
+            directories.Count > 0 &&
+            string.Equals(probed, "C:\\Tools\\deferred.dll", StringComparison.OrdinalIgnoreCase) &&
+            resolver == SearchOrderType.EnvironmentPathDirectories;
+    }
+
+    private static bool CheckKernelMode()
+    {
+        var fileSystem = new CMemoryFileSystem();
+        var root = BeginScan(fileSystem, "C:\\Drivers\\driver.sys", true);
+
+        fileSystem.AddFile($"{fileSystem.SystemDirectory}\\drivers\\helper.sys");
+
+        string result = Resolve(root, "helper.sys", out var resolver);
+
+        return string.Equals(result, $"{fileSystem.SystemDirectory}\\drivers\\helper.sys", StringComparison.OrdinalIgnoreCase) &&
+            resolver == SearchOrderType.SystemDriversDirectory;
+    }
+
+    /// <summary>
+    /// Search order replayed by the benchmark.
+    /// </summary>
+    private readonly record struct RecordedSearchOrder(string Name, bool KernelMode, List<SearchOrderType> Order);
+
+    /// <summary>
+    /// Collects search orders to replay: built-in variants, orders from the program configuration
+    /// and orders listed in the --corpus file, one per line as comma separated search order names,
+    /// kernel mode lines prefixed with "km:".
+    /// </summary>
+    /// <returns>Search orders, or null if the list file cannot be read.</returns>
+    private static List<RecordedSearchOrder> LoadRecordedOrders(CliOptions options)
+    {
+        var config = CConfigManager.LoadConfiguration();
+
+        List<RecordedSearchOrder> orders =
+        [
+            new("default user mode", false, SearchOrderUM),
+            new("PATH before system", false,
+            [
+                SearchOrderType.KnownDlls,
+                SearchOrderType.ApplicationDirectory,
+                SearchOrderType.EnvironmentPathDirectories,
+                SearchOrderType.System32Directory,
+                SearchOrderType.WindowsDirectory,
+                SearchOrderType.UserDefinedDirectory
+            ]),
+            new("user directories first", false,
+            [
+                SearchOrderType.UserDefinedDirectory,
+                SearchOrderType.WinSXS,
+                SearchOrderType.KnownDlls,
+                SearchOrderType.ApplicationDirectory,
+                SearchOrderType.System32Directory,
+                SearchOrderType.SystemDirectory,
+                SearchOrderType.WindowsDirectory,
+                SearchOrderType.EnvironmentPathDirectories
+            ]),
+            new("default kernel mode", true, SearchOrderKM)
+        ];
+
+        if (config.SearchOrderListUM?.Count > 0)
+            orders.Add(new("configuration user mode", false, config.SearchOrderListUM));
+        if (config.SearchOrderListKM?.Count > 0)
+            orders.Add(new("configuration kernel mode", true, config.SearchOrderListKM));
+
+        if (string.IsNullOrEmpty(options.CorpusFile))
+            return orders;
+
+        string[] lines;
+        try
+        {
+            lines = File.ReadAllLines(options.CorpusFile);
+        }
+        catch (Exception ex)
+        {
+            Console.Error.WriteLine($"Error: Cannot read search order list {options.CorpusFile}: {ex.Message}");
+            return null;
+        }
+
+        for (int i = 0; i < lines.Length; i++)
+        {
+            string entry = lines[i].Trim();
+            if (entry.Length == 0 || entry.StartsWith('#'))
+                continue;
+
+            bool kernelMode = entry.StartsWith("km:", StringComparison.OrdinalIgnoreCase);
+            if (kernelMode)
+                entry = entry.Substring(3);
+
+            List<SearchOrderType> order = [];
+            foreach (var name in entry.Split(',', StringSplitOptions.TrimEntries | StringSplitOptions.RemoveEmptyEntries))
+            {
+                if (!Enum.TryParse(name, true, out SearchOrderType searchOrder) || searchOrder == SearchOrderType.None)
+                {
+                    Console.Error.WriteLine($"Warning: Unknown search order \"{name}\" at line {i + 1}, entry skipped");
+                    continue;
+                }
+
+                order.Add(searchOrder);
+            }
+
+            if (order.Count > 0)
+                orders.Add(new($"{Path.GetFileName(options.CorpusFile)}:{i + 1}", kernelMode, order));
+        }
+
+        return orders;
+    }
+
+    /// <summary>
+    /// Builds benchmark tree of BenchmarkTotalFiles files spread over application, system,
+    /// drivers, Windows, PATH and user defined directories.
+    /// </summary>
+    private static CMemoryFileSystem CreateBenchmarkFileSystem(List<string> pathDirectories, List<string> userDirectories,
+        List<(string Directory, int Count)> locations)
+    {
+        for (int i = 0; i < BenchmarkPathDirectories; i++)
+        {
+            pathDirectories.Add($"C:\\Path{i:D3}");
+        }
+
+        for (int i = 0; i < BenchmarkUserDirectories; i++)
+        {
+            userDirectories.Add($"D:\\User{i:D2}");
+        }
+
+        var fileSystem = new CMemoryFileSystem
+        {
+            PathEnvironment = [.. pathDirectories]
+        };
+
+        locations.Add(("C:\\App", BenchmarkApplicationFiles));
+        locations.Add(("C:\\Drivers", BenchmarkApplicationFiles));
+        locations.Add((fileSystem.SystemDirectory, BenchmarkSystemFiles));
+        locations.Add((fileSystem.SystemX86Directory, BenchmarkSystemFiles));
+        locations.Add(($"{fileSystem.SystemDirectory}\\drivers", BenchmarkDriverFiles));
+        locations.Add((fileSystem.WindowsDirectory, BenchmarkWindowsFiles));
+        locations.AddRange(pathDirectories.Select(directory => (directory, BenchmarkFilesPerDirectory)));
+        locations.AddRange(userDirectories.Select(directory => (directory, BenchmarkFilesPerDirectory)));
+
+        for (int i = 0; i < locations.Count; i++)
+        {
+            for (int j = 0; j < locations[i].Count; j++)
+            {
+                fileSystem.AddFile($"{locations[i].Directory}\\file{i:D3}_{j:D4}.dll");
+            }
+        }
+
+        return fileSystem;
+    }
+
+    /// <summary>
+    /// Replays recorded search orders over a synthetic tree of 100k files. Every order is checked for
+    /// memoised results to match full walks and, in user mode, for deferred directory search followed
+    /// by the client probe of the directory list to match the full walk. Resolution memo is dropped
+    /// every pass, so each pass walks the search order against cached directory listings.
+    /// </summary>
+    /// <returns>Number of search orders that failed the checks, or -1 if orders cannot be loaded.</returns>
+    private static int RunBenchmark(CliOptions options)
+    {
+        List<string> pathDirectories = [];
+        List<string> userDirectories = [];
+        List<(string Directory, int Count)> locations = [];
+        List<string> names = [];
+        int iterations = Math.Max(options.BenchmarkIterations, 1);
+        int failed = 0;
+
+        var orders = LoadRecordedOrders(options);
+        if (orders == null)
+            return -1;
+
+        var fileSystem = CreateBenchmarkFileSystem(pathDirectories, userDirectories, locations);
+        int totalFiles = locations.Sum(location => location.Count);
+
+        for (int i = 0; i < BenchmarkNames; i++)
+        {
+            // Every eighth name is missing and walks the whole search order.
+            if (i % 8 == 7)
+            {
+                names.Add($"missing{i}.dll");
+                continue;
+            }
+
+            int location = (i * 7919) % locations.Count;
+            names.Add($"file{location:D3}_{(i * 31) % locations[location].Count:D4}.dll");
+        }
+
+        foreach (var recorded in orders)
+        {
+            var root = BeginScan(fileSystem, recorded.KernelMode ? "C:\\Drivers\\driver.sys" : "C:\\App\\app.dll",
+                recorded.KernelMode);
+            string systemDirectory = GetSystemDirectory(fileSystem, root);
+
+            CPathResolver.UserDirectoriesUM = userDirectories;
+            CPathResolver.UserDirectoriesKM = userDirectories;
+
+            // First system directory files are known dlls.
+            List<string> knownDlls = [];
+            int systemLocation = locations.FindIndex(location => location.Directory == systemDirectory);
+            for (int j = 0; j < BenchmarkKnownDlls; j++)
+            {
+                knownDlls.Add($"file{systemLocation:D3}_{j:D4}.dll");
+            }
+
+            if (root.Is64bitArchitecture())
+                CPathResolver.KnownDlls = knownDlls;
+            else
+                CPathResolver.KnownDlls32 = knownDlls;
+
+            List<SearchOrderType> orderUM = recorded.KernelMode ? SearchOrderUM : recorded.Order;
+            List<SearchOrderType> orderKM = recorded.KernelMode ? recorded.Order : SearchOrderKM;
+            List<double> rates = [];
+            string[] reference = new string[names.Count];
+            int found = 0, mismatches = 0;
+
+            for (int iteration = 0; iteration <= iterations; iteration++)
+            {
+                CPathResolver.ClearResolutionCache();
+
+                var stopwatch = Stopwatch.StartNew();
+
+                for (int i = 0; i < names.Count; i++)
+                {
+                    string result = CPathResolver.ResolvePathForModule(names[i], root, orderUM, orderKM, out _);
+                    if (iteration == 0)
+                        reference[i] = result;
+                }
+
+                stopwatch.Stop();
+
+                if (iteration > 0 && stopwatch.Elapsed.TotalMilliseconds > 0)
+                    rates.Add(names.Count * 1000.0 / stopwatch.Elapsed.TotalMilliseconds);
+            }
+
+            var directories = recorded.KernelMode ? null : CPathResolver.GetSearchDirectories(root, orderUM, orderKM);
+
+            for (int i = 0; i < names.Count; i++)
+            {
+                if (reference[i].Length > 0)
+                    found++;
+
+                // Memoised result of the last pass.
+                string memoised = CPathResolver.ResolvePathForModule(names[i], root, orderUM, orderKM, out _);
+
+                string deferred = reference[i];
+                if (directories != null)
+                {
+                    deferred = CPathResolver.ResolvePathForModule(names[i], root, orderUM, orderKM, out _, true);
+                    if (deferred.Length == 0)
+                        deferred = CPathResolver.PathFromSearchDirectories(names[i], directories, out _);
+                }
+
+                if (!string.Equals(memoised, reference[i], StringComparison.OrdinalIgnoreCase) ||
+                    !string.Equals(deferred, reference[i], StringComparison.OrdinalIgnoreCase))
+                {
+                    mismatches++;
+                }
+            }
+
+            rates.Sort();
+
+            if (mismatches > 0)
+                failed++;
+
+            if (!options.Quiet || mismatches > 0)
+            {
+                Console.WriteLine($"[{(mismatches == 0 ? "PASS" : "FAIL")}] {recorded.Name} " +
+                    $"({string.Join(", ", recorded.Order)}): {found} of {names.Count} found" +
+                    (mismatches > 0 ? $", {mismatches} mismatch(es)" : string.Empty) +
+                    (rates.Count > 0 ? $", median {rates[rates.Count / 2]:F0} names/s" : string.Empty));
+            }
+        }
+
+        if (!options.Quiet)
+        {
+            Console.WriteLine($"Resolutions: {names.Count} names per search order over {totalFiles} files " +
+                $"in {locations.Count} directories");
+            Console.WriteLine($"Probes: {CDirectoryProbeCache.ProbeCount}, answered from listings {CDirectoryProbeCache.ProbesSaved}, " +
+                $"directories enumerated {CDirectoryProbeCache.DirectoriesEnumerated}");
+        }
+
+        return failed;
+    }
+}
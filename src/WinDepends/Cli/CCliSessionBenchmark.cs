@@ -0,0 +1,169 @@
+﻿/*******************************************************************************
+*
+*  (C) COPYRIGHT AUTHORS, 2026
+*
+*  TITLE:       CCLISESSIONBENCHMARK.CS
+*
+*  VERSION:     1.00
+*
+*  DATE:        18 Oct 2026
+*  
+*  Session file format benchmark for command-line mode.
+*
+* THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF
+* ANY KIND, EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED
+* TO THE IMPLIED WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+*******************************************************************************/
+using System.Diagnostics;
+
+namespace WinDepends;
+
+/// <summary>
+/// Saves and loads a recorded session in every supported session file format.
+/// </summary>
+static class CCliSessionBenchmark
+{
+    /// <summary>
+    /// Compares save time, load time and file size of session file formats.
+    /// </summary>
+    /// <remarks>
+    /// The session is loaded once, then saved and loaded back in every format. Timings are
+    /// medians of measured passes after a warm-up pass.
+    /// </remarks>
+    /// <param name="options">Command-line options.</param>
+    /// <returns>Process exit code.</returns>
+    internal static int Run(CliOptions options)
+    {
+        CDepends session;
+
+        try
+        {
+            string fileName = options.SessionBenchmarkFile;
+
+            if (CSessionSerializer.IsSessionFile(fileName))
+            {
+                session = CSessionSerializer.Load(fileName, null);
+            }
+            else
+            {
+                try
+                {
+                    session = (CDepends)CUtils.LoadPackedObjectFromFile(fileName, typeof(CDepends), null);
+                }
+                catch
+                {
+                    session = (CDepends)CUtils.LoadObjectFromFilePlainText(fileName, typeof(CDepends));
+                }
+            }
+        }
+        catch (Exception ex)
+        {
+            Console.Error.WriteLine($"Error: Cannot load session {options.SessionBenchmarkFile}: {ex.Message}");
+            return 1;
+        }
+
+        if (session?.RootModule == null)
+        {
+            Console.Error.WriteLine($"Error: Cannot load session {options.SessionBenchmarkFile}");
+            return 1;
+        }
+
+        var formats = new (string Name, Func<string, bool> Save, Func<string, CDepends> Load)[]
+        {
+            ("JSON, Brotli", file => CUtils.SavePackedObjectToFile(file, session, typeof(CDepends), null),
+                file => (CDepends)CUtils.LoadPackedObjectFromFile(file, typeof(CDepends), null)),
+            ("Binary", file => CSessionSerializer.Save(file, session, false, null),
+                file => CSessionSerializer.Load(file, null)),
+            ("Binary, Brotli", file => CSessionSerializer.Save(file, session, true, null),
+                file => CSessionSerializer.Load(file, null))
+        };
+
+        int moduleCount = CountModules(session.RootModule);
+        string tempFile = Path.Combine(Path.GetTempPath(), $"WinDepends_{Environment.ProcessId}{CConsts.WinDependsSessionFileExt}");
+        bool failed = false;
+
+        if (!options.Quiet)
+        {
+            Console.WriteLine($"Session: {moduleCount} module(s), {options.BenchmarkIterations} iteration(s) after warm-up");
+            Console.WriteLine();
+            Console.WriteLine($"{"Format",-16} {"Save ms",10} {"Load ms",10} {"Lists ms",10} {"Size KB",12}");
+        }
+
+        try
+        {
+            foreach (var format in formats)
+            {
+                List<double> saveTimes = [], loadTimes = [], listTimes = [];
+                long fileSize = 0;
+
+                for (int iteration = 0; iteration <= options.BenchmarkIterations; iteration++)
+                {
+                    var stopwatch = Stopwatch.StartNew();
+                    format.Save(tempFile);
+                    double saveTime = stopwatch.Elapsed.TotalMilliseconds;
+
+                    fileSize = new FileInfo(tempFile).Length;
+
+                    stopwatch.Restart();
+                    var loaded = format.Load(tempFile);
+                    double loadTime = stopwatch.Elapsed.TotalMilliseconds;
+
+                    // Page in function lists deferred by the mapped load, this also releases the file.
+                    stopwatch.Restart();
+                    loaded?.DetachSessionFile();
+                    double listTime = stopwatch.Elapsed.TotalMilliseconds;
+
+                    if (CountModules(loaded?.RootModule) != moduleCount)
+                    {
+                        Console.Error.WriteLine($"Error: {format.Name} session does not match the source session");
+                        failed = true;
+                        break;
+                    }
+
+                    if (iteration > 0)
+                    {
+                        saveTimes.Add(saveTime);
+                        loadTimes.Add(loadTime);
+                        listTimes.Add(listTime);
+                    }
+                }
+
+                if (!options.Quiet)
+                {
+                    Console.WriteLine($"{format.Name,-16} {CCliBenchmark.GetMedian(saveTimes),10:F1} {CCliBenchmark.GetMedian(loadTimes),10:F1} {CCliBenchmark.GetMedian(listTimes),10:F1} {fileSize / 1024,12}");
+                }
+            }
+        }
+        catch (Exception ex)
+        {
+            Console.Error.WriteLine($"Error: {ex.Message}");
+            failed = true;
+        }
+        finally
+        {
+            try { File.Delete(tempFile); } catch { }
+        }
+
+        return failed ? 1 : 0;
+    }
+
+    private static int CountModules(CModule module)
+    {
+        if (module == null)
+            return 0;
+
+        int count = 1;
+
+        if (module.Dependents != null)
+        {
+            foreach (var dependent in module.Dependents)
+            {
+                count += CountModules(dependent);
+            }
+        }
+
+        return count;
+    }
+}
@@ -1,12 +1,12 @@
 ﻿/*******************************************************************************
 *
-*  (C) COPYRIGHT AUTHORS, 2024 - 2025
+*  (C) COPYRIGHT AUTHORS, 2024 - 2026
 *
 *  TITLE:       CEXPORTER.CS
 *
 *  VERSION:     1.00
 *
-*  DATE:        29 Nov 2025
+*  DATE:        18 Oct 2026
 *  
 *  Implementation of dependency export functionality. 
 *
@@ -16,9 +16,9 @@
 * PARTICULAR PURPOSE.
 *
 *******************************************************************************/
-using System.Runtime.Serialization;
-using System.Runtime.Serialization.Json;
 using System.Text;
+using System.Text.Encodings.Web;
+using System.Text.Json;
 
 namespace WinDepends;
 
@@ -49,6 +49,10 @@ public class ExportOptions
 /// <summary>
 /// Handles exporting dependency data to various formats.
 /// </summary>
+/// <remarks>
+/// Exporters write to the output while walking the module tree, nothing is built in memory
+/// except the set of visited modules, so output of large trees starts immediately.
+/// </remarks>
 public static class CExporter
 {
     /// <summary>
@@ -56,26 +60,60 @@ public static class CExporter
     /// </summary>
     public static bool Export(CDepends session, string outputPath, ExportFormat format, ExportOptions options)
     {
+        bool fileCreated = false;
+
         if (session?.RootModule == null)
             return false;
 
         try
         {
-            string content = format switch
+            using var stream = new FileStream(
+                outputPath,
+                FileMode.Create,
+                FileAccess.Write,
+                FileShare.None,
+                bufferSize: 4096,
+                FileOptions.SequentialScan
+            );
+
+            fileCreated = true;
+
+            if (format == ExportFormat.Json)
             {
-                ExportFormat.Json => ExportToJson(session, options),
-                ExportFormat.Csv => ExportToCsv(session, options),
-                ExportFormat.Html => ExportToHtml(session, options),
-                ExportFormat.Dot => ExportToDot(session, options),
-                ExportFormat.Text => ExportToText(session, options),
-                _ => throw new ArgumentException($"Unsupported format: {format}")
-            };
-
-            File.WriteAllText(outputPath, content, Encoding.UTF8);
+                ExportToJson(session, options, stream);
+                return true;
+            }
+
+            using var writer = new StreamWriter(stream, Encoding.UTF8, CConsts.ExportBufferSize);
+
+            switch (format)
+            {
+                case ExportFormat.Csv:
+                    ExportToCsv(session, options, writer);
+                    break;
+                case ExportFormat.Html:
+                    ExportToHtml(session, options, writer);
+                    break;
+                case ExportFormat.Dot:
+                    ExportToDot(session, options, writer);
+                    break;
+                case ExportFormat.Text:
+                    ExportToText(session, options, writer);
+                    break;
+                default:
+                    throw new ArgumentException($"Unsupported format: {format}");
+            }
+
             return true;
         }
         catch
         {
+            // Do not leave truncated output behind.
+            if (fileCreated)
+            {
+                try { File.Delete(outputPath); } catch { }
+            }
+
             return false;
         }
     }
@@ -83,40 +121,47 @@ public static class CExporter
     /// <summary>
     /// Export to JSON format.
     /// </summary>
-    public static string ExportToJson(CDepends session, ExportOptions options)
+    public static void ExportToJson(CDepends session, ExportOptions options, Stream stream)
     {
-        var exportData = BuildExportData(session, options);
-
-        using var ms = new MemoryStream();
-        var settings = new DataContractJsonSerializerSettings
+        var writerOptions = new JsonWriterOptions
         {
-            UseSimpleDictionaryFormat = true
+            Indented = true,
+            Encoder = JavaScriptEncoder.UnsafeRelaxedJsonEscaping
         };
 
-        var serializer = new DataContractJsonSerializer(typeof(ExportData), settings);
-        using var writer = JsonReaderWriterFactory.CreateJsonWriter(ms, Encoding.UTF8, true, true, "  ");
-        serializer.WriteObject(writer, exportData);
-        writer.Flush();
+        using var writer = new Utf8JsonWriter(stream, writerOptions);
+
+        writer.WriteStartObject();
+        writer.WriteString("GeneratedAt", DateTime.Now.ToString("o"));
+        writer.WriteString("ToolVersion", $"{CConsts.VersionMajor}.{CConsts.VersionMinor}.{CConsts.VersionRevision}.{CConsts.VersionBuild}");
+        writer.WriteString("RootModule", session.RootModule.FileName);
+        writer.WriteStartArray("Modules");
 
-        return Encoding.UTF8.GetString(ms.ToArray());
+        WalkModules(session.RootModule, options.MaxDepth, module =>
+        {
+            WriteJsonModule(writer, module, options);
+
+            // Writer buffers everything until flushed.
+            if (writer.BytesPending >= CConsts.ExportBufferSize)
+                writer.Flush();
+        });
+
+        writer.WriteEndArray();
+        writer.WriteEndObject();
+        writer.Flush();
     }
 
     /// <summary>
     /// Export to CSV format (flat module list).
     /// </summary>
-    public static string ExportToCsv(CDepends session, ExportOptions options)
+    public static void ExportToCsv(CDepends session, ExportOptions options, TextWriter writer)
     {
-        var sb = new StringBuilder();
-        var modules = new List<CModule>();
-
-        CollectAllModules(session.RootModule, modules, new HashSet<string>(StringComparer.OrdinalIgnoreCase), options.MaxDepth, 0);
-
-        sb.AppendLine("\"Module\",\"Path\",\"Status\",\"FileSize\",\"LinkChecksum\",\"RealChecksum\"," +
+        writer.WriteLine("\"Module\",\"Path\",\"Status\",\"FileSize\",\"LinkChecksum\",\"RealChecksum\"," +
                       "\"Machine\",\"Subsystem\",\"PreferredBase\",\"VirtualSize\",\"FileVersion\"," +
                       "\"ProductVersion\",\"LinkerVersion\",\"IsDelayLoad\",\"Is64Bit\",\"IsDotNet\"," +
                       "\"FileTimestamp\",\"LinkTimestamp\",\"ResolvedBy\",\"ExportCount\",\"ImportCount\"");
 
-        foreach (var module in modules)
+        WalkModules(session.RootModule, options.MaxDepth, module =>
         {
             string status = GetModuleStatus(module);
             string machine = GetMachineName(module.ModuleData?.Machine ?? 0);
@@ -126,7 +171,7 @@ public static class CExporter
             int exportCount = module.ModuleData?.Exports?.Count ?? 0;
             int importCount = module.ParentImports?.Count ?? 0;
 
-            sb.AppendLine($"\"{EscapeCsv(Path.GetFileName(module.FileName))}\"," +
+            writer.WriteLine($"\"{EscapeCsv(Path.GetFileName(module.FileName))}\"," +
                           $"\"{EscapeCsv(module.FileName)}\"," +
                           $"\"{status}\"," +
                           $"\"{module.ModuleData?.FileSize ?? 0}\"," +
@@ -147,78 +192,78 @@ public static class CExporter
                           $"\"{module.FileNameResolvedBy}\"," +
                           $"\"{exportCount}\"," +
                           $"\"{importCount}\"");
-        }
-
-        return sb.ToString();
+        });
     }
 
     /// <summary>
     /// Export to HTML format with collapsible tree.
     /// </summary>
-    public static string ExportToHtml(CDepends session, ExportOptions options)
+    /// <remarks>
+    /// Summary counts and the sorted module table need the whole module list, only module
+    /// references are collected for them.
+    /// </remarks>
+    public static void ExportToHtml(CDepends session, ExportOptions options, TextWriter writer)
     {
-        var sb = new StringBuilder();
-
         string rootFileName = Path.GetFileName(session.RootModule.FileName);
         string generatedDate = DateTime.Now.ToString("yyyy-MM-dd HH:mm:ss");
 
-        sb.AppendLine("<!DOCTYPE html>");
-        sb.AppendLine("<html lang=\"en\">");
-        sb.AppendLine("<head>");
-        sb.AppendLine("    <meta charset=\"UTF-8\">");
-        sb.AppendLine("    <meta name=\"viewport\" content=\"width=device-width, initial-scale=1.0\">");
-        sb.AppendLine($"    <title>Dependency Report - {HtmlEncode(rootFileName)}</title>");
-        sb.AppendLine("    <style>");
-        sb.AppendLine(GetHtmlStyles());
-        sb.AppendLine("    </style>");
-        sb.AppendLine("</head>");
-        sb.AppendLine("<body>");
-
-        sb.AppendLine("    <div class=\"header\">");
-        sb.AppendLine($"        <h1>Dependency Analysis Report</h1>");
-        sb.AppendLine($"        <div class=\"subtitle\">{HtmlEncode(session.RootModule.FileName)}</div>");
-        sb.AppendLine($"        <div class=\"meta\">Generated: {generatedDate} | WinDepends v{CConsts.VersionMajor}.{CConsts.VersionMinor}.{CConsts.VersionRevision}</div>");
-        sb.AppendLine("    </div>");
+        writer.WriteLine("<!DOCTYPE html>");
+        writer.WriteLine("<html lang=\"en\">");
+        writer.WriteLine("<head>");
+        writer.WriteLine("    <meta charset=\"UTF-8\">");
+        writer.WriteLine("    <meta name=\"viewport\" content=\"width=device-width, initial-scale=1.0\">");
+        writer.WriteLine($"    <title>Dependency Report - {HtmlEncode(rootFileName)}</title>");
+        writer.WriteLine("    <style>");
+        writer.WriteLine(GetHtmlStyles());
+        writer.WriteLine("    </style>");
+        writer.WriteLine("</head>");
+        writer.WriteLine("<body>");
+
+        writer.WriteLine("    <div class=\"header\">");
+        writer.WriteLine($"        <h1>Dependency Analysis Report</h1>");
+        writer.WriteLine($"        <div class=\"subtitle\">{HtmlEncode(session.RootModule.FileName)}</div>");
+        writer.WriteLine($"        <div class=\"meta\">Generated: {generatedDate} | WinDepends v{CConsts.VersionMajor}.{CConsts.VersionMinor}.{CConsts.VersionRevision}</div>");
+        writer.WriteLine("    </div>");
 
         var allModules = new List<CModule>();
-        CollectAllModules(session.RootModule, allModules, new HashSet<string>(StringComparer.OrdinalIgnoreCase), options.MaxDepth, 0);
+        WalkModules(session.RootModule, options.MaxDepth, allModules.Add);
 
         int totalModules = allModules.Count;
         int missingModules = allModules.Count(m => m.FileNotFound);
         int warningModules = allModules.Count(m => m.ExportContainErrors || m.OtherErrorsPresent);
 
-        sb.AppendLine("    <div class=\"summary\">");
-        sb.AppendLine("        <div class=\"summary-item\"><span class=\"count\">" + totalModules + "</span><span class=\"label\"> Total Modules</span></div>");
-        sb.AppendLine("        <div class=\"summary-item missing\"><span class=\"count\">" + missingModules + "</span><span class=\"label\"> Missing</span></div>");
-        sb.AppendLine("        <div class=\"summary-item warning\"><span class=\"count\">" + warningModules + "</span><span class=\"label\"> Warnings</span></div>");
-        sb.AppendLine("    </div>");
-
-        sb.AppendLine("    <div class=\"controls\">");
-        sb.AppendLine("        <button onclick=\"expandAll()\">Expand All</button>");
-        sb.AppendLine("        <button onclick=\"collapseAll()\">Collapse All</button>");
-        sb.AppendLine("    </div>");
-
-        sb.AppendLine("    <div class=\"tree-container\">");
-        sb.AppendLine("        <h2>Dependency Tree</h2>");
-        sb.AppendLine("        <ul class=\"tree\">");
-        BuildHtmlTree(sb, session.RootModule, options, new HashSet<string>(StringComparer.OrdinalIgnoreCase), 0);
-        sb.AppendLine("        </ul>");
-        sb.AppendLine("    </div>");
-
-        sb.AppendLine("    <div class=\"table-container\">");
-        sb.AppendLine("        <h2>Module List</h2>");
-        sb.AppendLine("        <table>");
-        sb.AppendLine("            <thead>");
-        sb.AppendLine("                <tr>");
-        sb.AppendLine("                    <th>Module</th>");
-        sb.AppendLine("                    <th>Status</th>");
-        sb.AppendLine("                    <th>Machine</th>");
-        sb.AppendLine("                    <th>File Size</th>");
-        sb.AppendLine("                    <th>Version</th>");
-        sb.AppendLine("                    <th>Path</th>");
-        sb.AppendLine("                </tr>");
-        sb.AppendLine("            </thead>");
-        sb.AppendLine("            <tbody>");
+        writer.WriteLine("    <div class=\"summary\">");
+        writer.WriteLine("        <div class=\"summary-item\"><span class=\"count\">" + totalModules + "</span><span class=\"label\"> Total Modules</span></div>");
+        writer.WriteLine("        <div class=\"summary-item missing\"><span class=\"count\">" + missingModules + "</span><span class=\"label\"> Missing</span></div>");
+        writer.WriteLine("        <div class=\"summary-item warning\"><span class=\"count\">" + warningModules + "</span><span class=\"label\"> Warnings</span></div>");
+        writer.WriteLine("    </div>");
+
+        writer.WriteLine("    <div class=\"controls\">");
+        writer.WriteLine("        <button onclick=\"expandAll()\">Expand All</button>");
+        writer.WriteLine("        <button onclick=\"collapseAll()\">Collapse All</button>");
+        writer.WriteLine("    </div>");
+
+        writer.WriteLine("    <div class=\"tree-container\">");
+        writer.WriteLine("        <h2>Dependency Tree</h2>");
+        writer.WriteLine("        <ul class=\"tree\">");
+        BuildHtmlTree(writer, session.RootModule, options, new HashSet<string>(StringComparer.OrdinalIgnoreCase), 0);
+        writer.WriteLine("        </ul>");
+        writer.WriteLine("    </div>");
+
+        writer.WriteLine("    <div class=\"table-container\">");
+        writer.WriteLine("        <h2>Module List</h2>");
+        writer.WriteLine("        <table>");
+        writer.WriteLine("            <thead>");
+        writer.WriteLine("                <tr>");
+        writer.WriteLine("                    <th>Module</th>");
+        writer.WriteLine("                    <th>Status</th>");
+        writer.WriteLine("                    <th>Machine</th>");
+        writer.WriteLine("                    <th>File Size</th>");
+        writer.WriteLine("                    <th>Version</th>");
+        writer.WriteLine("                    <th>Path</th>");
+        writer.WriteLine("                </tr>");
+        writer.WriteLine("            </thead>");
+        writer.WriteLine("            <tbody>");
 
         foreach (var module in allModules.OrderBy(m => Path.GetFileName(m.FileName), StringComparer.OrdinalIgnoreCase))
         {
@@ -228,162 +273,153 @@ public static class CExporter
             string fileSize = module.ModuleData != null ? FormatFileSize(module.ModuleData.FileSize) : "N/A";
             string version = module.ModuleData?.FileVersion ?? "N/A";
 
-            sb.AppendLine($"                <tr class=\"{statusClass}\">");
-            sb.AppendLine($"                    <td>{HtmlEncode(Path.GetFileName(module.FileName))}</td>");
-            sb.AppendLine($"                    <td><span class=\"status-badge {statusClass}\">{status}</span></td>");
-            sb.AppendLine($"                    <td>{machine}</td>");
-            sb.AppendLine($"                    <td>{fileSize}</td>");
-            sb.AppendLine($"                    <td>{HtmlEncode(version)}</td>");
-            sb.AppendLine($"                    <td class=\"path\">{HtmlEncode(module.FileName)}</td>");
-            sb.AppendLine("                </tr>");
+            writer.WriteLine($"                <tr class=\"{statusClass}\">");
+            writer.WriteLine($"                    <td>{HtmlEncode(Path.GetFileName(module.FileName))}</td>");
+            writer.WriteLine($"                    <td><span class=\"status-badge {statusClass}\">{status}</span></td>");
+            writer.WriteLine($"                    <td>{machine}</td>");
+            writer.WriteLine($"                    <td>{fileSize}</td>");
+            writer.WriteLine($"                    <td>{HtmlEncode(version)}</td>");
+            writer.WriteLine($"                    <td class=\"path\">{HtmlEncode(module.FileName)}</td>");
+            writer.WriteLine("                </tr>");
         }
 
-        sb.AppendLine("            </tbody>");
-        sb.AppendLine("        </table>");
-        sb.AppendLine("    </div>");
+        writer.WriteLine("            </tbody>");
+        writer.WriteLine("        </table>");
+        writer.WriteLine("    </div>");
 
-        sb.AppendLine("    <script>");
-        sb.AppendLine(GetHtmlScript());
-        sb.AppendLine("    </script>");
+        writer.WriteLine("    <script>");
+        writer.WriteLine(GetHtmlScript());
+        writer.WriteLine("    </script>");
 
-        sb.AppendLine("</body>");
-        sb.AppendLine("</html>");
-
-        return sb.ToString();
+        writer.WriteLine("</body>");
+        writer.WriteLine("</html>");
     }
 
     /// <summary>
     /// Export to DOT format for Graphviz visualization.
     /// </summary>
-    public static string ExportToDot(CDepends session, ExportOptions options)
+    /// <remarks>
+    /// Nodes and edges are written as they are visited, node declarations are not grouped.
+    /// </remarks>
+    public static void ExportToDot(CDepends session, ExportOptions options, TextWriter writer)
     {
-        var sb = new StringBuilder();
-        var edges = new HashSet<string>();
-        var nodes = new Dictionary<string, CModule>(StringComparer.OrdinalIgnoreCase);
-
-        CollectGraphData(session.RootModule, nodes, edges, new HashSet<string>(StringComparer.OrdinalIgnoreCase), options.MaxDepth, 0);
-
-        sb.AppendLine("digraph Dependencies {");
-        sb.AppendLine("    rankdir=LR;");
-        sb.AppendLine("    node [shape=box, style=filled, fontname=\"Segoe UI\", fontsize=10];");
-        sb.AppendLine("    edge [fontname=\"Segoe UI\", fontsize=8];");
-        sb.AppendLine();
+        writer.WriteLine("digraph Dependencies {");
+        writer.WriteLine("    rankdir=LR;");
+        writer.WriteLine("    node [shape=box, style=filled, fontname=\"Segoe UI\", fontsize=10];");
+        writer.WriteLine("    edge [fontname=\"Segoe UI\", fontsize=8];");
+        writer.WriteLine();
 
-        foreach (var kvp in nodes)
-        {
-            string nodeId = GetDotNodeId(kvp.Key);
-            string label = Path.GetFileName(kvp.Key);
-            string color = GetDotNodeColor(kvp.Value);
-            string tooltip = kvp.Key.Replace("\\", "\\\\").Replace("\"", "\\\"");
-
-            sb.AppendLine($"    {nodeId} [label=\"{EscapeDotLabel(label)}\", fillcolor=\"{color}\", tooltip=\"{tooltip}\"];");
-        }
-
-        sb.AppendLine();
-
-        foreach (var edge in edges)
-        {
-            sb.AppendLine($"    {edge};");
-        }
+        WriteGraphData(writer, session.RootModule, new HashSet<string>(), new HashSet<string>(StringComparer.OrdinalIgnoreCase), options.MaxDepth, 0);
 
-        sb.AppendLine("}");
-
-        return sb.ToString();
+        writer.WriteLine("}");
     }
 
     /// <summary>
     /// Export to plain text format (tree view).
     /// </summary>
-    public static string ExportToText(CDepends session, ExportOptions options)
+    public static void ExportToText(CDepends session, ExportOptions options, TextWriter writer)
     {
-        var sb = new StringBuilder();
-
-        sb.AppendLine($"Dependency Analysis: {session.RootModule.FileName}");
-        sb.AppendLine($"Generated: {DateTime.Now:yyyy-MM-dd HH:mm:ss}");
-        sb.AppendLine(new string('=', 80));
-        sb.AppendLine();
+        writer.WriteLine($"Dependency Analysis: {session.RootModule.FileName}");
+        writer.WriteLine($"Generated: {DateTime.Now:yyyy-MM-dd HH:mm:ss}");
+        writer.WriteLine(new string('=', 80));
+        writer.WriteLine();
 
-        BuildTextTree(sb, session.RootModule, "", true, new HashSet<string>(StringComparer.OrdinalIgnoreCase), options.MaxDepth, 0);
-
-        return sb.ToString();
+        BuildTextTree(writer, session.RootModule, "", true, new HashSet<string>(StringComparer.OrdinalIgnoreCase), options.MaxDepth, 0);
     }
 
     #region Private Helper Methods
 
-    private static ExportData BuildExportData(CDepends session, ExportOptions options)
+    private static void WriteJsonModule(Utf8JsonWriter writer, CModule module, ExportOptions options)
     {
-        var data = new ExportData
-        {
-            GeneratedAt = DateTime.Now.ToString("o"),
-            ToolVersion = $"{CConsts.VersionMajor}.{CConsts.VersionMinor}.{CConsts.VersionRevision}.{CConsts.VersionBuild}",
-            RootModule = session.RootModule.FileName
-        };
-
-        var modules = new List<CModule>();
-        CollectAllModules(session.RootModule, modules, new HashSet<string>(StringComparer.OrdinalIgnoreCase), options.MaxDepth, 0);
-
-        foreach (var module in modules)
+        var moduleData = module.ModuleData;
+
+        writer.WriteStartObject();
+        writer.WriteString("FileName", module.FileName);
+        writer.WriteString("RawFileName", module.RawFileName);
+        writer.WriteString("Status", GetModuleStatus(module));
+        writer.WriteBoolean("IsDelayLoad", module.IsDelayLoad);
+        writer.WriteBoolean("IsForward", module.IsForward);
+        writer.WriteBoolean("Is64Bit", module.Is64bitArchitecture());
+        writer.WriteBoolean("IsDotNet", module.IsDotNetModule);
+        writer.WriteBoolean("FileNotFound", module.FileNotFound);
+        writer.WriteBoolean("IsInvalid", module.IsInvalid);
+        writer.WriteString("ResolvedBy", module.FileNameResolvedBy.ToString());
+        writer.WriteNumber("FileSize", moduleData?.FileSize ?? 0);
+        writer.WriteNumber("LinkChecksum", moduleData?.LinkChecksum ?? 0);
+        writer.WriteNumber("RealChecksum", moduleData?.RealChecksum ?? 0);
+        writer.WriteNumber("PreferredBase", moduleData?.PreferredBase ?? 0);
+        writer.WriteNumber("VirtualSize", moduleData?.VirtualSize ?? 0);
+        writer.WriteNumber("Machine", moduleData?.Machine ?? 0);
+        writer.WriteNumber("Subsystem", moduleData?.Subsystem ?? 0);
+        writer.WriteString("FileVersion", moduleData?.FileVersion);
+        writer.WriteString("ProductVersion", moduleData?.ProductVersion);
+        writer.WriteString("LinkerVersion", moduleData?.LinkerVersion);
+        writer.WriteString("FileTimestamp", moduleData?.FileTimeStamp ?? default);
+        writer.WriteNumber("LinkTimestamp", moduleData?.LinkTimeStamp ?? 0);
+
+        writer.WritePropertyName("Exports");
+        if (options.IncludeExports && moduleData?.Exports != null)
         {
-            var exportModule = new ExportModuleData
+            writer.WriteStartArray();
+            foreach (var function in moduleData.Exports)
             {
-                FileName = module.FileName,
-                RawFileName = module.RawFileName,
-                Status = GetModuleStatus(module),
-                IsDelayLoad = module.IsDelayLoad,
-                IsForward = module.IsForward,
-                Is64Bit = module.Is64bitArchitecture(),
-                IsDotNet = module.IsDotNetModule,
-                FileNotFound = module.FileNotFound,
-                IsInvalid = module.IsInvalid,
-                ResolvedBy = module.FileNameResolvedBy.ToString()
-            };
-
-            if (module.ModuleData != null)
-            {
-                exportModule.FileSize = module.ModuleData.FileSize;
-                exportModule.LinkChecksum = module.ModuleData.LinkChecksum;
-                exportModule.RealChecksum = module.ModuleData.RealChecksum;
-                exportModule.PreferredBase = module.ModuleData.PreferredBase;
-                exportModule.VirtualSize = module.ModuleData.VirtualSize;
-                exportModule.Machine = module.ModuleData.Machine;
-                exportModule.Subsystem = module.ModuleData.Subsystem;
-                exportModule.FileVersion = module.ModuleData.FileVersion;
-                exportModule.ProductVersion = module.ModuleData.ProductVersion;
-                exportModule.LinkerVersion = module.ModuleData.LinkerVersion;
-                exportModule.FileTimestamp = module.ModuleData.FileTimeStamp;
-                exportModule.LinkTimestamp = module.ModuleData.LinkTimeStamp;
+                WriteJsonFunction(writer, function, function.Address, 0, function.ForwardName);
             }
+            writer.WriteEndArray();
+        }
+        else
+        {
+            writer.WriteNullValue();
+        }
 
-            if (options.IncludeExports && module.ModuleData?.Exports != null)
+        writer.WritePropertyName("Imports");
+        if (options.IncludeImports && module.ParentImports != null)
+        {
+            writer.WriteStartArray();
+            foreach (var function in module.ParentImports)
             {
-                exportModule.Exports = module.ModuleData.Exports.Select(f => new ExportFunctionData
-                {
-                    Name = f.RawName,
-                    Ordinal = f.Ordinal,
-                    Address = f.Address,
-                    ForwardName = f.ForwardName
-                }).ToList();
+                WriteJsonFunction(writer, function, 0, function.Hint, null);
             }
+            writer.WriteEndArray();
+        }
+        else
+        {
+            writer.WriteNullValue();
+        }
 
-            if (options.IncludeImports && module.ParentImports != null)
+        writer.WriteStartArray("Dependencies");
+        if (module.Dependents != null)
+        {
+            foreach (var dependent in module.Dependents)
             {
-                exportModule.Imports = module.ParentImports.Select(f => new ExportFunctionData
-                {
-                    Name = f.RawName,
-                    Ordinal = f.Ordinal,
-                    Hint = f.Hint
-                }).ToList();
+                writer.WriteStringValue(Path.GetFileName(dependent.FileName));
             }
+        }
+        writer.WriteEndArray();
 
-            exportModule.Dependencies = module.Dependents?.Select(d => Path.GetFileName(d.FileName)).ToList() ?? [];
+        writer.WriteEndObject();
+    }
 
-            data.Modules.Add(exportModule);
-        }
+    private static void WriteJsonFunction(Utf8JsonWriter writer, CFunction function, ulong address, uint hint, string forwardName)
+    {
+        writer.WriteStartObject();
+        writer.WriteString("Name", function.RawName);
+        writer.WriteNumber("Ordinal", function.Ordinal);
+        writer.WriteNumber("Hint", hint);
+        writer.WriteNumber("Address", address);
+        writer.WriteString("ForwardName", forwardName);
+        writer.WriteEndObject();
+    }
 
-        return data;
+    /// <summary>
+    /// Calls action for every unique module of the tree, in depth-first order.
+    /// </summary>
+    private static void WalkModules(CModule root, int maxDepth, Action<CModule> action)
+    {
+        WalkModules(root, action, new HashSet<string>(StringComparer.OrdinalIgnoreCase), maxDepth, 0);
     }
 
-    private static void CollectAllModules(CModule module, List<CModule> modules, HashSet<string> visited, int maxDepth, int currentDepth)
+    private static void WalkModules(CModule module, Action<CModule> action, HashSet<string> visited, int maxDepth, int currentDepth)
     {
         if (module == null || currentDepth > maxDepth)
             return;
@@ -392,18 +428,18 @@ public static class CExporter
         if (!visited.Add(key))
             return;
 
-        modules.Add(module);
+        action(module);
 
         if (module.Dependents != null)
         {
             foreach (var dep in module.Dependents)
             {
-                CollectAllModules(dep, modules, visited, maxDepth, currentDepth + 1);
+                WalkModules(dep, action, visited, maxDepth, currentDepth + 1);
             }
         }
     }
 
-    private static void CollectGraphData(CModule module, Dictionary<string, CModule> nodes, HashSet<string> edges, HashSet<string> visited, int maxDepth, int currentDepth)
+    private static void WriteGraphData(TextWriter writer, CModule module, HashSet<string> edges, HashSet<string> visited, int maxDepth, int currentDepth)
     {
         if (module == null || currentDepth > maxDepth)
             return;
@@ -414,7 +450,12 @@ public static class CExporter
 
         if (!string.IsNullOrEmpty(module.FileName))
         {
-            nodes.TryAdd(module.FileName, module);
+            string nodeId = GetDotNodeId(module.FileName);
+            string label = Path.GetFileName(module.FileName);
+            string color = GetDotNodeColor(module);
+            string tooltip = module.FileName.Replace("\\", "\\\\").Replace("\"", "\\\"");
+
+            writer.WriteLine($"    {nodeId} [label=\"{EscapeDotLabel(label)}\", fillcolor=\"{color}\", tooltip=\"{tooltip}\"];");
         }
 
         if (module.Dependents != null)
@@ -426,15 +467,20 @@ public static class CExporter
                     string fromId = GetDotNodeId(module.FileName);
                     string toId = GetDotNodeId(dep.FileName);
                     string edgeStyle = dep.IsDelayLoad ? " [style=dashed]" : "";
-                    edges.Add($"{fromId} -> {toId}{edgeStyle}");
+                    string edge = $"{fromId} -> {toId}{edgeStyle}";
+
+                    if (edges.Add(edge))
+                    {
+                        writer.WriteLine($"    {edge};");
+                    }
                 }
 
-                CollectGraphData(dep, nodes, edges, visited, maxDepth, currentDepth + 1);
+                WriteGraphData(writer, dep, edges, visited, maxDepth, currentDepth + 1);
             }
         }
     }
 
-    private static void BuildHtmlTree(StringBuilder sb, CModule module, ExportOptions options, HashSet<string> visited, int depth)
+    private static void BuildHtmlTree(TextWriter writer, CModule module, ExportOptions options, HashSet<string> visited, int depth)
     {
         if (module == null || depth > options.MaxDepth)
             return;
@@ -452,31 +498,31 @@ public static class CExporter
 
         if (hasChildren)
         {
-            sb.AppendLine($"            <li class=\"collapsible{duplicateClass}\">");
-            sb.AppendLine($"                <span class=\"toggle\">▶</span>");
-            sb.AppendLine($"                <span class=\"module-name {statusClass}\" title=\"{HtmlEncode(module.FileName)}\">{HtmlEncode(fileName)}</span>");
-            sb.AppendLine($"                {delayLoadBadge}{dotNetBadge}");
-            sb.AppendLine("                <ul class=\"nested\">");
+            writer.WriteLine($"            <li class=\"collapsible{duplicateClass}\">");
+            writer.WriteLine($"                <span class=\"toggle\">▶</span>");
+            writer.WriteLine($"                <span class=\"module-name {statusClass}\" title=\"{HtmlEncode(module.FileName)}\">{HtmlEncode(fileName)}</span>");
+            writer.WriteLine($"                {delayLoadBadge}{dotNetBadge}");
+            writer.WriteLine("                <ul class=\"nested\">");
 
             foreach (var dep in module.Dependents)
             {
-                BuildHtmlTree(sb, dep, options, visited, depth + 1);
+                BuildHtmlTree(writer, dep, options, visited, depth + 1);
             }
 
-            sb.AppendLine("                </ul>");
-            sb.AppendLine("            </li>");
+            writer.WriteLine("                </ul>");
+            writer.WriteLine("            </li>");
         }
         else
         {
-            sb.AppendLine($"            <li class=\"{duplicateClass}\">");
-            sb.AppendLine($"                <span class=\"module-name {statusClass}\" title=\"{HtmlEncode(module.FileName)}\">{HtmlEncode(fileName)}</span>");
-            sb.AppendLine($"                {delayLoadBadge}{dotNetBadge}");
-            if (isDuplicate) sb.AppendLine("                <span class=\"badge dup\">↺</span>");
-            sb.AppendLine("            </li>");
+            writer.WriteLine($"            <li class=\"{duplicateClass}\">");
+            writer.WriteLine($"                <span class=\"module-name {statusClass}\" title=\"{HtmlEncode(module.FileName)}\">{HtmlEncode(fileName)}</span>");
+            writer.WriteLine($"                {delayLoadBadge}{dotNetBadge}");
+            if (isDuplicate) writer.WriteLine("                <span class=\"badge dup\">↺</span>");
+            writer.WriteLine("            </li>");
         }
     }
 
-    private static void BuildTextTree(StringBuilder sb, CModule module, string indent, bool isLast, HashSet<string> visited, int maxDepth, int depth)
+    private static void BuildTextTree(TextWriter writer, CModule module, string indent, bool isLast, HashSet<string> visited, int maxDepth, int depth)
     {
         if (module == null || depth > maxDepth)
             return;
@@ -495,7 +541,7 @@ public static class CExporter
         if (module.IsDelayLoad) status += " (delay-load)";
         if (isDuplicate) status += " (duplicate)";
 
-        sb.AppendLine($"{indent}{connector}{fileName}{status}");
+        writer.WriteLine($"{indent}{connector}{fileName}{status}");
 
         if (!isDuplicate && module.Dependents != null && module.Dependents.Count > 0)
         {
@@ -503,7 +549,7 @@ public static class CExporter
             for (int i = 0; i < module.Dependents.Count; i++)
             {
                 bool childIsLast = i == module.Dependents.Count - 1;
-                BuildTextTree(sb, module.Dependents[i], childIndent, childIsLast, visited, maxDepth, depth + 1);
+                BuildTextTree(writer, module.Dependents[i], childIndent, childIsLast, visited, maxDepth, depth + 1);
             }
         }
     }
@@ -671,121 +717,3 @@ public static class CExporter
 
     #endregion
 }
-
-#region Export Data Models
-
-[DataContract]
-public class ExportData
-{
-    [System.Runtime.Serialization.DataMember(Order = 0)]
-    public string GeneratedAt { get; set; }
-
-    [System.Runtime.Serialization.DataMember(Order = 1)]
-    public string ToolVersion { get; set; }
-
-    [System.Runtime.Serialization.DataMember(Order = 2)]
-    public string RootModule { get; set; }
-
-    [System.Runtime.Serialization.DataMember(Order = 3)]
-    public List<ExportModuleData> Modules { get; set; } = [];
-}
-
-[DataContract]
-public class ExportModuleData
-{
-    [DataMember]
-    public string FileName { get; set; }
-
-    [DataMember]
-    public string RawFileName { get; set; }
-
-    [DataMember]
-    public string Status { get; set; }
-
-    [DataMember]
-    public bool IsDelayLoad { get; set; }
-
-    [DataMember]
-    public bool IsForward { get; set; }
-
-    [DataMember]
-    public bool Is64Bit { get; set; }
-
-    [DataMember]
-    public bool IsDotNet { get; set; }
-
-    [DataMember]
-    public bool FileNotFound { get; set; }
-
-    [DataMember]
-    public bool IsInvalid { get; set; }
-
-    [DataMember]
-    public string ResolvedBy { get; set; }
-
-    [DataMember]
-    public ulong FileSize { get; set; }
-
-    [DataMember]
-    public uint LinkChecksum { get; set; }
-
-    [DataMember]
-    public uint RealChecksum { get; set; }
-
-    [DataMember]
-    public ulong PreferredBase { get; set; }
-
-    [DataMember]
-    public uint VirtualSize { get; set; }
-
-    [DataMember]
-    public ushort Machine { get; set; }
-
-    [DataMember]
-    public ushort Subsystem { get; set; }
-
-    [DataMember]
-    public string FileVersion { get; set; }
-
-    [DataMember]
-    public string ProductVersion { get; set; }
-
-    [DataMember]
-    public string LinkerVersion { get; set; }
-
-    [DataMember]
-    public DateTime FileTimestamp { get; set; }
-
-    [DataMember]
-    public uint LinkTimestamp { get; set; }
-
-    [DataMember]
-    public List<ExportFunctionData> Exports { get; set; }
-
-    [DataMember]
-    public List<ExportFunctionData> Imports { get; set; }
-
-    [DataMember]
-    public List<string> Dependencies { get; set; }
-}
-
-[DataContract]
-public class ExportFunctionData
-{
-    [DataMember]
-    public string Name { get; set; }
-
-    [DataMember]
-    public uint Ordinal { get; set; }
-
-    [DataMember]
-    public uint Hint { get; set; }
-
-    [DataMember]
-    public ulong Address { get; set; }
-
-    [DataMember]
-    public string ForwardName { get; set; }
-}
-
-#endregion
@@ -6,7 +6,7 @@
 *
 *  VERSION:     1.00
 *
-*  DATE:        16 Jul 2026
+*  DATE:        18 Oct 2026
 *
 * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF
 * ANY KIND, EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED
@@ -62,6 +62,8 @@ public class CConfiguration
     [DataMember]
     public bool UseSymbols { get; set; }
     [DataMember]
+    public bool SymbolsPrefetch { get; set; }
+    [DataMember]
     public bool ProcessRelocsForImage { get; set; }
     [DataMember]
     public bool UseCustomImageBase { get; set; }
@@ -173,6 +175,7 @@ public class CConfiguration
         ProcessRelocsForImage = other.ProcessRelocsForImage;
         UseStats = other.UseStats;
         UseSymbols = other.UseSymbols;
+        SymbolsPrefetch = other.SymbolsPrefetch;
         UseCustomImageBase = other.UseCustomImageBase;
         AnalysisSettingsUseAsDefault = other.AnalysisSettingsUseAsDefault;
         PropagateSettingsOnDependencies = other.PropagateSettingsOnDependencies;
@@ -228,6 +231,7 @@ public class CConfiguration
             UseCustomImageBase = false;
             EnableExperimentalFeatures = false;
             ExpandForwarders = false;
+            SymbolsPrefetch = false;
             ToolBarTheme = ToolBarThemeType.Classic;
             GuiFontSize = CConsts.DefaultGuiFontSize;
             WindowState = (int)FormWindowState.Normal;
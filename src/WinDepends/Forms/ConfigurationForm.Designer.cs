@@ -162,6 +162,7 @@
             folderBrowserDialog = new FolderBrowserDialog();
             colorDialog = new ColorDialog();
             buttonBrowseCache = new Button();
+            chBoxSymbolsPrefetch = new CheckBox();
             ((System.ComponentModel.ISupportInitialize)splitContainer2).BeginInit();
             splitContainer2.Panel1.SuspendLayout();
             splitContainer2.Panel2.SuspendLayout();
@@ -1420,6 +1421,7 @@
             // 
             // groupBoxSymbols
             // 
+            groupBoxSymbols.Controls.Add(chBoxSymbolsPrefetch);
             groupBoxSymbols.Controls.Add(buttonBrowseCache);
             groupBoxSymbols.Controls.Add(buttonSymbolsDefault);
             groupBoxSymbols.Controls.Add(buttonSymbolPickColor);
@@ -1573,6 +1575,18 @@
             buttonBrowseCache.UseVisualStyleBackColor = true;
             buttonBrowseCache.Click += buttonBrowseCache_Click;
             // 
+            // chBoxSymbolsPrefetch
+            // 
+            chBoxSymbolsPrefetch.AutoSize = true;
+            chBoxSymbolsPrefetch.Location = new Point(19, 228);
+            chBoxSymbolsPrefetch.Name = "chBoxSymbolsPrefetch";
+            chBoxSymbolsPrefetch.Size = new Size(296, 19);
+            chBoxSymbolsPrefetch.TabIndex = 11;
+            chBoxSymbolsPrefetch.Tag = "608";
+            chBoxSymbolsPrefetch.Text = "Prefetch symbols for all modules in the tree";
+            chBoxSymbolsPrefetch.UseVisualStyleBackColor = true;
+            chBoxSymbolsPrefetch.Click += ChBox_Click;
+            // 
             // ConfigurationForm
             // 
             AutoScaleDimensions = new SizeF(7F, 15F);
@@ -1780,5 +1794,6 @@
         private CheckBox chBoxAnalysisEnableExperimentalFeatures;
         private CheckBox chBoxExpandForwarders;
         private Button buttonBrowseCache;
+        private CheckBox chBoxSymbolsPrefetch;
     }
 }
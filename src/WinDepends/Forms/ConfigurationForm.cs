@@ -6,7 +6,7 @@
 *
 *  VERSION:     1.00
 *
-*  DATE:        28 May 2026
+*  DATE:        18 Oct 2026
 *
 * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF
 * ANY KIND, EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED
@@ -353,6 +353,7 @@ public partial class ConfigurationForm : Form
         chBoxAnalysisDefaultEnabled.Checked = _config.AnalysisSettingsUseAsDefault;
         chBoxPropagateSettings.Checked = _config.PropagateSettingsOnDependencies;
         chBoxUseSymbols.Checked = _config.UseSymbols;
+        chBoxSymbolsPrefetch.Checked = _config.SymbolsPrefetch;
 
         groupBoxSymbols.Enabled = _config.UseSymbols;
 
@@ -562,6 +563,10 @@ public partial class ConfigurationForm : Form
                 groupBoxSymbols.Enabled = isChecked;
                 break;
 
+            case CConsts.TagSymbolsPrefetch:
+                _config.SymbolsPrefetch = isChecked;
+                break;
+
             case CConsts.TagEnableExperimentalFeatures:
                 _config.EnableExperimentalFeatures = isChecked;
                 break;
@@ -6,7 +6,7 @@
 *
 *  VERSION:     1.00
 *
-*  DATE:        14 Jul 2026
+*  DATE:        18 Oct 2026
 *  
 *  File and session open/save routines for main form.
 *
@@ -44,6 +44,9 @@ public partial class MainForm
     /// </summary>
     private void CloseInputFile()
     {
+        // Crawl thread must not keep filling lists of a released session.
+        CancelModulePopulation();
+
         if (_depends != null)
         {
             var programTitle = CUtils.IsAdministrator
@@ -52,6 +55,7 @@ public partial class MainForm
 
             this.Text = $"{CConsts.ProgramName}{programTitle}";
 
+            _depends.ReleaseSessionFile();
             _depends = null;
             _rootNode = null;
         }
@@ -146,13 +150,12 @@ public partial class MainForm
                 {
                     CPathResolver.ActCtxHelper = sxsHelper;
 
-                    TVModules.BeginUpdate();
-                    try
-                    {
-                        PopulateObjectToLists(_depends.RootModule, false, fileOpenSettings);
-                        _rootNode?.Expand();
-                    }
-                    finally { TVModules.EndUpdate(); }
+                    // Tree view updates are batched by population routine.
+                    // Leave without touching controls if population was interrupted by shutdown or cancellation.
+                    if (!PopulateObjectToLists(_depends.RootModule, false, fileOpenSettings))
+                        return FileOpenResult.Failure;
+
+                    _rootNode?.Expand();
 
                     LVModules.BeginUpdate();
                     try
@@ -200,6 +203,16 @@ public partial class MainForm
     /// <param name="fileName"></param>
     private bool OpenInputFile(string? fileName)
     {
+        //
+        // Drag and drop still reaches the form while the tree is populated with menus disabled,
+        // do not re-enter file open from the population message loop.
+        //
+        if (_populateTask != null)
+        {
+            AppLogger.LogExt($"Analysis is in progress, \"{fileName}\" was not opened.", LogMessageType.Information);
+            return false;
+        }
+
         CFileOpenState state = new(fileName);
         return _fileOpenOrchestrationService.Execute(
              state,
@@ -229,14 +242,11 @@ public partial class MainForm
         if (_depends.RootModule != null)
         {
             // Insert tree modules from session file.
-            TVModules.BeginUpdate();
-            try
-            {
-                PopulateObjectToLists(_depends.RootModule, true, null);
-                // Expand root module.
-                _rootNode?.Expand();
-            }
-            finally { TVModules.EndUpdate(); }
+            if (!PopulateObjectToLists(_depends.RootModule, true, null))
+                return false;
+
+            // Expand root module.
+            _rootNode?.Expand();
 
             // Insert list modules from session file.
             LVModules.BeginUpdate();
@@ -259,6 +269,7 @@ public partial class MainForm
         else
         {
             // Corrupted file, leaving.
+            _depends.ReleaseSessionFile();
             _depends = null;
             _rootNode = null;
             return false;
@@ -271,6 +282,12 @@ public partial class MainForm
     {
         try
         {
+            if (CSessionSerializer.IsSessionFile(fileName))
+            {
+                return CSessionSerializer.Load(fileName, UpdateOperationStatus);
+            }
+
+            // Sessions saved as JSON by earlier versions.
             if (bIsCompressed)
             {
                 return (CDepends)CUtils.LoadPackedObjectFromFile(fileName, typeof(CDepends), UpdateOperationStatus);
@@ -361,13 +378,16 @@ public partial class MainForm
 
         try
         {
-            if (useCompression)
+            // Read lists still deferred to the loaded session file and release it, both formats may overwrite it.
+            _depends.DetachSessionFile();
+
+            if (jsonOutput)
             {
-                bSaved = CUtils.SavePackedObjectToFile(fileName, _depends, typeof(CDepends), UpdateOperationStatus);
+                bSaved = CUtils.SaveObjectToFilePlainText(fileName, _depends, typeof(CDepends));
             }
             else
             {
-                bSaved = CUtils.SaveObjectToFilePlainText(fileName, _depends, typeof(CDepends));
+                bSaved = CSessionSerializer.Save(fileName, _depends, useCompression, UpdateOperationStatus);
             }
         }
         catch (Exception ex)
@@ -6,7 +6,7 @@
 *
 *  VERSION:     1.00
 *
-*  DATE:        14 Jul 2026
+*  DATE:        18 Oct 2026
 *  
 *  Import and export function view routines for main form.
 *
@@ -110,6 +110,15 @@ public partial class MainForm
         ResolveFunctionKindForList(_currentImportsList, module, _loadedModulesList, _configuration);
         ResolveFunctionKindForList(_currentExportsList, module, _loadedModulesList, _configuration);
 
+        //
+        // Undecorate names once per list instead of per row.
+        //
+        if (_configuration.ViewUndecorated)
+        {
+            _symbolResolver.UndecorateFunctionNames(_currentImportsList);
+            _symbolResolver.UndecorateFunctionNames(_currentExportsList);
+        }
+
         UpdateListViewInternal(LVExports, _currentExportsList, _configuration.SortColumnExports, _lvExportsSortOrder, DisplayCacheType.Exports);
         UpdateListViewInternal(LVImports, _currentImportsList, _configuration.SortColumnImports, _lvImportsSortOrder, DisplayCacheType.Imports);
 
@@ -133,11 +142,6 @@ public partial class MainForm
 
     static string TryUndecorateFunction(CSymbolResolver symbolResolver, bool viewUndecorated, CFunction function)
     {
-        if (!symbolResolver.UndecorationReady)
-        {
-            return function.RawName;
-        }
-
         return viewUndecorated && function.IsNameDecorated() ? 
             function.UndecorateFunctionName(symbolResolver) : 
             function.RawName;
@@ -536,7 +540,13 @@ public partial class MainForm
     /// <param name="cacheType"></param>
     private void LVFunctionsSort(ListView listView, int columnIndex, SortOrder sortOrder, List<CFunction> data, DisplayCacheType cacheType)
     {
-        IComparer<CFunction> funcComparer = new CFunctionComparer(sortOrder, columnIndex, _symbolResolver);
+        if (columnIndex == (int)FunctionsColumns.Name)
+        {
+            // Comparer uses precomputed undecorated names.
+            _symbolResolver.UndecorateFunctionNames(data);
+        }
+
+        IComparer<CFunction> funcComparer = new CFunctionComparer(sortOrder, columnIndex);
         data.Sort(funcComparer);
         //
         // Reset listview items cache.
@@ -6,7 +6,7 @@
 *
 *  VERSION:     1.00
 *
-*  DATE:        17 Jul 2026
+*  DATE:        18 Oct 2026
 *  
 *  Log view rendering, interaction, and search routines for main form.
 *
@@ -98,6 +98,13 @@ public partial class MainForm
                 break;
         }
 
+        // Messages from module analysis thread are marshalled before being recorded.
+        if (richTextBox != null && !richTextBox.IsDisposed && richTextBox.InvokeRequired)
+        {
+            richTextBox.BeginInvoke(() => AppLogger_OnLogMessage(e));
+            return;
+        }
+
         if (e.ModuleMessage)
         {
             _depends.ModuleAnalysisLog.Add(new LogEntry(e.Message, outputColor));
@@ -105,12 +112,6 @@ public partial class MainForm
 
         if (richTextBox != null && !richTextBox.IsDisposed)
         {
-            if (richTextBox.InvokeRequired)
-            {
-                richTextBox.BeginInvoke(() => AppLogger_OnLogMessage(e));
-                return;
-            }
-
             richTextBox.SuspendLayout();
 
             int startPosition = richTextBox.TextLength;
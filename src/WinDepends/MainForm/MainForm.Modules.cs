@@ -6,7 +6,7 @@
 *
 *  VERSION:     1.00
 *
-*  DATE:        14 Jul 2026
+*  DATE:        18 Oct 2026
 *  
 *  Module tree, list, and navigation routines for main form.
 *
@@ -17,6 +17,7 @@
 *
 *******************************************************************************/
 
+using System.Collections.Concurrent;
 using System.Reflection.PortableExecutable;
 using System.Text;
 
@@ -191,20 +192,15 @@ public partial class MainForm
     /// <summary>
     /// Validates whether a module can be added based on tree depth settings.
     /// </summary>
-    /// <param name="parentNode">The parent node to check depth against.</param>
+    /// <param name="parentModule">The parent module to check depth against.</param>
     /// <param name="maxDepth">The maximum allowed depth.</param>
     /// <returns>true if the node is within the depth limit; otherwise, false.</returns>
-    private bool ValidateTreeDepth(TreeNode parentNode, int maxDepth)
+    private static bool ValidateTreeDepth(CModule parentModule, int maxDepth)
     {
-        if (parentNode == null)
+        if (parentModule == null)
             return true; // Root node is always valid
 
-        if (parentNode.Tag is CModule parentModule)
-        {
-            return parentModule.Depth <= maxDepth;
-        }
-
-        return true;
+        return parentModule.Depth <= maxDepth;
     }
 
     /// <summary>
@@ -325,27 +321,95 @@ public partial class MainForm
         return secondSep < 0;
     }
 
+    /// <summary>
+    /// Module entry produced by the analysis crawl and consumed by the tree view population.
+    /// </summary>
+    private sealed class CModuleTreeItem(CModule module, CModuleTreeItem parent)
+    {
+        /// <summary>
+        /// Analyzed module, owned by the UI thread once the entry is queued.
+        /// </summary>
+        public CModule Module { get; } = module;
+
+        /// <summary>
+        /// Parent entry, or null for the root module.
+        /// </summary>
+        public CModuleTreeItem Parent { get; } = parent;
+
+        /// <summary>
+        /// Tree node created for this entry, assigned on the UI thread.
+        /// </summary>
+        public TreeNode Node { get; set; }
+
+        /// <summary>
+        /// Module is the original instance and is added to the loaded modules list by the UI thread.
+        /// </summary>
+        public bool IsNewModule { get; init; }
+
+        /// <summary>
+        /// Errors of this entry are propagated to the parent module by the UI thread.
+        /// </summary>
+        public bool PropagateErrorToParent { get; init; }
+    }
+
+    /// <summary>
+    /// State of a single module tree crawl, owned by the crawl thread.
+    /// </summary>
+    /// <remarks>
+    /// Modules handed over to the UI thread are not modified by the crawl, original instances
+    /// and error propagation are tracked here and applied by the UI thread with the batch.
+    /// </remarks>
+    private sealed class CModuleCrawlState
+    {
+        /// <summary>
+        /// Original module instances by file name.
+        /// </summary>
+        public Dictionary<string, CModule> Originals { get; } = new(StringComparer.OrdinalIgnoreCase);
+
+        /// <summary>
+        /// Modules that received errors propagated from their dependencies.
+        /// </summary>
+        public HashSet<CModule> ErrorModules { get; } = new(ReferenceEqualityComparer.Instance);
+    }
+
+    /// <summary>
+    /// Cancellation source of the currently running module tree population, if any.
+    /// </summary>
+    CancellationTokenSource _populateCancellation;
+
+    /// <summary>
+    /// Background analysis task of the currently running module tree population, if any.
+    /// </summary>
+    Task _populateTask;
+
     /// <summary>
     /// AddModuleEntry core implementation. Shared between normal and session files.
+    /// Performs analysis only and does not touch any UI controls or modules already handed over
+    /// to the UI thread, so it is safe to call from the crawl thread.
     /// </summary>
     /// <param name="module">The module to add</param>
-    /// <param name="parentNode">Parent node, or null for root level</param>
+    /// <param name="parentItem">Parent entry, or null for root level</param>
     /// <param name="maxDepth">Maximum allowed node depth</param>
+    /// <param name="state">Crawl state</param>
     /// <param name="moduleProcessor">Optional processing to perform on new modules</param>
-    /// <returns>Created TreeNode or null if validation fails</returns>
-    private TreeNode AddModuleEntryCore(
+    /// <returns>Created module tree entry or null if validation fails</returns>
+    private CModuleTreeItem AddModuleEntryCore(
         CModule module,
-        TreeNode parentNode,
+        CModuleTreeItem parentItem,
         int maxDepth,
+        CModuleCrawlState state,
         Action<CModule> moduleProcessor = null)
     {
+        CModule parent = parentItem?.Module;
+
         // 1. Validate tree depth
-        if (!ValidateTreeDepth(parentNode, maxDepth))
+        if (!ValidateTreeDepth(parent, maxDepth))
             return null;
 
         // 2. Check if module already exists
         bool isNewModule = true;
-        CModule origInstance = CUtils.GetModuleByHash(module.FileName, _loadedModulesList);
+        bool propagateError = false;
+        state.Originals.TryGetValue(module.FileName, out CModule origInstance);
 
         if (origInstance != null)
         {
@@ -357,14 +421,18 @@ public partial class MainForm
             // Do not copy OtherErrorsPresent from original instance, must set it directly
             // module.OtherErrorsPresent = origInstance.OtherErrorsPresent;
             module.IsDotNetModule = origInstance.IsDotNetModule;
-            module.ModuleData = new(origInstance.ModuleData);
+            // Duplicates reference one shared header snapshot instead of a private copy each.
+            module.ModuleData = origInstance.ModuleData.GetSharedDuplicateData();
 
             // Propagate errors from duplicate to parent if this is not root
-            if (parentNode?.Tag is CModule parent)
+            if (parent != null)
             {
-                // Only propagate genuine errors, not from apiset contracts or stopped nodes
+                // Only propagate genuine errors, not from apiset contracts or stopped nodes.
+                // Propagated errors are tracked by the crawl state, the UI thread sets
+                // OtherErrorsPresent of published modules later.
                 bool shouldPropagate = origInstance.ExportContainErrors ||
                                        origInstance.OtherErrorsPresent ||
+                                       state.ErrorModules.Contains(origInstance) ||
                                        origInstance.FileNotFound;
 
                 // Don't propagate from apiset contracts
@@ -379,13 +447,7 @@ public partial class MainForm
                         shouldPropagate = false;
                 }
 
-                if (shouldPropagate)
-                {
-                    parent.OtherErrorsPresent = true;
-                    parent.ModuleImageIndex = parent.GetIconIndexForModule();
-                    parentNode.ImageIndex = parent.ModuleImageIndex;
-                    parentNode.SelectedImageIndex = parent.ModuleImageIndex;
-                }
+                propagateError = shouldPropagate;
             }
         }
 
@@ -395,61 +457,45 @@ public partial class MainForm
             moduleProcessor(module);
         }
 
-        // 4. Format display name
-        string moduleDisplayName = BuildModuleDisplayName(
-                   module.GetModuleNameRespectApiSet(_configuration.ResolveAPIsets),
-                   _configuration.FullPaths,
-                   _configuration.UpperCaseModuleNames);
-
         // Mark forward user as red if there is no forward module.
-        if (module.IsForward && module.FileNotFound && parentNode?.Tag is CModule parentMod)
+        if (module.IsForward && module.FileNotFound && parent != null)
         {
-            parentMod.OtherErrorsPresent = true;
-            parentMod.ModuleImageIndex = parentMod.GetIconIndexForModule();
-            parentNode.ImageIndex = parentMod.ModuleImageIndex;
-            parentNode.SelectedImageIndex = parentMod.ModuleImageIndex;
+            propagateError = true;
         }
 
-        // 5. Create the tree node
-        module.ModuleImageIndex = module.GetIconIndexForModule();
-        TreeNode tvNode = new(moduleDisplayName)
+        if (propagateError)
         {
-            Tag = module,
-            ImageIndex = module.ModuleImageIndex,
-            SelectedImageIndex = module.ModuleImageIndex,
-            ForeColor = (module.IsApiSetContract && _configuration.HighlightApiSet) ? Color.Blue : Color.Black
-        };
-
-        // 6. Add to tree in correct location
-        if (parentNode != null)
-        {
-            if (parentNode.Tag is CModule parentModule)
-            {
-                module.Depth = parentModule.Depth + 1;
-            }
-            parentNode?.Nodes?.Add(tvNode);
+            state.ErrorModules.Add(parent);
         }
-        else
+
+        // 4. Set icon and depth, node is created later by the UI thread
+        module.ModuleImageIndex = module.GetIconIndexForModule();
+        if (parent != null)
         {
-            TVModules.Nodes?.Add(tvNode);
+            module.Depth = parent.Depth + 1;
         }
 
-        // 7. Update module collections if new
+        // 5. Remember original instance, loaded modules list is updated by the UI thread
         if (isNewModule)
         {
-            _loadedModulesList.Add(module);
+            state.Originals.TryAdd(module.FileName, module);
         }
 
-        return tvNode;
+        return new CModuleTreeItem(module, parentItem)
+        {
+            IsNewModule = isNewModule,
+            PropagateErrorToParent = propagateError
+        };
     }
 
     /// <summary>
-    /// Insert module entry to TVModules treeview.
+    /// Analyze module entry for insertion to TVModules treeview.
     /// </summary>
-    /// <returns>Tree node.</returns>
-    private TreeNode AddModuleEntry(CModule module, CFileOpenSettings fileOpenSettings, TreeNode parentNode = null)
+    /// <returns>Module tree entry.</returns>
+    private CModuleTreeItem AddModuleEntry(CModule module, CFileOpenSettings fileOpenSettings, CModuleCrawlState state,
+        CModuleTreeItem parentItem = null)
     {
-        bool isRootModule = (parentNode == null);
+        bool isRootModule = (parentItem == null);
 
         // Define action processor (callback)
         Action<CModule> processModule = (mod) =>
@@ -480,8 +526,9 @@ public partial class MainForm
         // Use shared implementation with our specific processor
         return AddModuleEntryCore(
             module,
-            parentNode,
+            parentItem,
             _configuration.ModuleNodeDepthMax,
+            state,
             processModule);
     }
 
@@ -489,100 +536,282 @@ public partial class MainForm
     /// Adds module entry from loaded session object (saved session view).
     /// </summary>
     /// <param name="module">Module entry to be added.</param>
-    /// <param name="parentNode">Parent node if present.</param>
-    /// <returns>Tree node entry.</returns>
-    private TreeNode AddSessionModuleEntry(CModule module, TreeNode parentNode = null)
+    /// <param name="state">Crawl state.</param>
+    /// <param name="parentItem">Parent entry if present.</param>
+    /// <returns>Module tree entry.</returns>
+    private CModuleTreeItem AddSessionModuleEntry(CModule module, CModuleCrawlState state, CModuleTreeItem parentItem = null)
     {
         // Just use the shared implementation without any specific processor set
         return AddModuleEntryCore(
             module,
-            parentNode,
-            _depends.SessionNodeMaxDepth);
+            parentItem,
+            _depends.SessionNodeMaxDepth,
+            state);
     }
 
     /// <summary>
-    /// Populates the tree and related lists for the root module and its dependencies.
+    /// Creates tree view node for the analyzed module entry and inserts it under the parent node.
+    /// Applies module list and error propagation changes of the entry. Must be called on the UI thread.
     /// </summary>
-    /// <param name="module">The root module to populate.</param>
-    /// <param name="loadFromObject">If true, populates from a restored session object.</param>
-    /// <param name="fileOpenSettings">Specific file open settings from the program configuration.</param>
-    private void PopulateObjectToLists(CModule module, bool loadFromObject, CFileOpenSettings fileOpenSettings)
+    /// <param name="item">Module tree entry.</param>
+    private void CreateModuleTreeNode(CModuleTreeItem item)
     {
-        List<TreeNode> baseNodes = [];
+        CModule module = item.Module;
 
-        UpdateOperationStatus($"Populating {module.FileName}");
+        if (item.IsNewModule)
+        {
+            _loadedModulesList.Add(module);
+        }
+
+        if (item.PropagateErrorToParent && item.Parent != null)
+        {
+            CModule parent = item.Parent.Module;
+            parent.OtherErrorsPresent = true;
+            parent.ModuleImageIndex = parent.GetIconIndexForModule();
+        }
+
+        using var span = CTraceRecorder.BeginSpan("tree-insert", "ui", module.FileName);
 
-        if (loadFromObject)
+        string moduleDisplayName = BuildModuleDisplayName(
+                   module.GetModuleNameRespectApiSet(_configuration.ResolveAPIsets),
+                   _configuration.FullPaths,
+                   _configuration.UpperCaseModuleNames);
+
+        TreeNode tvNode = new(moduleDisplayName)
         {
-            // Add root session module.
-            _rootNode = AddSessionModuleEntry(module, null);
+            Tag = module,
+            ImageIndex = module.ModuleImageIndex,
+            SelectedImageIndex = module.ModuleImageIndex,
+            ForeColor = (module.IsApiSetContract && _configuration.HighlightApiSet) ? Color.Blue : Color.Black
+        };
+
+        item.Node = tvNode;
+
+        TreeNode parentNode = item.Parent?.Node;
+        if (parentNode != null)
+        {
+            parentNode.Nodes.Add(tvNode);
 
-            // Add root session module dependencies.
-            foreach (var importModule in module.Dependents)
+            // Parent icon could be changed by error propagation from its dependencies.
+            int parentImageIndex = item.Parent.Module.ModuleImageIndex;
+            if (parentNode.ImageIndex != parentImageIndex)
             {
-                UpdateOperationStatus($"Populating {importModule.FileName}");
-                var addedNode = AddSessionModuleEntry(importModule, _rootNode);
-                if (addedNode != null)
-                    baseNodes.Add(addedNode);
+                parentNode.ImageIndex = parentImageIndex;
+                parentNode.SelectedImageIndex = parentImageIndex;
             }
         }
         else
         {
-            // Add root module.
-            _rootNode = AddModuleEntry(module, fileOpenSettings, null);
+            TVModules.Nodes.Add(tvNode);
+            _rootNode = tvNode;
+        }
+    }
+
+    /// <summary>
+    /// Appends a batch of analyzed module entries to the TVModules treeview.
+    /// </summary>
+    /// <param name="batch">Module tree entries in crawl order.</param>
+    private void AppendModuleTreeBatch(List<CModuleTreeItem> batch)
+    {
+        TVModules.BeginUpdate();
+        try
+        {
+            foreach (var item in batch)
+            {
+                CreateModuleTreeNode(item);
+            }
 
-            // Add root module dependencies.
-            foreach (var importModule in module.Dependents)
+            // Show first level dependencies as soon as they are available.
+            if (_rootNode != null && !_rootNode.IsExpanded && _rootNode.Nodes.Count > 0)
             {
-                UpdateOperationStatus($"Populating {importModule.FileName}");
-                var addedNode = AddModuleEntry(importModule, fileOpenSettings, _rootNode);
-                if (addedNode != null)
-                    baseNodes.Add(addedNode);
+                _rootNode.Expand();
             }
         }
+        finally { TVModules.EndUpdate(); }
+    }
+
+    /// <summary>
+    /// Walks the root module and its dependencies in display order, producing module tree entries.
+    /// Runs on the crawl thread.
+    /// </summary>
+    /// <param name="module">The root module to walk.</param>
+    /// <param name="loadFromObject">If true, walks a restored session object.</param>
+    /// <param name="fileOpenSettings">Specific file open settings from the program configuration.</param>
+    /// <param name="output">Collection receiving the produced entries.</param>
+    /// <param name="token">Cancellation token.</param>
+    private void CrawlModuleTree(CModule module,
+        bool loadFromObject,
+        CFileOpenSettings fileOpenSettings,
+        BlockingCollection<CModuleTreeItem> output,
+        CancellationToken token)
+    {
+        List<CModuleTreeItem> baseItems = [];
+        CModuleCrawlState state = new();
 
-        // Add sub dependencies.
-        foreach (var node in baseNodes)
+        CModuleTreeItem AddEntry(CModule entry, CModuleTreeItem parentItem)
         {
-            if (node.Tag is not CModule nodeModule)
-                continue;
+            var item = loadFromObject
+                ? AddSessionModuleEntry(entry, state, parentItem)
+                : AddModuleEntry(entry, fileOpenSettings, state, parentItem);
+
+            if (item != null)
+                output.Add(item);
 
-            foreach (var dependent in nodeModule.Dependents)
+            return item;
+        }
+
+        // Add root module.
+        var rootItem = AddEntry(module, null);
+        if (rootItem == null)
+            return;
+
+        // Add root module dependencies.
+        foreach (var importModule in module.Dependents)
+        {
+            if (token.IsCancellationRequested)
+                return;
+
+            UpdateOperationStatus($"Populating {importModule.FileName}");
+            var addedItem = AddEntry(importModule, rootItem);
+            if (addedItem != null)
+                baseItems.Add(addedItem);
+        }
+
+        // Add sub dependencies, depth-first under each first level dependency.
+        Stack<(CModule Module, CModuleTreeItem Parent)> pending = new();
+
+        foreach (var baseItem in baseItems)
+        {
+            for (int i = baseItem.Module.Dependents.Count - 1; i >= 0; i--)
             {
+                pending.Push((baseItem.Module.Dependents[i], baseItem));
+            }
+
+            while (pending.Count > 0)
+            {
+                if (token.IsCancellationRequested)
+                    return;
+
+                var (dependent, parentItem) = pending.Pop();
+
                 UpdateOperationStatus($"Populating {dependent.FileName}");
-                PopulateDependentObjectsToLists(dependent, node, loadFromObject, fileOpenSettings);
+                var item = AddEntry(dependent, parentItem);
+                if (item == null)
+                    continue;
+
+                for (int i = dependent.Dependents.Count - 1; i >= 0; i--)
+                {
+                    pending.Push((dependent.Dependents[i], item));
+                }
             }
         }
-
     }
 
     /// <summary>
-    /// Populates dependent modules under the specified parent node, respecting the configured depth limit.
+    /// Populates the tree and related lists for the root module and its dependencies.
+    /// Analysis runs on a background task while the UI thread appends produced nodes in batches.
     /// </summary>
-    /// <param name="module">The dependent module to populate.</param>
-    /// <param name="parentNode">The parent tree node.</param>
+    /// <param name="module">The root module to populate.</param>
     /// <param name="loadFromObject">If true, populates from a restored session object.</param>
     /// <param name="fileOpenSettings">Specific file open settings from the program configuration.</param>
-    private void PopulateDependentObjectsToLists(CModule module, TreeNode parentNode, bool loadFromObject, CFileOpenSettings fileOpenSettings)
+    /// <returns>True if population completed, false if it was interrupted by shutdown or cancellation.</returns>
+    private bool PopulateObjectToLists(CModule module, bool loadFromObject, CFileOpenSettings fileOpenSettings)
     {
-        TreeNode tvNode;
+        bool completed = false;
+        List<CModuleTreeItem> batch = new(CConsts.ModuleTreeBatchSize);
+        bool prefetchSymbols = !loadFromObject && _configuration.UseSymbols &&
+            _configuration.SymbolsPrefetch && _symbolResolver.SymbolsInitialized;
+
+        UpdateOperationStatus($"Populating {module.FileName}");
 
-        if (loadFromObject)
+        using BlockingCollection<CModuleTreeItem> pendingItems = new();
+        using CancellationTokenSource cts = new();
+
+        _populateCancellation = cts;
+        Task crawlTask = Task.Run(() =>
         {
-            tvNode = AddSessionModuleEntry(module, parentNode);
+            try
+            {
+                CrawlModuleTree(module, loadFromObject, fileOpenSettings, pendingItems, cts.Token);
+
+                // Debug info queries share the server connection with the crawl, keep them on this thread.
+                if (prefetchSymbols && !cts.Token.IsCancellationRequested)
+                    PrefetchSymbolsForModuleTree(module, cts.Token);
+            }
+            finally
+            {
+                pendingItems.CompleteAdding();
+            }
+        });
+        _populateTask = crawlTask;
+
+        try
+        {
+            while (!pendingItems.IsCompleted)
+            {
+                if (pendingItems.TryTake(out var item, CConsts.ModuleTreeBatchWaitMs))
+                {
+                    do
+                    {
+                        batch.Add(item);
+                    } while (batch.Count < CConsts.ModuleTreeBatchSize && pendingItems.TryTake(out item));
+
+                    if (_shutdownInProgress || TVModules.IsDisposed)
+                        break;
+
+                    AppendModuleTreeBatch(batch);
+                    batch.Clear();
+                }
+
+                // Keep window responsive while analysis is in progress, input controls are disabled by caller.
+                Application.DoEvents();
+
+                if (_shutdownInProgress || TVModules.IsDisposed)
+                    break;
+            }
+
+            if (!_shutdownInProgress && !TVModules.IsDisposed && pendingItems.IsCompleted)
+            {
+                // Flush log and status messages posted by the crawl thread.
+                Application.DoEvents();
+
+                // Rethrow crawl errors to the file open handler.
+                crawlTask.GetAwaiter().GetResult();
+
+                completed = !cts.IsCancellationRequested && !_shutdownInProgress;
+            }
         }
-        else
+        finally
         {
-            tvNode = AddModuleEntry(module, fileOpenSettings, parentNode);
+            CancelModulePopulation();
         }
 
-        if (tvNode == null)
+        return completed;
+    }
+
+    /// <summary>
+    /// Stops running module tree population and waits for the crawl task to leave.
+    /// </summary>
+    private void CancelModulePopulation()
+    {
+        Task populateTask = _populateTask;
+
+        if (populateTask == null)
             return;
 
-        foreach (CModule dependentModule in module.Dependents)
+        try
+        {
+            _populateCancellation?.Cancel();
+            populateTask.Wait();
+        }
+        catch (AggregateException)
+        {
+            // Crawl errors are reported by PopulateObjectToLists.
+        }
+        finally
         {
-            UpdateOperationStatus($"Populating {dependentModule.FileName}");
-            PopulateDependentObjectsToLists(dependentModule, tvNode, loadFromObject, fileOpenSettings);
+            _populateCancellation = null;
+            _populateTask = null;
         }
     }
 
@@ -6,7 +6,7 @@
 *
 *  VERSION:     1.00
 *
-*  DATE:        14 Jul 2026
+*  DATE:        18 Oct 2026
 *  
 *  Codename:    VasilEk
 *
@@ -435,9 +435,12 @@ public partial class MainForm : Form
                 UpdateOperationStatus(e.Message);
                 break;
             case SymbolLoadState.Cancelled:
-            case SymbolLoadState.Idle:
                 UpdateOperationStatus(string.Empty);
                 break;
+            case SymbolLoadState.Idle:
+                // Empty unless prefetch summary is reported.
+                UpdateOperationStatus(e.Message);
+                break;
             case SymbolLoadState.Failed:
                 UpdateOperationStatus(e.Message);
                 break;
@@ -1706,6 +1709,71 @@ public partial class MainForm : Form
         {
             _symbolResolver.RequestModulePreload(module.FileName, 0);
         }
+
+        //
+        // Direct imports of the selection go ahead of the tree-wide prefetch.
+        //
+        if (_configuration.SymbolsPrefetch)
+        {
+            foreach (var dependent in module.Dependents)
+            {
+                if (!dependent.FileNotFound && !string.IsNullOrEmpty(dependent.FileName))
+                {
+                    _symbolResolver.EnqueueModulePrefetch(dependent.FileName, null, SymbolLoadPriority.Nearby);
+                }
+            }
+        }
+    }
+
+    /// <summary>
+    /// Queues symbol prefetch for all modules of the opened file, PDB identity is read by the server in batches.
+    /// Runs on the crawl thread, modules are queued level by level so direct imports of the root come first.
+    /// </summary>
+    /// <param name="rootModule">Root module of the opened file.</param>
+    /// <param name="token">Cancellation token.</param>
+    private void PrefetchSymbolsForModuleTree(CModule rootModule, CancellationToken token)
+    {
+        List<string> fileNames = [];
+        HashSet<string> visited = new(StringComparer.OrdinalIgnoreCase);
+        Queue<CModule> pending = new();
+
+        pending.Enqueue(rootModule);
+
+        while (pending.Count > 0)
+        {
+            var module = pending.Dequeue();
+
+            if (module.FileNotFound || string.IsNullOrEmpty(module.FileName) || !visited.Add(module.FileName))
+                continue;
+
+            fileNames.Add(module.FileName);
+
+            foreach (var dependent in module.Dependents)
+            {
+                pending.Enqueue(dependent);
+            }
+        }
+
+        foreach (var chunk in fileNames.Chunk(CConsts.DebugInfoBatchSize))
+        {
+            if (token.IsCancellationRequested)
+                return;
+
+            var debugInfo = _coreClient?.GetDebugInfo(chunk);
+            if (debugInfo?.Entries == null || debugInfo.Entries.Count != chunk.Length)
+            {
+                foreach (var fileName in chunk)
+                {
+                    _symbolResolver.EnqueueModulePrefetch(fileName, null);
+                }
+                continue;
+            }
+
+            for (int i = 0; i < chunk.Length; i++)
+            {
+                _symbolResolver.EnqueueModulePrefetch(chunk[i], debugInfo.Entries[i]);
+            }
+        }
     }
 
     private void MainMenu_FileDropDown(object sender, EventArgs e)
@@ -1794,6 +1862,9 @@ public partial class MainForm : Form
     {
         _shutdownInProgress = true;
 
+        // Stop background module analysis before core client goes away.
+        CancelModulePopulation();
+
         if (_findDialog != null && !_findDialog.IsDisposed)
         {
             _findDialog.Close();
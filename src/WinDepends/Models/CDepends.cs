@@ -6,7 +6,7 @@
 *
 *  VERSION:     1.00
 *
-*  DATE:        16 Jul 2026
+*  DATE:        18 Oct 2026
 *  
 *  Implementation of base session class.
 *
@@ -53,6 +53,12 @@ public class CDepends
     [DataMember]
     public List<LogEntry> ModuleAnalysisLog { get; set; } = [];
 
+    /// <summary>
+    /// Mapped session file the function lists of the loaded session are read from on demand.
+    /// </summary>
+    [IgnoreDataMember]
+    internal CSessionFile SessionFile { get; set; }
+
     public CDepends()
     {
     }
@@ -68,4 +74,46 @@ public class CDepends
         
         RootModule = module;
     }
+
+    /// <summary>
+    /// Reads all function lists still deferred to the session file and releases the file.
+    /// </summary>
+    internal void DetachSessionFile()
+    {
+        if (SessionFile == null)
+            return;
+
+        if (RootModule != null)
+        {
+            Stack<CModule> modules = new();
+            modules.Push(RootModule);
+
+            while (modules.Count > 0)
+            {
+                var module = modules.Pop();
+
+                _ = module.ParentImports;
+                _ = module.ModuleData?.Exports;
+
+                if (module.Dependents == null)
+                    continue;
+
+                foreach (var dependent in module.Dependents)
+                {
+                    modules.Push(dependent);
+                }
+            }
+        }
+
+        ReleaseSessionFile();
+    }
+
+    /// <summary>
+    /// Releases the session file, function lists not read so far are no longer available.
+    /// </summary>
+    internal void ReleaseSessionFile()
+    {
+        SessionFile?.Dispose();
+        SessionFile = null;
+    }
 }
@@ -6,7 +6,7 @@
 *
 *  VERSION:     1.00
 *
-*  DATE:        28 May 2026
+*  DATE:        18 Oct 2026
 *  
 *  Implementation of CFunction and CFunctionComparer classes.
 *
@@ -755,30 +755,30 @@ public class CFunction
 /// 
 /// The comparison logic handles decorated function names, forwarded functions, and special values
 /// like <see cref="CConsts.OrdinalNotPresent"/> which are used to indicate unset ordinals and <see cref="CConsts.HintNotPresent"/> for hints.
+/// 
+/// Decorated names are compared by <see cref="CFunction.UndecoratedName"/>, which must be precomputed
+/// with <see cref="CSymbolResolver.UndecorateFunctionNames"/> before sorting.
 /// </remarks>
 public class CFunctionComparer : IComparer<CFunction>
 {
     private readonly int _fieldIndex;
     private readonly SortOrder _sortOrder;
     private readonly StringComparer _stringComparer;
-    readonly CSymbolResolver _symbolResolver;
 
     /// <summary>
     /// Initializes a new instance of the <see cref="CFunctionComparer"/> class.
     /// </summary>
     /// <param name="sortOrder">The sort direction to apply to comparisons.</param>
     /// <param name="fieldIndex">The index of the field to compare.</param>
-    /// <param name="symbolResolver">The symbol resolver class object.</param>
     /// <remarks>
     /// This constructor configures the comparer to sort functions based on the specified field
     /// and in the specified direction.
     /// </remarks>
-    public CFunctionComparer(SortOrder sortOrder, int fieldIndex, CSymbolResolver symbolResolver)
+    public CFunctionComparer(SortOrder sortOrder, int fieldIndex)
     {
         _fieldIndex = fieldIndex;
         _sortOrder = sortOrder;
         _stringComparer = StringComparer.OrdinalIgnoreCase;
-        _symbolResolver = symbolResolver;
     }
 
     public int Compare(CFunction x, CFunction y)
@@ -848,13 +848,6 @@ public class CFunctionComparer : IComparer<CFunction>
 
             case (int)FunctionsColumns.Name:
                 {
-                    // Cache UndecoratedName if needed
-                    if (string.IsNullOrEmpty(x.UndecoratedName) && !string.IsNullOrEmpty(x.RawName) && x.IsNameDecorated())
-                        x.UndecorateFunctionName(_symbolResolver);
-
-                    if (string.IsNullOrEmpty(y.UndecoratedName) && !string.IsNullOrEmpty(y.RawName) && y.IsNameDecorated())
-                        y.UndecorateFunctionName(_symbolResolver);
-
                     string nameX = !string.IsNullOrEmpty(x.UndecoratedName) ? x.UndecoratedName : x.RawName;
                     string nameY = !string.IsNullOrEmpty(y.UndecoratedName) ? y.UndecoratedName : y.RawName;
 
@@ -6,7 +6,7 @@
 *
 *  VERSION:     1.00
 *
-*  DATE:        14 Feb 2026
+*  DATE:        18 Oct 2026
 *  
 *  Implementation of base CModule and CModuleComparer classes.
 *
@@ -703,8 +703,47 @@ public class CModuleData
     /// Gets or sets the list of exported functions from this module.
     /// </summary>
     /// <value>A list of <see cref="CFunction"/> objects representing the module's exports.</value>
+    /// <remarks>
+    /// For sessions loaded from a binary session file the list is read from the file on first access.
+    /// </remarks>
     [DataMember]
-    public List<CFunction> Exports { get; set; } = [];
+    public List<CFunction> Exports
+    {
+        get
+        {
+            var block = _exportsBlock;
+            if (block != null)
+            {
+                _exports = block.Load();
+                _exportsBlock = null;
+            }
+            return _exports;
+        }
+        set
+        {
+            _exports = value;
+            _exportsBlock = null;
+        }
+    }
+
+    [IgnoreDataMember]
+    private List<CFunction> _exports = [];
+
+    [IgnoreDataMember]
+    private CSessionFunctionBlock _exportsBlock;
+
+    /// <summary>
+    /// Gets a value indicating whether this instance is shared between duplicate module entries.
+    /// </summary>
+    /// <value><c>true</c> if the instance is shared and must be treated as read-only.</value>
+    [IgnoreDataMember]
+    public bool IsShared { get; private set; }
+
+    /// <summary>
+    /// Header-only snapshot referenced by all duplicate entries of the module, created on first request.
+    /// </summary>
+    [IgnoreDataMember]
+    private CModuleData _sharedDuplicateData;
 
     /// <summary>
     /// Initializes a new instance of the <see cref="CModuleData"/> class.
@@ -764,6 +803,46 @@ public class CModuleData
         //    ? new List<CFunction>(other.Exports)
         //    : [];
     }
+
+    /// <summary>
+    /// Returns the module data instance shared by all duplicate entries of this module.
+    /// </summary>
+    /// <remarks>
+    /// The snapshot is created once per original module, exports are not included the same way
+    /// as in the copy constructor. Use <see cref="CModule.GetWritableModuleData"/> before modifying it.
+    /// </remarks>
+    /// <returns>Shared read-only <see cref="CModuleData"/> instance.</returns>
+    public CModuleData GetSharedDuplicateData()
+    {
+        if (IsShared)
+            return this;
+
+        var shared = _sharedDuplicateData;
+        if (shared == null)
+        {
+            shared = new CModuleData(this) { IsShared = true };
+            shared = Interlocked.CompareExchange(ref _sharedDuplicateData, shared, null) ?? shared;
+        }
+
+        return shared;
+    }
+
+    /// <summary>
+    /// Marks a deserialized instance as shared between duplicate module entries.
+    /// </summary>
+    internal void MarkShared()
+    {
+        IsShared = true;
+    }
+
+    /// <summary>
+    /// Defers loading of exports until first access.
+    /// </summary>
+    internal void SetDeferredExports(CSessionFunctionBlock block)
+    {
+        _exports = null;
+        _exportsBlock = block;
+    }
 }
 
 /// <summary>
@@ -972,8 +1051,43 @@ public class CModule
     /// <value>
     /// A list of <see cref="CFunction"/> objects representing imports from parent modules.
     /// </value>
+    /// <remarks>
+    /// For sessions loaded from a binary session file the list is read from the file on first access.
+    /// </remarks>
     [DataMember]
-    public List<CFunction> ParentImports { get; set; } = [];
+    public List<CFunction> ParentImports
+    {
+        get
+        {
+            var block = _parentImportsBlock;
+            if (block != null)
+            {
+                _parentImports = block.Load();
+                _parentImportsBlock = null;
+            }
+            return _parentImports;
+        }
+        set
+        {
+            _parentImports = value;
+            _parentImportsBlock = null;
+        }
+    }
+
+    [IgnoreDataMember]
+    private List<CFunction> _parentImports = [];
+
+    [IgnoreDataMember]
+    private CSessionFunctionBlock _parentImportsBlock;
+
+    /// <summary>
+    /// Defers loading of parent imports until first access.
+    /// </summary>
+    internal void SetDeferredParentImports(CSessionFunctionBlock block)
+    {
+        _parentImports = null;
+        _parentImportsBlock = block;
+    }
 
     /// <summary>
     /// Gets or sets the list of modules that depend on this module.
@@ -1051,6 +1165,20 @@ public class CModule
         };
     }
 
+    /// <summary>
+    /// Returns module data that can be modified, detaching it from shared duplicate data first if needed.
+    /// </summary>
+    /// <returns>The module's own <see cref="CModuleData"/> instance.</returns>
+    public CModuleData GetWritableModuleData()
+    {
+        if (ModuleData == null || ModuleData.IsShared)
+        {
+            ModuleData = ModuleData == null ? new() : new(ModuleData);
+        }
+
+        return ModuleData;
+    }
+
     /// <summary>
     /// Determines if the module targets a 64-bit architecture.
     /// </summary>
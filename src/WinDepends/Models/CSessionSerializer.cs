@@ -0,0 +1,1002 @@
+﻿/*******************************************************************************
+*
+*  (C) COPYRIGHT AUTHORS, 2026
+*
+*  TITLE:       CSESSIONSERIALIZER.CS
+*
+*  VERSION:     1.00
+*  
+*  DATE:        18 Oct 2026
+*
+*  Binary session file format.
+*
+* THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF
+* ANY KIND, EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED
+* TO THE IMPLIED WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+*******************************************************************************/
+using System.IO.Compression;
+using System.IO.MemoryMappedFiles;
+using System.Text;
+
+namespace WinDepends;
+
+/// <summary>
+/// Saves and loads sessions in the versioned binary format.
+/// </summary>
+/// <remarks>
+/// File starts with a header (magic, version, flags, block locations). Module data shared
+/// between duplicate module entries is stored once and referenced by id.
+///
+/// Version 2 is the first binary format, version 1 was never released and is rejected.
+/// Every import and export list is stored in its own block, followed by the string table,
+/// the module tree skeleton and the block index. Strings of all blocks and the skeleton are stored
+/// once in the string table and referenced by id, so names shared by many modules are not repeated
+/// per block. Blocks, the string table and the skeleton are compressed separately. The file is
+/// memory-mapped on load, the string table and the skeleton are read and function lists are paged in by
+/// <see cref="CSessionFunctionBlock"/> when they are first accessed, e.g. when a module is selected.
+///
+/// Sessions saved as JSON by earlier versions are still loaded by <see cref="CUtils.LoadPackedObjectFromFile"/>.
+/// </remarks>
+static class CSessionSerializer
+{
+    const uint SessionMagic = 0x42534457; // "WDSB"
+    const ushort SessionVersion = 2;
+    internal const ushort FlagCompressed = 0x0001;
+
+    //
+    // Reference encoding of strings and shared objects: null, new object follows, id of stored object.
+    // Strings are always stored in the string table and referenced by id.
+    //
+    const int RefNull = 0;
+    const int RefNew = 1;
+    const int RefBase = 2;
+
+    //
+    // Function list reference in the skeleton: null, empty list, index of function block.
+    //
+    const int ListNull = 0;
+    const int ListEmpty = 1;
+    const int ListBase = 2;
+
+    //
+    // Limits of untrusted input: module tree nesting and capacity reserved ahead of reading list items.
+    //
+    const int MaxModuleDepth = 1024;
+    const int MaxPreallocatedCount = 4096;
+
+    //
+    // Smallest encoded size of list items, counts that cannot fit in the rest of the stream are rejected.
+    //
+    const int MinPropertySize = 2;
+    const int MinLogEntrySize = 5;
+    const int MinForwarderSize = 6;
+    const int MinModuleSize = 29;
+    const int MinFunctionSize = 22;
+    const int MinStringSize = 1;
+    const int BlockIndexEntrySize = 16;
+
+    [Flags]
+    enum ModuleFlags : ushort
+    {
+        None = 0,
+        IsProcessed = 0x0001,
+        IsForward = 0x0002,
+        IsDelayLoad = 0x0004,
+        FileNotFound = 0x0008,
+        IsInvalid = 0x0010,
+        IsReproducibleBuild = 0x0020,
+        IsApiSetContract = 0x0040,
+        IsKernelModule = 0x0080,
+        IsDotNetModule = 0x0100,
+        ExportContainErrors = 0x0200,
+        OtherErrorsPresent = 0x0400,
+        ForwardersExpanded = 0x0800
+    }
+
+    [Flags]
+    enum FunctionFlags : byte
+    {
+        None = 0,
+        IsExportFunction = 0x01,
+        IsNameFromSymbols = 0x02
+    }
+
+    /// <summary>
+    /// Checks whether the file is a binary session file.
+    /// </summary>
+    /// <param name="fileName">Session file name.</param>
+    /// <returns>True if the file starts with the binary session signature.</returns>
+    public static bool IsSessionFile(string fileName)
+    {
+        try
+        {
+            using var fileStream = new FileStream(fileName, FileMode.Open, FileAccess.Read, FileShare.Read);
+            using var reader = new BinaryReader(fileStream);
+
+            return fileStream.Length >= sizeof(uint) && reader.ReadUInt32() == SessionMagic;
+        }
+        catch
+        {
+            return false;
+        }
+    }
+
+    /// <summary>
+    /// Saves session to file.
+    /// </summary>
+    /// <remarks>
+    /// Function lists still deferred to the session file the session was loaded from are read
+    /// and the file is released first, so the session can be saved over it.
+    /// </remarks>
+    /// <param name="fileName">Session file name.</param>
+    /// <param name="session">Session to save.</param>
+    /// <param name="compress">Compress the skeleton and function blocks with Brotli.</param>
+    /// <param name="updateStatusCallback">Optional status callback.</param>
+    /// <returns>True on success.</returns>
+    public static bool Save(string fileName, CDepends session, bool compress, UpdateLoadStatusCallback updateStatusCallback)
+    {
+        ArgumentNullException.ThrowIfNull(session);
+
+        updateStatusCallback?.Invoke($"Saving data to {fileName}");
+
+        session.DetachSessionFile();
+
+        using var fileStream = new FileStream(
+            fileName,
+            FileMode.Create,
+            FileAccess.Write,
+            FileShare.None,
+            bufferSize: 65536,
+            FileOptions.SequentialScan
+        );
+
+        using var header = new BinaryWriter(fileStream, Encoding.UTF8, true);
+
+        header.Write(SessionMagic);
+        header.Write(SessionVersion);
+        header.Write(compress ? FlagCompressed : (ushort)0);
+        header.Write(0UL); // Skeleton offset, written last.
+        header.Write(0UL); // Skeleton size.
+        header.Write(0UL); // String table offset.
+        header.Write(0UL); // String table size.
+        header.Flush();
+
+        updateStatusCallback?.Invoke("Serializing session data");
+
+        //
+        // Function blocks go straight to the file, the skeleton is small and kept in memory
+        // until all blocks are written.
+        //
+        List<(long Offset, long Size)> blocks = [];
+        Dictionary<List<CFunction>, int> blockIds = new(ReferenceEqualityComparer.Instance);
+        Dictionary<string, int> strings = new(StringComparer.Ordinal);
+
+        int WriteFunctionBlock(List<CFunction> functions)
+        {
+            if (blockIds.TryGetValue(functions, out int id))
+                return id;
+
+            long offset = fileStream.Position;
+
+            WriteBlock(fileStream, compress, writer => new SessionWriter(writer, null, strings).WriteFunctions(functions));
+
+            id = blocks.Count;
+            blocks.Add((offset, fileStream.Position - offset));
+            blockIds.Add(functions, id);
+            return id;
+        }
+
+        using var skeleton = new MemoryStream();
+        using (var writer = new BinaryWriter(skeleton, Encoding.UTF8, true))
+        {
+            new SessionWriter(writer, WriteFunctionBlock, strings).WriteSession(session);
+
+            writer.Write7BitEncodedInt(blocks.Count);
+            foreach (var (offset, size) in blocks)
+            {
+                writer.Write(offset);
+                writer.Write(size);
+            }
+        }
+
+        //
+        // String table is complete once the skeleton is serialized, ids are assigned in insertion order.
+        //
+        long stringsOffset = fileStream.Position;
+
+        WriteBlock(fileStream, compress, writer =>
+        {
+            writer.Write7BitEncodedInt(strings.Count);
+            foreach (var value in strings.Keys)
+            {
+                writer.Write(value);
+            }
+        });
+
+        long stringsSize = fileStream.Position - stringsOffset;
+        long skeletonOffset = fileStream.Position;
+
+        skeleton.Position = 0;
+        WriteBlock(fileStream, compress, writer => skeleton.CopyTo(writer.BaseStream));
+
+        long skeletonSize = fileStream.Position - skeletonOffset;
+
+        fileStream.Position = sizeof(uint) + sizeof(ushort) * 2;
+        header.Write(skeletonOffset);
+        header.Write(skeletonSize);
+        header.Write(stringsOffset);
+        header.Write(stringsSize);
+
+        return true;
+    }
+
+    /// <summary>
+    /// Loads session from file.
+    /// </summary>
+    /// <remarks>
+    /// Sessions of the current version keep the file mapped until <see cref="CDepends.DetachSessionFile"/>
+    /// is called, function lists are read on first access.
+    /// </remarks>
+    /// <param name="fileName">Session file name.</param>
+    /// <param name="updateStatusCallback">Optional status callback.</param>
+    /// <returns>Loaded session.</returns>
+    /// <exception cref="InvalidDataException">File is not a binary session or has unsupported version.</exception>
+    public static CDepends Load(string fileName, UpdateLoadStatusCallback updateStatusCallback)
+    {
+        updateStatusCallback?.Invoke($"Loading data from {fileName}");
+
+        var fileStream = new FileStream(
+            fileName,
+            FileMode.Open,
+            FileAccess.Read,
+            FileShare.Read,
+            bufferSize: 65536,
+            FileOptions.SequentialScan
+        );
+
+        try
+        {
+            using var header = new BinaryReader(fileStream, Encoding.UTF8, true);
+
+            if (header.ReadUInt32() != SessionMagic)
+                throw new InvalidDataException("Not a WinDepends session file");
+
+            ushort version = header.ReadUInt16();
+            ushort flags = header.ReadUInt16();
+
+            if (version != SessionVersion)
+                throw new InvalidDataException($"Unsupported session file version {version}");
+
+            long skeletonOffset = header.ReadInt64();
+            long skeletonSize = header.ReadInt64();
+            long stringsOffset = header.ReadInt64();
+            long stringsSize = header.ReadInt64();
+
+            // File stream is owned by the mapping from now on.
+            var session = LoadMapped(fileStream, flags, skeletonOffset, skeletonSize,
+                stringsOffset, stringsSize, updateStatusCallback);
+            fileStream = null;
+            return session;
+        }
+        finally
+        {
+            fileStream?.Dispose();
+        }
+    }
+
+    private static CDepends LoadMapped(FileStream fileStream, ushort flags, long skeletonOffset, long skeletonSize,
+        long stringsOffset, long stringsSize, UpdateLoadStatusCallback updateStatusCallback)
+    {
+        if (skeletonOffset <= 0 || skeletonSize <= 0 || skeletonOffset + skeletonSize > fileStream.Length ||
+            stringsOffset <= 0 || stringsSize <= 0 || stringsOffset + stringsSize > fileStream.Length)
+        {
+            throw new InvalidDataException("Invalid session file index");
+        }
+
+        var mappedFile = MemoryMappedFile.CreateFromFile(fileStream, null, 0,
+            MemoryMappedFileAccess.Read, HandleInheritability.None, false);
+
+        var sessionFile = new CSessionFile(mappedFile, fileStream.Length, flags);
+
+        try
+        {
+            updateStatusCallback?.Invoke("Reading session data, please wait");
+
+            CDepends session;
+
+            using (var reader = sessionFile.OpenBlock(stringsOffset, stringsSize))
+            {
+                sessionFile.SetStrings(ReadStringTable(reader));
+            }
+
+            using (var reader = sessionFile.OpenBlock(skeletonOffset, skeletonSize))
+            {
+                session = new SessionReader(reader, sessionFile, sessionFile.Strings).ReadSession();
+
+                int count = reader.Read7BitEncodedInt();
+                if (count < 0 || !CountFitsStream(reader, count, BlockIndexEntrySize))
+                    throw new InvalidDataException("Invalid session file index");
+
+                var blocks = new List<(long Offset, long Size)>(Math.Min(count, MaxPreallocatedCount));
+                for (int i = 0; i < count; i++)
+                {
+                    blocks.Add((reader.ReadInt64(), reader.ReadInt64()));
+                }
+
+                sessionFile.SetBlocks([.. blocks]);
+            }
+
+            session.SessionFile = sessionFile;
+            return session;
+        }
+        catch
+        {
+            sessionFile.Dispose();
+            throw;
+        }
+    }
+
+    /// <summary>
+    /// Writes block to the file, compressed if requested.
+    /// </summary>
+    private static void WriteBlock(FileStream fileStream, bool compress, Action<BinaryWriter> writeContent)
+    {
+        if (compress)
+        {
+            using var compressionStream = new BrotliStream(fileStream, CompressionLevel.Fastest, true);
+            using var writer = new BinaryWriter(compressionStream, Encoding.UTF8, true);
+            writeContent(writer);
+        }
+        else
+        {
+            using var writer = new BinaryWriter(fileStream, Encoding.UTF8, true);
+            writeContent(writer);
+        }
+    }
+
+    /// <summary>
+    /// Reads the string table shared by the skeleton and function blocks.
+    /// </summary>
+    private static List<string> ReadStringTable(BinaryReader reader)
+    {
+        int count = reader.Read7BitEncodedInt();
+        if (count < 0 || !CountFitsStream(reader, count, MinStringSize))
+            throw new InvalidDataException("Invalid session string table");
+
+        var strings = new List<string>(Math.Min(count, MaxPreallocatedCount));
+        for (int i = 0; i < count; i++)
+        {
+            strings.Add(reader.ReadString());
+        }
+
+        return strings;
+    }
+
+    /// <summary>
+    /// Reads function list of a block.
+    /// </summary>
+    internal static List<CFunction> ReadFunctionBlock(BinaryReader reader, List<string> strings)
+    {
+        return new SessionReader(reader, null, strings).ReadFunctions();
+    }
+
+    /// <summary>
+    /// Checks that count items of the given minimal size fit in the rest of the stream.
+    /// </summary>
+    /// <remarks>
+    /// Length of a decompressing stream is not known, the count is only limited by the
+    /// capacity reserved for it then and a truncated stream fails on read.
+    /// </remarks>
+    static bool CountFitsStream(BinaryReader reader, int count, int itemSize)
+    {
+        var stream = reader.BaseStream;
+
+        if (!stream.CanSeek)
+            return true;
+
+        return (long)count * itemSize <= stream.Length - stream.Position;
+    }
+
+    /// <summary>
+    /// Writes session parts, strings are added to the string table shared by all parts of the file.
+    /// </summary>
+    sealed class SessionWriter(BinaryWriter writer, Func<List<CFunction>, int> writeFunctionBlock,
+        Dictionary<string, int> strings)
+    {
+        readonly BinaryWriter _writer = writer;
+        readonly Func<List<CFunction>, int> _writeFunctionBlock = writeFunctionBlock;
+        readonly Dictionary<string, int> _strings = strings;
+        readonly Dictionary<CModuleData, int> _moduleData = new(ReferenceEqualityComparer.Instance);
+
+        public void WriteSession(CDepends session)
+        {
+            _writer.Write(session.IsSavedSessionView);
+            WriteString(session.SessionFileName);
+            _writer.Write(session.SessionNodeMaxDepth);
+
+            WriteCount(session.SystemInformation);
+            if (session.SystemInformation != null)
+            {
+                foreach (var element in session.SystemInformation)
+                {
+                    WriteString(element.Name);
+                    WriteString(element.Value);
+                }
+            }
+
+            WriteCount(session.ModuleAnalysisLog);
+            if (session.ModuleAnalysisLog != null)
+            {
+                foreach (var entry in session.ModuleAnalysisLog)
+                {
+                    WriteString(entry.LoggedMessage);
+                    _writer.Write(entry.EntryColor.ToArgb());
+                }
+            }
+
+            _writer.Write(session.RootModule != null);
+            if (session.RootModule != null)
+            {
+                WriteModule(session.RootModule);
+            }
+        }
+
+        void WriteModule(CModule module)
+        {
+            var flags = ModuleFlags.None;
+
+            if (module.IsProcessed) flags |= ModuleFlags.IsProcessed;
+            if (module.IsForward) flags |= ModuleFlags.IsForward;
+            if (module.IsDelayLoad) flags |= ModuleFlags.IsDelayLoad;
+            if (module.FileNotFound) flags |= ModuleFlags.FileNotFound;
+            if (module.IsInvalid) flags |= ModuleFlags.IsInvalid;
+            if (module.IsReproducibleBuild) flags |= ModuleFlags.IsReproducibleBuild;
+            if (module.IsApiSetContract) flags |= ModuleFlags.IsApiSetContract;
+            if (module.IsKernelModule) flags |= ModuleFlags.IsKernelModule;
+            if (module.IsDotNetModule) flags |= ModuleFlags.IsDotNetModule;
+            if (module.ExportContainErrors) flags |= ModuleFlags.ExportContainErrors;
+            if (module.OtherErrorsPresent) flags |= ModuleFlags.OtherErrorsPresent;
+            if (module.ForwardersExpanded) flags |= ModuleFlags.ForwardersExpanded;
+
+            _writer.Write((ushort)flags);
+            _writer.Write(module.InstanceId);
+            _writer.Write(module.OriginalInstanceId);
+            _writer.Write(module.ModuleImageIndex);
+            _writer.Write(module.Depth);
+            _writer.Write((uint)module.FileNameResolvedBy);
+            WriteString(module.FileName);
+            WriteString(module.RawFileName);
+            WriteString(module.ManifestData);
+
+            WriteModuleData(module.ModuleData);
+            WriteFunctionList(module.ParentImports);
+
+            WriteCount(module.ForwarderEntries);
+            if (module.ForwarderEntries != null)
+            {
+                foreach (var entry in module.ForwarderEntries)
+                {
+                    WriteString(entry.TargetModuleName);
+                    WriteString(entry.TargetFunctionName);
+                    _writer.Write(entry.TargetOrdinal);
+                }
+            }
+
+            WriteCount(module.Dependents);
+            if (module.Dependents != null)
+            {
+                foreach (var dependent in module.Dependents)
+                {
+                    WriteModule(dependent);
+                }
+            }
+        }
+
+        void WriteModuleData(CModuleData data)
+        {
+            if (data == null)
+            {
+                _writer.Write7BitEncodedInt(RefNull);
+                return;
+            }
+
+            // Duplicate module entries reference the same shared snapshot.
+            if (_moduleData.TryGetValue(data, out int id))
+            {
+                _writer.Write7BitEncodedInt(RefBase + id);
+                return;
+            }
+
+            _moduleData.Add(data, _moduleData.Count);
+            _writer.Write7BitEncodedInt(RefNew);
+
+            _writer.Write(data.IsShared);
+            _writer.Write(data.FileTimeStamp.ToBinary());
+            _writer.Write(data.LinkTimeStamp);
+            _writer.Write(data.FileSize);
+            _writer.Write((uint)data.Attributes);
+            _writer.Write(data.LinkChecksum);
+            _writer.Write(data.RealChecksum);
+            _writer.Write(data.Machine);
+            _writer.Write(data.Characteristics);
+            _writer.Write(data.DllCharacteristics);
+            _writer.Write(data.ExtendedCharacteristics);
+            _writer.Write(data.Subsystem);
+            _writer.Write(data.PreferredBase);
+            _writer.Write(data.VirtualSize);
+            WriteString(data.FileVersion);
+            WriteString(data.ProductVersion);
+            WriteString(data.ImageVersion);
+            WriteString(data.LinkerVersion);
+            WriteString(data.OSVersion);
+            WriteString(data.SubsystemVersion);
+            _writer.Write(data.ImageFixed);
+            _writer.Write(data.ImageDotNet);
+            _writer.Write(data.CorFlags);
+            WriteString(data.RuntimeVersion);
+            WriteString(data.FrameworkKind);
+            _writer.Write(data.IsSystemAssembly);
+            WriteString(data.ResolutionSource);
+            WriteString(data.ReferenceVersion);
+            WriteString(data.ReferencePublicKeyToken);
+            WriteString(data.ReferenceCulture);
+
+            WriteCount(data.DebugDirTypes);
+            if (data.DebugDirTypes != null)
+            {
+                foreach (var type in data.DebugDirTypes)
+                {
+                    _writer.Write(type);
+                }
+            }
+
+            WriteFunctionList(data.Exports);
+        }
+
+        /// <summary>
+        /// Writes function list of the skeleton as reference to a function block.
+        /// </summary>
+        void WriteFunctionList(List<CFunction> functions)
+        {
+            if (functions == null)
+            {
+                _writer.Write7BitEncodedInt(ListNull);
+            }
+            else if (functions.Count == 0)
+            {
+                _writer.Write7BitEncodedInt(ListEmpty);
+            }
+            else
+            {
+                _writer.Write7BitEncodedInt(ListBase + _writeFunctionBlock(functions));
+            }
+        }
+
+        public void WriteFunctions(List<CFunction> functions)
+        {
+            WriteCount(functions);
+            if (functions == null)
+                return;
+
+            foreach (var function in functions)
+            {
+                var flags = FunctionFlags.None;
+
+                if (function.IsExportFunction) flags |= FunctionFlags.IsExportFunction;
+                if (function.IsNameFromSymbols) flags |= FunctionFlags.IsNameFromSymbols;
+
+                _writer.Write((byte)flags);
+                _writer.Write((ushort)function.Kind);
+                _writer.Write(function.Ordinal);
+                _writer.Write(function.Hint);
+                _writer.Write(function.Address);
+                WriteString(function.RawName);
+                WriteString(function.ForwardName);
+                WriteString(function.UndecoratedName);
+            }
+        }
+
+        /// <summary>
+        /// Writes list length + 1, zero for null list.
+        /// </summary>
+        void WriteCount<T>(List<T> list)
+        {
+            _writer.Write7BitEncodedInt(list != null ? list.Count + 1 : 0);
+        }
+
+        void WriteString(string value)
+        {
+            if (value == null)
+            {
+                _writer.Write7BitEncodedInt(RefNull);
+                return;
+            }
+
+            if (!_strings.TryGetValue(value, out int id))
+            {
+                id = _strings.Count;
+                _strings.Add(value, id);
+            }
+
+            _writer.Write7BitEncodedInt(RefBase + id);
+        }
+    }
+
+    /// <summary>
+    /// Reads session parts, strings are resolved from the string table of the file.
+    /// </summary>
+    sealed class SessionReader(BinaryReader reader, CSessionFile sessionFile, List<string> strings)
+    {
+        readonly BinaryReader _reader = reader;
+        readonly CSessionFile _sessionFile = sessionFile;
+        readonly List<string> _strings = strings;
+        readonly List<CModuleData> _moduleData = [];
+
+        public CDepends ReadSession()
+        {
+            var session = new CDepends
+            {
+                IsSavedSessionView = _reader.ReadBoolean(),
+                SessionFileName = ReadString(),
+                SessionNodeMaxDepth = _reader.ReadInt32()
+            };
+
+            int count = ReadCount(out bool isNull, MinPropertySize);
+            session.SystemInformation = isNull ? null : new List<PropertyElement>(Capacity(count));
+            for (int i = 0; i < count; i++)
+            {
+                string name = ReadString();
+                session.SystemInformation.Add(new PropertyElement(name, ReadString()));
+            }
+
+            count = ReadCount(out isNull, MinLogEntrySize);
+            session.ModuleAnalysisLog = isNull ? null : new List<LogEntry>(Capacity(count));
+            for (int i = 0; i < count; i++)
+            {
+                string message = ReadString();
+                session.ModuleAnalysisLog.Add(new LogEntry(message, Color.FromArgb(_reader.ReadInt32())));
+            }
+
+            if (_reader.ReadBoolean())
+            {
+                session.RootModule = ReadModule(0);
+            }
+
+            return session;
+        }
+
+        CModule ReadModule(int depth)
+        {
+            if (depth > MaxModuleDepth)
+                throw new InvalidDataException("Module tree is nested too deep");
+
+            var flags = (ModuleFlags)_reader.ReadUInt16();
+
+            var module = new CModule
+            {
+                IsProcessed = flags.HasFlag(ModuleFlags.IsProcessed),
+                IsForward = flags.HasFlag(ModuleFlags.IsForward),
+                IsDelayLoad = flags.HasFlag(ModuleFlags.IsDelayLoad),
+                FileNotFound = flags.HasFlag(ModuleFlags.FileNotFound),
+                IsInvalid = flags.HasFlag(ModuleFlags.IsInvalid),
+                IsReproducibleBuild = flags.HasFlag(ModuleFlags.IsReproducibleBuild),
+                IsApiSetContract = flags.HasFlag(ModuleFlags.IsApiSetContract),
+                IsKernelModule = flags.HasFlag(ModuleFlags.IsKernelModule),
+                IsDotNetModule = flags.HasFlag(ModuleFlags.IsDotNetModule),
+                ExportContainErrors = flags.HasFlag(ModuleFlags.ExportContainErrors),
+                OtherErrorsPresent = flags.HasFlag(ModuleFlags.OtherErrorsPresent),
+                ForwardersExpanded = flags.HasFlag(ModuleFlags.ForwardersExpanded),
+                InstanceId = _reader.ReadInt32(),
+                OriginalInstanceId = _reader.ReadInt32(),
+                ModuleImageIndex = _reader.ReadInt32(),
+                Depth = _reader.ReadInt32(),
+                FileNameResolvedBy = (SearchOrderType)_reader.ReadUInt32(),
+                FileName = ReadString(),
+                RawFileName = ReadString(),
+                ManifestData = ReadString()
+            };
+
+            module.ModuleData = ReadModuleData();
+
+            ReadFunctionList(out var imports, out var importsBlock);
+            if (importsBlock != null)
+                module.SetDeferredParentImports(importsBlock);
+            else
+                module.ParentImports = imports;
+
+            int count = ReadCount(out bool isNull, MinForwarderSize);
+            module.ForwarderEntries = isNull ? null : new List<CForwarderEntry>(Capacity(count));
+            for (int i = 0; i < count; i++)
+            {
+                module.ForwarderEntries.Add(new CForwarderEntry
+                {
+                    TargetModuleName = ReadString(),
+                    TargetFunctionName = ReadString(),
+                    TargetOrdinal = _reader.ReadUInt32()
+                });
+            }
+
+            count = ReadCount(out isNull, MinModuleSize);
+            module.Dependents = isNull ? null : new List<CModule>(Capacity(count));
+            for (int i = 0; i < count; i++)
+            {
+                module.Dependents.Add(ReadModule(depth + 1));
+            }
+
+            return module;
+        }
+
+        CModuleData ReadModuleData()
+        {
+            int reference = _reader.Read7BitEncodedInt();
+
+            if (reference == RefNull)
+                return null;
+
+            if (reference != RefNew)
+            {
+                if (reference < RefBase || reference - RefBase >= _moduleData.Count)
+                    throw new InvalidDataException("Invalid module data reference");
+
+                return _moduleData[reference - RefBase];
+            }
+
+            bool isShared = _reader.ReadBoolean();
+
+            var data = new CModuleData
+            {
+                FileTimeStamp = DateTime.FromBinary(_reader.ReadInt64()),
+                LinkTimeStamp = _reader.ReadUInt32(),
+                FileSize = _reader.ReadUInt64(),
+                Attributes = (ModuleFileAttributes)_reader.ReadUInt32(),
+                LinkChecksum = _reader.ReadUInt32(),
+                RealChecksum = _reader.ReadUInt32(),
+                Machine = _reader.ReadUInt16(),
+                Characteristics = _reader.ReadUInt16(),
+                DllCharacteristics = _reader.ReadUInt16(),
+                ExtendedCharacteristics = _reader.ReadUInt32(),
+                Subsystem = _reader.ReadUInt16(),
+                PreferredBase = _reader.ReadUInt64(),
+                VirtualSize = _reader.ReadUInt32(),
+                FileVersion = ReadString(),
+                ProductVersion = ReadString(),
+                ImageVersion = ReadString(),
+                LinkerVersion = ReadString(),
+                OSVersion = ReadString(),
+                SubsystemVersion = ReadString(),
+                ImageFixed = _reader.ReadUInt32(),
+                ImageDotNet = _reader.ReadUInt32(),
+                CorFlags = _reader.ReadUInt32(),
+                RuntimeVersion = ReadString(),
+                FrameworkKind = ReadString(),
+                IsSystemAssembly = _reader.ReadBoolean(),
+                ResolutionSource = ReadString(),
+                ReferenceVersion = ReadString(),
+                ReferencePublicKeyToken = ReadString(),
+                ReferenceCulture = ReadString()
+            };
+
+            int count = ReadCount(out bool isNull, sizeof(uint));
+            data.DebugDirTypes = isNull ? null : new List<uint>(Capacity(count));
+            for (int i = 0; i < count; i++)
+            {
+                data.DebugDirTypes.Add(_reader.ReadUInt32());
+            }
+
+            ReadFunctionList(out var exports, out var exportsBlock);
+            if (exportsBlock != null)
+                data.SetDeferredExports(exportsBlock);
+            else
+                data.Exports = exports;
+
+            // Keep duplicates read-only, writers detach through CModule.GetWritableModuleData.
+            if (isShared)
+                data.MarkShared();
+
+            _moduleData.Add(data);
+            return data;
+        }
+
+        /// <summary>
+        /// Reads reference to a function block of the skeleton.
+        /// </summary>
+        void ReadFunctionList(out List<CFunction> functions, out CSessionFunctionBlock block)
+        {
+            functions = null;
+            block = null;
+
+            int reference = _reader.Read7BitEncodedInt();
+
+            if (reference == ListEmpty)
+                functions = [];
+            else if (reference >= ListBase)
+                block = new CSessionFunctionBlock(_sessionFile, reference - ListBase);
+            else if (reference != ListNull)
+                throw new InvalidDataException("Invalid function list reference");
+        }
+
+        public List<CFunction> ReadFunctions()
+        {
+            int count = ReadCount(out bool isNull, MinFunctionSize);
+            if (isNull)
+                return null;
+
+            var functions = new List<CFunction>(Capacity(count));
+
+            for (int i = 0; i < count; i++)
+            {
+                var flags = (FunctionFlags)_reader.ReadByte();
+
+                functions.Add(new CFunction
+                {
+                    IsExportFunction = flags.HasFlag(FunctionFlags.IsExportFunction),
+                    IsNameFromSymbols = flags.HasFlag(FunctionFlags.IsNameFromSymbols),
+                    Kind = (FunctionKind)_reader.ReadUInt16(),
+                    Ordinal = _reader.ReadUInt32(),
+                    Hint = _reader.ReadUInt32(),
+                    Address = _reader.ReadUInt64(),
+                    RawName = ReadString(),
+                    ForwardName = ReadString(),
+                    UndecoratedName = ReadString()
+                });
+            }
+
+            return functions;
+        }
+
+        /// <summary>
+        /// Reads list length written by WriteCount, rejecting lengths the rest of the stream cannot hold.
+        /// </summary>
+        int ReadCount(out bool isNull, int itemSize)
+        {
+            int value = _reader.Read7BitEncodedInt();
+
+            if (value < 0)
+                throw new InvalidDataException("Invalid list length");
+
+            isNull = value == 0;
+            int count = isNull ? 0 : value - 1;
+
+            if (!CountFitsStream(_reader, count, itemSize))
+                throw new InvalidDataException("Invalid list length");
+
+            return count;
+        }
+
+        static int Capacity(int count) => Math.Min(count, MaxPreallocatedCount);
+
+        string ReadString()
+        {
+            int reference = _reader.Read7BitEncodedInt();
+
+            if (reference == RefNull)
+                return null;
+
+            if (reference < RefBase || reference - RefBase >= _strings.Count)
+                throw new InvalidDataException("Invalid string reference");
+
+            return _strings[reference - RefBase];
+        }
+    }
+}
+
+/// <summary>
+/// Memory-mapped session file, source of function lists deferred by <see cref="CSessionSerializer"/>.
+/// </summary>
+internal sealed class CSessionFile : IDisposable
+{
+    readonly MemoryMappedFile _mappedFile;
+    readonly long _fileSize;
+    readonly bool _compressed;
+    readonly object _lock = new();
+    (long Offset, long Size)[] _blocks = [];
+    List<CFunction>[] _functions = [];
+    bool _disposed;
+
+    /// <summary>
+    /// String table shared by the skeleton and function blocks.
+    /// </summary>
+    internal List<string> Strings { get; private set; } = [];
+
+    internal CSessionFile(MemoryMappedFile mappedFile, long fileSize, ushort flags)
+    {
+        _mappedFile = mappedFile;
+        _fileSize = fileSize;
+        _compressed = (flags & CSessionSerializer.FlagCompressed) != 0;
+    }
+
+    internal void SetStrings(List<string> strings)
+    {
+        Strings = strings;
+    }
+
+    internal void SetBlocks((long Offset, long Size)[] blocks)
+    {
+        foreach (var (offset, size) in blocks)
+        {
+            if (offset <= 0 || size <= 0 || offset + size > _fileSize)
+                throw new InvalidDataException("Invalid session file index");
+        }
+
+        _blocks = blocks;
+        _functions = new List<CFunction>[blocks.Length];
+    }
+
+    /// <summary>
+    /// Opens reader over a block of the mapped file.
+    /// </summary>
+    internal BinaryReader OpenBlock(long offset, long size)
+    {
+        Stream stream = _mappedFile.CreateViewStream(offset, size, MemoryMappedFileAccess.Read);
+
+        if (_compressed)
+            stream = new BrotliStream(stream, CompressionMode.Decompress, false);
+
+        return new BinaryReader(stream, Encoding.UTF8, false);
+    }
+
+    /// <summary>
+    /// Returns function list of the block, reading it from the file on first request.
+    /// </summary>
+    internal List<CFunction> GetFunctions(int index)
+    {
+        lock (_lock)
+        {
+            ObjectDisposedException.ThrowIf(_disposed, this);
+
+            if ((uint)index >= (uint)_blocks.Length)
+                throw new InvalidDataException("Invalid function block reference");
+
+            var functions = _functions[index];
+            if (functions == null)
+            {
+                var (offset, size) = _blocks[index];
+
+                using var reader = OpenBlock(offset, size);
+                functions = CSessionSerializer.ReadFunctionBlock(reader, Strings);
+                _functions[index] = functions;
+            }
+
+            return functions;
+        }
+    }
+
+    public void Dispose()
+    {
+        lock (_lock)
+        {
+            if (_disposed)
+                return;
+
+            _disposed = true;
+            _functions = [];
+            Strings = [];
+            _mappedFile.Dispose();
+        }
+    }
+}
+
+/// <summary>
+/// Function list stored in a session file block, loaded on first access.
+/// </summary>
+internal sealed record CSessionFunctionBlock(CSessionFile SessionFile, int Index)
+{
+    /// <summary>
+    /// Reads the function list, a damaged or already released session file gives an empty list.
+    /// </summary>
+    public List<CFunction> Load()
+    {
+        try
+        {
+            return SessionFile.GetFunctions(Index);
+        }
+        catch (Exception ex) when (ex is InvalidDataException || ex is ObjectDisposedException || ex is IOException)
+        {
+            AppLogger.Log($"Error: Function list {Index} could not be read from session file because \"{ex.Message}\"",
+                LogMessageType.ErrorOrWarning);
+            return [];
+        }
+    }
+}
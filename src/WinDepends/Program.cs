@@ -6,7 +6,7 @@
 *
 *  VERSION:     1.00
 *
-*  DATE:        11 Feb 2026
+*  DATE:        18 Oct 2026
 *
 * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF
 * ANY KIND, EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED
@@ -55,8 +55,21 @@ internal static class Program
 
         SetCurrentProcessExplicitAppUserModelID("hfiref0x.WinDepends");
 
+        // Timeline of the whole GUI session, written when the program exits.
+        string traceFile = Environment.GetEnvironmentVariable(CConsts.TraceEnvironmentVariable);
+        if (!string.IsNullOrEmpty(traceFile))
+        {
+            CTraceRecorder.Start();
+        }
+
         Application.Run(new MainForm());
 
+        if (CTraceRecorder.Enabled)
+        {
+            CTraceRecorder.Stop();
+            CTraceRecorder.Save(traceFile);
+        }
+
         return 0;
     }
 }
@@ -1,12 +1,12 @@
 ﻿/*******************************************************************************
 *
-*  (C) COPYRIGHT AUTHORS, 2024 - 2025
+*  (C) COPYRIGHT AUTHORS, 2024 - 2026
 *
 *  TITLE:       CAPISETCACHEMANAGER.CS
 *
 *  VERSION:     1.00
 *
-*  DATE:        20 Dec 2025
+*  DATE:        18 Oct 2026
 *
 * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF
 * ANY KIND, EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED
@@ -26,16 +26,34 @@ static class CApiSetCacheManager
     }
 
     static readonly ConcurrentDictionary<string, ApiSetItem> apiSetCache = new();
+    static CApiSetNamespaceSnapshot namespaceSnapshot;
 
-    public static void AddApiSet(string apiSetName, string resolvedName)
+    /// <summary>
+    /// Snapshot of the active server Apiset namespace, null if not yet received.
+    /// </summary>
+    public static CApiSetNamespaceSnapshot NamespaceSnapshot
+    {
+        get => Volatile.Read(ref namespaceSnapshot);
+        set => Volatile.Write(ref namespaceSnapshot, value);
+    }
+
+    /// <summary>
+    /// Cache key of the contract, parent specific hosts are kept apart from the default host.
+    /// </summary>
+    static string GetCacheKey(string apiSetName, string parentName)
+    {
+        return string.IsNullOrEmpty(parentName) ? apiSetName : apiSetName + ":" + parentName;
+    }
+
+    public static void AddApiSet(string apiSetName, string parentName, string resolvedName)
     {
         var item = new ApiSetItem { ResolvedName = resolvedName };
-        apiSetCache.AddOrUpdate(apiSetName, item, (key, oldValue) => item);
+        apiSetCache.AddOrUpdate(GetCacheKey(apiSetName, parentName), item, (key, oldValue) => item);
     }
 
-    public static string GetResolvedNameByApiSetName(string apiSetName)
+    public static string GetResolvedNameByApiSetName(string apiSetName, string parentName)
     {
-        if (apiSetCache.TryGetValue(apiSetName, out var item))
+        if (apiSetCache.TryGetValue(GetCacheKey(apiSetName, parentName), out var item))
         {
             return item.ResolvedName;
         }
@@ -47,5 +65,6 @@ static class CApiSetCacheManager
     public static void ClearCache()
     {
         apiSetCache.Clear();
+        NamespaceSnapshot = null;
     }
 }
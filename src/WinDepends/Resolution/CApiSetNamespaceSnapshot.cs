@@ -0,0 +1,163 @@
+/*******************************************************************************
+*
+*  (C) COPYRIGHT AUTHORS, 2026
+*
+*  TITLE:       CAPISETNAMESPACESNAPSHOT.CS
+*
+*  VERSION:     1.00
+*
+*  DATE:        18 Oct 2026
+*
+*  Local copy of the server Apiset namespace used to resolve contracts
+*  without server round trips.
+*
+* THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF
+* ANY KIND, EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED
+* TO THE IMPLIED WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+*******************************************************************************/
+
+namespace WinDepends;
+
+/// <summary>
+/// Snapshot of the Apiset namespace built from the server "apisetdump" reply.
+/// </summary>
+/// <remarks>
+/// Lookup rules follow the server ApiSetResolveToHost* routines:
+/// V6 contracts are matched by the name part up to the last hyphen,
+/// V2/V4 contracts are matched by the name without prefix and ".dll" extension.
+/// </remarks>
+public sealed class CApiSetNamespaceSnapshot
+{
+    private sealed class ContractEntry
+    {
+        public string DefaultHost;
+        public Dictionary<string, string> ParentHosts;
+    }
+
+    const uint SchemaVersionV2 = 2;
+    const uint SchemaVersionV4 = 4;
+    const uint SchemaVersionV6 = 6;
+    const int PrefixLength = 4;     // "api-" or "ext-"
+    const int ExtensionLength = 4;  // ".dll"
+
+    private readonly Dictionary<string, ContractEntry> _contracts = new(StringComparer.OrdinalIgnoreCase);
+
+    /// <summary>
+    /// Apiset namespace schema version.
+    /// </summary>
+    public uint Version { get; }
+
+    /// <summary>
+    /// Count of contracts in the snapshot.
+    /// </summary>
+    public int Count => _contracts.Count;
+
+    private CApiSetNamespaceSnapshot(uint version)
+    {
+        Version = version;
+    }
+
+    /// <summary>
+    /// Builds snapshot from the server namespace dump.
+    /// </summary>
+    /// <param name="dump">Server reply.</param>
+    /// <returns>Snapshot or null if the dump is empty or of unsupported version.</returns>
+    public static CApiSetNamespaceSnapshot FromDump(CCoreApiSetDump dump)
+    {
+        if (dump?.Entries == null || dump.Entries.Count == 0)
+            return null;
+
+        if (dump.Version != SchemaVersionV2 && dump.Version != SchemaVersionV4 && dump.Version != SchemaVersionV6)
+            return null;
+
+        var snapshot = new CApiSetNamespaceSnapshot(dump.Version);
+
+        foreach (var entry in dump.Entries)
+        {
+            if (string.IsNullOrEmpty(entry.Name))
+                continue;
+
+            if (!snapshot._contracts.TryGetValue(entry.Name, out var contract))
+            {
+                contract = new ContractEntry();
+                snapshot._contracts[entry.Name] = contract;
+            }
+
+            if (string.IsNullOrEmpty(entry.Parent))
+            {
+                contract.DefaultHost = entry.Host;
+            }
+            else
+            {
+                contract.ParentHosts ??= new(StringComparer.OrdinalIgnoreCase);
+                contract.ParentHosts.TryAdd(entry.Parent, entry.Host);
+            }
+        }
+
+        return snapshot;
+    }
+
+    /// <summary>
+    /// Returns namespace lookup key for the contract name.
+    /// </summary>
+    /// <param name="apiSetName">Contract name, e.g. api-ms-win-core-file-l1-2-0.dll.</param>
+    /// <returns>Lookup key or null if name is not an Apiset contract.</returns>
+    private string GetLookupKey(string apiSetName)
+    {
+        if (apiSetName.Length < PrefixLength ||
+            (!apiSetName.StartsWith("api-", StringComparison.OrdinalIgnoreCase) &&
+             !apiSetName.StartsWith("ext-", StringComparison.OrdinalIgnoreCase)))
+        {
+            return null;
+        }
+
+        if (Version == SchemaVersionV6)
+        {
+            return apiSetName[..apiSetName.LastIndexOf('-')];
+        }
+
+        string name = apiSetName[PrefixLength..];
+        if (name.Length >= ExtensionLength && name[^ExtensionLength] == '.')
+        {
+            name = name[..^ExtensionLength];
+        }
+
+        return name;
+    }
+
+    /// <summary>
+    /// Resolves contract name to the host module name.
+    /// </summary>
+    /// <param name="apiSetName">Contract name.</param>
+    /// <param name="parentName">Optional importing module name.</param>
+    /// <param name="hostName">Host module name on success.</param>
+    /// <returns>True if contract is present and hosted, otherwise false.</returns>
+    public bool TryResolve(string apiSetName, string parentName, out string hostName)
+    {
+        hostName = null;
+
+        if (string.IsNullOrEmpty(apiSetName))
+            return false;
+
+        string key = GetLookupKey(apiSetName);
+        if (key == null || !_contracts.TryGetValue(key, out var contract))
+            return false;
+
+        if (!string.IsNullOrEmpty(parentName) && contract.ParentHosts != null)
+        {
+            // V4 schema does not fall back to default host for unknown parent.
+            if (!contract.ParentHosts.TryGetValue(parentName, out hostName) && Version != SchemaVersionV4)
+            {
+                hostName = contract.DefaultHost;
+            }
+        }
+        else
+        {
+            hostName = contract.DefaultHost;
+        }
+
+        return !string.IsNullOrEmpty(hostName);
+    }
+}
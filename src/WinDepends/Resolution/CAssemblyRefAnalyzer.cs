@@ -6,7 +6,7 @@
 *
 *  VERSION:     1.00
 *
-*  DATE:        16 Jul 2026
+*  DATE:        18 Oct 2026
 *
 * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF
 * ANY KIND, EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED
@@ -558,8 +558,10 @@ public static class CAssemblyRefAnalyzer
                 return false;
 
             var mdReader = peReader.GetMetadataReader();
+            var moduleData = module.GetWritableModuleData();
+
             runtimeVersion = mdReader.MetadataVersion;
-            module.ModuleData.RuntimeVersion = runtimeVersion;
+            moduleData.RuntimeVersion = runtimeVersion;
 
             var machine = peReader.PEHeaders.CoffHeader.Machine;
             switch (machine)
@@ -587,7 +589,7 @@ public static class CAssemblyRefAnalyzer
             if (corHeader != null)
             {
                 var flags = corHeader.Flags;
-                module.ModuleData.CorFlags = (uint)flags;
+                moduleData.CorFlags = (uint)flags;
 
                 if (machine == System.Reflection.PortableExecutable.Machine.I386 && (flags & CorFlags.ILOnly) != 0)
                 {
@@ -622,7 +624,7 @@ public static class CAssemblyRefAnalyzer
                     kind = DotNetAssemblyKind.NetCoreOrNet;
             }
 
-            module.ModuleData.FrameworkKind = kind.ToString();
+            moduleData.FrameworkKind = kind.ToString();
 
             foreach (var handle in mdReader.AssemblyReferences)
             {
@@ -0,0 +1,207 @@
+﻿/*******************************************************************************
+*
+*  (C) COPYRIGHT AUTHORS, 2026
+*
+*  TITLE:       CDIRECTORYPROBECACHE.CS
+*
+*  VERSION:     1.00
+*
+*  DATE:        18 Oct 2026
+*
+*  Directory listing cache used by module path resolution.
+*
+* THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF
+* ANY KIND, EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED
+* TO THE IMPLIED WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+*******************************************************************************/
+using System.Collections.Concurrent;
+
+namespace WinDepends;
+
+/// <summary>
+/// Caches file name listings of search directories so that path probes become hash lookups.
+/// </summary>
+/// <remarks>
+/// Each directory is enumerated once and reused for the whole scan. On the next scan the
+/// listing is kept only if the directory last write time did not change.
+/// </remarks>
+static class CDirectoryProbeCache
+{
+    private sealed class DirectoryListing
+    {
+        public HashSet<string> Files;
+        public DateTime LastWriteTimeUtc;
+        public int ScanId;
+    }
+
+    static readonly ConcurrentDictionary<string, DirectoryListing> listingCache = new(StringComparer.OrdinalIgnoreCase);
+    static readonly char[] nonCacheableChars = ['\\', '/', ':', '*', '?'];
+
+    static int currentScanId;
+    static long probeCount;
+    static long probesSaved;
+    static long directoriesEnumerated;
+
+    /// <summary>
+    /// Total count of file probes requested during current scan.
+    /// </summary>
+    public static long ProbeCount => Interlocked.Read(ref probeCount);
+
+    /// <summary>
+    /// Count of file probes answered from cached listings without touching the filesystem.
+    /// </summary>
+    public static long ProbesSaved => Interlocked.Read(ref probesSaved);
+
+    /// <summary>
+    /// Count of directories enumerated or revalidated during current scan.
+    /// </summary>
+    public static long DirectoriesEnumerated => Interlocked.Read(ref directoriesEnumerated);
+
+    /// <summary>
+    /// Starts a new scan: resets statistics and marks cached listings for revalidation.
+    /// </summary>
+    public static void BeginScan()
+    {
+        Interlocked.Increment(ref currentScanId);
+        Interlocked.Exchange(ref probeCount, 0);
+        Interlocked.Exchange(ref probesSaved, 0);
+        Interlocked.Exchange(ref directoriesEnumerated, 0);
+    }
+
+    /// <summary>
+    /// Drops all cached directory listings.
+    /// </summary>
+    public static void ClearCache()
+    {
+        listingCache.Clear();
+    }
+
+    /// <summary>
+    /// Checks whether the given file exists in the directory.
+    /// </summary>
+    /// <param name="fileSystem">Filesystem to probe.</param>
+    /// <param name="directory">Directory to probe.</param>
+    /// <param name="fileName">File name, may include a relative or absolute path.</param>
+    /// <param name="fullPath">Combined path when the file exists, otherwise an empty string.</param>
+    /// <returns>True if the file exists, otherwise false.</returns>
+    public static bool TryProbe(IResolverFileSystem fileSystem, string directory, string fileName, out string fullPath)
+    {
+        fullPath = string.Empty;
+
+        if (string.IsNullOrEmpty(directory) || string.IsNullOrEmpty(fileName))
+            return false;
+
+        Interlocked.Increment(ref probeCount);
+
+        string candidate = fileSystem.CombinePath(directory, fileName);
+
+        // Only plain file names can be answered from directory listing.
+        if (fileName.IndexOfAny(nonCacheableChars) >= 0)
+        {
+            if (!fileSystem.FileExists(candidate))
+                return false;
+
+            fullPath = candidate;
+            return true;
+        }
+
+        var listing = GetListing(fileSystem, directory, out bool cached);
+        if (listing == null)
+        {
+            if (!fileSystem.FileExists(candidate))
+                return false;
+
+            fullPath = candidate;
+            return true;
+        }
+
+        // First probe of a directory in the scan pays for its listing.
+        if (cached)
+            Interlocked.Increment(ref probesSaved);
+
+        if (!listing.Files.Contains(fileName))
+            return false;
+
+        fullPath = candidate;
+        return true;
+    }
+
+    /// <summary>
+    /// Returns listing for the directory, enumerating it if not cached or outdated.
+    /// </summary>
+    /// <param name="fileSystem">Filesystem to list.</param>
+    /// <param name="directory">Directory to list.</param>
+    /// <param name="cached">True if the listing was already checked during current scan and the filesystem was not touched.</param>
+    /// <returns>Listing or null if directory cannot be enumerated.</returns>
+    private static DirectoryListing GetListing(IResolverFileSystem fileSystem, string directory, out bool cached)
+    {
+        int scanId = Volatile.Read(ref currentScanId);
+
+        cached = false;
+
+        if (listingCache.TryGetValue(directory, out var listing) && listing.ScanId == scanId)
+        {
+            cached = true;
+            return listing.Files != null ? listing : null;
+        }
+
+        Interlocked.Increment(ref directoriesEnumerated);
+
+        DateTime lastWriteTime;
+        try
+        {
+            if (!fileSystem.DirectoryExists(directory))
+            {
+                // Missing directory behaves as empty one for the rest of the scan.
+                listing = new DirectoryListing { Files = [], ScanId = scanId };
+                listingCache[directory] = listing;
+                return listing;
+            }
+
+            lastWriteTime = fileSystem.GetDirectoryLastWriteTimeUtc(directory);
+        }
+        catch
+        {
+            lastWriteTime = DateTime.MinValue;
+        }
+
+        // Listing from previous scan is still valid if directory was not modified.
+        if (listing != null && listing.Files != null &&
+            lastWriteTime != DateTime.MinValue && listing.LastWriteTimeUtc == lastWriteTime)
+        {
+            listing.ScanId = scanId;
+            return listing;
+        }
+
+        HashSet<string> files = null;
+        try
+        {
+            files = new HashSet<string>(StringComparer.OrdinalIgnoreCase);
+            foreach (var name in fileSystem.EnumerateFileNames(directory))
+            {
+                files.Add(name);
+            }
+        }
+        catch (IOException)
+        {
+            files = null;
+        }
+        catch (UnauthorizedAccessException)
+        {
+            files = null;
+        }
+
+        // Null file set means directory cannot be listed, probes fall back to the filesystem.
+        listing = new DirectoryListing
+        {
+            Files = files,
+            LastWriteTimeUtc = lastWriteTime,
+            ScanId = scanId
+        };
+        listingCache[directory] = listing;
+
+        return files != null ? listing : null;
+    }
+}
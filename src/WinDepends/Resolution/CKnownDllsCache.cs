@@ -0,0 +1,143 @@
+﻿/*******************************************************************************
+*
+*  (C) COPYRIGHT AUTHORS, 2026
+*
+*  TITLE:       CKNOWNDLLSCACHE.CS
+*
+*  VERSION:     1.00
+*
+*  DATE:        18 Oct 2026
+*
+*  Persistent cache of KnownDlls lists received from the core server.
+*
+* THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF
+* ANY KIND, EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED
+* TO THE IMPLIED WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+*******************************************************************************/
+
+namespace WinDepends;
+
+/// <summary>
+/// KnownDlls lists of one server version.
+/// </summary>
+public sealed class CKnownDllsSet
+{
+    public string Version { get; init; } = string.Empty;
+    public string Path { get; init; } = string.Empty;
+    public string Path32 { get; init; } = string.Empty;
+    public List<string> Entries { get; init; } = [];
+    public List<string> Entries32 { get; init; } = [];
+}
+
+/// <summary>
+/// Keeps the last received KnownDlls lists in memory and on disk.
+/// </summary>
+/// <remarks>
+/// Server version is a hash of the lists content, so the cache stays valid across
+/// server and CLI restarts until KnownDlls change or another snapshot is loaded.
+/// </remarks>
+static class CKnownDllsCache
+{
+    const string SectionEntries = "[KnownDlls]";
+    const string SectionEntries32 = "[KnownDlls32]";
+
+    static readonly object cacheLock = new();
+    static CKnownDllsSet cachedSet;
+    static bool diskChecked;
+
+    static string CacheFilePath =>
+        System.IO.Path.Combine(System.IO.Path.GetTempPath(), $"{CConsts.ShortProgramName}.knowndlls.cache");
+
+    /// <summary>
+    /// Returns cached lists for the given server version.
+    /// </summary>
+    /// <param name="version">KnownDlls version reported by the server.</param>
+    /// <returns>Cached lists or null if cache is empty or outdated.</returns>
+    public static CKnownDllsSet TryGet(string version)
+    {
+        if (string.IsNullOrEmpty(version))
+            return null;
+
+        lock (cacheLock)
+        {
+            if (cachedSet == null && !diskChecked)
+            {
+                diskChecked = true;
+                cachedSet = LoadFromDisk();
+            }
+
+            return (cachedSet != null && cachedSet.Version.Equals(version, StringComparison.OrdinalIgnoreCase))
+                ? cachedSet : null;
+        }
+    }
+
+    /// <summary>
+    /// Remembers lists and writes them to the cache file.
+    /// </summary>
+    /// <param name="set">Lists to remember, must have version.</param>
+    public static void Store(CKnownDllsSet set)
+    {
+        if (set == null || string.IsNullOrEmpty(set.Version))
+            return;
+
+        lock (cacheLock)
+        {
+            cachedSet = set;
+            diskChecked = true;
+
+            try
+            {
+                using var writer = new StreamWriter(CacheFilePath, false);
+                writer.WriteLine(set.Version);
+                writer.WriteLine(set.Path);
+                writer.WriteLine(set.Path32);
+                writer.WriteLine(SectionEntries);
+                set.Entries.ForEach(writer.WriteLine);
+                writer.WriteLine(SectionEntries32);
+                set.Entries32.ForEach(writer.WriteLine);
+            }
+            catch (IOException) { }
+            catch (UnauthorizedAccessException) { }
+        }
+    }
+
+    private static CKnownDllsSet LoadFromDisk()
+    {
+        try
+        {
+            if (!File.Exists(CacheFilePath))
+                return null;
+
+            var lines = File.ReadAllLines(CacheFilePath);
+            if (lines.Length < 4 || lines[3] != SectionEntries)
+                return null;
+
+            var set = new CKnownDllsSet { Version = lines[0], Path = lines[1], Path32 = lines[2] };
+            var target = set.Entries;
+
+            for (int i = 4; i < lines.Length; i++)
+            {
+                if (lines[i] == SectionEntries32)
+                {
+                    target = set.Entries32;
+                }
+                else if (lines[i].Length > 0)
+                {
+                    target.Add(lines[i]);
+                }
+            }
+
+            return set;
+        }
+        catch (IOException)
+        {
+            return null;
+        }
+        catch (UnauthorizedAccessException)
+        {
+            return null;
+        }
+    }
+}
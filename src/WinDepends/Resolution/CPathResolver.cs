@@ -1,12 +1,12 @@
 ﻿/*******************************************************************************
 *
-*  (C) COPYRIGHT AUTHORS, 2024 - 2025
+*  (C) COPYRIGHT AUTHORS, 2024 - 2026
 *
 *  TITLE:       CPATHRESOLVER.CS
 *
 *  VERSION:     1.00
 *
-*  DATE:        24 Dec 2025
+*  DATE:        18 Oct 2026
 *
 * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF
 * ANY KIND, EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED
@@ -14,6 +14,7 @@
 * PARTICULAR PURPOSE.
 *
 *******************************************************************************/
+using System.Collections.Concurrent;
 using System.Reflection.PortableExecutable;
 using System.Text;
 
@@ -24,15 +25,31 @@ namespace WinDepends;
 /// </summary>
 public static class CPathResolver
 {
-    private const uint InitialSearchPathBufferSize = 2048;
-    private const uint MaxSearchPathBufferSize = (uint)int.MaxValue;
+    private static IResolverFileSystem _fileSystem = new CPhysicalFileSystem();
 
-    public static string WindowsDirectory { get; } = Environment.GetFolderPath(Environment.SpecialFolder.Windows);
-    public static string WinSxSDirectory { get; } = Path.Combine(Environment.GetFolderPath(Environment.SpecialFolder.Windows), CConsts.WinSxSDir);
-    public static string System16Directory { get; } = Path.Combine(Environment.GetFolderPath(Environment.SpecialFolder.Windows), CConsts.HostSys16Dir);
-    public static string System32Directory { get; } = Environment.GetFolderPath(Environment.SpecialFolder.System);
-    public static string SystemDriversDirectory { get; } = Path.Combine(Environment.GetFolderPath(Environment.SpecialFolder.System), CConsts.DriversDir);
-    public static string SysWowDirectory { get; } = Environment.GetFolderPath(Environment.SpecialFolder.SystemX86);
+    /// <summary>
+    /// Gets or sets filesystem and system directory inputs used for resolution.
+    /// Setting this property drops all cached listings and resolutions.
+    /// </summary>
+    public static IResolverFileSystem FileSystem
+    {
+        get => _fileSystem;
+        set
+        {
+            _fileSystem = value ?? new CPhysicalFileSystem();
+            CDirectoryProbeCache.ClearCache();
+            ClearResolutionCache();
+            ClearWinSxSSearchPathCache();
+            Initialized = false;
+        }
+    }
+
+    public static string WindowsDirectory => _fileSystem.WindowsDirectory;
+    public static string WinSxSDirectory => _fileSystem.CombinePath(_fileSystem.WindowsDirectory, CConsts.WinSxSDir);
+    public static string System16Directory => _fileSystem.CombinePath(_fileSystem.WindowsDirectory, CConsts.HostSys16Dir);
+    public static string System32Directory => _fileSystem.SystemDirectory;
+    public static string SystemDriversDirectory => _fileSystem.CombinePath(_fileSystem.SystemDirectory, CConsts.DriversDir);
+    public static string SysWowDirectory => _fileSystem.SystemX86Directory;
 
     public static bool Initialized { get; set; }
     public static string MainModuleFileName { get; private set; } = string.Empty;
@@ -40,10 +57,29 @@ public static class CPathResolver
     public static List<string> UserDirectoriesUM { get; set; } = [];
     public static List<string> UserDirectoriesKM { get; set; } = [];
 
-    public static string KnownDllsPath { get; set; } = string.Empty;
-    public static string KnownDllsPath32 { get; set; } = string.Empty;
-    public static string[] PathEnvironment { get; } =
-            (Environment.GetEnvironmentVariable("PATH") ?? string.Empty).Split(";", StringSplitOptions.RemoveEmptyEntries);
+    public static string KnownDllsPath
+    {
+        get => _knownDllsPath;
+        set
+        {
+            _knownDllsPath = value ?? string.Empty;
+            Interlocked.Increment(ref _knownDllsVersion);
+        }
+    }
+
+    public static string KnownDllsPath32
+    {
+        get => _knownDllsPath32;
+        set
+        {
+            _knownDllsPath32 = value ?? string.Empty;
+            Interlocked.Increment(ref _knownDllsVersion);
+        }
+    }
+
+    private static string _knownDllsPath = string.Empty;
+    private static string _knownDllsPath32 = string.Empty;
+    public static string[] PathEnvironment => _fileSystem.PathEnvironment;
     private static readonly List<string> _knownDllsList = [];
     private static readonly List<string> _knownDlls32List = [];
     private static HashSet<string> _knownDllsSet = new(StringComparer.OrdinalIgnoreCase);
@@ -55,6 +91,28 @@ public static class CPathResolver
     private static readonly Dictionary<string, string> _winsxsSearchPathCache = new(StringComparer.OrdinalIgnoreCase);
     private static readonly object _winsxsCacheLock = new();
 
+    // Memoised results of ResolvePathForModule for the current scan. The key holds every input
+    // the result depends on: import name, target architecture, resolution mode, the search order
+    // sequence with user directories, KnownDlls version and presence of the SearchPath fallback
+    // candidate. Application directory, activation context and filesystem are fixed until
+    // QueryFileInformation starts a new scan or FileSystem is replaced, both drop the table.
+    private readonly record struct ResolutionKey(string FileName, ushort Machine, bool NeedRedirection, bool KernelMode,
+        bool DeferDirectorySearch, bool SearchPathCandidate, string SearchOrder, long KnownDllsVersion);
+    private static readonly ConcurrentDictionary<ResolutionKey, (string Path, SearchOrderType Resolver)> _resolutionCache = new();
+    private static long _resolutionCacheHits;
+    private static long _resolutionCacheMisses;
+    private static long _knownDllsVersion;
+
+    /// <summary>
+    /// Count of module path resolutions answered from the memo table during current scan.
+    /// </summary>
+    public static long ResolutionCacheHits => Interlocked.Read(ref _resolutionCacheHits);
+
+    /// <summary>
+    /// Count of module path resolutions that performed the full search order walk during current scan.
+    /// </summary>
+    public static long ResolutionCacheMisses => Interlocked.Read(ref _resolutionCacheMisses);
+
     /// <summary>
     /// Gets or sets the list of known 64-bit DLLs. Setting this property updates the internal lookup cache.
     /// </summary>
@@ -78,6 +136,7 @@ public static class CPathResolver
             }
 
             _knownDllsSet = newSet;
+            Interlocked.Increment(ref _knownDllsVersion);
         }
     }
 
@@ -104,6 +163,7 @@ public static class CPathResolver
             }
 
             _knownDlls32Set = newSet;
+            Interlocked.Increment(ref _knownDllsVersion);
         }
     }
 
@@ -124,6 +184,7 @@ public static class CPathResolver
 
         _knownDllsSet = newSet;
         _knownDlls32Set = newSet32;
+        Interlocked.Increment(ref _knownDllsVersion);
     }
 
     public static void ClearWinSxSSearchPathCache()
@@ -134,6 +195,59 @@ public static class CPathResolver
         }
     }
 
+    /// <summary>
+    /// Drops memoised module path resolutions and resets hit statistics.
+    /// </summary>
+    public static void ClearResolutionCache()
+    {
+        _resolutionCache.Clear();
+        Interlocked.Exchange(ref _resolutionCacheHits, 0);
+        Interlocked.Exchange(ref _resolutionCacheMisses, 0);
+    }
+
+    /// <summary>
+    /// Builds resolution cache key text of the search order sequence.
+    /// User defined directories are included at their position, as they can be changed in place.
+    /// </summary>
+    /// <param name="searchOrder">Search order list.</param>
+    /// <param name="userDirectories">User defined directories of the resolution mode.</param>
+    /// <returns>Key text, empty for null list.</returns>
+    private static string GetSearchOrderKey(List<SearchOrderType> searchOrder, List<string> userDirectories)
+    {
+        if (searchOrder == null)
+            return string.Empty;
+
+        StringBuilder sb = new();
+        foreach (var entry in searchOrder)
+        {
+            sb.Append((int)entry).Append(';');
+            if (entry == SearchOrderType.UserDefinedDirectory && userDirectories != null)
+            {
+                foreach (var directory in userDirectories)
+                {
+                    sb.Append(directory).Append('|');
+                }
+            }
+        }
+
+        return sb.ToString();
+    }
+
+    /// <summary>
+    /// Removes SearchPath fallback candidate if it still holds the given path.
+    /// </summary>
+    private static void RemoveSearchPathCandidate(string fileName, string path)
+    {
+        lock (_winsxsCacheLock)
+        {
+            if (_winsxsSearchPathCache.TryGetValue(fileName, out string cached) &&
+                string.Equals(cached, path, StringComparison.OrdinalIgnoreCase))
+            {
+                _winsxsSearchPathCache.Remove(fileName);
+            }
+        }
+    }
+
     /// <summary>
     /// Queries information about the main module and initializes the resolver.
     /// </summary>
@@ -151,8 +265,12 @@ public static class CPathResolver
             return;
         }
 
-        // Clear cached non-WinSxS search path candidates for previous scan.
+        // Clear cached non-WinSxS search path candidates and resolutions for previous scan.
         ClearWinSxSSearchPathCache();
+        ClearResolutionCache();
+
+        // Revalidate directory listings cached by previous scan.
+        CDirectoryProbeCache.BeginScan();
 
         MainModuleFileName = module.FileName;
         CurrentDirectory = Path.GetDirectoryName(MainModuleFileName) ?? string.Empty;
@@ -180,15 +298,12 @@ public static class CPathResolver
     /// <returns>The full path if the file exists, otherwise an empty string.</returns>
     private static string CombineAndValidatePath(string directory, string fileName)
     {
-        string result;
-
         if (string.IsNullOrEmpty(directory) || string.IsNullOrEmpty(fileName))
             return string.Empty;
 
         try
         {
-            result = Path.Combine(directory, fileName);
-            return File.Exists(result) ? result : string.Empty;
+            return CDirectoryProbeCache.TryProbe(_fileSystem, directory, fileName, out string result) ? result : string.Empty;
         }
         catch
         {
@@ -354,6 +469,11 @@ public static class CPathResolver
             return string.Empty;
 
         dllsDir = Is64bitFile ? KnownDllsPath : KnownDllsPath32;
+
+        // KnownDlls directory not reported by the server, it is the system directory of the filesystem.
+        if (string.IsNullOrEmpty(dllsDir))
+            dllsDir = Is64bitFile ? System32Directory : SysWowDirectory;
+
         return CombineAndValidatePath(dllsDir, fileName);
     }
 
@@ -401,7 +521,7 @@ public static class CPathResolver
         // Search the exempt directories.
         foreach (var element in pathRedirectExempt)
         {
-            directoryPart = Path.Combine(WindowsDirectory, element);
+            directoryPart = _fileSystem.CombinePath(WindowsDirectory, element);
             if (filePath.Contains(directoryPart, StringComparison.OrdinalIgnoreCase))
             {
                 return filePath; // Leave as is if it contains exempt directory.
@@ -409,7 +529,7 @@ public static class CPathResolver
         }
 
         // Only checks for "windows\system32" bulk in a path.
-        directoryPart = Path.Combine(WindowsDirectory, CConsts.HostSysDir);
+        directoryPart = _fileSystem.CombinePath(WindowsDirectory, CConsts.HostSysDir);
         if (filePath.Contains(directoryPart, StringComparison.OrdinalIgnoreCase))
         {
             result = filePath.Replace(CConsts.HostSysDir, GetReplacementDirectory(cpuArchitecture), StringComparison.OrdinalIgnoreCase);
@@ -430,16 +550,16 @@ public static class CPathResolver
         // Opportunistic search, find the first matching file.
         // Fixme: properly handle file name generation?
         string dotLocalDir = $"{applicationName}.local";
-        if (!Directory.Exists(dotLocalDir))
+        if (!_fileSystem.DirectoryExists(dotLocalDir))
             return string.Empty;
 
         try
         {
-            string[] subdirectories = Directory.GetDirectories(dotLocalDir);
+            string[] subdirectories = _fileSystem.GetDirectories(dotLocalDir);
             foreach (string dir in subdirectories)
             {
-                string filePath = Path.Combine(dir, fileName);
-                if (File.Exists(filePath))
+                string filePath = CombineAndValidatePath(dir, fileName);
+                if (!string.IsNullOrEmpty(filePath))
                     return filePath;
             }
         }
@@ -468,81 +588,24 @@ public static class CPathResolver
         if (string.IsNullOrEmpty(fileName))
             return string.Empty;
 
-        if (ActCtxHelper == null)
+        string found = _fileSystem.SearchPath(fileName, ActCtxHelper);
+        if (string.IsNullOrEmpty(found))
             return string.Empty;
 
-        bool needsDeactivation = false;
-        IntPtr cookie = IntPtr.Zero;
-
-        try
+        // Check candidate to be from WinSxS.
+        if (found.IndexOf(WinSxSDirectory, StringComparison.OrdinalIgnoreCase) >= 0)
         {
-            if (ActCtxHelper.ActivateContext())
-            {
-                needsDeactivation = true;
-            }
-            else
-            {
-                // If activation failed, try deactivating current context
-                cookie = ActCtxHelper.DeactivateCurrentContext();
-                if (cookie == IntPtr.Zero)
-                    return string.Empty;
-            }
-
-            uint bufferSize = InitialSearchPathBufferSize;
-            StringBuilder path = new((int)bufferSize);
-
-            uint charsCopied = NativeMethods.SearchPath(null, fileName, null, bufferSize, path, out _);
-            if (charsCopied > bufferSize)
-            {
-                if (charsCopied > MaxSearchPathBufferSize)
-                    return string.Empty;
-
-                // Buffer was too small
-                path.Capacity = (int)charsCopied;
-                charsCopied = NativeMethods.SearchPath(null, fileName, null, charsCopied, path, out _);
-            }
-
-            if (charsCopied == 0)
-                return string.Empty;
-
-            string found = path.ToString(0, (int)charsCopied);
-
-            // Check candidate to be from WinSxS.
-            if (!string.IsNullOrEmpty(found) &&
-                found.IndexOf(WinSxSDirectory, StringComparison.OrdinalIgnoreCase) >= 0)
-            {
-                // Candidate from WinSxS, allow it as result.
-                return found;
-            }
-
-            // Candidate not from WinSxS: cache it for later fallback and do not return it now.
-            lock (_winsxsCacheLock)
-            {
-                _winsxsSearchPathCache[fileName] = found;
-            }
-
-            return string.Empty;
-
+            // Candidate from WinSxS, allow it as result.
+            return found;
         }
-        catch (OutOfMemoryException)
-        {
-            return string.Empty;
-        }
-        catch (System.ComponentModel.Win32Exception)
-        {
-            return string.Empty;
-        }
-        finally
+
+        // Candidate not from WinSxS: cache it for later fallback and do not return it now.
+        lock (_winsxsCacheLock)
         {
-            if (needsDeactivation)
-            {
-                ActCtxHelper.DeactivateContext();
-            }
-            else if (cookie != IntPtr.Zero)
-            {
-                ActCtxHelper.ReactivateContext(cookie);
-            }
+            _winsxsSearchPathCache[fileName] = found;
         }
+
+        return string.Empty;
     }
 
     /// <summary>
@@ -551,12 +614,14 @@ public static class CPathResolver
     /// <param name="fileName">The file name to resolve.</param>
     /// <param name="searchOrderKM">Kernel mode search order list.</param>
     /// <param name="is64bitMachine">True if the target is 64-bit architecture.</param>
+    /// <param name="deferredSearchStart">Index of the first search order entry left to the server.</param>
     /// <param name="resolver">Output parameter indicating which resolver found the file.</param>
     /// <returns>The resolved path if found, otherwise an empty string.</returns>
     private static string ResolveKernelModulePath(
         string fileName,
         List<SearchOrderType> searchOrderKM,
         bool is64bitMachine,
+        int deferredSearchStart,
         out SearchOrderType resolver)
     {
         string result;
@@ -565,8 +630,13 @@ public static class CPathResolver
         if (searchOrderKM == null)
             return string.Empty;
 
-        foreach (var searchOrder in searchOrderKM)
+        for (int i = 0; i < searchOrderKM.Count; i++)
         {
+            // Remaining directories are probed by the server.
+            if (i == deferredSearchStart)
+                return string.Empty;
+
+            var searchOrder = searchOrderKM[i];
             result = searchOrder switch
             {
                 SearchOrderType.SystemDriversDirectory => PathFromSystemDriversDirectory(fileName),
@@ -646,6 +716,7 @@ public static class CPathResolver
     /// <param name="is64bitMachine">True if the target is 64-bit architecture.</param>
     /// <param name="needRedirection">True if architecture redirection is needed.</param>
     /// <param name="moduleMachine">The module's machine type.</param>
+    /// <param name="deferredSearchStart">Index of the first search order entry left to the server.</param>
     /// <param name="resolver">Output parameter indicating which resolver found the file.</param>
     /// <returns>The resolved path if found, otherwise an empty string.</returns>
     private static string ResolveUserModulePath(
@@ -654,6 +725,7 @@ public static class CPathResolver
         bool is64bitMachine,
         bool needRedirection,
         ushort moduleMachine,
+        int deferredSearchStart,
         out SearchOrderType resolver)
     {
         string result;
@@ -674,7 +746,7 @@ public static class CPathResolver
                     string full = Path.GetFullPath(direct);
 
                     // Only short-circuit if the file actually exists.
-                    if (File.Exists(full))
+                    if (_fileSystem.FileExists(full))
                     {
                         // Prefer to mark as ApplicationDirectory only when the file is in current application directory.
                         string dir = Path.GetDirectoryName(full) ?? string.Empty;
@@ -703,8 +775,14 @@ public static class CPathResolver
         if (searchOrderUM == null)
             return string.Empty;
 
-        foreach (var searchOrder in searchOrderUM)
+        for (int i = 0; i < searchOrderUM.Count; i++)
         {
+            // Remaining directories are probed by the server, unless SearchPath fallback
+            // candidate must be checked after them.
+            if (i == deferredSearchStart && !HasSearchPathCandidate(fileName))
+                return string.Empty;
+
+            var searchOrder = searchOrderUM[i];
             result = ResolveBySearchOrder(searchOrder, fileName, is64bitMachine, needRedirection);
             if (!string.IsNullOrEmpty(result))
             {
@@ -738,6 +816,181 @@ public static class CPathResolver
         return string.Empty;
     }
 
+    /// <summary>
+    /// Checks whether paths for the given machine type need architecture redirection on this system.
+    /// </summary>
+    /// <param name="moduleMachine">The module's machine type.</param>
+    /// <returns>True if module architecture differs from the system one, otherwise false.</returns>
+    private static bool IsArchRedirectionRequired(ushort moduleMachine)
+    {
+        return CUtils.SystemProcessorArchitecture switch
+        {
+            NativeMethods.PROCESSOR_ARCHITECTURE_INTEL => moduleMachine != (ushort)Machine.I386,
+            NativeMethods.PROCESSOR_ARCHITECTURE_AMD64 => moduleMachine != (ushort)Machine.Amd64,
+            NativeMethods.PROCESSOR_ARCHITECTURE_IA64 => moduleMachine != (ushort)Machine.IA64,
+            NativeMethods.PROCESSOR_ARCHITECTURE_ARM64 => moduleMachine != (ushort)Machine.Arm64,
+            _ => false,
+        };
+    }
+
+    /// <summary>
+    /// Checks whether a search order entry only probes fixed directories.
+    /// </summary>
+    /// <param name="searchOrder">Search order entry.</param>
+    /// <param name="kernelMode">True for kernel mode search order.</param>
+    /// <returns>True if the entry can be expressed as a directory list, entries ignored in the mode included.</returns>
+    private static bool IsDirectorySearchOrder(SearchOrderType searchOrder, bool kernelMode)
+    {
+        return kernelMode || (searchOrder != SearchOrderType.WinSXS && searchOrder != SearchOrderType.KnownDlls);
+    }
+
+    /// <summary>
+    /// Checks whether SearchPath returned a fallback candidate for the file name.
+    /// </summary>
+    private static bool HasSearchPathCandidate(string fileName)
+    {
+        lock (_winsxsCacheLock)
+        {
+            return _winsxsSearchPathCache.ContainsKey(fileName);
+        }
+    }
+
+    /// <summary>
+    /// Expands directory based search order entries starting at the given index.
+    /// </summary>
+    /// <param name="searchOrderList">Search order list.</param>
+    /// <param name="start">Index of the first entry to expand.</param>
+    /// <param name="kernelMode">True for kernel mode search order.</param>
+    /// <param name="is64bitMachine">True if the target is 64-bit architecture.</param>
+    /// <returns>Directories in probe order, or null if any of them cannot be passed to the server.</returns>
+    private static List<(string Directory, SearchOrderType SearchOrder)> ExpandSearchDirectories(
+        List<SearchOrderType> searchOrderList,
+        int start,
+        bool kernelMode,
+        bool is64bitMachine)
+    {
+        List<(string Directory, SearchOrderType SearchOrder)> directories = [];
+
+        void Add(IEnumerable<string> paths, SearchOrderType searchOrder)
+        {
+            foreach (var path in paths)
+            {
+                if (!string.IsNullOrEmpty(path))
+                    directories.Add((path, searchOrder));
+            }
+        }
+
+        for (int i = start; i < searchOrderList.Count; i++)
+        {
+            var searchOrder = searchOrderList[i];
+
+            switch (searchOrder)
+            {
+                case SearchOrderType.ApplicationDirectory:
+                    Add([CurrentDirectory], searchOrder);
+                    break;
+                case SearchOrderType.System32Directory:
+                    Add([is64bitMachine ? System32Directory : SysWowDirectory], searchOrder);
+                    break;
+                case SearchOrderType.SystemDriversDirectory when kernelMode:
+                    Add([SystemDriversDirectory], searchOrder);
+                    break;
+                case SearchOrderType.WindowsDirectory when !kernelMode:
+                    Add([WindowsDirectory], searchOrder);
+                    break;
+                case SearchOrderType.SystemDirectory when !kernelMode:
+                    Add([System16Directory], searchOrder);
+                    break;
+                case SearchOrderType.EnvironmentPathDirectories when !kernelMode:
+                    Add(PathEnvironment, searchOrder);
+                    break;
+                case SearchOrderType.UserDefinedDirectory:
+                    Add((kernelMode ? UserDirectoriesKM : UserDirectoriesUM) ?? [], searchOrder);
+                    break;
+            }
+        }
+
+        // Semicolon separates directories in the server request.
+        return directories.Exists(entry => entry.Directory.Contains(';')) ? null : directories;
+    }
+
+    /// <summary>
+    /// Finds the trailing part of the search order that can be left to the server.
+    /// </summary>
+    /// <param name="searchOrderList">Search order list.</param>
+    /// <param name="kernelMode">True for kernel mode search order.</param>
+    /// <param name="is64bitMachine">True if the target is 64-bit architecture.</param>
+    /// <returns>Index of the first deferred entry, list count if nothing can be deferred.</returns>
+    private static int GetDeferredSearchStart(List<SearchOrderType> searchOrderList, bool kernelMode, bool is64bitMachine)
+    {
+        int start = searchOrderList.Count;
+
+        // Only directories after the last name based entry (WinSxS, KnownDlls) keep their precedence.
+        while (start > 0 && IsDirectorySearchOrder(searchOrderList[start - 1], kernelMode))
+            start--;
+
+        if (ExpandSearchDirectories(searchOrderList, start, kernelMode, is64bitMachine) == null)
+            return searchOrderList.Count;
+
+        return start;
+    }
+
+    /// <summary>
+    /// Returns directories left to the server by <see cref="ResolvePathForModule"/> with directory search deferred.
+    /// </summary>
+    /// <param name="parentModule">The parent module whose dependents are being opened.</param>
+    /// <param name="searchOrderUM">User mode search order list.</param>
+    /// <param name="searchOrderKM">Kernel mode search order list.</param>
+    /// <returns>Directories in probe order with their search order entry, empty if nothing was deferred.</returns>
+    /// <remarks>
+    /// Used for server side lookup of unresolved modules. Cross-architecture modules need path
+    /// redirection and are always resolved on the client.
+    /// </remarks>
+    static internal List<(string Directory, SearchOrderType SearchOrder)> GetSearchDirectories(CModule parentModule,
+        List<SearchOrderType> searchOrderUM,
+        List<SearchOrderType> searchOrderKM)
+    {
+        if (parentModule == null || IsArchRedirectionRequired(parentModule.ModuleData.Machine))
+            return [];
+
+        bool is64bitMachine = parentModule.Is64bitArchitecture();
+        bool kernelMode = parentModule.IsKernelModule;
+        var searchOrderList = kernelMode ? searchOrderKM : searchOrderUM;
+
+        if (searchOrderList == null)
+            return [];
+
+        int start = GetDeferredSearchStart(searchOrderList, kernelMode, is64bitMachine);
+
+        return ExpandSearchDirectories(searchOrderList, start, kernelMode, is64bitMachine) ?? [];
+    }
+
+    /// <summary>
+    /// Probes the given directories in order on the client.
+    /// </summary>
+    /// <param name="fileName">The file name to search for.</param>
+    /// <param name="directories">Directories returned by <see cref="GetSearchDirectories"/>.</param>
+    /// <param name="resolver">Search order entry of the directory where the file was found.</param>
+    /// <returns>The full path if found, otherwise an empty string.</returns>
+    static internal string PathFromSearchDirectories(string fileName,
+        IReadOnlyList<(string Directory, SearchOrderType SearchOrder)> directories,
+        out SearchOrderType resolver)
+    {
+        resolver = SearchOrderType.None;
+
+        foreach (var (directory, searchOrder) in directories)
+        {
+            string result = CombineAndValidatePath(directory, fileName);
+            if (!string.IsNullOrEmpty(result))
+            {
+                resolver = searchOrder;
+                return result;
+            }
+        }
+
+        return string.Empty;
+    }
+
     /// <summary>
     /// Resolves the full path for a module based on search order rules.
     /// </summary>
@@ -746,12 +999,17 @@ public static class CPathResolver
     /// <param name="searchOrderUM">User mode search order list.</param>
     /// <param name="searchOrderKM">Kernel mode search order list.</param>
     /// <param name="resolver">Output parameter indicating which resolver found the file.</param>
+    /// <param name="deferDirectorySearch">
+    /// Leave the trailing directory entries of the search order to the server "openresolve" command,
+    /// see <see cref="GetSearchDirectories"/>.
+    /// </param>
     /// <returns>The fully resolved path if found, otherwise an empty string.</returns>
     static internal string ResolvePathForModule(string partiallyResolvedFileName,
                                                 CModule parentModule,
                                                 List<SearchOrderType> searchOrderUM,
                                                 List<SearchOrderType> searchOrderKM,
-                                                out SearchOrderType resolver)
+                                                out SearchOrderType resolver,
+                                                bool deferDirectorySearch = false)
     {
         bool is64bitMachine, needRedirection;
         ushort moduleMachine;
@@ -763,28 +1021,62 @@ public static class CPathResolver
 
         is64bitMachine = parentModule.Is64bitArchitecture();
         moduleMachine = parentModule.ModuleData.Machine;
+        needRedirection = IsArchRedirectionRequired(moduleMachine);
+
+        bool kernelMode = !needRedirection && parentModule.IsKernelModule;
+        var searchOrderList = kernelMode ? searchOrderKM : searchOrderUM;
+
+        deferDirectorySearch = deferDirectorySearch && !needRedirection && searchOrderList != null;
+
+        ResolutionKey key = new(partiallyResolvedFileName.ToLowerInvariant(),
+            moduleMachine,
+            needRedirection,
+            kernelMode,
+            deferDirectorySearch,
+            HasSearchPathCandidate(partiallyResolvedFileName),
+            GetSearchOrderKey(searchOrderList, kernelMode ? UserDirectoriesKM : UserDirectoriesUM),
+            Interlocked.Read(ref _knownDllsVersion));
 
-        needRedirection = CUtils.SystemProcessorArchitecture switch
+        if (_resolutionCache.TryGetValue(key, out var cached))
         {
-            NativeMethods.PROCESSOR_ARCHITECTURE_INTEL => moduleMachine != (ushort)Machine.I386,
-            NativeMethods.PROCESSOR_ARCHITECTURE_AMD64 => moduleMachine != (ushort)Machine.Amd64,
-            NativeMethods.PROCESSOR_ARCHITECTURE_IA64 => moduleMachine != (ushort)Machine.IA64,
-            NativeMethods.PROCESSOR_ARCHITECTURE_ARM64 => moduleMachine != (ushort)Machine.Arm64,
-            _ => false,
-        };
+            Interlocked.Increment(ref _resolutionCacheHits);
+            resolver = cached.Resolver;
 
-        // KM module resolving.
-        if (!needRedirection && parentModule.IsKernelModule)
+            // Replay consumption of the SearchPath fallback candidate done by the full walk.
+            if (resolver == SearchOrderType.WinSXS)
+            {
+                RemoveSearchPathCandidate(partiallyResolvedFileName, cached.Path);
+            }
+
+            return cached.Path;
+        }
+
+        Interlocked.Increment(ref _resolutionCacheMisses);
+
+        string result;
+        int deferredSearchStart = deferDirectorySearch ?
+            GetDeferredSearchStart(searchOrderList, kernelMode, is64bitMachine) :
+            int.MaxValue;
+
+        if (kernelMode)
+        {
+            // KM module resolving.
+            result = ResolveKernelModulePath(partiallyResolvedFileName, searchOrderKM, is64bitMachine,
+                deferredSearchStart, out resolver);
+        }
+        else
         {
-            return ResolveKernelModulePath(partiallyResolvedFileName, searchOrderKM, is64bitMachine, out resolver);
+            // UM module resolving.
+            result = ResolveUserModulePath(partiallyResolvedFileName,
+                searchOrderUM,
+                is64bitMachine,
+                needRedirection,
+                moduleMachine,
+                deferredSearchStart,
+                out resolver);
         }
 
-        // UM module resolving.
-        return ResolveUserModulePath(partiallyResolvedFileName,
-            searchOrderUM,
-            is64bitMachine,
-            needRedirection,
-            moduleMachine,
-            out resolver);
+        _resolutionCache[key] = (result, resolver);
+        return result;
     }
 }
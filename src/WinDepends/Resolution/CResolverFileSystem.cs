@@ -0,0 +1,413 @@
+﻿/*******************************************************************************
+*
+*  (C) COPYRIGHT AUTHORS, 2026
+*
+*  TITLE:       CRESOLVERFILESYSTEM.CS
+*
+*  VERSION:     1.00
+*
+*  DATE:        18 Oct 2026
+*
+*  Filesystem and system directory inputs of module path resolution.
+*
+* THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF
+* ANY KIND, EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED
+* TO THE IMPLIED WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+*******************************************************************************/
+using System.Text;
+
+namespace WinDepends;
+
+/// <summary>
+/// Filesystem and system directory inputs used by <see cref="CPathResolver"/>.
+/// </summary>
+public interface IResolverFileSystem
+{
+    /// <summary>
+    /// Windows directory, e.g. C:\Windows.
+    /// </summary>
+    string WindowsDirectory { get; }
+
+    /// <summary>
+    /// Native system directory, e.g. C:\Windows\System32.
+    /// </summary>
+    string SystemDirectory { get; }
+
+    /// <summary>
+    /// 32-bit system directory, e.g. C:\Windows\SysWOW64.
+    /// </summary>
+    string SystemX86Directory { get; }
+
+    /// <summary>
+    /// Directories listed in the PATH environment variable.
+    /// </summary>
+    string[] PathEnvironment { get; }
+
+    bool FileExists(string path);
+    bool DirectoryExists(string path);
+    DateTime GetDirectoryLastWriteTimeUtc(string path);
+    string[] GetDirectories(string path);
+
+    /// <summary>
+    /// Enumerates names of files in the directory, without directory part.
+    /// </summary>
+    IEnumerable<string> EnumerateFileNames(string path);
+
+    /// <summary>
+    /// Combines directory and file name using separators of the filesystem.
+    /// </summary>
+    string CombinePath(string directory, string fileName);
+
+    /// <summary>
+    /// Searches for the file as SearchPath does under the application activation context.
+    /// </summary>
+    /// <param name="fileName">File name to search for.</param>
+    /// <param name="actCtxHelper">Activation context of the application, may be null.</param>
+    /// <returns>Full path of the file, or an empty string if not found.</returns>
+    string SearchPath(string fileName, CActCtxHelper actCtxHelper);
+}
+
+/// <summary>
+/// Resolver inputs backed by the real filesystem and process environment.
+/// </summary>
+public sealed class CPhysicalFileSystem : IResolverFileSystem
+{
+    public string WindowsDirectory { get; } = Environment.GetFolderPath(Environment.SpecialFolder.Windows);
+    public string SystemDirectory { get; } = Environment.GetFolderPath(Environment.SpecialFolder.System);
+    public string SystemX86Directory { get; } = Environment.GetFolderPath(Environment.SpecialFolder.SystemX86);
+    public string[] PathEnvironment { get; } =
+        (Environment.GetEnvironmentVariable("PATH") ?? string.Empty).Split(";", StringSplitOptions.RemoveEmptyEntries);
+
+    private const uint InitialSearchPathBufferSize = 2048;
+    private const uint MaxSearchPathBufferSize = (uint)int.MaxValue;
+
+    public bool FileExists(string path) => File.Exists(path);
+    public bool DirectoryExists(string path) => Directory.Exists(path);
+    public DateTime GetDirectoryLastWriteTimeUtc(string path) => Directory.GetLastWriteTimeUtc(path);
+    public string[] GetDirectories(string path) => Directory.GetDirectories(path);
+    public IEnumerable<string> EnumerateFileNames(string path) => Directory.EnumerateFiles(path).Select(Path.GetFileName);
+    public string CombinePath(string directory, string fileName) => Path.Combine(directory, fileName);
+
+    public string SearchPath(string fileName, CActCtxHelper actCtxHelper)
+    {
+        if (string.IsNullOrEmpty(fileName) || actCtxHelper == null)
+            return string.Empty;
+
+        bool needsDeactivation = false;
+        IntPtr cookie = IntPtr.Zero;
+
+        try
+        {
+            if (actCtxHelper.ActivateContext())
+            {
+                needsDeactivation = true;
+            }
+            else
+            {
+                // If activation failed, try deactivating current context
+                cookie = actCtxHelper.DeactivateCurrentContext();
+                if (cookie == IntPtr.Zero)
+                    return string.Empty;
+            }
+
+            uint bufferSize = InitialSearchPathBufferSize;
+            StringBuilder path = new((int)bufferSize);
+
+            uint charsCopied = NativeMethods.SearchPath(null, fileName, null, bufferSize, path, out _);
+            if (charsCopied > bufferSize)
+            {
+                if (charsCopied > MaxSearchPathBufferSize)
+                    return string.Empty;
+
+                // Buffer was too small
+                path.Capacity = (int)charsCopied;
+                charsCopied = NativeMethods.SearchPath(null, fileName, null, charsCopied, path, out _);
+            }
+
+            return charsCopied == 0 ? string.Empty : path.ToString(0, (int)charsCopied);
+        }
+        catch (OutOfMemoryException)
+        {
+            return string.Empty;
+        }
+        catch (System.ComponentModel.Win32Exception)
+        {
+            return string.Empty;
+        }
+        finally
+        {
+            if (needsDeactivation)
+            {
+                actCtxHelper.DeactivateContext();
+            }
+            else if (cookie != IntPtr.Zero)
+            {
+                actCtxHelper.ReactivateContext(cookie);
+            }
+        }
+    }
+}
+
+/// <summary>
+/// In-memory resolver inputs, allows resolution rules to be exercised without touching the host filesystem.
+/// </summary>
+/// <remarks>
+/// Paths are compared case-insensitively using Windows separators, forward slashes and repeated
+/// separators are normalized on every call, so results do not depend on the host platform.
+/// Directories are created implicitly for every added file. Each modification updates last write
+/// time of the affected directory, so cached listings are revalidated the same way as on a real volume.
+/// SearchPath only returns files registered with <see cref="AddActivationContextFile"/>, the
+/// standard search directories are probed by the resolver itself.
+/// </remarks>
+public sealed class CMemoryFileSystem : IResolverFileSystem
+{
+    private sealed class DirectoryEntry
+    {
+        public readonly HashSet<string> Files = new(StringComparer.OrdinalIgnoreCase);
+        public readonly HashSet<string> Directories = new(StringComparer.OrdinalIgnoreCase);
+        public DateTime LastWriteTimeUtc;
+    }
+
+    private readonly Dictionary<string, DirectoryEntry> _directories = new(StringComparer.OrdinalIgnoreCase);
+    private readonly Dictionary<string, string> _activationContextFiles = new(StringComparer.OrdinalIgnoreCase);
+    private readonly object _lock = new();
+    private long _tick;
+
+    public string WindowsDirectory { get; }
+    public string SystemDirectory { get; }
+    public string SystemX86Directory { get; }
+    private string[] _pathEnvironment = [];
+
+    public string[] PathEnvironment
+    {
+        get => _pathEnvironment;
+        set => _pathEnvironment = value?.Select(NormalizePath).ToArray() ?? [];
+    }
+
+    /// <summary>
+    /// Initializes a new in-memory filesystem with the given system directories.
+    /// </summary>
+    /// <param name="windowsDirectory">Windows directory.</param>
+    /// <param name="systemDirectory">Native system directory, defaults to Windows\System32.</param>
+    /// <param name="systemX86Directory">32-bit system directory, defaults to Windows\SysWOW64.</param>
+    public CMemoryFileSystem(string windowsDirectory = "C:\\Windows",
+        string systemDirectory = null,
+        string systemX86Directory = null)
+    {
+        WindowsDirectory = NormalizePath(windowsDirectory);
+        SystemDirectory = NormalizePath(systemDirectory ?? CombineNormalized(WindowsDirectory, CConsts.HostSysDir));
+        SystemX86Directory = NormalizePath(systemX86Directory ?? CombineNormalized(WindowsDirectory, "SysWOW64"));
+
+        AddDirectory(WindowsDirectory);
+        AddDirectory(SystemDirectory);
+        AddDirectory(SystemX86Directory);
+    }
+
+    private static string NormalizePath(string path)
+    {
+        if (string.IsNullOrEmpty(path))
+            return string.Empty;
+
+        path = path.Replace('/', '\\');
+
+        // Collapse repeated separators, UNC prefix excluded.
+        int start = path.StartsWith("\\\\", StringComparison.Ordinal) ? 2 : 0;
+        while (path.IndexOf("\\\\", start, StringComparison.Ordinal) >= 0)
+        {
+            path = path[..start] + path[start..].Replace("\\\\", "\\");
+        }
+
+        return path.Length > 3 ? path.TrimEnd('\\') : path;
+    }
+
+    // Windows path rules are applied explicitly so behavior does not depend on the host platform.
+    private static string CombineNormalized(string directory, string name)
+    {
+        return directory.EndsWith('\\') ? directory + name : directory + "\\" + name;
+    }
+
+    public string CombinePath(string directory, string fileName)
+    {
+        return NormalizePath(CombineNormalized(NormalizePath(directory), fileName));
+    }
+
+    private static string GetFileName(string path)
+    {
+        return path[(path.LastIndexOf('\\') + 1)..];
+    }
+
+    private static string GetParent(string path)
+    {
+        int lastSep = path.LastIndexOf('\\');
+        if (lastSep <= 0)
+            return null;
+
+        // Keep drive root separator, C:\
+        return (lastSep == 2 && path[1] == ':') ? path[..3] : path[..lastSep];
+    }
+
+    private DirectoryEntry EnsureDirectory(string path)
+    {
+        if (_directories.TryGetValue(path, out var entry))
+            return entry;
+
+        entry = new DirectoryEntry { LastWriteTimeUtc = NextTimestamp() };
+        _directories[path] = entry;
+
+        string parent = GetParent(path);
+        if (parent != null && !parent.Equals(path, StringComparison.OrdinalIgnoreCase))
+        {
+            var parentEntry = EnsureDirectory(parent);
+            parentEntry.Directories.Add(path);
+            parentEntry.LastWriteTimeUtc = NextTimestamp();
+        }
+
+        return entry;
+    }
+
+    private DateTime NextTimestamp()
+    {
+        return DateTime.UnixEpoch.AddTicks(++_tick);
+    }
+
+    /// <summary>
+    /// Adds directory and all its missing parents.
+    /// </summary>
+    /// <param name="path">Full directory path.</param>
+    public void AddDirectory(string path)
+    {
+        lock (_lock)
+        {
+            EnsureDirectory(NormalizePath(path));
+        }
+    }
+
+    /// <summary>
+    /// Adds file and all its missing parent directories.
+    /// </summary>
+    /// <param name="path">Full file path.</param>
+    public void AddFile(string path)
+    {
+        path = NormalizePath(path);
+        string directory = GetParent(path);
+        if (directory == null)
+            return;
+
+        lock (_lock)
+        {
+            var entry = EnsureDirectory(directory);
+            if (entry.Files.Add(GetFileName(path)))
+            {
+                entry.LastWriteTimeUtc = NextTimestamp();
+            }
+        }
+    }
+
+    /// <summary>
+    /// Removes file if present.
+    /// </summary>
+    /// <param name="path">Full file path.</param>
+    public void RemoveFile(string path)
+    {
+        path = NormalizePath(path);
+        string directory = GetParent(path);
+        if (directory == null)
+            return;
+
+        lock (_lock)
+        {
+            if (_directories.TryGetValue(directory, out var entry) && entry.Files.Remove(GetFileName(path)))
+            {
+                entry.LastWriteTimeUtc = NextTimestamp();
+            }
+        }
+    }
+
+    /// <summary>
+    /// Registers file found by SearchPath through the application activation context, e.g. a WinSxS assembly.
+    /// </summary>
+    /// <param name="fileName">File name as imported.</param>
+    /// <param name="path">Full path of the file, added to the filesystem as well.</param>
+    public void AddActivationContextFile(string fileName, string path)
+    {
+        path = NormalizePath(path);
+        AddFile(path);
+
+        lock (_lock)
+        {
+            _activationContextFiles[fileName] = path;
+        }
+    }
+
+    public string SearchPath(string fileName, CActCtxHelper actCtxHelper)
+    {
+        string result;
+
+        if (string.IsNullOrEmpty(fileName))
+            return string.Empty;
+
+        lock (_lock)
+        {
+            if (_activationContextFiles.TryGetValue(fileName, out result) && FileExists(result))
+                return result;
+        }
+
+        return string.Empty;
+    }
+
+    public bool FileExists(string path)
+    {
+        path = NormalizePath(path);
+        string directory = GetParent(path);
+        if (directory == null)
+            return false;
+
+        lock (_lock)
+        {
+            return _directories.TryGetValue(directory, out var entry) && entry.Files.Contains(GetFileName(path));
+        }
+    }
+
+    public bool DirectoryExists(string path)
+    {
+        lock (_lock)
+        {
+            return _directories.ContainsKey(NormalizePath(path));
+        }
+    }
+
+    public DateTime GetDirectoryLastWriteTimeUtc(string path)
+    {
+        lock (_lock)
+        {
+            if (!_directories.TryGetValue(NormalizePath(path), out var entry))
+                throw new DirectoryNotFoundException(path);
+
+            return entry.LastWriteTimeUtc;
+        }
+    }
+
+    public IEnumerable<string> EnumerateFileNames(string path)
+    {
+        lock (_lock)
+        {
+            if (!_directories.TryGetValue(NormalizePath(path), out var entry))
+                throw new DirectoryNotFoundException(path);
+
+            return [.. entry.Files];
+        }
+    }
+
+    public string[] GetDirectories(string path)
+    {
+        lock (_lock)
+        {
+            if (!_directories.TryGetValue(NormalizePath(path), out var entry))
+                throw new DirectoryNotFoundException(path);
+
+            return [.. entry.Directories];
+        }
+    }
+}
@@ -0,0 +1,1156 @@
+﻿/*******************************************************************************
+*
+*  (C) COPYRIGHT AUTHORS, 2026
+*
+*  TITLE:       CMSVCDEMANGLER.CS
+*
+*  VERSION:     1.00
+*  
+*  DATE:        18 Oct 2026
+*
+*  Managed undecorator of Microsoft Visual C++ decorated names.
+*
+* THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF
+* ANY KIND, EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED
+* TO THE IMPLIED WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+*******************************************************************************/
+namespace WinDepends;
+
+/// <summary>
+/// Undecorates Microsoft Visual C++ decorated names without dbghelp.
+/// </summary>
+/// <remarks>
+/// Output follows dbghelp UnDecorateSymbolName for <see cref="CSymbolResolver.UNDNAME.Complete"/>
+/// and <see cref="CSymbolResolver.UNDNAME.NoMsKeyWords"/>. Constructs that are not implemented
+/// (vtordisp/vcall thunks, member pointers, arrays, function types in templates, dynamic
+/// initializers) make <see cref="TryUndecorate"/> fail, so callers can fall back to dbghelp.
+///
+/// Thread-safe, parser state is kept per thread and reused between calls.
+/// </remarks>
+static class CMsvcDemangler
+{
+    [ThreadStatic]
+    static Parser threadParser;
+
+    /// <summary>
+    /// Undecorates a decorated name.
+    /// </summary>
+    /// <param name="name">Decorated name, starting with '?'.</param>
+    /// <param name="flags">Undecoration flags, only Complete and NoMsKeyWords are supported.</param>
+    /// <param name="result">Undecorated name on success, otherwise null.</param>
+    /// <returns>True if the name was undecorated, false if it is not decorated or not supported.</returns>
+    public static bool TryUndecorate(string name, CSymbolResolver.UNDNAME flags, out string result)
+    {
+        result = null;
+
+        if (string.IsNullOrEmpty(name) || name[0] != '?')
+            return false;
+
+        if ((flags & ~CSymbolResolver.UNDNAME.NoMsKeyWords) != 0)
+            return false;
+
+        var parser = threadParser ??= new Parser();
+
+        try
+        {
+            return parser.Run(name, (flags & CSymbolResolver.UNDNAME.NoMsKeyWords) == 0, out result);
+        }
+        catch (InvalidOperationException)
+        {
+            // Recursion limit of malformed input.
+            result = null;
+            return false;
+        }
+    }
+
+    /// <summary>
+    /// Type split around the declarator, e.g. "void (*" and ")(int)" for a function pointer.
+    /// </summary>
+    readonly record struct DataType(string Left, string Right);
+
+    /// <summary>
+    /// Back references of types used in an argument list.
+    /// </summary>
+    sealed class ParamTable
+    {
+        const int MaxEntries = 10;
+
+        readonly DataType[] _entries = new DataType[MaxEntries];
+
+        public int Count { get; private set; }
+
+        public void Add(DataType type)
+        {
+            // Only first ten types are remembered by the compiler.
+            if (Count < MaxEntries)
+                _entries[Count++] = type;
+        }
+
+        public bool TryGet(int index, out DataType type)
+        {
+            type = index < Count ? _entries[index] : default;
+            return index < Count;
+        }
+    }
+
+    sealed class Parser
+    {
+        const int MaxDepth = 64;
+
+        string _text;
+        int _pos;
+        int _depth;
+        bool _msKeywords;
+
+        //
+        // Name back references, _nameStart is the first entry visible in current template scope.
+        //
+        readonly List<string> _names = [];
+        int _nameStart;
+
+        //
+        // Components of the qualified name being parsed, innermost first.
+        //
+        List<string> _stack = [];
+
+        public bool Run(string text, bool msKeywords, out string result)
+        {
+            _text = text;
+            _pos = 0;
+            _depth = 0;
+            _msKeywords = msKeywords;
+            _names.Clear();
+            _nameStart = 0;
+            _stack.Clear();
+
+            try
+            {
+                return DemangleSymbol(out result);
+            }
+            finally
+            {
+                _text = null;
+            }
+        }
+
+        char Peek() => _pos < _text.Length ? _text[_pos] : '\0';
+
+        char PeekAt(int offset) => _pos + offset < _text.Length ? _text[_pos + offset] : '\0';
+
+        char Next() => _pos < _text.Length ? _text[_pos++] : '\0';
+
+        void EnterScope()
+        {
+            if (++_depth > MaxDepth)
+                throw new InvalidOperationException();
+        }
+
+        bool DemangleSymbol(out string result)
+        {
+            string functionName = null;
+            bool isConstructor = false, isDestructor = false, isCastOperator = false, noReturns = false;
+
+            result = null;
+
+            if (Next() != '?')
+                return false;
+
+            // Operator code, "??$?" is an operator template, "??$" a function template name.
+            if (Peek() == '?' && (PeekAt(1) != '$' || PeekAt(2) == '?'))
+            {
+                bool inTemplate = false;
+
+                if (PeekAt(1) == '$' && PeekAt(2) == '?')
+                {
+                    inTemplate = true;
+                    _pos += 2;
+                }
+
+                _pos++;
+                char op = Next();
+
+                switch (op)
+                {
+                    case '0': functionName = string.Empty; isConstructor = true; break;
+                    case '1': functionName = string.Empty; isDestructor = true; break;
+                    case 'B': functionName = "operator "; isCastOperator = true; break;
+                    case '_':
+                        op = Next();
+                        switch (op)
+                        {
+                            case 'C':
+                                // String literal, contents are not decoded.
+                                result = "`string'";
+                                return true;
+
+                            case 'R':
+                                noReturns = true;
+                                if (!GetRttiName(out functionName))
+                                    return false;
+                                break;
+
+                            default:
+                                functionName = GetExtendedOperatorName(op);
+                                break;
+                        }
+                        break;
+                    default:
+                        functionName = GetOperatorName(op);
+                        break;
+                }
+
+                if (functionName == null)
+                    return false;
+
+                if (inTemplate)
+                {
+                    string args = GetArgs(new ParamTable(), false, '<', '>');
+                    if (args == null)
+                        return false;
+
+                    functionName += args;
+                    _names.RemoveRange(_nameStart, _names.Count - _nameStart);
+                }
+
+                _stack.Add(functionName);
+            }
+            else if (Peek() == '$')
+            {
+                _pos++;
+                result = GetTemplateName();
+                return result != null;
+            }
+
+            // Either a class name, or '@' if the symbol is not a class member.
+            switch (Peek())
+            {
+                case '@':
+                    _pos++;
+                    break;
+                case '$':
+                    break;
+                default:
+                    if (!GetClass())
+                        return false;
+                    break;
+            }
+
+            if (isConstructor || isDestructor)
+            {
+                if (_stack.Count <= 1)
+                    return false;
+
+                _stack[0] = (isDestructor ? "~" : string.Empty) + _stack[1] + _stack[0];
+                noReturns = true;
+            }
+
+            char c = Peek();
+
+            if (c >= '0' && c <= '9')
+                return HandleData(out result);
+
+            if (c >= 'A' && c <= 'Z')
+                return HandleMethod(isCastOperator, noReturns, out result);
+
+            return false;
+        }
+
+        static string GetOperatorName(char op)
+        {
+            return op switch
+            {
+                '2' => "operator new",
+                '3' => "operator delete",
+                '4' => "operator=",
+                '5' => "operator>>",
+                '6' => "operator<<",
+                '7' => "operator!",
+                '8' => "operator==",
+                '9' => "operator!=",
+                'A' => "operator[]",
+                'C' => "operator->",
+                'D' => "operator*",
+                'E' => "operator++",
+                'F' => "operator--",
+                'G' => "operator-",
+                'H' => "operator+",
+                'I' => "operator&",
+                'J' => "operator->*",
+                'K' => "operator/",
+                'L' => "operator%",
+                'M' => "operator<",
+                'N' => "operator<=",
+                'O' => "operator>",
+                'P' => "operator>=",
+                'Q' => "operator,",
+                'R' => "operator()",
+                'S' => "operator~",
+                'T' => "operator^",
+                'U' => "operator|",
+                'V' => "operator&&",
+                'W' => "operator||",
+                'X' => "operator*=",
+                'Y' => "operator+=",
+                'Z' => "operator-=",
+                _ => null
+            };
+        }
+
+        static string GetExtendedOperatorName(char op)
+        {
+            return op switch
+            {
+                '0' => "operator/=",
+                '1' => "operator%=",
+                '2' => "operator>>=",
+                '3' => "operator<<=",
+                '4' => "operator&=",
+                '5' => "operator|=",
+                '6' => "operator^=",
+                '7' => "`vftable'",
+                '8' => "`vbtable'",
+                '9' => "`vcall'",
+                'A' => "`typeof'",
+                'B' => "`local static guard'",
+                'D' => "`vbase destructor'",
+                'E' => "`vector deleting destructor'",
+                'F' => "`default constructor closure'",
+                'G' => "`scalar deleting destructor'",
+                'H' => "`vector constructor iterator'",
+                'I' => "`vector destructor iterator'",
+                'J' => "`vector vbase constructor iterator'",
+                'K' => "`virtual displacement map'",
+                'L' => "`eh vector constructor iterator'",
+                'M' => "`eh vector destructor iterator'",
+                'N' => "`eh vector vbase constructor iterator'",
+                'O' => "`copy constructor closure'",
+                'S' => "`local vftable'",
+                'T' => "`local vftable constructor closure'",
+                'U' => "operator new[]",
+                'V' => "operator delete[]",
+                'X' => "`placement delete closure'",
+                'Y' => "`placement delete[] closure'",
+                _ => null
+            };
+        }
+
+        bool GetRttiName(out string name)
+        {
+            name = null;
+
+            switch (Next())
+            {
+                case '0':
+                    // Type descriptor is followed by "@8", handled as data without type.
+                    if (!DemangleDataType(out var type, null, false))
+                        return false;
+
+                    name = type.Left + type.Right + " `RTTI Type Descriptor'";
+                    return true;
+
+                case '1':
+                    string n1 = GetNumber(), n2 = GetNumber(), n3 = GetNumber(), n4 = GetNumber();
+                    if (n1 == null || n2 == null || n3 == null || n4 == null)
+                        return false;
+
+                    name = $"`RTTI Base Class Descriptor at ({n1},{n2},{n3},{n4})'";
+                    return true;
+
+                case '2': name = "`RTTI Base Class Array'"; return true;
+                case '3': name = "`RTTI Class Hierarchy Descriptor'"; return true;
+                case '4': name = "`RTTI Complete Object Locator'"; return true;
+                default: return false;
+            }
+        }
+
+        /// <summary>
+        /// Reads encoded number: '0'-'9' for 1-10, hex digits 'A'-'P' terminated by '@', '?' prefix for negative.
+        /// </summary>
+        string GetNumber()
+        {
+            bool negative = false;
+
+            if (Peek() == '?')
+            {
+                negative = true;
+                _pos++;
+            }
+
+            char c = Peek();
+            if (c >= '0' && c <= '9')
+            {
+                _pos++;
+                return (negative ? "-" : string.Empty) + (c - '0' + 1).ToString();
+            }
+
+            if (c >= 'A' && c <= 'P')
+            {
+                ulong value = 0;
+
+                while (Peek() >= 'A' && Peek() <= 'P')
+                {
+                    value = value * 16 + (ulong)(Next() - 'A');
+                }
+
+                if (Next() != '@')
+                    return null;
+
+                return (negative ? "-" : string.Empty) + value.ToString();
+            }
+
+            return null;
+        }
+
+        static bool IsIdentifierChar(char c)
+        {
+            return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') ||
+                c == '_' || c == '$' || c == '<' || c == '>' || c == '-';
+        }
+
+        string GetLiteralString()
+        {
+            int start = _pos;
+
+            while (Peek() != '@')
+            {
+                if (!IsIdentifierChar(Peek()))
+                    return null;
+
+                _pos++;
+            }
+
+            if (_pos == start)
+                return null;
+
+            string literal = _text.Substring(start, _pos - start);
+            _pos++;
+            _names.Add(literal);
+            return literal;
+        }
+
+        string GetTemplateName()
+        {
+            int nameCount = _names.Count, nameStart = _nameStart, stackCount = _stack.Count;
+            string name, args;
+
+            EnterScope();
+
+            // Template arguments have their own name back references.
+            _nameStart = _names.Count;
+
+            name = GetLiteralString();
+            args = name != null ? GetArgs(new ParamTable(), false, '<', '>') : null;
+
+            _names.RemoveRange(nameCount, _names.Count - nameCount);
+            _nameStart = nameStart;
+            _stack.RemoveRange(stackCount, _stack.Count - stackCount);
+            _depth--;
+
+            return args != null ? name + args : null;
+        }
+
+        /// <summary>
+        /// Reads qualified name components up to the terminating '@'.
+        /// </summary>
+        bool GetClass()
+        {
+            while (Peek() != '@')
+            {
+                string name;
+                char c = Peek();
+
+                if (c == '\0')
+                    return false;
+
+                if (c >= '0' && c <= '9')
+                {
+                    int index = _nameStart + (c - '0');
+                    if (index >= _names.Count)
+                        return false;
+
+                    name = _names[index];
+                    _pos++;
+                }
+                else if (c == '?')
+                {
+                    _pos++;
+
+                    switch (Peek())
+                    {
+                        case '$':
+                            _pos++;
+                            name = GetTemplateName();
+                            if (name == null)
+                                return false;
+
+                            _names.Add(name);
+                            break;
+
+                        case '?':
+                            name = GetNestedSymbol();
+                            break;
+
+                        case 'A' when PeekAt(1) == '0' && PeekAt(2) == 'x':
+                            while (Peek() != '@' && Peek() != '\0')
+                                _pos++;
+
+                            if (Next() != '@')
+                                return false;
+
+                            name = "`anonymous namespace'";
+                            _names.Add(name);
+                            break;
+
+                        default:
+                            name = GetNumber();
+                            if (name != null)
+                                name = "`" + name + "'";
+                            break;
+                    }
+                }
+                else
+                {
+                    name = GetLiteralString();
+                }
+
+                if (name == null)
+                    return false;
+
+                _stack.Add(name);
+            }
+
+            _pos++;
+            return true;
+        }
+
+        /// <summary>
+        /// Scope given by a whole decorated symbol, e.g. function of a local static.
+        /// </summary>
+        string GetNestedSymbol()
+        {
+            var stack = _stack;
+            int nameCount = _names.Count, nameStart = _nameStart;
+            string result;
+
+            EnterScope();
+
+            _stack = [];
+            bool success = DemangleSymbol(out result);
+            _stack = stack;
+
+            _names.RemoveRange(nameCount, _names.Count - nameCount);
+            _nameStart = nameStart;
+            _depth--;
+
+            return success ? "`" + result + "'" : null;
+        }
+
+        string GetClassString(int start)
+        {
+            if (_stack.Count - 1 == start)
+                return _stack[start];
+
+            var parts = new string[_stack.Count - start];
+            for (int i = _stack.Count - 1, j = 0; i >= start; i--, j++)
+            {
+                parts[j] = _stack[i];
+            }
+
+            return string.Join("::", parts);
+        }
+
+        string GetClassName()
+        {
+            int mark = _stack.Count;
+            string name = null;
+
+            if (GetClass() && _stack.Count > mark)
+                name = GetClassString(mark);
+
+            _stack.RemoveRange(mark, _stack.Count - mark);
+            return name;
+        }
+
+        bool GetModifier(out string modifier, out string ptrModifier)
+        {
+            ptrModifier = null;
+
+            if (Peek() == 'E')
+            {
+                if (_msKeywords)
+                    ptrModifier = "__ptr64";
+
+                _pos++;
+            }
+
+            switch (Next())
+            {
+                case 'A': modifier = null; return true;
+                case 'B': modifier = "const"; return true;
+                case 'C': modifier = "volatile"; return true;
+                case 'D': modifier = "const volatile"; return true;
+                default: modifier = null; return false;
+            }
+        }
+
+        bool GetCallingConvention(char c, out string callConv)
+        {
+            callConv = c switch
+            {
+                'A' or 'B' => "__cdecl",
+                'C' or 'D' => "__pascal",
+                'E' or 'F' => "__thiscall",
+                'G' or 'H' => "__stdcall",
+                'I' or 'J' => "__fastcall",
+                'K' or 'L' => string.Empty,
+                'M' => "__clrcall",
+                'Q' => "__vectorcall",
+                _ => null
+            };
+
+            if (callConv == null)
+                return false;
+
+            if (!_msKeywords || callConv.Length == 0)
+                callConv = null;
+
+            return true;
+        }
+
+        static string GetSimpleType(char c)
+        {
+            return c switch
+            {
+                'C' => "signed char",
+                'D' => "char",
+                'E' => "unsigned char",
+                'F' => "short",
+                'G' => "unsigned short",
+                'H' => "int",
+                'I' => "unsigned int",
+                'J' => "long",
+                'K' => "unsigned long",
+                'M' => "float",
+                'N' => "double",
+                'O' => "long double",
+                'X' => "void",
+                'Z' => "...",
+                _ => null
+            };
+        }
+
+        static string GetExtendedType(char c)
+        {
+            return c switch
+            {
+                'D' => "__int8",
+                'E' => "unsigned __int8",
+                'F' => "__int16",
+                'G' => "unsigned __int16",
+                'H' => "__int32",
+                'I' => "unsigned __int32",
+                'J' => "__int64",
+                'K' => "unsigned __int64",
+                'L' => "__int128",
+                'M' => "unsigned __int128",
+                'N' => "bool",
+                'Q' => "char8_t",
+                'S' => "char16_t",
+                'U' => "char32_t",
+                'W' => "wchar_t",
+                _ => null
+            };
+        }
+
+        bool DemangleDataType(out DataType type, ParamTable table, bool inArgs)
+        {
+            bool addToTable = true;
+            char dt = Next();
+
+            type = default;
+            EnterScope();
+
+            try
+            {
+                switch (dt)
+                {
+                    case '_':
+                        type = new DataType(GetExtendedType(Next()), null);
+                        break;
+
+                    case 'C': case 'D': case 'E': case 'F': case 'G':
+                    case 'H': case 'I': case 'J': case 'K': case 'M':
+                    case 'N': case 'O': case 'X': case 'Z':
+                        type = new DataType(GetSimpleType(dt), null);
+                        addToTable = false;
+                        break;
+
+                    case 'T':
+                    case 'U':
+                    case 'V':
+                    case 'Y':
+                        {
+                            string className = GetClassName();
+                            if (className == null)
+                                return false;
+
+                            string typeName = dt switch
+                            {
+                                'T' => "union ",
+                                'U' => "struct ",
+                                'V' => "class ",
+                                _ => "cointerface "
+                            };
+
+                            type = new DataType(typeName + className, null);
+                        }
+                        break;
+
+                    case '?':
+                        if (inArgs)
+                        {
+                            string number = GetNumber();
+                            if (number == null)
+                                return false;
+
+                            type = new DataType("`template-parameter-" + number + "'", null);
+                        }
+                        else if (!GetModifiedType(out type, table, '?', inArgs))
+                        {
+                            return false;
+                        }
+                        break;
+
+                    case 'A':
+                    case 'B':
+                        if (!GetModifiedType(out type, table, dt, inArgs))
+                            return false;
+                        break;
+
+                    case 'Q':
+                    case 'R':
+                    case 'S':
+                        if (!GetModifiedType(out type, table, inArgs ? dt : 'P', inArgs))
+                            return false;
+                        break;
+
+                    case 'P':
+                        if (Peek() >= '0' && Peek() <= '9')
+                        {
+                            // Only plain function pointers, member pointers are not supported.
+                            if (Next() != '6')
+                                return false;
+
+                            int mark = _stack.Count;
+
+                            if (!GetCallingConvention(Next(), out string callConv) ||
+                                !DemangleDataType(out var returnType, table, false))
+                            {
+                                return false;
+                            }
+
+                            string args = GetArgs(table, true, '(', ')');
+                            if (args == null)
+                                return false;
+
+                            _stack.RemoveRange(mark, _stack.Count - mark);
+                            type = new DataType(returnType.Left + returnType.Right + " (" + callConv + "*", ")" + args);
+                        }
+                        else if (!GetModifiedType(out type, table, 'P', inArgs))
+                        {
+                            return false;
+                        }
+                        break;
+
+                    case 'W':
+                        {
+                            if (Next() != '4')
+                                return false;
+
+                            string enumName = GetClassName();
+                            if (enumName == null)
+                                return false;
+
+                            type = new DataType("enum " + enumName, null);
+                        }
+                        break;
+
+                    case '0': case '1': case '2': case '3': case '4':
+                    case '5': case '6': case '7': case '8': case '9':
+                        // Back reference to a type parsed earlier in the argument list.
+                        if (table == null || !table.TryGet(dt - '0', out type))
+                            return false;
+
+                        addToTable = false;
+                        break;
+
+                    case '$':
+                        if (!DemangleTemplateArgument(out type, table, inArgs))
+                            return false;
+                        break;
+
+                    default:
+                        return false;
+                }
+
+                if (type.Left == null)
+                    return false;
+
+                if (addToTable && table != null && inArgs)
+                    table.Add(type);
+
+                return true;
+            }
+            finally
+            {
+                _depth--;
+            }
+        }
+
+        bool DemangleTemplateArgument(out DataType type, ParamTable table, bool inArgs)
+        {
+            string n1, n2, n3;
+
+            type = default;
+
+            switch (Next())
+            {
+                case '0':
+                    n1 = GetNumber();
+                    type = new DataType(n1, null);
+                    break;
+
+                case 'D':
+                    n1 = GetNumber();
+                    if (n1 != null)
+                        type = new DataType("`template-parameter" + n1 + "'", null);
+                    break;
+
+                case 'F':
+                    n1 = GetNumber();
+                    n2 = GetNumber();
+                    if (n1 != null && n2 != null)
+                        type = new DataType("{" + n1 + "," + n2 + "}", null);
+                    break;
+
+                case 'G':
+                    n1 = GetNumber();
+                    n2 = GetNumber();
+                    n3 = GetNumber();
+                    if (n1 != null && n2 != null && n3 != null)
+                        type = new DataType("{" + n1 + "," + n2 + "," + n3 + "}", null);
+                    break;
+
+                case 'Q':
+                    n1 = GetNumber();
+                    if (n1 != null)
+                        type = new DataType("`non-type-template-parameter" + n1 + "'", null);
+                    break;
+
+                case '$':
+                    switch (Next())
+                    {
+                        case 'B':
+                            // Arrays are not supported.
+                            if (Peek() == 'Y')
+                                return false;
+
+                            return DemangleDataType(out type, table, false);
+
+                        case 'C':
+                            if (!GetModifier(out string modifier, out _) ||
+                                !DemangleDataType(out type, table, inArgs))
+                            {
+                                return false;
+                            }
+
+                            type = new DataType(type.Left + " " + modifier, type.Right);
+                            break;
+
+                        case 'Q':
+                            return GetModifiedType(out type, table, '$', inArgs);
+
+                        case 'T':
+                            type = new DataType("std::nullptr_t", null);
+                            break;
+
+                        default:
+                            return false;
+                    }
+                    break;
+
+                default:
+                    return false;
+            }
+
+            return type.Left != null;
+        }
+
+        /// <summary>
+        /// Pointer, reference or storage qualified type.
+        /// </summary>
+        bool GetModifiedType(out DataType type, ParamTable table, char modif, bool inArgs)
+        {
+            string ptrModifier = string.Empty;
+            string typeModifier;
+
+            type = default;
+
+            if (Peek() == 'E')
+            {
+                if (_msKeywords)
+                    ptrModifier = " __ptr64";
+
+                _pos++;
+            }
+
+            typeModifier = modif switch
+            {
+                'A' => " &" + ptrModifier,
+                'B' => " &" + ptrModifier + " volatile",
+                'P' => " *" + ptrModifier,
+                'Q' => " *" + ptrModifier + " const",
+                'R' => " *" + ptrModifier + " volatile",
+                'S' => " *" + ptrModifier + " const volatile",
+                '?' => string.Empty,
+                '$' => " &&" + ptrModifier,
+                _ => null
+            };
+
+            if (typeModifier == null || !GetModifier(out string modifier, out _))
+                return false;
+
+            // Arrays are not supported.
+            if (Peek() == 'Y')
+                return false;
+
+            int mark = _stack.Count;
+
+            if (!DemangleDataType(out var pointee, table, false))
+                return false;
+
+            _stack.RemoveRange(mark, _stack.Count - mark);
+
+            if (modifier != null)
+            {
+                type = new DataType(pointee.Left + " " + modifier + typeModifier, pointee.Right);
+            }
+            else
+            {
+                // No space between duplicate '*'.
+                if (!inArgs && typeModifier.Length > 1 && typeModifier[1] == '*' && pointee.Left.EndsWith('*'))
+                    typeModifier = typeModifier.Substring(1);
+
+                type = new DataType(pointee.Left + typeModifier, pointee.Right);
+            }
+
+            return true;
+        }
+
+        string GetArgs(ParamTable table, bool functionArgs, char open, char close)
+        {
+            List<string> args = [];
+
+            EnterScope();
+
+            while (Peek() != '\0')
+            {
+                if (Peek() == '@')
+                {
+                    _pos++;
+                    break;
+                }
+
+                if (!DemangleDataType(out var type, table, true))
+                {
+                    _depth--;
+                    return null;
+                }
+
+                // 'void' terminates function argument list.
+                if (functionArgs && type.Left == "void")
+                    break;
+
+                args.Add(type.Left + type.Right);
+
+                if (type.Left == "...")
+                    break;
+            }
+
+            _depth--;
+
+            // Function argument lists are always terminated by 'Z'.
+            if (functionArgs && Next() != 'Z')
+                return null;
+
+            if (args.Count == 0 || (args.Count == 1 && args[0] == "void"))
+                return $"{open}void{close}";
+
+            string joined = string.Join(',', args);
+
+            // Keep "> >" apart.
+            if (close == '>' && joined.EndsWith('>'))
+                return open + joined + " " + close;
+
+            return open + joined + close;
+        }
+
+        bool HandleData(out string result)
+        {
+            string access = null, memberType = null, modifier = null, ptrModifier;
+            DataType type = default;
+
+            result = null;
+
+            switch (Peek())
+            {
+                case '0': access = "private: "; memberType = "static "; break;
+                case '1': access = "protected: "; memberType = "static "; break;
+                case '2': access = "public: "; memberType = "static "; break;
+            }
+
+            string name = GetClassString(0);
+
+            switch (Next())
+            {
+                case '0': case '1': case '2':
+                case '3': case '4': case '5':
+                    if (!DemangleDataType(out type, new ParamTable(), false) ||
+                        !GetModifier(out modifier, out ptrModifier))
+                    {
+                        return false;
+                    }
+
+                    if (modifier != null && ptrModifier != null)
+                        modifier = modifier + " " + ptrModifier;
+                    else
+                        modifier ??= ptrModifier;
+                    break;
+
+                case '6':
+                case '7':
+                    // Compiler generated static, e.g. vftable.
+                    if (!GetModifier(out modifier, out _))
+                        return false;
+
+                    if (Peek() != '@')
+                    {
+                        string className = GetClassName();
+                        if (className == null)
+                            return false;
+
+                        type = new DataType(null, "{for `" + className + "'}");
+                    }
+                    break;
+
+                case '8':
+                case '9':
+                    break;
+
+                default:
+                    return false;
+            }
+
+            result = string.Concat(access, memberType, type.Left,
+                modifier != null && type.Left != null ? " " : null, modifier,
+                modifier != null || type.Left != null ? " " : null, name, type.Right);
+
+            return true;
+        }
+
+        bool HandleMethod(bool isCastOperator, bool noReturns, out string result)
+        {
+            string access, memberType = null, modifier = null, name, args;
+            DataType returnType = default;
+            char accmem = Next();
+
+            result = null;
+
+            // Function class letter: access level in groups of eight, 'Y' and 'Z' are global.
+            int kind = (accmem - 'A') % 8;
+            bool isMember = accmem <= 'X';
+            bool isThunk = isMember && (kind == 6 || kind == 7);
+
+            access = ((accmem - 'A') / 8) switch
+            {
+                0 => "private: ",
+                1 => "protected: ",
+                2 => "public: ",
+                _ => null
+            };
+
+            if (isThunk)
+                access = "[thunk]:" + (access ?? " ");
+
+            if (isMember)
+            {
+                memberType = kind switch
+                {
+                    2 or 3 => "static ",
+                    4 or 5 or 6 or 7 => "virtual ",
+                    _ => null
+                };
+            }
+
+            name = GetClassString(0);
+
+            if (isThunk)
+            {
+                string adjustor = GetNumber();
+                if (adjustor == null)
+                    return false;
+
+                name += "`adjustor{" + adjustor + "}'";
+            }
+
+            // Implicit 'this' pointer qualifiers of non-static members.
+            if (isMember && kind != 2 && kind != 3)
+            {
+                if (!GetModifier(out modifier, out string ptrModifier))
+                    return false;
+
+                if (modifier != null || ptrModifier != null)
+                    modifier = modifier + " " + ptrModifier;
+            }
+
+            if (!GetCallingConvention(Next(), out string callConv))
+                return false;
+
+            var table = new ParamTable();
+
+            // Return type, or '@' for void.
+            if (Peek() == '@')
+            {
+                returnType = new DataType("void", null);
+                _pos++;
+            }
+            else if (!DemangleDataType(out returnType, table, false))
+            {
+                return false;
+            }
+
+            if (noReturns)
+                returnType = default;
+
+            if (isCastOperator)
+            {
+                name += returnType.Left + returnType.Right;
+                returnType = default;
+            }
+
+            args = GetArgs(table, true, '(', ')');
+            if (args == null)
+                return false;
+
+            result = string.Concat(
+                string.Concat(access, memberType, returnType.Left,
+                    returnType.Left != null && returnType.Right == null ? " " : null),
+                string.Concat(callConv, callConv != null ? " " : null, name, args),
+                string.Concat(modifier, returnType.Right));
+
+            return true;
+        }
+    }
+}
@@ -6,7 +6,7 @@
 *
 *  VERSION:     1.00
 *  
-*  DATE:        17 Jul 2026
+*  DATE:        18 Oct 2026
 *
 *  MS Symbols resolver support class.
 *
@@ -18,6 +18,7 @@
 *******************************************************************************/
 using Microsoft.Win32;
 using Microsoft.Win32.SafeHandles;
+using System.Collections.Concurrent;
 using System.Diagnostics;
 using System.Runtime.InteropServices;
 using System.Text;
@@ -65,12 +66,49 @@ public enum SymbolLoadState
     Cancelled
 }
 
+/// <summary>
+/// Priority of a queued symbol load, lower values are served first.
+/// </summary>
+public enum SymbolLoadPriority
+{
+    /// <summary>
+    /// Module selected by the user, loaded ahead of everything else.
+    /// </summary>
+    Foreground = 0,
+
+    /// <summary>
+    /// Direct import of the module selected by the user.
+    /// </summary>
+    Nearby = 1,
+
+    /// <summary>
+    /// Module queued for background prefetch.
+    /// </summary>
+    Prefetch = 2
+}
+
 public sealed class SymbolLoadStatusChangedEventArgs : EventArgs
 {
     public string FileName { get; init; }
     public SymbolLoadState State { get; init; }
+    public SymbolLoadPriority Priority { get; init; }
     public string Message { get; init; }
     public Exception Error { get; init; }
+
+    /// <summary>
+    /// Count of modules still waiting in the prefetch or load queue.
+    /// </summary>
+    public int QueueDepth { get; init; }
+
+    /// <summary>
+    /// Time from queueing the module until its symbols were loaded.
+    /// </summary>
+    public TimeSpan Latency { get; init; }
+
+    /// <summary>
+    /// Time spent by dbghelp loading the module and its PDB.
+    /// </summary>
+    public TimeSpan LoadTime { get; init; }
 }
 
 /// <summary>
@@ -134,6 +172,9 @@ public sealed class CSymbolResolver : IDisposable
         NoThrowSignatures = 0x0100,
     }
 
+    // Note: DependencyWalker uses UNDNAME.NoAllocateLanguage | UNDNAME.NoMsKeyWords | UNDNAME.NoFunctionReturns | UNDNAME.NoAccessSpecifiers
+    internal const UNDNAME UndecorateFlags = UNDNAME.NoMsKeyWords;
+
     [StructLayout(LayoutKind.Sequential, CharSet = CharSet.Unicode)]
     public struct SYMBOL_INFO
     {
@@ -211,22 +252,87 @@ public sealed class CSymbolResolver : IDisposable
     SymFromAddrDelegate SymFromAddr;
     UnDecorateSymbolNameDelegate UnDecorateSymbolName;
 
+    //
+    // Symbol modules loaded by the resolver are placed at synthetic, non-overlapping
+    // bases, so several of them can stay loaded at once. Slot size covers any image size.
+    //
+    const UInt64 SymModuleBaseStart = 0x0000100000000000;
+    const UInt64 SymModuleSlotSize = 0x100000000;
+
+    /// <summary>
+    /// Queued symbol load of a single module.
+    /// </summary>
+    sealed class SymbolLoadRequest
+    {
+        public string FileName { get; init; }
+        public UInt64 BaseAddress { get; init; }
+        public SymbolLoadPriority Priority { get; init; }
+        public long Sequence { get; init; }
+        public long QueuedTimestamp { get; init; }
+
+        /// <summary>
+        /// PDB file name and symbol store key (GUID/signature and age), empty if unknown.
+        /// </summary>
+        public string PdbName { get; init; }
+        public string PdbKey { get; init; }
+    }
+
+    /// <summary>
+    /// Symbol module loaded in dbghelp.
+    /// </summary>
+    sealed class LoadedSymModule
+    {
+        public IntPtr Base { get; init; }
+        public int Slot { get; init; }
+        public long LastUse { get; set; }
+
+        /// <summary>
+        /// Module was selected or queried by the user, background loads do not evict it.
+        /// </summary>
+        public bool Used { get; set; }
+    }
+
+    /// <summary>
+    /// Downstream symbol store with the local upstream stores it is filled from.
+    /// </summary>
+    sealed record SymbolStoreChain(string CachePath, List<string> UpstreamPaths);
+
     readonly object _stateLock = new();
     readonly object _dbgHelpLock = new();
     readonly AutoResetEvent _preloadSignal = new(false);
+    readonly SemaphoreSlim _prefetchSignal = new(0);
 
     Thread _preloadWorkerThread;
+    readonly List<Thread> _prefetchWorkerThreads = [];
     bool _workerStarted;
     volatile bool _disposeRequested;
 
-    string _pendingModuleFileName = string.Empty;
-    UInt64 _pendingModuleBaseAddress;
-    int _pendingRequestId;
+    //
+    // Queues and request state, guarded by _stateLock. Requests pass the prefetch
+    // queue (parallel file I/O) first, then the load queue (serialized dbghelp calls).
+    // A request superseded in _pendingRequests is dropped when dequeued.
+    //
+    readonly PriorityQueue<SymbolLoadRequest, (int, long)> _prefetchQueue = new();
+    readonly PriorityQueue<SymbolLoadRequest, (int, long)> _loadQueue = new();
+    readonly Dictionary<string, SymbolLoadRequest> _pendingRequests = new(StringComparer.OrdinalIgnoreCase);
+    SymbolLoadRequest _foregroundRequest;
+    long _requestSequence;
+
+    long _prefetchLoadCount;
+    long _prefetchTotalLatency;
+    long _prefetchMaxLatency;
+    long _prefetchTotalLoadTime;
 
     string _activeModuleFileName = string.Empty;
 
-    string _nativeLoadedModuleFileName = string.Empty;
-    IntPtr _nativeLoadedModuleBase = IntPtr.Zero;
+    //
+    // Loaded symbol modules, guarded by _dbgHelpLock.
+    //
+    readonly Dictionary<string, LoadedSymModule> _loadedModules = new(StringComparer.OrdinalIgnoreCase);
+    readonly bool[] _moduleSlotUsed = new bool[Environment.Is64BitProcess ? CConsts.SymbolLoadedModulesMax : 1];
+    long _moduleUseCounter;
+
+    List<SymbolStoreChain> _symbolStores = [];
 
     IntPtr DbgHelpModule { get; set; } = IntPtr.Zero;
 
@@ -239,14 +345,29 @@ public sealed class CSymbolResolver : IDisposable
 
     static readonly SafeProcessHandle CurrentProcess = new(new IntPtr(-1), false);
 
-    private void RaiseSymbolLoadStatusChanged(string fileName, SymbolLoadState state, string message, Exception error = null)
+    //
+    // Undecorated names by decorated name, shared by all resolver instances.
+    // Undecoration buffer is reused under _dbgHelpLock.
+    //
+    static readonly ConcurrentDictionary<string, string> UndecoratedNameCache = new(StringComparer.Ordinal);
+    static int _undecoratedNameCacheCount;
+    static int _undecoratedNameCacheTrimming;
+    readonly StringBuilder _undecorateBuffer = new(1024);
+
+    private void RaiseSymbolLoadStatusChanged(string fileName, SymbolLoadState state, string message, Exception error = null,
+        SymbolLoadPriority priority = SymbolLoadPriority.Foreground, int queueDepth = 0, TimeSpan latency = default,
+        TimeSpan loadTime = default)
     {
         SymbolLoadStatusChanged?.Invoke(this, new SymbolLoadStatusChangedEventArgs
         {
             FileName = fileName,
             State = state,
+            Priority = priority,
             Message = message,
-            Error = error
+            Error = error,
+            QueueDepth = queueDepth,
+            Latency = latency,
+            LoadTime = loadTime
         });
     }
 
@@ -261,8 +382,18 @@ public sealed class CSymbolResolver : IDisposable
             Name = "CSymbolResolver.PreloadWorker"
         };
 
+        for (int i = 0; i < CConsts.SymbolPrefetchWorkerCount; i++)
+        {
+            _prefetchWorkerThreads.Add(new Thread(PrefetchWorkerProc)
+            {
+                IsBackground = true,
+                Name = $"CSymbolResolver.PrefetchWorker{i}"
+            });
+        }
+
         _workerStarted = true;
         _preloadWorkerThread.Start();
+        _prefetchWorkerThreads.ForEach(thread => thread.Start());
     }
 
     private void ClearSymbolsDelegates()
@@ -396,18 +527,23 @@ public sealed class CSymbolResolver : IDisposable
 
             if (useSymbols && InitializeSymbolsDelegates())
             {
+                //
+                // No deferred loads, PDB must be loaded by the load worker and not
+                // by the first symbol query on the UI thread.
+                //
                 SymSetOptions(
                     (SymGetOptions() |
-                     SYMOPT_DEFERRED_LOADS |
                      SYMOPT_FAIL_CRITICAL_ERRORS |
                      SYMOPT_PUBLICS_ONLY
                     // | SYMOPT_NO_PROMPTS
-                    ) & ~SYMOPT_UNDNAME);
+                    ) & ~(SYMOPT_UNDNAME | SYMOPT_DEFERRED_LOADS));
 
                 SymbolsInitialized = SymInitialize(CurrentProcess, StorePath, false);
             }
         }
 
+        _symbolStores = ParseSymbolStores(StorePath);
+
         if (useSymbols)
         {
             if (!SymbolsInitialized)
@@ -425,10 +561,19 @@ public sealed class CSymbolResolver : IDisposable
             : SymbolResolverInitResult.InitializationFailure;
     }
 
+    /// <summary>
+    /// Queues symbol loading for the module selected by the user.
+    /// </summary>
+    /// <remarks>
+    /// The request is served ahead of queued prefetch work. A previous foreground request
+    /// that has not been loaded yet is reported as cancelled and stays queued for prefetch.
+    /// </remarks>
+    /// <param name="fileName">Full path of the module.</param>
+    /// <param name="baseAddress">Load base, only used by 32-bit process where synthetic bases are not available.</param>
     public void RequestModulePreload(string fileName, UInt64 baseAddress)
     {
-        string loadedFileName;
-        IntPtr loadedBase;
+        SymbolLoadRequest request, cancelledRequest = null;
+        bool queued;
 
         if (!SymbolsInitialized || string.IsNullOrEmpty(fileName))
             return;
@@ -440,181 +585,447 @@ public sealed class CSymbolResolver : IDisposable
             return;
         }
 
-        lock (_dbgHelpLock)
+        if (IsModuleLoaded(fileName))
         {
-            loadedFileName = _nativeLoadedModuleFileName;
-            loadedBase = _nativeLoadedModuleBase;
+            lock (_stateLock)
+            {
+                _activeModuleFileName = fileName;
+            }
+            return;
         }
 
         lock (_stateLock)
         {
-            if (loadedBase != IntPtr.Zero &&
-                string.Equals(loadedFileName, fileName, StringComparison.OrdinalIgnoreCase) &&
-                string.IsNullOrEmpty(_pendingModuleFileName))
-            {
-                _activeModuleFileName = fileName;
+            _pendingRequests.TryGetValue(fileName, out var current);
+            if (current != null && current.Priority == SymbolLoadPriority.Foreground)
                 return;
+
+            request = CreateRequest(fileName, baseAddress, SymbolLoadPriority.Foreground,
+                current?.PdbName, current?.PdbKey);
+
+            //
+            // Demote previous foreground request to background, it is still worth loading.
+            //
+            if (_foregroundRequest != null && IsCurrentRequestLocked(_foregroundRequest))
+            {
+                cancelledRequest = CreateRequest(_foregroundRequest.FileName, _foregroundRequest.BaseAddress,
+                    SymbolLoadPriority.Nearby, _foregroundRequest.PdbName, _foregroundRequest.PdbKey);
+
+                _pendingRequests[cancelledRequest.FileName] = cancelledRequest;
+                _prefetchQueue.Enqueue(cancelledRequest, ((int)cancelledRequest.Priority, cancelledRequest.Sequence));
             }
 
-            if (string.Equals(_pendingModuleFileName, fileName, StringComparison.OrdinalIgnoreCase))
+            queued = EnqueueRequestLocked(request, true);
+            _foregroundRequest = request;
+        }
+
+        if (cancelledRequest != null)
+        {
+            _prefetchSignal.Release();
+            RaiseSymbolLoadStatusChanged(cancelledRequest.FileName, SymbolLoadState.Cancelled, string.Empty);
+        }
+
+        if (queued)
+        {
+            _prefetchSignal.Release();
+            RaiseSymbolLoadStatusChanged(fileName, SymbolLoadState.Queued,
+                $"Loading symbols for \"{fileName}\", please wait...");
+        }
+    }
+
+    /// <summary>
+    /// Queues background symbol loading for a module.
+    /// </summary>
+    /// <remarks>
+    /// When PDB identity is known, the PDB is copied from a local upstream symbol store into the
+    /// downstream cache by one of the prefetch workers before dbghelp loads the module.
+    /// </remarks>
+    /// <param name="fileName">Full path of the module.</param>
+    /// <param name="debugInfo">Debug records of the module as returned by the server, or null if unknown.</param>
+    /// <param name="priority">Background priority of the request.</param>
+    public void EnqueueModulePrefetch(string fileName, CCoreDebugInfo debugInfo,
+        SymbolLoadPriority priority = SymbolLoadPriority.Prefetch)
+    {
+        SymbolLoadRequest request;
+        bool queued;
+
+        if (!SymbolsInitialized || string.IsNullOrEmpty(fileName))
+            return;
+
+        if (debugInfo != null && !debugInfo.IsImage)
+            return;
+
+        if (IsModuleLoaded(fileName))
+            return;
+
+        GetPdbIdentity(debugInfo, out string pdbName, out string pdbKey);
+
+        lock (_stateLock)
+        {
+            request = CreateRequest(fileName, 0, priority, pdbName, pdbKey);
+            queued = EnqueueRequestLocked(request, false);
+        }
+
+        if (queued)
+        {
+            _prefetchSignal.Release();
+        }
+    }
+
+    /// <summary>
+    /// Gets count of modules waiting in the prefetch or load queue.
+    /// </summary>
+    public int QueueDepth
+    {
+        get
+        {
+            lock (_stateLock)
             {
-                return;
+                return _pendingRequests.Count;
             }
+        }
+    }
+
+    private SymbolLoadRequest CreateRequest(string fileName, UInt64 baseAddress, SymbolLoadPriority priority,
+        string pdbName, string pdbKey)
+    {
+        return new SymbolLoadRequest
+        {
+            FileName = fileName,
+            BaseAddress = baseAddress,
+            Priority = priority,
+            Sequence = ++_requestSequence,
+            QueuedTimestamp = Stopwatch.GetTimestamp(),
+            PdbName = pdbName,
+            PdbKey = pdbKey
+        };
+    }
 
-            _pendingModuleFileName = fileName;
-            _pendingModuleBaseAddress = baseAddress;
-            _pendingRequestId++;
+    /// <summary>
+    /// Adds request to the prefetch queue, must be called with _stateLock held.
+    /// </summary>
+    /// <param name="request">Request to add.</param>
+    /// <param name="replace">Replace a pending request of the same module even if it has the same priority.</param>
+    /// <returns>True if request was queued, caller must signal prefetch workers.</returns>
+    private bool EnqueueRequestLocked(SymbolLoadRequest request, bool replace)
+    {
+        if (_pendingRequests.TryGetValue(request.FileName, out var current))
+        {
+            if (current.Priority < request.Priority ||
+                (current.Priority == request.Priority && !replace))
+            {
+                return false;
+            }
+
+            // Keep PDB identity learned by the superseded request.
+            if (string.IsNullOrEmpty(request.PdbKey) && !string.IsNullOrEmpty(current.PdbKey))
+            {
+                request = CreateRequest(request.FileName, request.BaseAddress, request.Priority,
+                    current.PdbName, current.PdbKey);
+            }
         }
 
-        RaiseSymbolLoadStatusChanged(fileName, SymbolLoadState.Queued,
-            $"Loading symbols for \"{fileName}\", please wait...");
+        _pendingRequests[request.FileName] = request;
+        _prefetchQueue.Enqueue(request, ((int)request.Priority, request.Sequence));
+        return true;
+    }
 
-        _preloadSignal.Set();
+    private bool IsCurrentRequestLocked(SymbolLoadRequest request)
+    {
+        return _pendingRequests.TryGetValue(request.FileName, out var current) &&
+            ReferenceEquals(current, request);
     }
 
-    private void PreloadWorkerProc()
+    private bool IsModuleLoaded(string fileName)
+    {
+        lock (_dbgHelpLock)
+        {
+            return _loadedModules.ContainsKey(fileName);
+        }
+    }
+
+    /// <summary>
+    /// Prefetch worker, fills the downstream symbol cache, several of them run in parallel.
+    /// </summary>
+    private void PrefetchWorkerProc()
     {
         while (true)
         {
-            string fileName;
-            UInt64 baseAddress;
-            int requestId;
-            bool alreadyLoaded;
-            bool loadSucceeded;
-            IntPtr loadedBase;
-            string nativeLoadedName;
-            int lastError;
+            SymbolLoadRequest request;
 
-            _preloadSignal.WaitOne();
+            _prefetchSignal.Wait();
 
             if (_disposeRequested)
                 break;
 
             lock (_stateLock)
             {
-                fileName = _pendingModuleFileName;
-                baseAddress = _pendingModuleBaseAddress;
-                requestId = _pendingRequestId;
+                if (!_prefetchQueue.TryDequeue(out request, out _) ||
+                    !IsCurrentRequestLocked(request))
+                {
+                    continue;
+                }
+            }
+
+            try
+            {
+                using var span = CTraceRecorder.BeginSpan("symfetch", "symbols", request.FileName);
+                FetchSymbolFile(request);
+            }
+            catch
+            {
+                // Not fatal, dbghelp still searches the symbol path on load.
+            }
+
+            lock (_stateLock)
+            {
+                if (!IsCurrentRequestLocked(request))
+                    continue;
 
-                _pendingModuleFileName = string.Empty;
-                _pendingModuleBaseAddress = 0;
+                _loadQueue.Enqueue(request, ((int)request.Priority, request.Sequence));
             }
 
-            if (string.IsNullOrEmpty(fileName))
-                continue;
+            _preloadSignal.Set();
+        }
+    }
 
-            try
+    /// <summary>
+    /// Load worker, the only thread that loads symbol modules, dbghelp calls are serialized.
+    /// </summary>
+    private void PreloadWorkerProc()
+    {
+        while (true)
+        {
+            _preloadSignal.WaitOne();
+
+            if (_disposeRequested)
+                break;
+
+            while (!_disposeRequested)
+            {
+                SymbolLoadRequest request;
+
+                lock (_stateLock)
+                {
+                    if (!_loadQueue.TryDequeue(out request, out _))
+                        break;
+
+                    if (!IsCurrentRequestLocked(request))
+                        continue;
+                }
+
+                LoadRequestedModule(request);
+            }
+        }
+
+        if (!_disposeRequested)
+        {
+            RaiseSymbolLoadStatusChanged(string.Empty, SymbolLoadState.Idle, string.Empty);
+        }
+    }
+
+    private void LoadRequestedModule(SymbolLoadRequest request)
+    {
+        string fileName = request.FileName;
+        bool foreground = request.Priority == SymbolLoadPriority.Foreground;
+        bool isCurrent, loadSucceeded, slotAvailable = true;
+        int lastError = 0, queueDepth;
+        long latency, loadStart, loadTime;
+        string summary = null;
+
+        try
+        {
+            if (foreground)
             {
                 RaiseSymbolLoadStatusChanged(fileName, SymbolLoadState.Loading,
                     $"Loading symbols for \"{fileName}\", please wait...");
+            }
 
+            using (CTraceRecorder.BeginSpan("symload", "symbols", fileName))
+            {
                 lock (_dbgHelpLock)
                 {
-                    alreadyLoaded = string.Equals(_nativeLoadedModuleFileName, fileName, StringComparison.OrdinalIgnoreCase)
-                        && _nativeLoadedModuleBase != IntPtr.Zero;
-                }
+                    if (_disposeRequested)
+                        return;
 
-                loadSucceeded = alreadyLoaded;
-                loadedBase = IntPtr.Zero;
-                nativeLoadedName = string.Empty;
-                lastError = 0;
+                    loadStart = Stopwatch.GetTimestamp();
 
-                if (!alreadyLoaded)
-                {
-                    lock (_dbgHelpLock)
+                    if (_loadedModules.TryGetValue(fileName, out var loadedModule))
                     {
-                        if (_disposeRequested)
-                            break;
-
-                        loadedBase = LoadModuleNative(fileName, baseAddress, out lastError);
-                        if (loadedBase != IntPtr.Zero)
-                        {
-                            _nativeLoadedModuleFileName = fileName;
-                            _nativeLoadedModuleBase = loadedBase;
-                            nativeLoadedName = fileName;
-                            loadSucceeded = true;
-                        }
-                        else
-                        {
-                            _nativeLoadedModuleFileName = string.Empty;
-                            _nativeLoadedModuleBase = IntPtr.Zero;
-                        }
+                        loadSucceeded = true;
+                        if (foreground)
+                            loadedModule.Used = true;
                     }
-                }
-                else
-                {
-                    lock (_dbgHelpLock)
+                    else
                     {
-                        nativeLoadedName = _nativeLoadedModuleFileName;
-                        loadedBase = _nativeLoadedModuleBase;
+                        loadSucceeded = LoadModuleNative(fileName, request.BaseAddress, request.Priority,
+                            out lastError, out slotAvailable) != IntPtr.Zero;
                     }
+
+                    loadTime = Stopwatch.GetTimestamp() - loadStart;
                 }
+            }
+
+            latency = Stopwatch.GetTimestamp() - request.QueuedTimestamp;
 
-                if (!loadSucceeded)
+            lock (_stateLock)
+            {
+                isCurrent = IsCurrentRequestLocked(request);
+                if (isCurrent)
                 {
-                    RaiseSymbolLoadStatusChanged(fileName, SymbolLoadState.Failed,
-                        lastError != 0
-                            ? $"Symbol load failed for \"{fileName}\", error 0x{lastError:X8}."
-                            : $"Symbol load failed for \"{fileName}\".");
-                    continue;
+                    _pendingRequests.Remove(fileName);
                 }
 
-                lock (_stateLock)
+                if (ReferenceEquals(_foregroundRequest, request))
                 {
-                    if (string.Equals(nativeLoadedName, fileName, StringComparison.OrdinalIgnoreCase) &&
-                        loadedBase != IntPtr.Zero)
-                    {
+                    _foregroundRequest = null;
+                    if (loadSucceeded)
                         _activeModuleFileName = fileName;
-                    }
                 }
 
-                lock (_stateLock)
+                if (!foreground && loadSucceeded)
                 {
-                    bool isCancelled;
+                    _prefetchLoadCount++;
+                    _prefetchTotalLatency += latency;
+                    _prefetchMaxLatency = Math.Max(_prefetchMaxLatency, latency);
+                    _prefetchTotalLoadTime += loadTime;
+                }
 
-                    lock (_stateLock)
-                    {
-                        isCancelled = requestId != _pendingRequestId;
-                    }
+                queueDepth = _pendingRequests.Count;
 
-                    if (isCancelled)
-                    {
-                        RaiseSymbolLoadStatusChanged(fileName, SymbolLoadState.Cancelled, string.Empty);
-                        continue;
-                    }
+                if (queueDepth == 0 && _prefetchLoadCount > 0)
+                {
+                    summary = $"Symbols prefetch finished for {_prefetchLoadCount} module(s), " +
+                        $"average {Stopwatch.GetElapsedTime(0, _prefetchTotalLatency / _prefetchLoadCount).TotalMilliseconds:F0} ms, " +
+                        $"max {Stopwatch.GetElapsedTime(0, _prefetchMaxLatency).TotalMilliseconds:F0} ms per module, " +
+                        $"average load {Stopwatch.GetElapsedTime(0, _prefetchTotalLoadTime / _prefetchLoadCount).TotalMilliseconds:F0} ms";
+
+                    _prefetchLoadCount = 0;
+                    _prefetchTotalLatency = 0;
+                    _prefetchMaxLatency = 0;
+                    _prefetchTotalLoadTime = 0;
                 }
+            }
 
-                RaiseSymbolLoadStatusChanged(fileName, SymbolLoadState.Loaded, $"Symbols loading for \"{fileName}\" has been finished");
+            TimeSpan latencyTime = Stopwatch.GetElapsedTime(0, latency);
+            TimeSpan loadTimeSpan = Stopwatch.GetElapsedTime(0, loadTime);
+
+            if (!slotAvailable)
+            {
+                // Background load would evict a module in use, PDB stays in the downstream cache.
+                RaiseSymbolLoadStatusChanged(fileName, SymbolLoadState.Cancelled,
+                    $"Symbols prefetch for \"{fileName}\" skipped, all symbol module slots are in use",
+                    null, request.Priority, queueDepth, latencyTime);
             }
-            catch (Exception ex)
+            else if (!loadSucceeded)
             {
                 RaiseSymbolLoadStatusChanged(fileName, SymbolLoadState.Failed,
-                    $"Symbol load failed for \"{fileName}\": {ex.Message}", ex);
+                    lastError != 0
+                        ? $"Symbol load failed for \"{fileName}\", error 0x{lastError:X8}."
+                        : $"Symbol load failed for \"{fileName}\".",
+                    null, request.Priority, queueDepth, latencyTime);
+            }
+            else if (!isCurrent && foreground)
+            {
+                RaiseSymbolLoadStatusChanged(fileName, SymbolLoadState.Cancelled, string.Empty,
+                    null, request.Priority, queueDepth, latencyTime);
+            }
+            else if (foreground)
+            {
+                RaiseSymbolLoadStatusChanged(fileName, SymbolLoadState.Loaded,
+                    $"Symbols loading for \"{fileName}\" has been finished",
+                    null, request.Priority, queueDepth, latencyTime, loadTimeSpan);
+            }
+            else
+            {
+                RaiseSymbolLoadStatusChanged(fileName, SymbolLoadState.Loaded,
+                    $"Symbols prefetched for \"{fileName}\" in {latencyTime.TotalMilliseconds:F0} ms " +
+                    $"(load {loadTimeSpan.TotalMilliseconds:F0} ms), {queueDepth} module(s) queued",
+                    null, request.Priority, queueDepth, latencyTime, loadTimeSpan);
             }
-        }
 
-        if (!_disposeRequested)
+            if (summary != null)
+            {
+                RaiseSymbolLoadStatusChanged(string.Empty, SymbolLoadState.Idle, summary);
+            }
+        }
+        catch (Exception ex)
         {
-            RaiseSymbolLoadStatusChanged(string.Empty, SymbolLoadState.Idle, string.Empty);
+            lock (_stateLock)
+            {
+                if (IsCurrentRequestLocked(request))
+                    _pendingRequests.Remove(fileName);
+            }
+
+            RaiseSymbolLoadStatusChanged(fileName, SymbolLoadState.Failed,
+                $"Symbol load failed for \"{fileName}\": {ex.Message}", ex, request.Priority);
         }
     }
 
-    private IntPtr LoadModuleNative(string fileName, UInt64 baseAddress, out int lastError)
+    /// <summary>
+    /// Loads symbol module and its PDB, must be called with _dbgHelpLock held.
+    /// </summary>
+    /// <remarks>
+    /// If all slots are taken, a foreground load evicts the least recently used module,
+    /// a nearby load evicts only modules not used by the user and a prefetch load
+    /// evicts nothing.
+    /// </remarks>
+    /// <param name="fileName">Full path of the module.</param>
+    /// <param name="baseAddress">Load base for 32-bit process.</param>
+    /// <param name="priority">Priority of the request.</param>
+    /// <param name="lastError">Error code of a failed load.</param>
+    /// <param name="slotAvailable">False if the load was skipped because no slot could be freed.</param>
+    private IntPtr LoadModuleNative(string fileName, UInt64 baseAddress, SymbolLoadPriority priority,
+        out int lastError, out bool slotAvailable)
     {
         IntPtr symModule;
+        UInt64 loadBase;
+        int slot;
 
         lastError = 0;
+        slotAvailable = true;
 
         if (!SymbolsInitialized || SymLoadModuleEx == null)
             return IntPtr.Zero;
 
-        ClearLoadedModuleNative();
+        slot = Array.IndexOf(_moduleSlotUsed, false);
+        if (slot < 0)
+        {
+            string victim = null;
+            long victimUse = long.MaxValue;
+
+            if (priority != SymbolLoadPriority.Prefetch)
+            {
+                foreach (var item in _loadedModules)
+                {
+                    if (item.Value.LastUse < victimUse &&
+                        (priority == SymbolLoadPriority.Foreground || !item.Value.Used))
+                    {
+                        victim = item.Key;
+                        victimUse = item.Value.LastUse;
+                    }
+                }
+            }
+
+            if (victim == null)
+            {
+                slotAvailable = false;
+                return IntPtr.Zero;
+            }
+
+            slot = _loadedModules[victim].Slot;
+            UnloadModuleNative(victim);
+        }
+
+        loadBase = Environment.Is64BitProcess
+            ? SymModuleBaseStart + (UInt64)slot * SymModuleSlotSize
+            : baseAddress;
 
         symModule = SymLoadModuleEx(CurrentProcess,
             IntPtr.Zero,
             fileName,
             null,
-            baseAddress,
+            loadBase,
             0,
             IntPtr.Zero,
             0);
@@ -622,29 +1033,160 @@ public sealed class CSymbolResolver : IDisposable
         if (symModule == IntPtr.Zero)
         {
             lastError = Marshal.GetLastWin32Error();
+            return IntPtr.Zero;
         }
 
+        _moduleSlotUsed[slot] = true;
+        _loadedModules[fileName] = new LoadedSymModule
+        {
+            Base = symModule,
+            Slot = slot,
+            LastUse = ++_moduleUseCounter,
+            Used = priority == SymbolLoadPriority.Foreground
+        };
+
         return symModule;
     }
 
-    private bool ClearLoadedModuleNative()
+    private bool UnloadModuleNative(string fileName)
     {
         bool result = false;
 
-        if (_nativeLoadedModuleBase != IntPtr.Zero)
+        if (_loadedModules.Remove(fileName, out var module))
         {
             if (SymUnloadModule64 != null)
             {
-                result = SymUnloadModule64(CurrentProcess, _nativeLoadedModuleBase);
+                result = SymUnloadModule64(CurrentProcess, module.Base);
             }
+
+            _moduleSlotUsed[module.Slot] = false;
         }
 
-        _nativeLoadedModuleBase = IntPtr.Zero;
-        _nativeLoadedModuleFileName = string.Empty;
+        return result;
+    }
+
+    private bool ClearLoadedModulesNative()
+    {
+        bool result = true;
+
+        foreach (string fileName in _loadedModules.Keys.ToList())
+        {
+            result &= UnloadModuleNative(fileName);
+        }
 
         return result;
     }
 
+    /// <summary>
+    /// Extracts PDB file name and symbol store key from the first CodeView record.
+    /// </summary>
+    private static void GetPdbIdentity(CCoreDebugInfo debugInfo, out string pdbName, out string pdbKey)
+    {
+        pdbName = string.Empty;
+        pdbKey = string.Empty;
+
+        var codeView = debugInfo?.CodeView?.FirstOrDefault(cv => !string.IsNullOrEmpty(cv.PdbPath));
+        if (codeView == null)
+            return;
+
+        try
+        {
+            pdbName = Path.GetFileName(codeView.PdbPath);
+        }
+        catch
+        {
+            return;
+        }
+
+        if (string.Equals(codeView.Format, "RSDS", StringComparison.Ordinal) && !string.IsNullOrEmpty(codeView.Guid))
+        {
+            pdbKey = $"{codeView.Guid.Replace("-", string.Empty)}{codeView.Age:X}";
+        }
+        else if (string.Equals(codeView.Format, "NB10", StringComparison.Ordinal))
+        {
+            pdbKey = $"{codeView.Signature:X8}{codeView.Age:X}";
+        }
+    }
+
+    /// <summary>
+    /// Parses symbol path into downstream stores with their local upstream stores.
+    /// </summary>
+    /// <remarks>
+    /// Only "srv*cache*store..." elements are considered, HTTP stores are left to symsrv.
+    /// </remarks>
+    private static List<SymbolStoreChain> ParseSymbolStores(string symbolPath)
+    {
+        List<SymbolStoreChain> stores = [];
+
+        if (string.IsNullOrWhiteSpace(symbolPath))
+            return stores;
+
+        foreach (string element in symbolPath.Split(';', StringSplitOptions.RemoveEmptyEntries | StringSplitOptions.TrimEntries))
+        {
+            string[] parts = element.Split('*');
+
+            if (parts.Length < 3 ||
+                !string.Equals(parts[0], "srv", StringComparison.OrdinalIgnoreCase) ||
+                string.IsNullOrWhiteSpace(parts[1]))
+            {
+                continue;
+            }
+
+            List<string> upstreamPaths = parts.Skip(2)
+                .Where(path => !string.IsNullOrWhiteSpace(path) &&
+                    !path.StartsWith("http://", StringComparison.OrdinalIgnoreCase) &&
+                    !path.StartsWith("https://", StringComparison.OrdinalIgnoreCase))
+                .ToList();
+
+            if (upstreamPaths.Count > 0)
+            {
+                stores.Add(new SymbolStoreChain(parts[1], upstreamPaths));
+            }
+        }
+
+        return stores;
+    }
+
+    /// <summary>
+    /// Copies PDB of the requested module from a local upstream store into the downstream cache.
+    /// </summary>
+    private void FetchSymbolFile(SymbolLoadRequest request)
+    {
+        if (string.IsNullOrEmpty(request.PdbName) || string.IsNullOrEmpty(request.PdbKey))
+            return;
+
+        foreach (var store in _symbolStores)
+        {
+            string cachedFile = Path.Combine(store.CachePath, request.PdbName, request.PdbKey, request.PdbName);
+            if (File.Exists(cachedFile))
+                return;
+
+            foreach (string upstreamPath in store.UpstreamPaths)
+            {
+                string sourceFile = Path.Combine(upstreamPath, request.PdbName, request.PdbKey, request.PdbName);
+                if (!File.Exists(sourceFile))
+                    continue;
+
+                string tempFile = $"{cachedFile}.{Environment.CurrentManagedThreadId}.tmp";
+
+                Directory.CreateDirectory(Path.GetDirectoryName(cachedFile));
+                File.Copy(sourceFile, tempFile, true);
+
+                try
+                {
+                    File.Move(tempFile, cachedFile);
+                }
+                catch (IOException)
+                {
+                    // Another worker has cached it meanwhile.
+                    File.Delete(tempFile);
+                }
+
+                return;
+            }
+        }
+    }
+
     public IntPtr RetrieveCachedSymModule(string moduleName)
     {
         lock (_dbgHelpLock)
@@ -652,8 +1194,12 @@ public sealed class CSymbolResolver : IDisposable
             if (string.IsNullOrEmpty(moduleName))
                 return IntPtr.Zero;
 
-            if (string.Equals(_nativeLoadedModuleFileName, moduleName, StringComparison.OrdinalIgnoreCase))
-                return _nativeLoadedModuleBase;
+            if (_loadedModules.TryGetValue(moduleName, out var module))
+            {
+                module.LastUse = ++_moduleUseCounter;
+                module.Used = true;
+                return module.Base;
+            }
 
             return IntPtr.Zero;
         }
@@ -665,7 +1211,7 @@ public sealed class CSymbolResolver : IDisposable
 
         lock (_dbgHelpLock)
         {
-            result = ClearLoadedModuleNative();
+            result = ClearLoadedModulesNative();
         }
 
         lock (_stateLock)
@@ -684,11 +1230,20 @@ public sealed class CSymbolResolver : IDisposable
     {
         bool bResult = false;
 
+        lock (_stateLock)
+        {
+            _prefetchQueue.Clear();
+            _loadQueue.Clear();
+            _pendingRequests.Clear();
+            _foregroundRequest = null;
+            _activeModuleFileName = string.Empty;
+        }
+
         lock (_dbgHelpLock)
         {
             if (DbgHelpModule != IntPtr.Zero)
             {
-                ClearLoadedModuleNative();
+                ClearLoadedModulesNative();
 
                 if (SymbolsInitialized && SymCleanup != null)
                 {
@@ -706,14 +1261,6 @@ public sealed class CSymbolResolver : IDisposable
             }
         }
 
-        lock (_stateLock)
-        {
-            _pendingModuleFileName = string.Empty;
-            _pendingModuleBaseAddress = 0;
-            _pendingRequestId = 0;
-            _activeModuleFileName = string.Empty;
-        }
-
         return bResult;
     }
 
@@ -721,13 +1268,21 @@ public sealed class CSymbolResolver : IDisposable
     {
         _disposeRequested = true;
         _preloadSignal.Set();
+        _prefetchSignal.Release(Math.Max(_prefetchWorkerThreads.Count, 1));
 
         if (_preloadWorkerThread != null && _preloadWorkerThread.IsAlive)
         {
             _preloadWorkerThread.Join();
         }
 
+        foreach (var thread in _prefetchWorkerThreads)
+        {
+            if (thread.IsAlive)
+                thread.Join();
+        }
+
         _preloadSignal.Dispose();
+        _prefetchSignal.Dispose();
         ReleaseSymbolResolver();
     }
 
@@ -736,25 +1291,173 @@ public sealed class CSymbolResolver : IDisposable
     /// </summary>
     /// <param name="functionName">The decorated function name.</param>
     /// <returns>The undecorated function name, or the original name if it wasn't decorated.</returns>
+    /// <remarks>
+    /// Names are undecorated by <see cref="CMsvcDemangler"/> without taking the dbghelp lock,
+    /// dbghelp is only used for constructs the managed undecorator does not support.
+    /// </remarks>
     internal string UndecorateFunctionName(string functionName)
     {
+        if (string.IsNullOrEmpty(functionName))
+            return functionName;
+
+        if (UndecoratedNameCache.TryGetValue(functionName, out string undecoratedName))
+            return undecoratedName;
+
+        if (CMsvcDemangler.TryUndecorate(functionName, UndecorateFlags, out undecoratedName))
+            return CacheUndecoratedName(functionName, undecoratedName);
+
         lock (_dbgHelpLock)
         {
-            if (!UndecorationReady || UnDecorateSymbolName == null)
+            return UndecorateNameLocked(functionName);
+        }
+    }
+
+    /// <summary>
+    /// Undecorates names of all decorated functions in the list that have no undecorated name yet.
+    /// </summary>
+    /// <remarks>
+    /// Names missing from the cache are undecorated by <see cref="CMsvcDemangler"/>, names it cannot
+    /// handle are passed to dbghelp in a single locked pass. Results are stored in
+    /// <see cref="CFunction.UndecoratedName"/> so list rendering and sorting do not undecorate again.
+    /// </remarks>
+    /// <param name="functions">List of functions, e.g. module exports.</param>
+    internal void UndecorateFunctionNames(List<CFunction> functions)
+    {
+        List<CFunction> pending = null;
+
+        if (functions == null)
+            return;
+
+        foreach (var function in functions)
+        {
+            if (!string.IsNullOrEmpty(function.UndecoratedName) || !function.IsNameDecorated())
+                continue;
+
+            if (UndecoratedNameCache.TryGetValue(function.RawName, out string undecoratedName))
             {
-                return functionName;
+                function.UndecoratedName = undecoratedName;
             }
+            else if (CMsvcDemangler.TryUndecorate(function.RawName, UndecorateFlags, out undecoratedName))
+            {
+                function.UndecoratedName = CacheUndecoratedName(function.RawName, undecoratedName);
+            }
+            else
+            {
+                (pending ??= []).Add(function);
+            }
+        }
 
-            StringBuilder sb = new(1024);
+        if (pending == null || !UndecorationReady)
+            return;
 
-            // Note: DependencyWalker uses UNDNAME.NoAllocateLanguage | UNDNAME.NoMsKeyWords | UNDNAME.NoFunctionReturns | UNDNAME.NoAccessSpecifiers
-            if (UnDecorateSymbolName(functionName, sb, sb.Capacity, UNDNAME.NoMsKeyWords) > 0)
+        lock (_dbgHelpLock)
+        {
+            foreach (var function in pending)
             {
-                return sb.ToString();
+                function.UndecoratedName = UndecorateNameLocked(function.RawName);
             }
         }
+    }
+
+    /// <summary>
+    /// Undecorates name with dbghelp and caches the result, must be called with _dbgHelpLock held.
+    /// </summary>
+    private string UndecorateNameLocked(string functionName)
+    {
+        string result = functionName;
+
+        if (!UndecorationReady || UnDecorateSymbolName == null)
+        {
+            return functionName;
+        }
+
+        if (UndecoratedNameCache.TryGetValue(functionName, out string undecoratedName))
+        {
+            return undecoratedName;
+        }
+
+        _undecorateBuffer.Clear();
+
+        if (UnDecorateSymbolName(functionName, _undecorateBuffer, _undecorateBuffer.Capacity, UndecorateFlags) > 0)
+        {
+            result = _undecorateBuffer.ToString();
+        }
+
+        return CacheUndecoratedName(functionName, result);
+    }
+
+    /// <summary>
+    /// Undecorates name with dbghelp only, bypassing the cache.
+    /// </summary>
+    /// <remarks>
+    /// Used to validate <see cref="CMsvcDemangler"/> output against dbghelp.
+    /// </remarks>
+    /// <param name="name">The decorated name.</param>
+    /// <param name="result">Undecorated name on success.</param>
+    /// <returns>True if dbghelp undecorated the name.</returns>
+    internal bool UndecorateNameNative(string name, out string result)
+    {
+        result = null;
+
+        lock (_dbgHelpLock)
+        {
+            if (!UndecorationReady || UnDecorateSymbolName == null)
+                return false;
+
+            _undecorateBuffer.Clear();
+
+            if (UnDecorateSymbolName(name, _undecorateBuffer, _undecorateBuffer.Capacity, UndecorateFlags) == 0)
+                return false;
+
+            result = _undecorateBuffer.ToString();
+            return true;
+        }
+    }
+
+    private static string CacheUndecoratedName(string functionName, string undecoratedName)
+    {
+        // Count is tracked separately, ConcurrentDictionary.Count takes every bucket lock.
+        if (UndecoratedNameCache.TryAdd(functionName, undecoratedName) &&
+            Interlocked.Increment(ref _undecoratedNameCacheCount) > CConsts.UndecoratedNameCacheMax)
+        {
+            TrimUndecoratedNameCache();
+        }
 
-        return functionName;
+        return undecoratedName;
+    }
+
+    /// <summary>
+    /// Drops part of the undecoration cache once it is over the limit, so names in use stay cached
+    /// instead of undecorating everything again after a full reset. One thread trims at a time,
+    /// others keep adding meanwhile.
+    /// </summary>
+    private static void TrimUndecoratedNameCache()
+    {
+        if (Interlocked.Exchange(ref _undecoratedNameCacheTrimming, 1) != 0)
+            return;
+
+        try
+        {
+            int excess = Volatile.Read(ref _undecoratedNameCacheCount) - CConsts.UndecoratedNameCacheMax;
+            int toRemove = Math.Max(excess, 0) + CConsts.UndecoratedNameCacheTrim;
+
+            // Dictionary enumeration does not lock, removed entries are in hash order.
+            foreach (var entry in UndecoratedNameCache)
+            {
+                if (toRemove <= 0)
+                    break;
+
+                if (UndecoratedNameCache.TryRemove(entry.Key, out _))
+                {
+                    Interlocked.Decrement(ref _undecoratedNameCacheCount);
+                    toRemove--;
+                }
+            }
+        }
+        finally
+        {
+            Volatile.Write(ref _undecoratedNameCacheTrimming, 0);
+        }
     }
 
     /// <summary>